@@ -0,0 +1,238 @@
+//===- bvbench.cpp -- Micro-benchmark for bit vector kernels -----------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2022>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * bvbench.cpp
+ *
+ * Times the word-array kernels behind CoreBitVector and BitVector for every
+ * instruction set this CPU supports, checks they agree with the scalar
+ * kernels, and times whole-set operations on CoreBitVector, BitVector and
+ * SparseBitVector for reference.
+ */
+
+#include "Util/BitVectorKernels.h"
+#include "Util/BitVector.h"
+#include "Util/CoreBitVector.h"
+#include "Util/SparseBitVector.h"
+#include "Util/CommandLine.h"
+#include "Util/SVFUtil.h"
+
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace SVF;
+using namespace SVFUtil;
+
+static Option<u32_t> Repeats(
+    "repeats",
+    "Number of times each kernel is run per measurement",
+    20000
+);
+
+static Option<u32_t> Seed(
+    "seed",
+    "Seed for the random bit vectors",
+    1
+);
+
+typedef BitVectorKernels::Word Word;
+typedef std::vector<Word> Words;
+typedef std::chrono::steady_clock Clock;
+
+/// Returns n random words with each bit set with probability density.
+static Words randomWords(std::mt19937_64 &rng, size_t n, double density)
+{
+    std::bernoulli_distribution bit(density);
+    Words words(n, 0);
+    for (Word &w : words)
+    {
+        for (unsigned b = 0; b < 64; ++b)
+        {
+            if (bit(rng)) w |= (Word)1 << b;
+        }
+    }
+
+    return words;
+}
+
+/// Runs f repeats times and returns the average time of one run in nanoseconds.
+template <typename F>
+static double timeIt(u32_t repeats, F f)
+{
+    const Clock::time_point start = Clock::now();
+    for (u32_t i = 0; i < repeats; ++i) f();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / repeats;
+}
+
+/// Sink so the compiler keeps results of the timed calls.
+static volatile unsigned sink;
+
+/// Times every kernel of k on lhs and rhs. Returns false if a result differs
+/// from the scalar kernels.
+static bool benchKernels(const BitVectorKernels::Kernels &k, const Words &lhs, const Words &rhs,
+                         double scalarTimes[], bool scalar)
+{
+    const BitVectorKernels::Kernels &s = *BitVectorKernels::get(BitVectorKernels::Scalar);
+    const size_t n = lhs.size();
+    const u32_t repeats = std::max<u32_t>(1, Repeats() / std::max<size_t>(1, n / 64));
+    bool ok = true;
+
+    Words dst;
+    Words expected;
+    double times[6];
+
+    // Operations writing to dst: check once from a fresh copy, then time.
+    typedef bool (*WriteKernel)(Word *, const Word *, size_t);
+    const WriteKernel writes[3] = { k.unionWith, k.intersectWith, k.intersectWithComplement };
+    const WriteKernel scalarWrites[3] = { s.unionWith, s.intersectWith, s.intersectWithComplement };
+    for (unsigned op = 0; op < 3; ++op)
+    {
+        dst = lhs;
+        expected = lhs;
+        const bool changed = writes[op](dst.data(), rhs.data(), n);
+        const bool expectedChanged = scalarWrites[op](expected.data(), rhs.data(), n);
+        ok &= changed == expectedChanged && dst == expected;
+
+        times[op] = timeIt(repeats, [&]()
+        {
+            sink += writes[op](dst.data(), rhs.data(), n);
+        });
+    }
+
+    ok &= k.contains(lhs.data(), rhs.data(), n) == s.contains(lhs.data(), rhs.data(), n);
+    ok &= k.contains(lhs.data(), lhs.data(), n) == s.contains(lhs.data(), lhs.data(), n);
+    times[3] = timeIt(repeats, [&]()
+    {
+        sink += k.contains(lhs.data(), lhs.data(), n);
+    });
+
+    ok &= k.intersects(lhs.data(), rhs.data(), n) == s.intersects(lhs.data(), rhs.data(), n);
+    times[4] = timeIt(repeats, [&]()
+    {
+        sink += k.intersects(lhs.data(), rhs.data(), n);
+    });
+
+    ok &= k.count(lhs.data(), n) == s.count(lhs.data(), n);
+    times[5] = timeIt(repeats, [&]()
+    {
+        sink += k.count(lhs.data(), n);
+    });
+
+    outs() << std::left << std::setw(8) << k.name << std::right;
+    for (unsigned op = 0; op < 6; ++op)
+    {
+        if (scalar) scalarTimes[op] = times[op];
+        outs() << std::setw(11) << std::fixed << std::setprecision(1) << times[op]
+               << " (" << std::setw(4) << std::setprecision(2) << scalarTimes[op] / times[op] << "x)";
+    }
+
+    outs() << (ok ? "" : "  MISMATCH") << "\n";
+    return ok;
+}
+
+/// Times |=, &= and contains on whole sets built from lhs and rhs.
+template <typename BV>
+static void benchSets(const char *name, const Words &lhs, const Words &rhs)
+{
+    BV l;
+    BV r;
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        for (unsigned b = 0; b < 64; ++b)
+        {
+            if (lhs[i] & ((Word)1 << b)) l.set(i * 64 + b);
+            if (rhs[i] & ((Word)1 << b)) r.set(i * 64 + b);
+        }
+    }
+
+    const u32_t repeats = std::max<u32_t>(1, Repeats() / std::max<size_t>(1, lhs.size() / 16));
+    const double unionTime = timeIt(repeats, [&]()
+    {
+        BV d(l);
+        sink += d |= r;
+    });
+
+    const double intersectTime = timeIt(repeats, [&]()
+    {
+        BV d(l);
+        sink += d &= r;
+    });
+
+    const double containsTime = timeIt(repeats, [&]()
+    {
+        sink += l.contains(r);
+    });
+
+    outs() << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(1)
+           << std::setw(11) << unionTime << std::setw(11) << intersectTime
+           << std::setw(11) << containsTime << "\n";
+}
+
+int main(int argc, char** argv)
+{
+    OptionBase::parseOptions(argc, argv, "Bit vector kernel benchmark", "[options]");
+
+    std::mt19937_64 rng(Seed());
+    const size_t sizes[] = { 4, 64, 1024, 16384 };
+    const double densities[] = { 0.01, 0.5 };
+    const BitVectorKernels::ISA isas[] =
+    {
+        BitVectorKernels::Scalar, BitVectorKernels::SSE42,
+        BitVectorKernels::AVX2, BitVectorKernels::NEON,
+    };
+
+    outs() << "Selected kernels: " << BitVectorKernels::get().name << "\n";
+    bool ok = true;
+    for (size_t n : sizes)
+    {
+        for (double density : densities)
+        {
+            const Words lhs = randomWords(rng, n, density);
+            const Words rhs = randomWords(rng, n, density);
+
+            outs() << "\n" << n << " words, density " << density << " (ns per call, speedup over scalar)\n";
+            outs() << std::left << std::setw(8) << "isa" << std::right
+                   << std::setw(19) << "union" << std::setw(19) << "intersect"
+                   << std::setw(19) << "minus" << std::setw(19) << "contains"
+                   << std::setw(19) << "intersects" << std::setw(19) << "count" << "\n";
+
+            double scalarTimes[6];
+            for (BitVectorKernels::ISA isa : isas)
+            {
+                const BitVectorKernels::Kernels *k = BitVectorKernels::get(isa);
+                if (k == nullptr) continue;
+                ok &= benchKernels(*k, lhs, rhs, scalarTimes, isa == BitVectorKernels::Scalar);
+            }
+
+            outs() << std::left << std::setw(8) << "set" << std::right
+                   << std::setw(11) << "|=" << std::setw(11) << "&=" << std::setw(11) << "contains" << "\n";
+            benchSets<CoreBitVector>("cbv", lhs, rhs);
+            benchSets<BitVector>("bv", lhs, rhs);
+            benchSets<SparseBitVector<>>("sbv", lhs, rhs);
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+//===- CompactEdgeSet.h -- Compact per-node edge set--------------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * CompactEdgeSet.h
+ *
+ * An ordered set of edge pointers kept in one contiguous vector, as a drop-in
+ * replacement of OrderedSet<EdgeTy*, Cmp> for per-node adjacency.
+ */
+
+#ifndef INCLUDE_GRAPHS_COMPACTEDGESET_H_
+#define INCLUDE_GRAPHS_COMPACTEDGESET_H_
+
+#include "Util/GeneralType.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace SVF
+{
+
+/*!
+ * Ordered edge set stored in a vector: [0, numSorted) is the sorted (compacted)
+ * part and [numSorted, size) is a small sorted append buffer. New edges go to the
+ * buffer, which is merged into the compacted part once it grows beyond about the
+ * square root of it. Iteration merges the two parts on the fly, so it visits the
+ * edges in the same order as the OrderedSet it replaces.
+ *
+ * Removing an edge from the compacted part leaves a tombstone (nullptr) behind
+ * instead of shifting the rest, and tombstones are dropped at compaction, so
+ * that removing many edges of a hub node (e.g., when merging SCCs) stays cheap.
+ * Searches and iteration step over tombstones.
+ *
+ * Each edge costs one pointer instead of a tree node. As with any vector, an
+ * insertion or removal invalidates the iterators of this set.
+ */
+template<class EdgeTy, class Compare>
+class CompactEdgeSet
+{
+public:
+    typedef EdgeTy* value_type;
+    typedef EdgeTy* key_type;
+    typedef std::vector<EdgeTy*> EdgeVector;
+
+    /// Forward iterator merging the compacted part and the append buffer
+    class const_iterator
+    {
+        friend class CompactEdgeSet;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef EdgeTy* value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef EdgeTy* const* pointer;
+        typedef EdgeTy* const& reference;
+
+        const_iterator() : sortedIt(nullptr), sortedEnd(nullptr), bufIt(nullptr), bufEnd(nullptr), inSorted(true) {}
+
+        inline reference operator*() const
+        {
+            return inSorted ? *sortedIt : *bufIt;
+        }
+        inline pointer operator->() const
+        {
+            return inSorted ? sortedIt : bufIt;
+        }
+        inline const_iterator& operator++()
+        {
+            if (inSorted)
+                ++sortedIt;
+            else
+                ++bufIt;
+            pickNext();
+            return *this;
+        }
+        inline const_iterator operator++(int)
+        {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        inline bool operator==(const const_iterator& rhs) const
+        {
+            return sortedIt == rhs.sortedIt && bufIt == rhs.bufIt;
+        }
+        inline bool operator!=(const const_iterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        EdgeTy* const* sortedIt;
+        EdgeTy* const* sortedEnd;
+        EdgeTy* const* bufIt;
+        EdgeTy* const* bufEnd;
+        bool inSorted;  ///< Which part the current edge is in
+
+        const_iterator(EdgeTy* const* s, EdgeTy* const* se, EdgeTy* const* b, EdgeTy* const* be) :
+            sortedIt(s), sortedEnd(se), bufIt(b), bufEnd(be), inSorted(true)
+        {
+            pickNext();
+        }
+
+        /// Only the two candidates are compared (never the edge just visited,
+        /// which callers such as destructors may already have deleted).
+        inline void pickNext()
+        {
+            while (sortedIt != sortedEnd && *sortedIt == nullptr)
+                ++sortedIt;
+            if (sortedIt == sortedEnd)
+                inSorted = false;
+            else if (bufIt == bufEnd)
+                inSorted = true;
+            else
+                inSorted = !Compare()(*bufIt, *sortedIt);
+        }
+    };
+    typedef const_iterator iterator;
+
+private:
+    EdgeVector edges;
+    u32_t numSorted;
+    u32_t numDead;  ///< Tombstones in the compacted part
+
+    inline EdgeTy* const* sortedBegin() const
+    {
+        return edges.data();
+    }
+    inline EdgeTy* const* sortedEnd() const
+    {
+        return edges.data() + numSorted;
+    }
+    inline EdgeTy* const* bufBegin() const
+    {
+        return sortedEnd();
+    }
+    inline EdgeTy* const* bufEnd() const
+    {
+        return edges.data() + edges.size();
+    }
+
+    /// Equivalence under Compare, as used by OrderedSet
+    static inline bool equivalent(const EdgeTy* lhs, const EdgeTy* rhs)
+    {
+        return !Compare()(lhs, rhs) && !Compare()(rhs, lhs);
+    }
+
+    /// Merge the append buffer into the compacted part if it is large enough,
+    /// or drop the tombstones if there are as many
+    inline void compactIfNeeded()
+    {
+        size_t bufSize = edges.size() - numSorted;
+        if ((bufSize >= MinBufferSize && bufSize * bufSize >= numSorted)
+                || (numDead >= MinBufferSize && (size_t)numDead * numDead >= numSorted))
+            compact();
+    }
+
+    /// std::lower_bound over the compacted part, stepping over tombstones:
+    /// the first live edge not less than edge, or sortedEnd()
+    EdgeTy* const* sortedLowerBound(const EdgeTy* edge) const
+    {
+        EdgeTy* const* lo = sortedBegin();
+        EdgeTy* const* hi = sortedEnd();
+        EdgeTy* const* result = sortedEnd();
+        while (lo < hi)
+        {
+            EdgeTy* const* mid = lo + (hi - lo) / 2;
+            EdgeTy* const* live = mid;
+            while (live != hi && *live == nullptr)
+                ++live;
+            if (live == hi)
+                hi = mid;
+            else if (Compare()(*live, edge))
+                lo = live + 1;
+            else
+            {
+                // Everything in [mid, live) is a tombstone.
+                result = live;
+                hi = mid;
+            }
+        }
+        return result;
+    }
+
+public:
+    static constexpr size_t MinBufferSize = 8;
+
+    CompactEdgeSet() : numSorted(0), numDead(0) {}
+
+    /// Iterators
+    //@{
+    inline const_iterator begin() const
+    {
+        return const_iterator(sortedBegin(), sortedEnd(), bufBegin(), bufEnd());
+    }
+    inline const_iterator end() const
+    {
+        return const_iterator(sortedEnd(), sortedEnd(), bufEnd(), bufEnd());
+    }
+    //@}
+
+    inline size_t size() const
+    {
+        return edges.size() - numDead;
+    }
+    inline bool empty() const
+    {
+        return size() == 0;
+    }
+    inline void clear()
+    {
+        edges.clear();
+        numSorted = 0;
+        numDead = 0;
+    }
+
+    /// Find an edge equivalent to edge under Compare
+    const_iterator find(const EdgeTy* edge) const
+    {
+        EdgeTy* const* s = sortedLowerBound(edge);
+        EdgeTy* const* b = std::lower_bound(bufBegin(), bufEnd(), edge, Compare());
+        if ((s != sortedEnd() && equivalent(*s, edge)) || (b != bufEnd() && equivalent(*b, edge)))
+            return const_iterator(s, sortedEnd(), b, bufEnd());
+        return end();
+    }
+    inline size_t count(const EdgeTy* edge) const
+    {
+        return find(edge) != end() ? 1 : 0;
+    }
+
+    /// Insert an edge unless an equivalent one is already in the set
+    std::pair<const_iterator, bool> insert(EdgeTy* edge)
+    {
+        const_iterator it = find(edge);
+        if (it != end())
+            return std::make_pair(it, false);
+
+        typename EdgeVector::iterator pos = std::lower_bound(edges.begin() + numSorted, edges.end(), edge, Compare());
+        edges.insert(pos, edge);
+        compactIfNeeded();
+        return std::make_pair(find(edge), true);
+    }
+
+    /// Remove the edge at it
+    void erase(const_iterator it)
+    {
+        assert(it != end() && "can not erase end()!");
+        if (it.inSorted)
+        {
+            edges[it.sortedIt - sortedBegin()] = nullptr;
+            ++numDead;
+            compactIfNeeded();
+        }
+        else
+            edges.erase(edges.begin() + (it.bufIt - sortedBegin()));
+    }
+
+    /// Remove the edge equivalent to edge, return the number of removed edges
+    size_t erase(const EdgeTy* edge)
+    {
+        const_iterator it = find(edge);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    /// Drop the tombstones and merge the append buffer into the compacted part
+    void compact()
+    {
+        typename EdgeVector::iterator sortedEndIt = edges.begin() + numSorted;
+        if (numDead != 0)
+        {
+            typename EdgeVector::iterator liveEnd = std::remove(edges.begin(), sortedEndIt, nullptr);
+            edges.erase(liveEnd, sortedEndIt);
+            sortedEndIt = liveEnd;
+            numDead = 0;
+        }
+        std::inplace_merge(edges.begin(), sortedEndIt, edges.end(), Compare());
+        numSorted = edges.size();
+    }
+
+    /// Compact and release unused capacity
+    void shrink()
+    {
+        compact();
+        edges.shrink_to_fit();
+    }
+};
+
+} // End namespace SVF
+
+#endif /* INCLUDE_GRAPHS_COMPACTEDGESET_H_ */
@@ -368,6 +368,15 @@ public:
     }
     //@}
 
+    /// Offline pointer equivalence by hash-based value numbering with union (HU).
+    /// Each node is labelled with the set of points-to labels it can receive
+    /// through addr, copy and gep constraints; pointers with the same non-empty
+    /// label set end up with the same points-to set. Nodes which may receive
+    /// new incoming edges while solving (loads, objects, parameters of
+    /// address-taken functions, indirect callsite returns) get fresh labels.
+    /// Returns the classes of pointers with two or more members.
+    void computePointerEquivalence(std::vector<NodeBS>& classes);
+
     /// Dump graph into dot file
     void dump(std::string name);
     /// Print CG into terminal
@@ -32,6 +32,7 @@
 
 #include "SVFIR/SVFIR.h"
 #include "Util/WorkList.h"
+#include "Graphs/CompactEdgeSet.h"
 
 #include <map>
 #include <set>
@@ -40,11 +41,20 @@ namespace SVF
 {
 
 class ConstraintNode;
+class ConstraintEdge;
+typedef GenericEdge<ConstraintNode> GenericConsEdgeTy;
+
+/// Constraint nodes keep their (many) edges in compact vectors rather than trees
+template<>
+struct GEdgeSetTrait<ConstraintEdge>
+{
+    typedef CompactEdgeSet<ConstraintEdge, GenericConsEdgeTy::equalGEdge> GEdgeSetTy;
+};
+
 /*!
  * Self-defined edge for constraint resolution
  * including add/remove/re-target, but all the operations do not affect original SVFIR Edges
  */
-typedef GenericEdge<ConstraintNode> GenericConsEdgeTy;
 class ConstraintEdge : public GenericConsEdgeTy
 {
 
@@ -82,7 +92,9 @@ public:
                edge->getEdgeKind() == VariantGep;
     }
     /// Constraint edge type
-    typedef GenericNode<ConstraintNode,ConstraintEdge>::GEdgeSetTy ConstraintEdgeSetTy;
+    typedef OrderedSet<ConstraintEdge*, equalGEdge> ConstraintEdgeSetTy;
+    /// Edge set of a constraint node
+    typedef GenericNode<ConstraintNode,ConstraintEdge>::GEdgeSetTy ConstraintNodeEdgeSetTy;
 
 };
 
@@ -41,30 +41,30 @@ class ConstraintNode : public GenericConsNodeTy
 {
 
 public:
-    typedef ConstraintEdge::ConstraintEdgeSetTy::iterator iterator;
-    typedef ConstraintEdge::ConstraintEdgeSetTy::const_iterator const_iterator;
+    typedef ConstraintEdge::ConstraintNodeEdgeSetTy::iterator iterator;
+    typedef ConstraintEdge::ConstraintNodeEdgeSetTy::const_iterator const_iterator;
     bool _isPWCNode;
 
 private:
-    ConstraintEdge::ConstraintEdgeSetTy loadInEdges; ///< all incoming load edge of this node
-    ConstraintEdge::ConstraintEdgeSetTy loadOutEdges; ///< all outgoing load edge of this node
+    ConstraintEdge::ConstraintNodeEdgeSetTy loadInEdges; ///< all incoming load edge of this node
+    ConstraintEdge::ConstraintNodeEdgeSetTy loadOutEdges; ///< all outgoing load edge of this node
 
-    ConstraintEdge::ConstraintEdgeSetTy storeInEdges; ///< all incoming store edge of this node
-    ConstraintEdge::ConstraintEdgeSetTy storeOutEdges; ///< all outgoing store edge of this node
+    ConstraintEdge::ConstraintNodeEdgeSetTy storeInEdges; ///< all incoming store edge of this node
+    ConstraintEdge::ConstraintNodeEdgeSetTy storeOutEdges; ///< all outgoing store edge of this node
 
     /// Copy/call/ret/gep incoming edge of this node,
     /// To be noted: this set is only used when SCC detection, and node merges
-    ConstraintEdge::ConstraintEdgeSetTy directInEdges;
-    ConstraintEdge::ConstraintEdgeSetTy directOutEdges;
+    ConstraintEdge::ConstraintNodeEdgeSetTy directInEdges;
+    ConstraintEdge::ConstraintNodeEdgeSetTy directOutEdges;
 
-    ConstraintEdge::ConstraintEdgeSetTy copyInEdges;
-    ConstraintEdge::ConstraintEdgeSetTy copyOutEdges;
+    ConstraintEdge::ConstraintNodeEdgeSetTy copyInEdges;
+    ConstraintEdge::ConstraintNodeEdgeSetTy copyOutEdges;
 
-    ConstraintEdge::ConstraintEdgeSetTy gepInEdges;
-    ConstraintEdge::ConstraintEdgeSetTy gepOutEdges;
+    ConstraintEdge::ConstraintNodeEdgeSetTy gepInEdges;
+    ConstraintEdge::ConstraintNodeEdgeSetTy gepOutEdges;
 
-    ConstraintEdge::ConstraintEdgeSetTy addressInEdges; ///< all incoming address edge of this node
-    ConstraintEdge::ConstraintEdgeSetTy addressOutEdges; ///< all outgoing address edge of this node
+    ConstraintEdge::ConstraintNodeEdgeSetTy addressInEdges; ///< all incoming address edge of this node
+    ConstraintEdge::ConstraintNodeEdgeSetTy addressOutEdges; ///< all outgoing address edge of this node
 
 public:
     /// For stride-based field representation
@@ -100,51 +100,51 @@ public:
 
     /// Return constraint edges
     //@{
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getDirectInEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getDirectInEdges() const
     {
         return directInEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getDirectOutEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getDirectOutEdges() const
     {
         return directOutEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getCopyInEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getCopyInEdges() const
     {
         return copyInEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getCopyOutEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getCopyOutEdges() const
     {
         return copyOutEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getGepInEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getGepInEdges() const
     {
         return gepInEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getGepOutEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getGepOutEdges() const
     {
         return gepOutEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getLoadInEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getLoadInEdges() const
     {
         return loadInEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getLoadOutEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getLoadOutEdges() const
     {
         return loadOutEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getStoreInEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getStoreInEdges() const
     {
         return storeInEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getStoreOutEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getStoreOutEdges() const
     {
         return storeOutEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getAddrInEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getAddrInEdges() const
     {
         return addressInEdges;
     }
-    inline const ConstraintEdge::ConstraintEdgeSetTy& getAddrOutEdges() const
+    inline const ConstraintEdge::ConstraintNodeEdgeSetTy& getAddrOutEdges() const
     {
         return addressOutEdges;
     }
@@ -161,11 +161,11 @@ public:
     const_iterator directInEdgeBegin() const;
     const_iterator directInEdgeEnd() const;
 
-    ConstraintEdge::ConstraintEdgeSetTy& incomingAddrEdges()
+    ConstraintEdge::ConstraintNodeEdgeSetTy& incomingAddrEdges()
     {
         return addressInEdges;
     }
-    ConstraintEdge::ConstraintEdgeSetTy& outgoingAddrEdges()
+    ConstraintEdge::ConstraintNodeEdgeSetTy& outgoingAddrEdges()
     {
         return addressOutEdges;
     }
@@ -133,6 +133,16 @@ protected:
 };
 
 
+/*!
+ * Container holding the incoming/outgoing edges of a node.
+ * A graph may specialise it for its edge type (e.g. ConstraintEdge) to use a
+ * container with the same interface as OrderedSet but a smaller footprint.
+ */
+template<class EdgeTy>
+struct GEdgeSetTrait
+{
+    typedef OrderedSet<EdgeTy*, typename EdgeTy::equalGEdge> GEdgeSetTy;
+};
 
 /*!
  * Generic node on the graph as base class
@@ -145,7 +155,7 @@ public:
     typedef NodeTy NodeType;
     typedef EdgeTy EdgeType;
     /// Edge kind
-    typedef OrderedSet<EdgeType*, typename EdgeType::equalGEdge> GEdgeSetTy;
+    typedef typename GEdgeSetTrait<EdgeType>::GEdgeSetTy GEdgeSetTy;
     /// Edge iterator
     ///@{
     typedef typename GEdgeSetTy::iterator iterator;
@@ -53,6 +53,13 @@ private:
     MRVERSION version;
     MRVERID vid;
     MSSADef* def;
+
+    friend class MemSSA;
+    /// Constructor of a version MemSSA numbers later (see MemSSA::mergeFunBuildState)
+    MRVer(const MemRegion* m, MRVERSION v, MSSADef* d, MRVERID id) :
+        mr(m), version(v), vid(id),def(d)
+    {
+    }
 public:
     /// Constructor
     MRVer(const MemRegion* m, MRVERSION v, MSSADef* d) :
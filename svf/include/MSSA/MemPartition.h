@@ -76,7 +76,42 @@ class IntraDisjointMRG : public MRGenerator
 public:
     typedef OrderedMap<NodeBS, PointsToList> PtsToSubPtsMap;
     typedef Map<const FunObjVar*, PtsToSubPtsMap> FunToPtsMap;
-    typedef Map<const FunObjVar*, PointsToList> FunToInterMap;
+
+    /// Intersections of cpts, with the ones each object is in, so that those
+    /// overlapping a cpts are found without going through all of them.
+    struct InterList
+    {
+        PointsToList inters;
+        Map<NodeID, PointsToList> objToInters;
+
+        void insert(PointsToID inter, const NodeBS& cpts)
+        {
+            if (inters.insert(inter).second)
+            {
+                for (NodeID o : cpts)
+                    objToInters[o].insert(inter);
+            }
+        }
+        void erase(PointsToID inter, const NodeBS& cpts)
+        {
+            if (inters.erase(inter))
+            {
+                for (NodeID o : cpts)
+                    objToInters[o].erase(inter);
+            }
+        }
+        /// Intersections overlapping cpts, in ID order
+        void getOverlapping(PointsToList& overlapping, const NodeBS& cpts) const
+        {
+            for (NodeID o : cpts)
+            {
+                Map<NodeID, PointsToList>::const_iterator it = objToInters.find(o);
+                if (it != objToInters.end())
+                    overlapping.insert(it->second.begin(), it->second.end());
+            }
+        }
+    };
+    typedef Map<const FunObjVar*, InterList> FunToInterMap;
 
     IntraDisjointMRG(BVDataPTAImpl* p, bool ptrOnly) : MRGenerator(p, ptrOnly)
     {}
@@ -97,20 +132,23 @@ protected:
     virtual inline void getMRsForLoad(MRSet& aliasMRs, const NodeBS& cpts,
                                       const FunObjVar* fun)
     {
-        const PointsToList& inters = getIntersList(fun);
+        const InterList& inters = getIntersList(fun);
         getMRsForLoadFromInterList(aliasMRs, cpts, inters);
     }
 
-    void getMRsForLoadFromInterList(MRSet& mrs, const NodeBS& cpts, const PointsToList& inters);
+    void getMRsForLoadFromInterList(MRSet& mrs, const NodeBS& cpts, const InterList& inters);
+
+    /// Get the intersections in inters which cpts contains, in ID order
+    void getContainedInters(PointsToList& contained, const NodeBS& cpts, const InterList& inters) const;
 
     /// Get memory regions to be inserted at a load statement.
     virtual void getMRsForCallSiteRef(MRSet& aliasMRs, const NodeBS& cpts, const FunObjVar* fun);
 
     /// Create disjoint memory region
-    void createDisjointMR(const FunObjVar* func, const NodeBS& cpts);
+    void createDisjointMR(const FunObjVar* func, PointsToID cpts);
 
     /// Compute intersections between cpts and computed cpts intersections before.
-    void computeIntersections(const NodeBS& cpts, PointsToList& inters);
+    void computeIntersections(PointsToID cpts, InterList& inters);
 
 private:
     inline PtsToSubPtsMap& getPtsSubSetMap(const FunObjVar* func)
@@ -118,7 +156,7 @@ private:
         return funcToPtsMap[func];
     }
 
-    inline PointsToList& getIntersList(const FunObjVar* func)
+    inline InterList& getIntersList(const FunObjVar* func)
     {
         return funcToInterMap[func];
     }
@@ -162,7 +200,7 @@ protected:
     }
 
 private:
-    PointsToList inters;
+    InterList inters;
 };
 
 } // End namespace SVF
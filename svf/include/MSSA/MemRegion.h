@@ -144,10 +144,30 @@ public:
     ///Define mem region set
     typedef OrderedSet<const MemRegion*, MemRegion::equalMemRegion> MRSet;
     typedef Map<const PAGEdge*, const FunObjVar*> PAGEdgeToFunMap;
-    typedef OrderedSet<NodeBS, SVFUtil::equalNodeBS> PointsToList;
+    /// Conditional points-to sets are hash-consed (cf. PersistentPointsToCache):
+    /// each distinct one is stored once and referred to by its PointsToID.
+    /// Lists of them are ordered by ID, i.e., by first appearance; partitionMRs
+    /// visits them in NodeBS order.
+    typedef OrderedSet<PointsToID> PointsToList;
     typedef Map<const FunObjVar*, NodeBS> FunToPointsToMap;
     typedef Map<const FunObjVar*, PointsToList> FunToPointsTosMap;
-    typedef OrderedMap<NodeBS, NodeBS, SVFUtil::equalNodeBS> PtsToRepPtsSetMap;
+    typedef Map<PointsToID, PointsToID> PtsToRepPtsSetMap;
+    typedef OrderedMap<PointsToID, PointsToList> RepPtsToPtsSetMap;
+    typedef Map<PointsToID, const MemRegion*> PtsToMRMap;
+
+    /// Hash of all the objects of a cpts, as NodeBS's std::hash only looks
+    /// at its count and first/last objects.
+    struct HashNodeBS
+    {
+        size_t operator()(const NodeBS& cpts) const
+        {
+            size_t h = cpts.count();
+            for (NodeID o : cpts)
+                h ^= o + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    typedef Map<NodeBS, PointsToID, HashNodeBS> PtsToIDMap;
 
     /// Map a function to its region set
     typedef Map<const FunObjVar*, MRSet> FunToMRsMap;
@@ -186,15 +206,36 @@ public:
         return memRegSet;
     }
 
+    /// Get the ID of a cpts set, which must have been seen before
+    inline PointsToID getCPtsID(const NodeBS& cpts) const
+    {
+        PtsToIDMap::const_iterator it = cptsToIDMap.find(cpts);
+        assert(it!=cptsToIDMap.end() && "cpts not hash-consed??");
+        return it->second;
+    }
+    /// Get the cpts set of an ID
+    inline const NodeBS& getCPts(PointsToID id) const
+    {
+        assert(id < idToCPts.size() && "cpts ID out of range??");
+        return *idToCPts[id];
+    }
     /// Get superset cpts set
-    inline const NodeBS& getRepPointsTo(const NodeBS& cpts) const
+    inline PointsToID getRepPointsTo(PointsToID cpts) const
     {
         PtsToRepPtsSetMap::const_iterator it = cptsToRepCPtsMap.find(cpts);
         assert(it!=cptsToRepCPtsMap.end() && "can not find superset of cpts??");
         return it->second;
     }
+    inline const NodeBS& getRepPointsTo(const NodeBS& cpts) const
+    {
+        return getCPts(getRepPointsTo(getCPtsID(cpts)));
+    }
     /// Get a memory region according to cpts
-    const MemRegion* getMR(const NodeBS& cpts) const;
+    const MemRegion* getMR(PointsToID cpts) const;
+    inline const MemRegion* getMR(const NodeBS& cpts) const
+    {
+        return getMR(getCPtsID(cpts));
+    }
 
 private:
 
@@ -280,9 +321,32 @@ protected:
     MRSet memRegSet;
     /// Map a condition pts to its rep conditional pts (super set points-to)
     PtsToRepPtsSetMap cptsToRepCPtsMap;
+    /// The condition pts mapped to each rep, for sortPointsTo
+    RepPtsToPtsSetMap repCPtsToCPtsMap;
+    /// The greatest condition pts (in NodeBS order) mapped to each rep, to
+    /// pick between reps as when cptsToRepCPtsMap was ordered by NodeBS
+    PtsToRepPtsSetMap repCPtsToMaxCPtsMap;
+    /// Map a rep cpts to its memory region
+    PtsToMRMap cptsToMRMap;
+
+    /// Hash-consed cpts sets
+    //@{
+    PtsToIDMap cptsToIDMap;
+    std::vector<const NodeBS*> idToCPts;
+    //@}
+
+    /// Get the ID of a cpts set, giving it one if it is new
+    PointsToID emplaceCPts(const NodeBS& cpts);
+    /// Record that cpts is mapped to rep, for repCPtsToMaxCPtsMap
+    void addToMaxCPts(PointsToID rep, PointsToID cpts);
+    /// Whether cpts lhs comes before rhs in NodeBS order (SVFUtil::cmpNodeBS)
+    inline bool cptsBefore(PointsToID lhs, PointsToID rhs) const
+    {
+        return SVFUtil::cmpNodeBS(getCPts(lhs), getCPts(rhs));
+    }
 
     /// Generate a memory region and put in into functions which use it
-    void createMR(const FunObjVar* fun, const NodeBS& cpts);
+    void createMR(const FunObjVar* fun, PointsToID cpts);
 
     /// Collect all global variables for later escape analysis
     void collectGlobals();
@@ -300,7 +364,7 @@ protected:
     virtual void updateAliasMRs();
 
     /// Given a condition pts, insert into cptsToRepCPtsMap for region generation
-    virtual void sortPointsTo(const NodeBS& cpts);
+    virtual void sortPointsTo(PointsToID cpts);
 
     /// Whether a region is aliased with a conditional points-to
     virtual inline bool isAliasedMR(const NodeBS& cpts, const MemRegion* mr)
@@ -351,24 +415,24 @@ protected:
     inline void addCPtsToStore(NodeBS& cpts, const StoreStmt *st, const FunObjVar* fun)
     {
         storesToPointsToMap[st] = cpts;
-        funToPointsToMap[fun].insert(cpts);
+        funToPointsToMap[fun].insert(emplaceCPts(cpts));
         addModSideEffectOfFunction(fun,cpts);
     }
     inline void addCPtsToLoad(NodeBS& cpts, const LoadStmt *ld, const FunObjVar* fun)
     {
         loadsToPointsToMap[ld] = cpts;
-        funToPointsToMap[fun].insert(cpts);
+        funToPointsToMap[fun].insert(emplaceCPts(cpts));
         addRefSideEffectOfFunction(fun,cpts);
     }
     inline void addCPtsToCallSiteRefs(NodeBS& cpts, const CallICFGNode* cs)
     {
         callsiteToRefPointsToMap[cs] |= cpts;
-        funToPointsToMap[cs->getCaller()].insert(cpts);
+        funToPointsToMap[cs->getCaller()].insert(emplaceCPts(cpts));
     }
     inline void addCPtsToCallSiteMods(NodeBS& cpts, const CallICFGNode* cs)
     {
         callsiteToModPointsToMap[cs] |= cpts;
-        funToPointsToMap[cs->getCaller()].insert(cpts);
+        funToPointsToMap[cs->getCaller()].insert(emplaceCPts(cpts));
     }
     inline bool hasCPtsList(const FunObjVar* fun) const
     {
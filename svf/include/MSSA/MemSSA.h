@@ -122,14 +122,60 @@ protected:
     std::unique_ptr<MRGenerator> mrGen;
     MemSSAStat* stat;
 
+    /// What building memory SSA for a function creates, merged into this
+    /// MemSSA once the function is built. Functions built in parallel each
+    /// have their own.
+    struct FunBuildState
+    {
+        /// mus/chis/phis of the function
+        //@{
+        LoadToMUSetMap load2MuSetMap;
+        StoreToChiSetMap store2ChiSetMap;
+        CallSiteToMUSetMap callsiteToMuSetMap;
+        CallSiteToCHISetMap callsiteToChiSetMap;
+        BBToPhiSetMap bb2PhiSetMap;
+        FunToEntryChiSetMap funToEntryChiSetMap;
+        FunToReturnMuSetMap funToReturnMuSetMap;
+        //@}
+
+        MemRegToVerStackMap mr2VerStackMap;
+        MemRegToCounterMap mr2CounterMap;
+
+        /// The following three set are used for prune SSA phi insertion
+        // (see algorithm in book Engineering A Compiler section 9.3)
+        ///@{
+        /// Collects used memory regions
+        MRSet usedRegs;
+        /// Maps memory region to its basic block
+        MemRegToBBsMap reg2BBMap;
+        /// Collect memory regions whose definition killed
+        MRSet varKills;
+        //@}
+
+        /// MRVers in order of creation, numbered when merged.
+        std::vector<std::unique_ptr<MRVer>> mrVers;
+
+        double timeOfCreateMUCHI = 0;
+        double timeOfInsertingPHI = 0;
+        double timeOfSSARenaming = 0;
+    };
+
+    /// Build memory SSA for fun into fs
+    virtual void buildFunMemSSA(const FunObjVar& fun, FunBuildState& fs);
     /// Create mu chi for candidate regions in a function
-    virtual void createMUCHI(const FunObjVar& fun);
+    virtual void createMUCHI(const FunObjVar& fun, FunBuildState& fs);
     /// Insert phi for candidate regions in a function
-    virtual void insertPHI(const FunObjVar& fun);
+    virtual void insertPHI(const FunObjVar& fun, FunBuildState& fs);
     /// SSA rename for a function
-    virtual void SSARename(const FunObjVar& fun);
+    virtual void SSARename(const FunObjVar& fun, FunBuildState& fs);
     /// SSA rename for a basic block
-    virtual void SSARenameBB(const SVFBasicBlock& bb);
+    virtual void SSARenameBB(const SVFBasicBlock& bb, FunBuildState& fs);
+    /// Move what fs holds into this MemSSA, numbering its MRVers after all
+    /// merged before.
+    void mergeFunBuildState(FunBuildState& fs);
+    /// Create the MR sets of the loads and stores of funs, which building
+    /// them in parallel looks up.
+    void prepareParallelBuild(const std::vector<const FunObjVar*>& funs);
 private:
     LoadToMUSetMap load2MuSetMap;
     StoreToChiSetMap store2ChiSetMap;
@@ -140,155 +186,141 @@ private:
     FunToEntryChiSetMap funToEntryChiSetMap;
     FunToReturnMuSetMap funToReturnMuSetMap;
 
-    MemRegToVerStackMap mr2VerStackMap;
-    MemRegToCounterMap mr2CounterMap;
-
-    /// The following three set are used for prune SSA phi insertion
-    // (see algorithm in book Engineering A Compiler section 9.3)
-    ///@{
-    /// Collects used memory regions
-    MRSet usedRegs;
-    /// Maps memory region to its basic block
-    MemRegToBBsMap reg2BBMap;
-    /// Collect memory regions whose definition killed
-    MRSet varKills;
-    //@}
-
     std::vector<std::unique_ptr<MRVer>> usedMRVers;
 
     /// Release the memory
     void destroy();
 
     /// Get a new SSA name of a memory region
-    MRVer* newSSAName(const MemRegion* mr, MSSADEF* def);
+    MRVer* newSSAName(FunBuildState& fs, const MemRegion* mr, MSSADEF* def);
 
     /// Get the last version of the SSA ver of memory region
-    inline MRVer* getTopStackVer(const MemRegion* mr)
+    inline MRVer* getTopStackVer(FunBuildState& fs, const MemRegion* mr)
     {
-        std::vector<MRVer*> &stack = mr2VerStackMap[mr];
+        std::vector<MRVer*> &stack = fs.mr2VerStackMap[mr];
         assert(!stack.empty() && "stack is empty!!");
         return stack.back();
     }
 
     /// Collect region uses and region defs according to mus/chis, in order to insert phis
     //@{
-    inline void collectRegUses(const MemRegion* mr)
+    inline void collectRegUses(FunBuildState& fs, const MemRegion* mr)
     {
-        if (0 == varKills.count(mr))
-            usedRegs.insert(mr);
+        if (0 == fs.varKills.count(mr))
+            fs.usedRegs.insert(mr);
     }
-    inline void collectRegDefs(const SVFBasicBlock* bb, const MemRegion* mr)
+    inline void collectRegDefs(FunBuildState& fs, const SVFBasicBlock* bb, const MemRegion* mr)
     {
-        varKills.insert(mr);
-        reg2BBMap[mr].push_back(bb);
+        fs.varKills.insert(mr);
+        fs.reg2BBMap[mr].push_back(bb);
     }
     //@}
 
     /// Add methods for mus/chis/phis
     //@{
-    inline void AddLoadMU(const SVFBasicBlock* bb, const LoadStmt* load, const MRSet& mrSet)
+    inline void AddLoadMU(FunBuildState& fs, const SVFBasicBlock* bb, const LoadStmt* load, const MRSet& mrSet)
     {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddLoadMU(bb,load,*iter);
+            AddLoadMU(fs,bb,load,*iter);
     }
-    inline void AddStoreCHI(const SVFBasicBlock* bb, const StoreStmt* store, const MRSet& mrSet)
+    inline void AddStoreCHI(FunBuildState& fs, const SVFBasicBlock* bb, const StoreStmt* store, const MRSet& mrSet)
     {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddStoreCHI(bb,store,*iter);
+            AddStoreCHI(fs,bb,store,*iter);
     }
-    inline void AddCallSiteMU(const CallICFGNode* cs,  const MRSet& mrSet)
+    inline void AddCallSiteMU(FunBuildState& fs, const CallICFGNode* cs,  const MRSet& mrSet)
     {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddCallSiteMU(cs,*iter);
+            AddCallSiteMU(fs,cs,*iter);
     }
-    inline void AddCallSiteCHI(const CallICFGNode* cs,  const MRSet& mrSet)
+    inline void AddCallSiteCHI(FunBuildState& fs, const CallICFGNode* cs,  const MRSet& mrSet)
     {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddCallSiteCHI(cs,*iter);
+            AddCallSiteCHI(fs,cs,*iter);
     }
-    inline void AddMSSAPHI(const SVFBasicBlock* bb, const MRSet& mrSet)
+    inline void AddMSSAPHI(FunBuildState& fs, const SVFBasicBlock* bb, const MRSet& mrSet)
     {
         for (MRSet::iterator iter = mrSet.begin(), eiter = mrSet.end(); iter != eiter; ++iter)
-            AddMSSAPHI(bb,*iter);
+            AddMSSAPHI(fs,bb,*iter);
     }
-    inline void AddLoadMU(const SVFBasicBlock* bb, const LoadStmt* load, const MemRegion* mr)
+    inline void AddLoadMU(FunBuildState& fs, const SVFBasicBlock* bb, const LoadStmt* load, const MemRegion* mr)
     {
         LOADMU* mu = new LOADMU(bb,load, mr);
-        load2MuSetMap[load].insert(mu);
-        collectRegUses(mr);
+        fs.load2MuSetMap[load].insert(mu);
+        collectRegUses(fs,mr);
     }
-    inline void AddStoreCHI(const SVFBasicBlock* bb, const StoreStmt* store, const MemRegion* mr)
+    inline void AddStoreCHI(FunBuildState& fs, const SVFBasicBlock* bb, const StoreStmt* store, const MemRegion* mr)
     {
         STORECHI* chi = new STORECHI(bb,store, mr);
-        store2ChiSetMap[store].insert(chi);
-        collectRegUses(mr);
-        collectRegDefs(bb,mr);
+        fs.store2ChiSetMap[store].insert(chi);
+        collectRegUses(fs,mr);
+        collectRegDefs(fs,bb,mr);
     }
-    inline void AddCallSiteMU(const CallICFGNode* cs, const MemRegion* mr)
+    inline void AddCallSiteMU(FunBuildState& fs, const CallICFGNode* cs, const MemRegion* mr)
     {
         CALLMU* mu = new CALLMU(cs, mr);
-        callsiteToMuSetMap[cs].insert(mu);
-        collectRegUses(mr);
+        fs.callsiteToMuSetMap[cs].insert(mu);
+        collectRegUses(fs,mr);
     }
-    inline void AddCallSiteCHI(const CallICFGNode* cs, const MemRegion* mr)
+    inline void AddCallSiteCHI(FunBuildState& fs, const CallICFGNode* cs, const MemRegion* mr)
     {
         CALLCHI* chi = new CALLCHI(cs, mr);
-        callsiteToChiSetMap[cs].insert(chi);
-        collectRegUses(mr);
-        collectRegDefs(chi->getBasicBlock(),mr);
+        fs.callsiteToChiSetMap[cs].insert(chi);
+        collectRegUses(fs,mr);
+        collectRegDefs(fs,chi->getBasicBlock(),mr);
     }
-    inline void AddMSSAPHI(const SVFBasicBlock* bb, const MemRegion* mr)
+    inline void AddMSSAPHI(FunBuildState& fs, const SVFBasicBlock* bb, const MemRegion* mr)
     {
-        bb2PhiSetMap[bb].insert(new PHI(bb, mr));
+        fs.bb2PhiSetMap[bb].insert(new PHI(bb, mr));
     }
     //@}
 
     /// Rename mus, chis and phis
     //@{
     /// Rename mu set
-    inline void RenameMuSet(const MUSet& muSet)
+    inline void RenameMuSet(FunBuildState& fs, const MUSet& muSet)
     {
         for (MUSet::const_iterator mit = muSet.begin(), emit = muSet.end();
                 mit != emit; ++mit)
         {
             MU* mu = (*mit);
-            mu->setVer(getTopStackVer(mu->getMR()));
+            mu->setVer(getTopStackVer(fs, mu->getMR()));
         }
     }
 
     /// Rename chi set
-    inline void RenameChiSet(const CHISet& chiSet, MRVector& memRegs)
+    inline void RenameChiSet(FunBuildState& fs, const CHISet& chiSet, MRVector& memRegs)
     {
         for (CHISet::const_iterator cit = chiSet.begin(), ecit = chiSet.end();
                 cit != ecit; ++cit)
         {
             CHI* chi = (*cit);
-            chi->setOpVer(getTopStackVer(chi->getMR()));
-            chi->setResVer(newSSAName(chi->getMR(),chi));
+            chi->setOpVer(getTopStackVer(fs, chi->getMR()));
+            chi->setResVer(newSSAName(fs, chi->getMR(),chi));
             memRegs.push_back(chi->getMR());
         }
     }
 
     /// Rename result (LHS) of phis
-    inline void RenamePhiRes(const PHISet& phiSet, MRVector& memRegs)
+    inline void RenamePhiRes(FunBuildState& fs, const PHISet& phiSet, MRVector& memRegs)
     {
         for (PHISet::const_iterator iter = phiSet.begin(), eiter = phiSet.end();
                 iter != eiter; ++iter)
         {
             PHI* phi = *iter;
-            phi->setResVer(newSSAName(phi->getMR(),phi));
+            phi->setResVer(newSSAName(fs, phi->getMR(),phi));
             memRegs.push_back(phi->getMR());
         }
     }
 
     /// Rename operands (RHS) of phis
-    inline void RenamePhiOps(const PHISet& phiSet, u32_t pos, MRVector&)
+    inline void RenamePhiOps(FunBuildState& fs, const PHISet& phiSet, u32_t pos, MRVector&)
     {
         for (PHISet::const_iterator iter = phiSet.begin(), eiter = phiSet.end();
                 iter != eiter; ++iter)
         {
             PHI* phi = *iter;
-            phi->setOpVer(getTopStackVer(phi->getMR()), pos);
+            phi->setOpVer(getTopStackVer(fs, phi->getMR()), pos);
         }
     }
     //@}
@@ -318,6 +350,9 @@ public:
     }
     /// We start from here
     virtual void buildMemSSA(const FunObjVar& fun);
+    /// Build memory SSA for all of funs, in parallel with -mssa-threads.
+    /// Results, including MRVer IDs, are those of building them in order.
+    virtual void buildMemSSA(const std::vector<const FunObjVar*>& funs);
 
     /// Perform statistics
     void performStat();
@@ -73,6 +73,12 @@ public:
     /// Restrict the solve to the graph's nodes (whole: no restriction).
     void processNode(NodeID nodeId) override;
 
+    /// Solve sequentially: the parallel solver does not go through processNode.
+    u32_t getNumOfSolveThreads() const override
+    {
+        return 1;
+    }
+
     inline MHP* getMHP() const
     {
         return mhp;
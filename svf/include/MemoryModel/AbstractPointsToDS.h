@@ -38,6 +38,8 @@
 ///                                                ^
 ///                                                |
 ///                                        MutableIncDFPTData
+///
+/// CompactDFPTData (CompactPointsToDS.h) is another DFPTData.
 
 
 /*
@@ -53,6 +55,8 @@
 #ifndef ABSTRACT_POINTSTO_H_
 #define ABSTRACT_POINTSTO_H_
 
+#include <functional>
+
 namespace SVF
 {
 /// Basic points-to data structure
@@ -89,6 +93,7 @@ public:
         PersDataFlow,
         PersIncDataFlow,
         PersVersioned,
+        CompactDataFlow,
     };
 
     PTData(bool reversePT = true, PTDataTy ty = PTDataTy::Base) : rev(reversePT), ptdTy(ty) { }
@@ -134,6 +139,11 @@ public:
     /// dealing with non-GC persistent PT).
     virtual Map<DataSet, unsigned> getAllPts(bool liveOnly) const = 0;
 
+    /// Calls visitor on every points-to set stored, with the variable it is
+    /// stored for. Sets a variable holds at several locations or versions
+    /// are visited once for each.
+    virtual void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const = 0;
+
 protected:
     /// Whether we maintain reverse points-to sets or not.
     bool rev;
@@ -169,6 +179,12 @@ public:
     /// Clear propagated points-to set of var.
     virtual void clearPropaPts(Key& var) = 0;
 
+    /// Get/set propagated points-to set of var (e.g., to checkpoint a solver).
+    //@{
+    virtual const DataSet& getPropaPts(Key& var) = 0;
+    virtual void setPropaPts(Key& var, const DataSet& propa) = 0;
+    //@}
+
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
     static inline bool classof(const DiffPTData<Key, KeySet, Data, DataSet> *)
@@ -236,6 +252,25 @@ public:
 
     virtual void clearAllDFOutUpdatedVar(LocID) = 0;
 
+    /// Create the (empty) IN and/or OUT sets of loc, so that updating them
+    /// later does not insert into the maps shared by all locations.
+    virtual void initDFSets(LocID loc, bool in, bool out) = 0;
+
+    /// Make the IN sets of loc those of srcLoc (its OUT sets if srcOut) rather
+    /// than copies of them. Returns false, doing nothing, when unsupported.
+    virtual bool forwardDFIn(LocID, LocID, bool)
+    {
+        return false;
+    }
+
+    /// Estimate the bytes of the IN/OUT sets as stored (storedBytes) and as a
+    /// MutableDFPTData would store them (mutableBytes), setBytes giving the
+    /// bytes of the data structure of a set. Returns false when unsupported.
+    virtual bool estimateDFBytes(const std::function<u64_t(const DataSet&)>&, u64_t&, u64_t&) const
+    {
+        return false;
+    }
+
     /// Update points-to set of top-level pointers with IN[srcLoc:srcVar].
     virtual bool updateTLVPts(LocID srcLoc, const Key& srcVar, const Key& dstVar) = 0;
     /// Update address-taken variables OUT[dstLoc:dstVar] with points-to of top-level pointers
@@ -255,7 +290,8 @@ public:
                || ptd->getPTDTY() == BasePTData::MutDataFlow
                || ptd->getPTDTY() == BasePTData::MutIncDataFlow
                || ptd->getPTDTY() == BasePTData::PersDataFlow
-               || ptd->getPTDTY() == BasePTData::PersIncDataFlow;
+               || ptd->getPTDTY() == BasePTData::PersIncDataFlow
+               || ptd->getPTDTY() == BasePTData::CompactDataFlow;
     }
     ///@}
 };
@@ -0,0 +1,495 @@
+//===- CompactPointsToDS.h -- Compact data-flow points-to data structure---//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013->  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/// DFPTData (AbstractPointsToDS.h) implementation storing the IN/OUT sets of
+/// each location in a vector sorted by variable rather than in a map per
+/// location, selected by -compact-df.
+
+/*
+ * CompactPointsToDS.h
+ *
+ * Every IN/OUT points-to set lives in one deque; a location holds pairs of
+ * variable and index into it. Reading a set which was never written does not
+ * create it, and the IN sets of locations which only forward the sets of a
+ * single predecessor are not stored at all (see forwardDFIn).
+ */
+
+#ifndef COMPACT_POINTSTO_H_
+#define COMPACT_POINTSTO_H_
+
+#include <algorithm>
+#include <deque>
+
+#include "MemoryModel/MutablePointsToDS.h"
+
+namespace SVF
+{
+
+/// DFPTData with the IN/OUT sets of each location in a sorted vector.
+/// Top-level pointers are kept as in MutableDFPTData.
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
+class CompactDFPTData : public DFPTData<Key, KeySet, Data, DataSet>
+{
+public:
+    typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
+    typedef DFPTData<Key, KeySet, Data, DataSet> BaseDFPTData;
+    typedef typename BasePTData::PTDataTy PTDataTy;
+    typedef DataSetOps<DataSet, BitVectorTy> Ops;
+
+    typedef typename BaseDFPTData::LocID LocID;
+    /// Variables of a location, sorted, with the index of their set.
+    typedef std::vector<std::pair<Key, u32_t>> LocSets;
+
+    /// Constructor
+    CompactDFPTData(bool reversePT = true, PTDataTy ty = BaseDFPTData::CompactDataFlow)
+        : BaseDFPTData(reversePT, ty), mutPTData(reversePT), numOfForwardedLocs(0) { }
+
+    virtual ~CompactDFPTData() { }
+
+    virtual inline void clear() override
+    {
+        mutPTData.clear();
+        inSets.clear();
+        outSets.clear();
+        forwards.clear();
+        seenCounts.clear();
+        sets.clear();
+        numOfForwardedLocs = 0;
+    }
+
+    virtual inline const DataSet& getPts(const Key& var) override
+    {
+        return mutPTData.getPts(var);
+    }
+
+    virtual inline const KeySet& getRevPts(const Data& datum) override
+    {
+        assert(this->rev && "CompactDFPTData::getRevPts: constructed without reverse PT support!");
+        return mutPTData.getRevPts(datum);
+    }
+
+    virtual inline bool hasDFInSet(LocID loc) const override
+    {
+        return isForwarded(loc) || (loc < inSets.size() && !inSets[loc].empty());
+    }
+
+    virtual inline bool hasDFOutSet(LocID loc) const override
+    {
+        return loc < outSets.size() && !outSets[loc].empty();
+    }
+
+    virtual inline bool hasDFInSet(LocID loc, const Key& var) const override
+    {
+        bool out = false;
+        while (!out && isForwarded(loc))
+        {
+            out = forwards[loc].second;
+            loc = forwards[loc].first;
+        }
+
+        return findSet(loc, out, var) != nullptr;
+    }
+
+    virtual inline bool hasDFOutSet(LocID loc, const Key& var) const override
+    {
+        return findSet(loc, true, var) != nullptr;
+    }
+
+    virtual inline const DataSet& getDFInPtsSet(LocID loc, const Key& var) override
+    {
+        return readSet(loc, false, var);
+    }
+
+    virtual inline const DataSet& getDFOutPtsSet(LocID loc, const Key& var) override
+    {
+        return readSet(loc, true, var);
+    }
+
+    virtual inline bool updateDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) override
+    {
+        return updateDFIn(dstLoc, dstVar, readSet(srcLoc, false, srcVar));
+    }
+
+    virtual inline bool updateAllDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) override
+    {
+        return updateDFInFromIn(srcLoc, srcVar, dstLoc, dstVar);
+    }
+
+    virtual inline bool updateDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) override
+    {
+        return updateDFIn(dstLoc, dstVar, readSet(srcLoc, true, srcVar));
+    }
+
+    virtual inline bool updateAllDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) override
+    {
+        return updateDFInFromOut(srcLoc, srcVar, dstLoc, dstVar);
+    }
+
+    virtual inline bool updateDFOutFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) override
+    {
+        const DataSet &src = readSet(srcLoc, false, srcVar);
+        if (src.empty()) return false;
+        return Ops::unionWith(writeSet(dstLoc, true, dstVar), src);
+    }
+
+    virtual inline bool updateAllDFOutFromIn(LocID loc, const Key& singleton, bool strongUpdates) override
+    {
+        assert(!isForwarded(loc) && "CompactDFPTData::updateAllDFOutFromIn: IN of a store is forwarded!");
+        if (loc >= inSets.size()) return false;
+
+        bool changed = false;
+        // Index, as writing OUT may grow the vectors.
+        for (size_t i = 0; i < inSets[loc].size(); ++i)
+        {
+            const std::pair<Key, u32_t> vs = inSets[loc][i];
+            /// Enable strong updates if it is required to do so
+            if (strongUpdates && vs.first == singleton) continue;
+            if (sets[vs.second].empty()) continue;
+            if (Ops::unionWith(writeSet(loc, true, vs.first), sets[vs.second])) changed = true;
+        }
+
+        return changed;
+    }
+
+    virtual inline bool updateTLVPts(LocID srcLoc, const Key& srcVar, const Key& dstVar) override
+    {
+        return this->unionPts(dstVar, readSet(srcLoc, false, srcVar));
+    }
+
+    virtual inline bool updateATVPts(const Key& srcVar, LocID dstLoc, const Key& dstVar) override
+    {
+        return Ops::unionWith(writeSet(dstLoc, true, dstVar), getPts(srcVar));
+    }
+
+    virtual inline void clearAllDFOutUpdatedVar(LocID) override
+    {
+    }
+
+    virtual inline void initDFSets(LocID loc, bool in, bool out) override
+    {
+        if (in && inSets.size() <= loc) inSets.resize(loc + 1);
+        if (out && outSets.size() <= loc) outSets.resize(loc + 1);
+    }
+
+    /// The IN set of every variable at loc is that of srcLoc, its OUT set if
+    /// srcOut. loc must only get IN sets from srcLoc, and only those of the
+    /// variables it propagates. As loc does not know when the sets of srcLoc
+    /// change, propagating into loc reports a change when the set propagated
+    /// is larger than the one last propagated for that variable.
+    virtual inline bool forwardDFIn(LocID loc, LocID srcLoc, bool srcOut) override
+    {
+        assert(loc != srcLoc && "CompactDFPTData::forwardDFIn: forwarding to itself!");
+        assert((loc >= inSets.size() || inSets[loc].empty()) && "CompactDFPTData::forwardDFIn: IN already written!");
+        if (forwards.size() <= loc) forwards.resize(loc + 1, std::make_pair(NotForwarded, false));
+        if (!isForwarded(loc)) ++numOfForwardedLocs;
+        forwards[loc] = std::make_pair(srcLoc, srcOut);
+        if (seenCounts.size() <= loc) seenCounts.resize(loc + 1);
+        return true;
+    }
+
+    /// Number of locations whose IN sets are forwarded.
+    inline u32_t getNumOfForwardedLocs() const
+    {
+        return numOfForwardedLocs;
+    }
+
+    /// Number of IN/OUT sets stored.
+    inline u32_t getNumOfDFSets() const
+    {
+        return sets.size();
+    }
+
+    /// Stored: the sets, the sorted (variable, set) vectors, and the forwards.
+    /// Mutable: a map entry and a set per (location, variable), forwarded IN
+    /// sets being copies of all the sets of their source.
+    virtual bool estimateDFBytes(const std::function<u64_t(const DataSet&)>& setBytes,
+                                 u64_t& storedBytes, u64_t& mutableBytes) const override
+    {
+        const u64_t entryBytes = MapNodeBytes + sizeof(Key) + sizeof(DataSet);
+        const u64_t locBytes = MapNodeBytes + sizeof(LocID) + sizeof(Map<Key, DataSet>);
+
+        storedBytes = (inSets.capacity() + outSets.capacity() + seenCounts.capacity()) * sizeof(LocSets)
+                      + forwards.capacity() * sizeof(std::pair<LocID, bool>);
+        for (const LocSets &ls : seenCounts) storedBytes += ls.capacity() * sizeof(std::pair<Key, u32_t>);
+        mutableBytes = 0;
+        for (const std::vector<LocSets> *locSets : { &inSets, &outSets })
+        {
+            for (const LocSets &ls : *locSets)
+            {
+                storedBytes += ls.capacity() * sizeof(std::pair<Key, u32_t>);
+                if (ls.empty()) continue;
+                mutableBytes += locBytes;
+                for (const std::pair<Key, u32_t> &vs : ls) mutableBytes += entryBytes + setBytes(sets[vs.second]);
+            }
+        }
+        for (const DataSet &pts : sets) storedBytes += sizeof(DataSet) + setBytes(pts);
+
+        for (LocID loc = 0; loc < forwards.size(); ++loc)
+        {
+            if (!isForwarded(loc)) continue;
+            LocID src = loc;
+            bool out = false;
+            while (!out && isForwarded(src))
+            {
+                out = forwards[src].second;
+                src = forwards[src].first;
+            }
+
+            const std::vector<LocSets> &locSets = out ? outSets : inSets;
+            if (src >= locSets.size() || locSets[src].empty()) continue;
+            mutableBytes += locBytes;
+            for (const std::pair<Key, u32_t> &vs : locSets[src]) mutableBytes += entryBytes + setBytes(sets[vs.second]);
+        }
+
+        return true;
+    }
+
+    /// Override the methods defined in PTData.
+    /// Union/add points-to without adding reverse points-to, used internally
+    ///@{
+    virtual inline bool addPts(const Key &dstKey, const Key& srcKey) override
+    {
+        return Ops::testAndSet(lookupOrInsert(mutPTData.ptsMap, dstKey), srcKey);
+    }
+    virtual inline bool unionPts(const Key& dstKey, const Key& srcKey) override
+    {
+        return Ops::unionWith(lookupOrInsert(mutPTData.ptsMap, dstKey), getPts(srcKey));
+    }
+    virtual inline bool unionPts(const Key& dstKey, const DataSet& srcDataSet) override
+    {
+        return Ops::unionWith(lookupOrInsert(mutPTData.ptsMap, dstKey), srcDataSet);
+    }
+    virtual void clearPts(const Key& var, const Data& element) override
+    {
+        mutPTData.clearPts(var, element);
+    }
+    virtual void clearFullPts(const Key& var) override
+    {
+        mutPTData.clearFullPts(var);
+    }
+    virtual void remapAllPts(void) override
+    {
+        mutPTData.remapAllPts();
+        for (DataSet &pts : sets) pts.checkAndRemap();
+    }
+    ///@}
+
+    virtual inline Map<DataSet, unsigned> getAllPts(bool liveOnly) const override
+    {
+        Map<DataSet, unsigned> allPts = mutPTData.getAllPts(liveOnly);
+        for (const DataSet &pts : sets) ++allPts[pts];
+        return allPts;
+    }
+
+    virtual inline void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        mutPTData.visitPts(visitor);
+        for (const std::vector<LocSets> *locSets : { &inSets, &outSets })
+        {
+            for (const LocSets &ls : *locSets)
+            {
+                for (const std::pair<Key, u32_t> &vs : ls) visitor(vs.first, sets[vs.second]);
+            }
+        }
+    }
+
+    /// Methods to support type inquiry through isa, cast, and dyn_cast:
+    ///@{
+    static inline bool classof(const CompactDFPTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
+    {
+        return true;
+    }
+    static inline bool classof(const PTData<Key, KeySet, Data, DataSet>* ptd)
+    {
+        return ptd->getPTDTY() == BaseDFPTData::CompactDataFlow;
+    }
+    ///@}
+
+    /// Dump the DF IN/OUT set information for debugging purpose
+    ///@{
+    virtual inline void dumpPTData() override
+    {
+        /// dump points-to of top-level pointers
+        mutPTData.dumpPTData();
+        /// dump points-to of address-taken variables
+        std::fstream f("svfg_pts.data", std::ios_base::out);
+        if (!f.good())
+        {
+            SVFUtil::outs() << "  error opening file for writing!\n";
+            return;
+        }
+
+        const LocID numOfLocs = std::max(std::max(inSets.size(), outSets.size()), forwards.size());
+        for (LocID loc = 0; loc < numOfLocs; ++loc)
+        {
+            if (isForwarded(loc))
+            {
+                f << "Loc:" << loc << " IN:" << (forwards[loc].second ? "OUT" : "IN")
+                  << " of Loc:" << forwards[loc].first << "\n";
+            }
+            else if (hasDFInSet(loc))
+            {
+                f << "Loc:" << loc << " IN:{";
+                dumpPts(inSets[loc], f);
+                f << "}\n";
+            }
+
+            if (hasDFOutSet(loc))
+            {
+                f << "Loc:" << loc << " OUT:{";
+                dumpPts(outSets[loc], f);
+                f << "}\n";
+            }
+        }
+
+        f.close();
+        SVFUtil::outs() << "\n";
+    }
+    ///@}
+
+private:
+    static constexpr LocID NotForwarded = ~(LocID)0;
+    /// Overhead of a node of a Map (next pointer and cached hash).
+    static constexpr u64_t MapNodeBytes = 2 * sizeof(void *);
+
+    inline bool isForwarded(LocID loc) const
+    {
+        return loc < forwards.size() && forwards[loc].first != NotForwarded;
+    }
+
+    /// Returns the set of var at loc, or nullptr if it was never written.
+    inline const DataSet *findSet(LocID loc, bool out, const Key& var) const
+    {
+        const std::vector<LocSets> &locSets = out ? outSets : inSets;
+        if (loc >= locSets.size()) return nullptr;
+
+        const LocSets &ls = locSets[loc];
+        typename LocSets::const_iterator it = std::lower_bound(ls.begin(), ls.end(), var,
+                                              [](const std::pair<Key, u32_t> &vs, const Key &k)
+        {
+            return vs.first < k;
+        });
+        return it != ls.end() && it->first == var ? &sets[it->second] : nullptr;
+    }
+
+    /// Returns the set of var in IN (OUT if out) at loc, following forwarding.
+    inline const DataSet& readSet(LocID loc, bool out, const Key& var) const
+    {
+        // Chains of forwarding locations are short: calls, returns, and phis.
+        while (!out && isForwarded(loc))
+        {
+            out = forwards[loc].second;
+            loc = forwards[loc].first;
+        }
+
+        const DataSet *pts = findSet(loc, out, var);
+        return pts != nullptr ? *pts : emptySet;
+    }
+
+    /// Returns the set of var in IN (OUT if out) at loc, created if needed.
+    inline DataSet& writeSet(LocID loc, bool out, const Key& var)
+    {
+        std::vector<LocSets> &locSets = out ? outSets : inSets;
+        if (loc >= locSets.size()) locSets.resize(loc + 1);
+
+        LocSets &ls = locSets[loc];
+        typename LocSets::iterator it = std::lower_bound(ls.begin(), ls.end(), var,
+                                        [](const std::pair<Key, u32_t> &vs, const Key &k)
+        {
+            return vs.first < k;
+        });
+        if (it != ls.end() && it->first == var) return sets[it->second];
+
+        ls.insert(it, std::make_pair(var, (u32_t)sets.size()));
+        sets.emplace_back();
+        return sets.back();
+    }
+
+    /// IN[dstLoc:dstVar] = IN[dstLoc:dstVar] U src.
+    inline bool updateDFIn(LocID dstLoc, const Key& dstVar, const DataSet& src)
+    {
+        if (src.empty()) return false;
+        // Already holds src (see forwardDFIn); it changed if it grew since.
+        if (isForwarded(dstLoc))
+        {
+            LocSets &seen = seenCounts[dstLoc];
+            typename LocSets::iterator it = std::lower_bound(seen.begin(), seen.end(), dstVar,
+                                            [](const std::pair<Key, u32_t> &vc, const Key &k)
+            {
+                return vc.first < k;
+            });
+            const u32_t count = numOfElements(src);
+            if (it == seen.end() || it->first != dstVar)
+            {
+                seen.insert(it, std::make_pair(dstVar, count));
+                return true;
+            }
+            if (it->second >= count) return false;
+            it->second = count;
+            return true;
+        }
+
+        return Ops::unionWith(writeSet(dstLoc, false, dstVar), src);
+    }
+
+    /// Number of elements of a set; sets only grow, so it tells whether one changed.
+    static inline u32_t numOfElements(const PointsTo &pts)
+    {
+        return pts.count();
+    }
+    template<typename SetTy>
+    static inline u32_t numOfElements(const SetTy &s)
+    {
+        return s.size();
+    }
+
+    inline void dumpPts(const LocSets &ls, OutStream &O) const
+    {
+        for (const std::pair<Key, u32_t> &vs : ls)
+        {
+            const DataSet &pts = sets[vs.second];
+            if (pts.empty()) continue;
+            O << "<" << vs.first << ",{";
+            SVFUtil::dumpSet(pts, O);
+            O << "}> ";
+        }
+    }
+
+    /// IN and OUT sets, indexed by location.
+    std::vector<LocSets> inSets;
+    std::vector<LocSets> outSets;
+    /// forwards[loc] = (srcLoc, srcOut) when the IN sets of loc are those of srcLoc.
+    std::vector<std::pair<LocID, bool>> forwards;
+    /// seenCounts[loc] = (var, size) of the set last propagated into forwarded loc.
+    std::vector<LocSets> seenCounts;
+    /// All IN/OUT sets. A deque, so references stay valid as sets are added.
+    std::deque<DataSet> sets;
+    /// Returned for sets never written.
+    const DataSet emptySet;
+    /// Backing to implement the basic PTData methods which are not overridden.
+    MutablePTData<Key, KeySet, Data, DataSet, BitVectorTy> mutPTData;
+    u32_t numOfForwardedLocs;
+};
+
+} // End namespace SVF
+
+#endif  // COMPACT_POINTSTO_H_
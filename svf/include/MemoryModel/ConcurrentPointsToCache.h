@@ -0,0 +1,730 @@
+//===- ConcurrentPointsToCache.h -- Thread-safe persistent points-to sets ----//
+
+/*
+ * ConcurrentPointsToCache.h
+ *
+ * A PersistentPointsToCache which can be shared by several threads.
+ * The parallel VFS solver (VersionedFlowSensitiveParallel.cpp) hash-conses
+ * the updates its threads buffer in one.
+ */
+
+#ifndef CONCURRENT_POINTS_TO_H_
+#define CONCURRENT_POINTS_TO_H_
+
+#include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include <functional>
+
+#include "Util/GeneralType.h"
+#include "Util/SVFUtil.h"
+
+namespace SVF
+{
+
+/// Thread-safe variant of PersistentPointsToCache with the same interface and
+/// the same hash-consing (including the preemptive caching of results).
+///  - Interned points-to sets and the operation caches are split into shards,
+///    each guarded by its own mutex, so threads rarely wait on each other.
+///  - getActualPts takes no lock: IDs index a segmented table whose segments
+///    never move once allocated.
+///  - Threads doing many operations should each go through a FrontEnd, which
+///    answers repeated operations from a thread-local cache and merges the
+///    results it computed into the shared caches in batches.
+/// clear, reset, and remapAllPts must not run alongside other operations.
+template <typename Data>
+class ConcurrentPointsToCache
+{
+public:
+    typedef Map<Data, PointsToID> PTSToIDMap;
+    typedef std::function<Data(const Data &, const Data &)> DataOp;
+    typedef std::pair<PointsToID, PointsToID> OpKey;
+    typedef Map<OpKey, PointsToID> OpCache;
+
+    class FrontEnd;
+
+    static PointsToID emptyPointsToId(void)
+    {
+        return 0;
+    };
+
+private:
+    /// Operations with a cache.
+    enum OpKind
+    {
+        UnionOp,
+        ComplementOp,
+        IntersectionOp,
+        NumOps,
+    };
+
+    /// Operation statistics, as in PersistentPointsToCache.
+    enum OpStat
+    {
+        TotalStat,
+        PropertyStat,
+        UniqueStat,
+        LookupStat,
+        PreemptiveStat,
+        NumOpStats,
+    };
+
+    typedef u64_t OpStats[NumOps][NumOpStats];
+
+    /// Interned points-to sets and operation results whose hashes fall in
+    /// this shard. Aligned so shards do not share cache lines.
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        PTSToIDMap ptsToId;
+        OpCache opCaches[NumOps];
+        /// Times the mutex was taken, and how many of those had to wait.
+        /// Only updated while holding the mutex.
+        u64_t acquisitions = 0;
+        u64_t contended = 0;
+    };
+
+    /// log2 of the number of shards.
+    static constexpr u32_t ShardBits = 6;
+    static constexpr u32_t NumShards = 1 << ShardBits;
+
+    /// Segment i of the ID table holds FirstSegmentSize << i points-to sets, so
+    /// 32 - FirstSegmentBits segments cover every PointsToID.
+    static constexpr u32_t FirstSegmentBits = 10;
+    static constexpr u32_t FirstSegmentSize = 1 << FirstSegmentBits;
+    static constexpr u32_t NumSegments = 32 - FirstSegmentBits + 1;
+
+    typedef std::atomic<const Data *> Slot;
+
+public:
+    ConcurrentPointsToCache(void) : idCounter(1)
+    {
+        for (std::atomic<Slot *> &segment : segments) segment.store(nullptr, std::memory_order_relaxed);
+        initEmpty();
+        initStats();
+    }
+
+    ~ConcurrentPointsToCache(void)
+    {
+        freeAllPts();
+    }
+
+    ConcurrentPointsToCache(const ConcurrentPointsToCache &) = delete;
+    ConcurrentPointsToCache &operator=(const ConcurrentPointsToCache &) = delete;
+
+    /// Clear the cache.
+    void clear()
+    {
+        freeAllPts();
+        for (Shard &shard : shards)
+        {
+            shard.ptsToId.clear();
+            for (OpCache &opCache : shard.opCaches) opCache.clear();
+        }
+    }
+
+    /// Resets the cache removing everything except the emptyData it was initialised with.
+    void reset(void)
+    {
+        clear();
+        idCounter.store(1, std::memory_order_relaxed);
+        initEmpty();
+        initStats();
+    }
+
+    /// Remaps all points-to sets stored in the cache to the current mapping.
+    void remapAllPts(void)
+    {
+        for (Shard &shard : shards) shard.ptsToId.clear();
+
+        const PointsToID numIds = idCounter.load(std::memory_order_relaxed);
+        for (PointsToID id = 0; id < numIds; ++id)
+        {
+            Data *pts = const_cast<Data *>(slot(id).load(std::memory_order_relaxed));
+            pts->checkAndRemap();
+            ptsShard(*pts).ptsToId[*pts] = id;
+        }
+    }
+
+    /// If pts is not in the cache, inserts it, assigns an ID, and returns
+    /// that ID. If it is, then the ID is returned.
+    PointsToID emplacePts(const Data &pts)
+    {
+        Shard &shard = ptsShard(pts);
+        std::unique_lock<std::mutex> lock = lockShard(shard);
+
+        typename PTSToIDMap::const_iterator foundId = shard.ptsToId.find(pts);
+        if (foundId != shard.ptsToId.end()) return foundId->second;
+
+        const PointsToID id = newPointsToId();
+        storePts(id, new Data(pts));
+        shard.ptsToId.emplace(pts, id);
+        return id;
+    }
+
+    /// Returns the number of points-to sets stored, the empty set included.
+    PointsToID getNumOfPts(void) const
+    {
+        return idCounter.load(std::memory_order_acquire);
+    }
+
+    /// Returns the points-to set which id represents. id must be stored in the
+    /// cache. Lock-free.
+    const Data &getActualPts(PointsToID id) const
+    {
+        const Data *pts = slot(id).load(std::memory_order_acquire);
+        assert(pts != nullptr && "CPTC::getActualPts: points-to set not stored!");
+        return *pts;
+    }
+
+    /// Unions lhs and rhs and returns their union's ID.
+    PointsToID unionPts(PointsToID lhs, PointsToID rhs)
+    {
+        OpStats stats = {};
+        const PointsToID result = unionPts(lhs, rhs, stats, nullptr);
+        mergeStats(stats);
+        return result;
+    }
+
+    /// Relatively complements lhs and rhs (lhs \ rhs) and returns it's ID.
+    PointsToID complementPts(PointsToID lhs, PointsToID rhs)
+    {
+        OpStats stats = {};
+        const PointsToID result = complementPts(lhs, rhs, stats, nullptr);
+        mergeStats(stats);
+        return result;
+    }
+
+    /// Intersects lhs and rhs (lhs AND rhs) and returns the intersection's ID.
+    PointsToID intersectPts(PointsToID lhs, PointsToID rhs)
+    {
+        OpStats stats = {};
+        const PointsToID result = intersectPts(lhs, rhs, stats, nullptr);
+        mergeStats(stats);
+        return result;
+    }
+
+    /// Print statistics on operations, points-to set numbers, and contention.
+    void printStats(const std::string subtitle) const
+    {
+        static const unsigned fieldWidth = 25;
+        static const char *opNames[NumOps] = { "Unions", "Complements", "Intersections" };
+        static const char *statNames[NumOpStats] = { "Total", "Property", "Unique", "Lookup", "Preemptive" };
+        SVFUtil::outs().flags(std::ios::left);
+
+        SVFUtil::outs() << std::setw(fieldWidth) << "UniquePointsToSets" << idCounter.load() << "\n";
+
+        for (u32_t op = 0; op < NumOps; ++op)
+        {
+            for (u32_t stat = 0; stat < NumOpStats; ++stat)
+            {
+                const std::string name = std::string(statNames[stat]) + opNames[op];
+                SVFUtil::outs() << std::setw(fieldWidth) << name << opStats[op][stat].load() << "\n";
+            }
+        }
+
+        u64_t acquisitions = 0;
+        u64_t contended = 0;
+        u64_t maxContended = 0;
+        for (const Shard &shard : shards)
+        {
+            acquisitions += shard.acquisitions;
+            contended += shard.contended;
+            maxContended = std::max(maxContended, shard.contended);
+        }
+
+        const double contentionRate = acquisitions == 0 ? 0.0 : (double)contended / acquisitions;
+        SVFUtil::outs() << std::setw(fieldWidth) << "Shards"                  << NumShards               << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "ShardLocks"              << acquisitions            << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "ContendedShardLocks"     << contended               << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "MaxContendedPerShard"    << maxContended            << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "ContentionRate"          << contentionRate          << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "FrontEndHits"            << frontEndHits.load()     << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "FrontEndMerged"          << frontEndMerged.load()   << "\n";
+
+        SVFUtil::outs().flush();
+    }
+
+    /// Returns all points-to sets stored by this cache as keys to a map.
+    /// Values are all 1, as in PersistentPointsToCache::getAllPts.
+    Map<Data, unsigned> getAllPts(void)
+    {
+        Map<Data, unsigned> allPts;
+        const PointsToID numIds = idCounter.load(std::memory_order_acquire);
+        for (PointsToID id = 0; id < numIds; ++id) allPts[getActualPts(id)] = 1;
+        return allPts;
+    }
+
+    /// Per-thread front-end to a ConcurrentPointsToCache. Operations are first
+    /// looked up in a thread-local cache, then in the shared cache. Results
+    /// this thread computes are merged into the shared caches in batches, on
+    /// flush, or when the front-end is destroyed. Not thread-safe itself: use
+    /// one per thread.
+    class FrontEnd
+    {
+        friend class ConcurrentPointsToCache;
+
+    public:
+        explicit FrontEnd(ConcurrentPointsToCache &cache) : cache(cache), numPending(0), hits(0)
+        {
+            for (u32_t op = 0; op < NumOps; ++op)
+                for (u32_t stat = 0; stat < NumOpStats; ++stat) stats[op][stat] = 0;
+        }
+
+        ~FrontEnd(void)
+        {
+            flush();
+        }
+
+        FrontEnd(const FrontEnd &) = delete;
+        FrontEnd &operator=(const FrontEnd &) = delete;
+
+        ConcurrentPointsToCache &getCache(void)
+        {
+            return cache;
+        }
+
+        PointsToID emplacePts(const Data &pts)
+        {
+            return cache.emplacePts(pts);
+        }
+
+        const Data &getActualPts(PointsToID id) const
+        {
+            return cache.getActualPts(id);
+        }
+
+        PointsToID unionPts(PointsToID lhs, PointsToID rhs)
+        {
+            return cache.unionPts(lhs, rhs, stats, this);
+        }
+
+        PointsToID complementPts(PointsToID lhs, PointsToID rhs)
+        {
+            return cache.complementPts(lhs, rhs, stats, this);
+        }
+
+        PointsToID intersectPts(PointsToID lhs, PointsToID rhs)
+        {
+            return cache.intersectPts(lhs, rhs, stats, this);
+        }
+
+        /// Merge pending results and statistics into the shared cache.
+        void flush(void)
+        {
+            cache.merge(*this);
+        }
+
+    private:
+        /// Pending results are merged after this many.
+        static constexpr u32_t FlushThreshold = 1024;
+        /// The thread-local caches are dropped once they hold this many results.
+        static constexpr size_t MaxLocalResults = 1 << 18;
+
+        bool lookup(OpKind op, const OpKey &key, PointsToID &result) const
+        {
+            typename OpCache::const_iterator found = local[op].find(key);
+            if (found == local[op].end()) return false;
+            result = found->second;
+            return true;
+        }
+
+        void remember(OpKind op, const OpKey &key, PointsToID result)
+        {
+            if (local[op].size() >= MaxLocalResults) local[op].clear();
+            local[op][key] = result;
+        }
+
+        void record(OpKind op, const OpKey &key, PointsToID result)
+        {
+            remember(op, key, result);
+            pending[op].push_back(std::make_pair(key, result));
+            if (++numPending >= FlushThreshold) flush();
+        }
+
+    private:
+        ConcurrentPointsToCache &cache;
+        /// Results seen by this thread.
+        OpCache local[NumOps];
+        /// Results computed by this thread not yet in the shared caches.
+        std::vector<std::pair<OpKey, PointsToID>> pending[NumOps];
+        u32_t numPending;
+        /// Statistics not yet merged into the shared cache.
+        OpStats stats;
+        u64_t hits;
+    };
+
+private:
+    void initEmpty(void)
+    {
+        storePts(emptyPointsToId(), new Data());
+        ptsShard(Data()).ptsToId[Data()] = emptyPointsToId();
+    }
+
+    PointsToID newPointsToId(void)
+    {
+        const PointsToID id = idCounter.fetch_add(1, std::memory_order_relaxed);
+        // Make sure we don't overflow.
+        assert(id + 1 != emptyPointsToId() && "CPTC::newPointsToId: PointsToIDs exhausted! Try a larger type.");
+        return id;
+    }
+
+    /// Returns the segment and offset in it of id.
+    static inline void locate(PointsToID id, u32_t &segment, u32_t &offset)
+    {
+        const u64_t v = (u64_t)id + FirstSegmentSize;
+        segment = (63 - __builtin_clzll(v)) - FirstSegmentBits;
+        offset = (u32_t)(v - ((u64_t)FirstSegmentSize << segment));
+    }
+
+    /// Returns the slot of id, which must have been stored.
+    const Slot &slot(PointsToID id) const
+    {
+        u32_t segment, offset;
+        locate(id, segment, offset);
+        const Slot *s = segments[segment].load(std::memory_order_acquire);
+        assert(s != nullptr && "CPTC::slot: points-to set not stored!");
+        return s[offset];
+    }
+
+    Slot &slot(PointsToID id)
+    {
+        return const_cast<Slot &>(static_cast<const ConcurrentPointsToCache *>(this)->slot(id));
+    }
+
+    /// Stores pts as the points-to set of id, allocating its segment if needed.
+    void storePts(PointsToID id, const Data *pts)
+    {
+        u32_t segment, offset;
+        locate(id, segment, offset);
+        Slot *s = segments[segment].load(std::memory_order_acquire);
+        if (s == nullptr)
+        {
+            Slot *fresh = new Slot[(size_t)FirstSegmentSize << segment]();
+            if (segments[segment].compare_exchange_strong(s, fresh, std::memory_order_acq_rel)) s = fresh;
+            else delete[] fresh;
+        }
+
+        s[offset].store(pts, std::memory_order_release);
+    }
+
+    void freeAllPts(void)
+    {
+        for (u32_t segment = 0; segment < NumSegments; ++segment)
+        {
+            Slot *s = segments[segment].exchange(nullptr, std::memory_order_acq_rel);
+            if (s == nullptr) continue;
+            const size_t size = (size_t)FirstSegmentSize << segment;
+            for (size_t i = 0; i < size; ++i) delete s[i].load(std::memory_order_relaxed);
+            delete[] s;
+        }
+    }
+
+    /// Spreads a hash over the shards.
+    static inline u32_t shardIndex(size_t hash)
+    {
+        return (u32_t)(((u64_t)hash * 0x9E3779B97F4A7C15ULL) >> (64 - ShardBits));
+    }
+
+    Shard &ptsShard(const Data &pts)
+    {
+        return shards[shardIndex(Hash<Data>()(pts))];
+    }
+
+    Shard &opShard(const OpKey &key)
+    {
+        return shards[shardIndex(Hash<OpKey>()(key))];
+    }
+
+    /// Locks shard, counting the acquisition and whether it had to wait.
+    std::unique_lock<std::mutex> lockShard(Shard &shard)
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            lock.lock();
+            ++shard.contended;
+        }
+
+        ++shard.acquisitions;
+        return lock;
+    }
+
+    /// Finds the result of op on key in frontEnd's or the shared cache.
+    bool lookupOp(OpKind op, const OpKey &key, PointsToID &result, FrontEnd *frontEnd)
+    {
+        if (frontEnd != nullptr && frontEnd->lookup(op, key, result))
+        {
+            ++frontEnd->hits;
+            return true;
+        }
+
+        Shard &shard = opShard(key);
+        {
+            std::unique_lock<std::mutex> lock = lockShard(shard);
+            typename OpCache::const_iterator found = shard.opCaches[op].find(key);
+            if (found == shard.opCaches[op].end()) return false;
+            result = found->second;
+        }
+
+        if (frontEnd != nullptr) frontEnd->remember(op, key, result);
+        return true;
+    }
+
+    /// Caches the result of op on key, through frontEnd if there is one.
+    void cacheOp(OpKind op, const OpKey &key, PointsToID result, FrontEnd *frontEnd)
+    {
+        if (frontEnd != nullptr)
+        {
+            frontEnd->record(op, key, result);
+            return;
+        }
+
+        Shard &shard = opShard(key);
+        std::unique_lock<std::mutex> lock = lockShard(shard);
+        shard.opCaches[op][key] = result;
+    }
+
+    /// Merges frontEnd's pending results and statistics, locking each shard once.
+    void merge(FrontEnd &frontEnd)
+    {
+        // (shard, operation, key, result), sorted by shard.
+        typedef std::pair<std::pair<u32_t, u32_t>, std::pair<OpKey, PointsToID>> ShardResult;
+        std::vector<ShardResult> byShard;
+        byShard.reserve(frontEnd.numPending);
+        for (u32_t op = 0; op < NumOps; ++op)
+        {
+            for (const std::pair<OpKey, PointsToID> &result : frontEnd.pending[op])
+            {
+                const u32_t s = shardIndex(Hash<OpKey>()(result.first));
+                byShard.push_back(std::make_pair(std::make_pair(s, op), result));
+            }
+
+            frontEnd.pending[op].clear();
+        }
+
+        std::sort(byShard.begin(), byShard.end(), [](const ShardResult &a, const ShardResult &b)
+        {
+            return a.first < b.first;
+        });
+
+        std::unique_lock<std::mutex> lock;
+        u32_t lockedShard = NumShards;
+        for (const ShardResult &result : byShard)
+        {
+            const u32_t s = result.first.first;
+            if (s != lockedShard)
+            {
+                if (lock.owns_lock()) lock.unlock();
+                lock = lockShard(shards[s]);
+                lockedShard = s;
+            }
+
+            shards[s].opCaches[result.first.second][result.second.first] = result.second.second;
+        }
+
+        if (lock.owns_lock()) lock.unlock();
+
+        frontEnd.numPending = 0;
+        mergeStats(frontEnd.stats);
+        for (u32_t op = 0; op < NumOps; ++op)
+            for (u32_t stat = 0; stat < NumOpStats; ++stat) frontEnd.stats[op][stat] = 0;
+        if (frontEnd.hits != 0) frontEndHits.fetch_add(frontEnd.hits, std::memory_order_relaxed);
+        frontEnd.hits = 0;
+        if (!byShard.empty()) frontEndMerged.fetch_add(byShard.size(), std::memory_order_relaxed);
+    }
+
+    PointsToID unionPts(PointsToID lhs, PointsToID rhs, OpStats &stats, FrontEnd *frontEnd)
+    {
+        static const DataOp unionOp = [](const Data &lhs, const Data &rhs)
+        {
+            return lhs | rhs;
+        };
+
+        ++stats[UnionOp][TotalStat];
+
+        // Order operands so we don't perform x U y and y U x separately.
+        const OpKey operands = std::minmax(lhs, rhs);
+
+        // EMPTY_SET U x, and x U x.
+        if (operands.first == emptyPointsToId() || operands.first == operands.second)
+        {
+            ++stats[UnionOp][PropertyStat];
+            return operands.second;
+        }
+
+        bool opPerformed = false;
+        const PointsToID result = opPts(UnionOp, operands, unionOp, opPerformed, frontEnd);
+
+        if (opPerformed)
+        {
+            ++stats[UnionOp][UniqueStat];
+
+            // if x U y = z, then x U z = z and y U z = z.
+            if (lhs != result) preempt(UnionOp, std::minmax(lhs, result), result, stats, frontEnd);
+            if (rhs != result) preempt(UnionOp, std::minmax(rhs, result), result, stats, frontEnd);
+        }
+        else ++stats[UnionOp][LookupStat];
+
+        return result;
+    }
+
+    PointsToID complementPts(PointsToID lhs, PointsToID rhs, OpStats &stats, FrontEnd *frontEnd)
+    {
+        static const DataOp complementOp = [](const Data &lhs, const Data &rhs)
+        {
+            return lhs - rhs;
+        };
+
+        ++stats[ComplementOp][TotalStat];
+
+        // x - x, EMPTY_SET - x, and x - EMPTY_SET.
+        if (lhs == rhs || lhs == emptyPointsToId())
+        {
+            ++stats[ComplementOp][PropertyStat];
+            return emptyPointsToId();
+        }
+
+        if (rhs == emptyPointsToId())
+        {
+            ++stats[ComplementOp][PropertyStat];
+            return lhs;
+        }
+
+        bool opPerformed = false;
+        const PointsToID result = opPts(ComplementOp, OpKey(lhs, rhs), complementOp, opPerformed, frontEnd);
+
+        if (opPerformed)
+        {
+            ++stats[ComplementOp][UniqueStat];
+
+            // We performed lhs - rhs = result, so result AND rhs = EMPTY_SET,
+            // result AND lhs = result, and result - rhs = result.
+            if (result != emptyPointsToId())
+            {
+                preempt(IntersectionOp, std::minmax(result, rhs), emptyPointsToId(), stats, frontEnd);
+                preempt(IntersectionOp, std::minmax(result, lhs), result, stats, frontEnd);
+                preempt(ComplementOp, OpKey(result, rhs), result, stats, frontEnd);
+            }
+        }
+        else ++stats[ComplementOp][LookupStat];
+
+        return result;
+    }
+
+    PointsToID intersectPts(PointsToID lhs, PointsToID rhs, OpStats &stats, FrontEnd *frontEnd)
+    {
+        static const DataOp intersectionOp = [](const Data &lhs, const Data &rhs)
+        {
+            return lhs & rhs;
+        };
+
+        ++stats[IntersectionOp][TotalStat];
+
+        const OpKey operands = std::minmax(lhs, rhs);
+
+        // EMPTY_SET & x, and x & x.
+        if (operands.first == emptyPointsToId() || operands.first == operands.second)
+        {
+            ++stats[IntersectionOp][PropertyStat];
+            return operands.first;
+        }
+
+        bool opPerformed = false;
+        const PointsToID result = opPts(IntersectionOp, operands, intersectionOp, opPerformed, frontEnd);
+
+        if (opPerformed)
+        {
+            ++stats[IntersectionOp][UniqueStat];
+
+            // We performed lhs AND rhs = result, so result AND rhs = result,
+            // result AND lhs = result, result U lhs = lhs, and result U rhs = rhs.
+            if (result != emptyPointsToId())
+            {
+                if (result != rhs)
+                {
+                    preempt(IntersectionOp, std::minmax(result, rhs), result, stats, frontEnd);
+                    preempt(UnionOp, std::minmax(rhs, result), rhs, stats, frontEnd);
+                }
+
+                if (result != lhs)
+                {
+                    preempt(IntersectionOp, std::minmax(result, lhs), result, stats, frontEnd);
+                    preempt(UnionOp, std::minmax(lhs, result), lhs, stats, frontEnd);
+                }
+            }
+        }
+        else ++stats[IntersectionOp][LookupStat];
+
+        return result;
+    }
+
+    /// Caches a result implied by an operation just performed.
+    void preempt(OpKind op, const OpKey &key, PointsToID result, OpStats &stats, FrontEnd *frontEnd)
+    {
+        cacheOp(op, key, result, frontEnd);
+        ++stats[op][PreemptiveStat];
+        ++stats[op][TotalStat];
+    }
+
+    /// Performs dataOp on the operands, checking the caches first and
+    /// updating them afterwards. The operation itself runs without locks;
+    /// threads racing on the same operands intern the same result.
+    inline PointsToID opPts(OpKind op, const OpKey &operands, const DataOp &dataOp, bool &opPerformed,
+                            FrontEnd *frontEnd)
+    {
+        PointsToID resultId;
+        if (lookupOp(op, operands, resultId, frontEnd)) return resultId;
+
+        opPerformed = true;
+        const Data result = dataOp(getActualPts(operands.first), getActualPts(operands.second));
+        resultId = emplacePts(result);
+        cacheOp(op, operands, resultId, frontEnd);
+        return resultId;
+    }
+
+    void mergeStats(const OpStats &stats)
+    {
+        for (u32_t op = 0; op < NumOps; ++op)
+        {
+            for (u32_t stat = 0; stat < NumOpStats; ++stat)
+            {
+                if (stats[op][stat] != 0) opStats[op][stat].fetch_add(stats[op][stat], std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Initialises statistics variables to 0.
+    inline void initStats(void)
+    {
+        for (u32_t op = 0; op < NumOps; ++op)
+            for (u32_t stat = 0; stat < NumOpStats; ++stat) opStats[op][stat].store(0, std::memory_order_relaxed);
+        for (Shard &shard : shards) shard.acquisitions = shard.contended = 0;
+        frontEndHits.store(0, std::memory_order_relaxed);
+        frontEndMerged.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    Shard shards[NumShards];
+
+    /// Maps points-to IDs to their points-to sets. Segments are allocated on
+    /// demand and never move, so reading needs no lock.
+    std::atomic<Slot *> segments[NumSegments];
+
+    /// Used to generate new PointsToIDs. Any non-zero is valid.
+    std::atomic<PointsToID> idCounter;
+
+    // Statistics:
+    std::atomic<u64_t> opStats[NumOps][NumOpStats];
+    /// Operations answered by a front-end's thread-local cache.
+    std::atomic<u64_t> frontEndHits;
+    /// Results merged into the shared caches by front-ends.
+    std::atomic<u64_t> frontEndMerged;
+};
+
+} // End namespace SVF
+
+#endif /* CONCURRENT_POINTS_TO_H_ */
@@ -44,17 +44,34 @@
 namespace SVF
 {
 
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
 class MutableDFPTData;
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy>
+class CompactDFPTData;
+
+/// Returns map[key], looking key up before inserting it. Unlike operator[],
+/// does not write to map when key is present, so threads may call it on a
+/// map whose keys were all inserted beforehand (see FlowSensitive::solveInParallel).
+template <typename MapTy>
+inline typename MapTy::mapped_type& lookupOrInsert(MapTy& map, const typename MapTy::key_type& key)
+{
+    typename MapTy::iterator it = map.find(key);
+    return it != map.end() ? it->second : map[key];
+}
 
 /// PTData implemented using points-to sets which are created once and updated continuously.
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+/// When DataSet is PointsTo, BitVectorTy, if not void, is the data structure backing every
+/// points-to set, so set operations need not dispatch on it (see DataSetOps). This holds
+/// for all the points-to data structures here and in PersistentPointsToDS.h.
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
 class MutablePTData : public PTData<Key, KeySet, Data, DataSet>
 {
-    friend class MutableDFPTData<Key, KeySet, Data, DataSet>;
+    friend class MutableDFPTData<Key, KeySet, Data, DataSet, BitVectorTy>;
+    friend class CompactDFPTData<Key, KeySet, Data, DataSet, BitVectorTy>;
 public:
     typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
+    typedef DataSetOps<DataSet, BitVectorTy> Ops;
 
     typedef Map<Key, DataSet> PtsMap;
     typedef Map<Data, KeySet> RevPtsMap;
@@ -81,7 +98,7 @@ public:
 
     virtual inline const DataSet& getPts(const Key& var) override
     {
-        return ptsMap[var];
+        return lookupOrInsert(ptsMap, var);
     }
 
     virtual inline const KeySet& getRevPts(const Data& datum) override
@@ -93,19 +110,19 @@ public:
     virtual inline bool addPts(const Key &dstKey, const Data& element) override
     {
         addSingleRevPts(revPtsMap[element], dstKey);
-        return addPts(ptsMap[dstKey], element);
+        return addPts(lookupOrInsert(ptsMap, dstKey), element);
     }
 
     virtual inline bool unionPts(const Key& dstKey, const Key& srcKey) override
     {
-        addRevPts(ptsMap[srcKey], dstKey);
-        return unionPts(ptsMap[dstKey], getPts(srcKey));
+        addRevPts(getPts(srcKey), dstKey);
+        return unionPts(lookupOrInsert(ptsMap, dstKey), getPts(srcKey));
     }
 
     virtual inline bool unionPts(const Key& dstKey, const DataSet& srcDataSet) override
     {
         addRevPts(srcDataSet,dstKey);
-        return unionPts(ptsMap[dstKey], srcDataSet);
+        return unionPts(lookupOrInsert(ptsMap, dstKey), srcDataSet);
     }
 
     virtual inline void dumpPTData() override
@@ -116,7 +133,7 @@ public:
     virtual void clearPts(const Key& var, const Data& element) override
     {
         clearSingleRevPts(revPtsMap[element], var);
-        ptsMap[var].reset(element);
+        Ops::reset(ptsMap[var], element);
     }
 
     virtual void clearFullPts(const Key& var) override
@@ -143,9 +160,14 @@ public:
         return allPts;
     }
 
+    virtual inline void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        for (const typename PtsMap::value_type &ppt : ptsMap) visitor(ppt.first, ppt.second);
+    }
+
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const MutablePTData<Key, KeySet, Data, DataSet> *)
+    static inline bool classof(const MutablePTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
     {
         return true;
     }
@@ -179,11 +201,11 @@ private:
     ///@{
     inline bool unionPts(DataSet& dstDataSet, const DataSet& srcDataSet)
     {
-        return dstDataSet |= srcDataSet;
+        return Ops::unionWith(dstDataSet, srcDataSet);
     }
     inline bool addPts(DataSet &d, const Data& e)
     {
-        return d.test_and_set(e);
+        return Ops::testAndSet(d, e);
     }
     inline void addSingleRevPts(KeySet &revData, const Key& tgr)
     {
@@ -222,15 +244,16 @@ protected:
 };
 
 /// DiffPTData implemented with points-to sets which are updated continuously.
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
 class MutableDiffPTData : public DiffPTData<Key, KeySet, Data, DataSet>
 {
 public:
     typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
     typedef DiffPTData<Key, KeySet, Data, DataSet> BaseDiffPTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
+    typedef DataSetOps<DataSet, BitVectorTy> Ops;
 
-    typedef typename MutablePTData<Key, KeySet, Data, DataSet>::PtsMap PtsMap;
+    typedef typename MutablePTData<Key, KeySet, Data, DataSet, BitVectorTy>::PtsMap PtsMap;
 
     /// Constructor
     explicit MutableDiffPTData(bool reversePT = true, PTDataTy ty = PTDataTy::Diff) : BaseDiffPTData(reversePT, ty), mutPTData(reversePT) { }
@@ -306,22 +329,32 @@ public:
         DataSet& diff = diffPtsMap[var];
         diff.clear();
         /// Get all pts.
-        DataSet& propa = getPropaPts(var);
-        diff.intersectWithComplement(all, propa);
+        DataSet& propa = propaPtsMap[var];
+        Ops::intersectWithComplement(diff, all, propa);
         propa = all;
         return !diff.empty();
     }
 
     virtual inline void updatePropaPtsMap(Key &src, Key &dst) override
     {
-        DataSet& srcPropa = getPropaPts(src);
-        DataSet& dstPropa = getPropaPts(dst);
-        dstPropa &= srcPropa;
+        DataSet& srcPropa = propaPtsMap[src];
+        DataSet& dstPropa = propaPtsMap[dst];
+        Ops::intersectWith(dstPropa, srcPropa);
     }
 
     virtual inline void clearPropaPts(Key &var) override
     {
-        getPropaPts(var).clear();
+        propaPtsMap[var].clear();
+    }
+
+    virtual inline const DataSet& getPropaPts(Key &var) override
+    {
+        return propaPtsMap[var];
+    }
+
+    virtual inline void setPropaPts(Key &var, const DataSet &propa) override
+    {
+        propaPtsMap[var] = propa;
     }
 
     virtual inline Map<DataSet, unsigned> getAllPts(bool liveOnly) const override
@@ -329,9 +362,16 @@ public:
         return mutPTData.getAllPts(liveOnly);
     }
 
+    virtual inline void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        mutPTData.visitPts(visitor);
+        for (const typename PtsMap::value_type &ppt : diffPtsMap) visitor(ppt.first, ppt.second);
+        for (const typename PtsMap::value_type &ppt : propaPtsMap) visitor(ppt.first, ppt.second);
+    }
+
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const MutableDiffPTData<Key, KeySet, Data, DataSet> *)
+    static inline bool classof(const MutableDiffPTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
     {
         return true;
     }
@@ -342,30 +382,24 @@ public:
     }
     ///@}
 
-protected:
-    /// Get propagated points to.
-    inline DataSet &getPropaPts(Key &var)
-    {
-        return propaPtsMap[var];
-    }
-
 private:
     /// Backing to implement the basic PTData methods. This allows us to avoid multiple-inheritance.
-    MutablePTData<Key, KeySet, Data, DataSet> mutPTData;
+    MutablePTData<Key, KeySet, Data, DataSet, BitVectorTy> mutPTData;
     /// Diff points-to to be propagated.
     PtsMap diffPtsMap;
     /// Points-to already propagated.
     PtsMap propaPtsMap;
 };
 
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy>
 class MutableDFPTData : public DFPTData<Key, KeySet, Data, DataSet>
 {
 public:
     typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
-    typedef MutablePTData<Key, KeySet, Data, DataSet> BaseMutPTData;
+    typedef MutablePTData<Key, KeySet, Data, DataSet, BitVectorTy> BaseMutPTData;
     typedef DFPTData<Key, KeySet, Data, DataSet> BaseDFPTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
+    typedef DataSetOps<DataSet, BitVectorTy> Ops;
 
     typedef typename BaseDFPTData::LocID LocID;
     typedef typename BaseMutPTData::PtsMap PtsMap;
@@ -430,13 +464,13 @@ public:
 
     virtual inline DataSet& getDFInPtsSet(LocID loc, const Key& var) override
     {
-        PtsMap& inSet = dfInPtsMap[loc];
+        PtsMap& inSet = lookupOrInsert(dfInPtsMap, loc);
         return inSet[var];
     }
 
     virtual inline DataSet& getDFOutPtsSet(LocID loc, const Key& var) override
     {
-        PtsMap& outSet = dfOutPtsMap[loc];
+        PtsMap& outSet = lookupOrInsert(dfOutPtsMap, loc);
         return outSet[var];
     }
 
@@ -444,11 +478,11 @@ public:
     ///@{
     inline const PtsMap& getDFInPtsMap(LocID loc)
     {
-        return dfInPtsMap[loc];
+        return lookupOrInsert(dfInPtsMap, loc);
     }
     inline const PtsMap& getDFOutPtsMap(LocID loc)
     {
-        return dfOutPtsMap[loc];
+        return lookupOrInsert(dfOutPtsMap, loc);
     }
     inline const DFPtsMap& getDFIn()
     {
@@ -519,20 +553,26 @@ public:
     {
     }
 
+    virtual inline void initDFSets(LocID loc, bool in, bool out) override
+    {
+        if (in) dfInPtsMap[loc];
+        if (out) dfOutPtsMap[loc];
+    }
+
     /// Override the methods defined in PTData.
     /// Union/add points-to without adding reverse points-to, used internally
     ///@{
     virtual inline bool addPts(const Key &dstKey, const Key& srcKey) override
     {
-        return addPts(mutPTData.ptsMap[dstKey], srcKey);
+        return addPts(lookupOrInsert(mutPTData.ptsMap, dstKey), srcKey);
     }
     virtual inline bool unionPts(const Key& dstKey, const Key& srcKey) override
     {
-        return unionPts(mutPTData.ptsMap[dstKey], getPts(srcKey));
+        return unionPts(lookupOrInsert(mutPTData.ptsMap, dstKey), getPts(srcKey));
     }
     virtual inline bool unionPts(const Key& dstKey, const DataSet& srcDataSet) override
     {
-        return unionPts(mutPTData.ptsMap[dstKey], srcDataSet);
+        return unionPts(lookupOrInsert(mutPTData.ptsMap, dstKey), srcDataSet);
     }
     virtual void clearPts(const Key& var, const Data& element) override
     {
@@ -579,9 +619,23 @@ public:
         return allPts;
     }
 
+    virtual inline void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        mutPTData.visitPts(visitor);
+        for (const typename DFPtsMap::value_type &lptsmap : dfInPtsMap)
+        {
+            for (const typename PtsMap::value_type &vpt : lptsmap.second) visitor(vpt.first, vpt.second);
+        }
+
+        for (const typename DFPtsMap::value_type &lptsmap : dfOutPtsMap)
+        {
+            for (const typename PtsMap::value_type &vpt : lptsmap.second) visitor(vpt.first, vpt.second);
+        }
+    }
+
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const MutableDFPTData<Key, KeySet, Data, DataSet> *)
+    static inline bool classof(const MutableDFPTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
     {
         return true;
     }
@@ -597,11 +651,11 @@ protected:
     ///@{
     inline bool unionPts(DataSet& dstDataSet, const DataSet& srcDataSet)
     {
-        return dstDataSet |= srcDataSet;
+        return Ops::unionWith(dstDataSet, srcDataSet);
     }
     inline bool addPts(DataSet &d, const Data& e)
     {
-        return d.test_and_set(e);
+        return Ops::testAndSet(d, e);
     }
     ///@}
 
@@ -673,18 +727,18 @@ protected:
     DFPtsMap dfOutPtsMap;
     /// Backing to implement the basic PTData methods which are not overridden.
     /// This allows us to avoid multiple-inheritance.
-    MutablePTData<Key, KeySet, Data, DataSet> mutPTData;
+    MutablePTData<Key, KeySet, Data, DataSet, BitVectorTy> mutPTData;
 };
 
 /// Incremental version of the mutable data-flow points-to data structure.
-template <typename Key, typename KeySet, typename Data, typename DataSet>
-class MutableIncDFPTData : public MutableDFPTData<Key, KeySet, Data, DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
+class MutableIncDFPTData : public MutableDFPTData<Key, KeySet, Data, DataSet, BitVectorTy>
 {
 public:
     typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
-    typedef MutablePTData<Key, KeySet, Data, DataSet> BaseMutPTData;
+    typedef MutablePTData<Key, KeySet, Data, DataSet, BitVectorTy> BaseMutPTData;
     typedef DFPTData<Key, KeySet, Data, DataSet> BaseDFPTData;
-    typedef MutableDFPTData<Key, KeySet, Data, DataSet> BaseMutDFPTData;
+    typedef MutableDFPTData<Key, KeySet, Data, DataSet, BitVectorTy> BaseMutDFPTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
 
     typedef typename BaseDFPTData::LocID LocID;
@@ -812,9 +866,16 @@ public:
         }
     }
 
+    virtual inline void initDFSets(LocID loc, bool in, bool out) override
+    {
+        BaseMutDFPTData::initDFSets(loc, in, out);
+        if (in) inUpdatedVarMap[loc];
+        if (out) outUpdatedVarMap[loc];
+    }
+
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const MutableIncDFPTData<Key, KeySet, Data, DataSet> *)
+    static inline bool classof(const MutableIncDFPTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
     {
         return true;
     }
@@ -830,7 +891,7 @@ private:
     /// Add var into loc's IN updated set. Called when var's pts in loc's IN set changed
     inline void setVarDFInSetUpdated(LocID loc,const Key& var)
     {
-        inUpdatedVarMap[loc].set(var);
+        lookupOrInsert(inUpdatedVarMap, loc).set(var);
     }
     /// Remove var from loc's IN updated set
     inline void removeVarFromDFInUpdatedSet(LocID loc,const Key& var)
@@ -850,7 +911,7 @@ private:
     /// Get all var which have new pts information in loc's IN set
     inline const DataSet& getDFInUpdatedVar(LocID loc)
     {
-        return inUpdatedVarMap[loc];
+        return lookupOrInsert(inUpdatedVarMap, loc);
     }
     //@}
 
@@ -859,7 +920,7 @@ private:
     /// Add var into loc's OUT updated set. Called when var's pts in loc's OUT set changed
     inline void setVarDFOutSetUpdated(LocID loc,const Key& var)
     {
-        outUpdatedVarMap[loc].set(var);
+        lookupOrInsert(outUpdatedVarMap, loc).set(var);
     }
     /// Remove var from loc's OUT updated set
     inline void removeVarFromDFOutUpdatedSet(LocID loc,const Key& var)
@@ -879,7 +940,7 @@ private:
     /// Get all var which have new pts information in loc's OUT set
     inline const DataSet& getDFOutUpdatedVar(LocID loc)
     {
-        return outUpdatedVarMap[loc];
+        return lookupOrInsert(outUpdatedVarMap, loc);
     }
     //@}
 };
@@ -887,7 +948,7 @@ private:
 /// VersionedPTData implemented with mutable points-to set (DataSet).
 /// Implemented as a wrapper around two MutablePTDatas: one for Keys, one
 /// for VersionedKeys.
-template <typename Key, typename KeySet, typename Data, typename DataSet, typename VersionedKey, typename VersionedKeySet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename VersionedKey, typename VersionedKeySet, typename BitVectorTy = void>
 class MutableVersionedPTData : public VersionedPTData<Key, KeySet, Data, DataSet, VersionedKey, VersionedKeySet>
 {
 public:
@@ -991,6 +1052,15 @@ public:
         return allPts;
     }
 
+    virtual inline void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        tlPTData.visitPts(visitor);
+        atPTData.visitPts([&visitor](const VersionedKey& vk, const DataSet& pts)
+        {
+            visitor(vk.first, pts);
+        });
+    }
+
     virtual inline void dumpPTData() override
     {
         SVFUtil::outs() << "== Top-level points-to information\n";
@@ -1001,7 +1071,7 @@ public:
 
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const MutableVersionedPTData<Key, KeySet, Data, DataSet, VersionedKey, VersionedKeySet> *)
+    static inline bool classof(const MutableVersionedPTData<Key, KeySet, Data, DataSet, VersionedKey, VersionedKeySet, BitVectorTy> *)
     {
         return true;
     }
@@ -1014,9 +1084,9 @@ public:
 
 private:
     /// PTData for Keys (top-level pointers, generally).
-    MutablePTData<Key, KeySet, Data, DataSet> tlPTData;
+    MutablePTData<Key, KeySet, Data, DataSet, BitVectorTy> tlPTData;
     /// PTData for VersionedKeys (address-taken objects, generally).
-    MutablePTData<VersionedKey, VersionedKeySet, Data, DataSet> atPTData;
+    MutablePTData<VersionedKey, VersionedKeySet, Data, DataSet, BitVectorTy> atPTData;
 };
 
 } // End namespace SVF
@@ -32,7 +32,11 @@ enum PTATY
     Cxt_DDA,		///< context sensitive DDA
 
 
-    Default_PTA		///< default pta without any analysis
+    Default_PTA,		///< default pta without any analysis
+
+    // Whole program analysis added later, after the others to keep their values
+    AndersenLCD_WPA,    ///< Lazy cycle detection andersen-style WPA
+    AndersenHLCD_WPA,   ///< Hybrid (offline + lazy) cycle detection andersen-style WPA
 };
 
 /// Implementation type: BVDataPTAImpl or CondPTAImpl.
@@ -50,6 +54,15 @@ enum PTBackingType
     Persistent,
 };
 
+/// Order in which WPASolver hands out the nodes of its worklist.
+enum WorklistOrder
+{
+    FIFOWorklist,       ///< First in first out
+    TopoWorklist,       ///< Topological order found by the last SCC detection
+    LRFWorklist,        ///< Least recently fired (popped) node first
+    PtsDeltaWorklist,   ///< Node whose points-to set grew most since it was last popped first
+};
+
 }  // namespace SVF
 
 #endif // PTATY_H
@@ -18,8 +18,11 @@
 #include <iostream>
 #include <vector>
 #include <functional>
+#include <algorithm>
+#include <memory>
 
 #include "Util/GeneralType.h"
+#include "MemoryModel/PointsTo.h"
 
 namespace SVF
 {
@@ -28,14 +31,25 @@ namespace SVF
 /// PointsToDS and PointsToDFDS. Hides points-to sets and union operations from users and hands
 /// out PointsToIDs.
 /// Points-to sets are interned, and union operations are lazy and hash-consed.
+/// The operation caches can be bounded in size, and points-to sets no longer
+/// referenced by any PTData can be reclaimed (see setOpCacheLimit and
+/// setRefCounting).
 template <typename Data>
 class PersistentPointsToCache
 {
 public:
     typedef Map<Data, PointsToID> PTSToIDMap;
     typedef std::function<Data(const Data &, const Data &)> DataOp;
+
+    /// A cached operation result and the sweep generation it was last used in.
+    struct OpResult
+    {
+        PointsToID result;
+        u32_t lastUse;
+    };
+
     // TODO: an unordered pair type may be better.
-    typedef Map<std::pair<PointsToID, PointsToID>, PointsToID> OpCache;
+    typedef Map<std::pair<PointsToID, PointsToID>, OpResult> OpCache;
 
     static PointsToID emptyPointsToId(void)
     {
@@ -43,7 +57,7 @@ public:
     };
 
 public:
-    PersistentPointsToCache(void) : idCounter(1)
+    PersistentPointsToCache(void) : idCounter(1), maxOpResults(0), opGeneration(0), refCounting(false), numOfUnreferenced(0)
     {
         idToPts.push_back(std::make_unique<Data>());
         ptsToId[Data()] = emptyPointsToId();
@@ -60,6 +74,10 @@ public:
         unionCache.clear();
         complementCache.clear();
         intersectionCache.clear();
+
+        refCounts.clear();
+        freeIds.clear();
+        numOfUnreferenced = 0;
     }
 
     /// Resets the cache removing everything except the emptyData it was initialised with.
@@ -79,11 +97,17 @@ public:
     /// Remaps all points-to sets stored in the cache to the current mapping.
     void remapAllPts(void)
     {
-        for (auto &d : idToPts) d->checkAndRemap();
+        for (auto &d : idToPts)
+        {
+            if (d != nullptr) d->checkAndRemap();
+        }
 
         // Rebuild ptsToId from idToPts.
         ptsToId.clear();
-        for (PointsToID i = 0; i < idToPts.size(); ++i) ptsToId[*idToPts[i]] = i;
+        for (PointsToID i = 0; i < idToPts.size(); ++i)
+        {
+            if (idToPts[i] != nullptr) ptsToId[*idToPts[i]] = i;
+        }
     }
 
     /// If pts is not in the PersistentPointsToCache, inserts it, assigns an ID, and returns
@@ -95,27 +119,121 @@ public:
         if (foundId != ptsToId.end()) return foundId->second;
 
         // Otherwise, insert it.
-        PointsToID id = newPointsToId();
-        idToPts.push_back(std::make_unique<Data>(pts));
-        ptsToId[pts] = id;
-
-        return id;
+        return insertPts(pts);
     }
 
     /// Returns the points-to set which id represents. id must be stored in the cache.
     const Data &getActualPts(PointsToID id) const
     {
         // Check if the points-to set for ID has already been stored.
-        assert(idToPts.size() > id && "PPTC::getActualPts: points-to set not stored!");
+        assert(idToPts.size() > id && idToPts[id] != nullptr && "PPTC::getActualPts: points-to set not stored!");
         return *idToPts.at(id);
     }
 
+    /// Limit the operation caches to about bytes of memory, 0 for no limit.
+    /// Past the limit, results not used since the last sweep are evicted.
+    void setOpCacheLimit(size_t bytes)
+    {
+        maxOpResults = bytes / OpResultBytes;
+    }
+
+    /// Whether to count the references PTDatas hold to each points-to set so
+    /// unreferenced sets can be reclaimed by collectGarbage. Set it before
+    /// any PTData takes an ID, as earlier references are not counted.
+    void setRefCounting(bool enabled)
+    {
+        refCounting = enabled;
+    }
+
+    /// Record that a PTData holds id.
+    inline void incRef(PointsToID id)
+    {
+        if (!refCounting || id == emptyPointsToId()) return;
+        if (refCounts.size() <= id) refCounts.resize(id + 1, 0);
+        ++refCounts[id];
+    }
+
+    /// Record that a PTData no longer holds id.
+    inline void decRef(PointsToID id)
+    {
+        if (!refCounting || id == emptyPointsToId()) return;
+        assert(refCounts.size() > id && refCounts[id] > 0 && "PPTC::decRef: id not referenced!");
+        if (--refCounts[id] == 0) ++numOfUnreferenced;
+    }
+
+    /// Replaces the ID held in slot by id, updating reference counts.
+    inline void assign(PointsToID &slot, PointsToID id)
+    {
+        if (slot == id) return;
+        incRef(id);
+        decRef(slot);
+        slot = id;
+    }
+
+    /// Frees points-to sets no PTData references once there are enough of
+    /// them, or always when force is set, and recycles their IDs. Every set
+    /// with no reference is freed, including those never assigned to a PTData
+    /// (temporaries from emplacePts and operation results). Only call when
+    /// nobody holds an unreferenced ID or a reference to its set, i.e.,
+    /// between solver iterations. Returns the number of sets freed.
+    u32_t collectGarbage(bool force = false)
+    {
+        if (!refCounting) return 0;
+        const size_t liveSets = idToPts.size() - freeIds.size();
+        if (!force && numOfUnreferenced < std::max<size_t>(MinGarbage, liveSets / 8)) return 0;
+        numOfUnreferenced = 0;
+
+        // Sweep all IDs rather than only those seen becoming unreferenced,
+        // so that no interned set can be missed.
+        std::vector<bool> dead(idToPts.size(), false);
+        u32_t numDead = 0;
+        for (PointsToID id = 0; id < idToPts.size(); ++id)
+        {
+            if (id == emptyPointsToId() || idToPts[id] == nullptr) continue;
+            if (id < refCounts.size() && refCounts[id] != 0) continue;
+            dead[id] = true;
+            ++numDead;
+        }
+
+        if (numDead == 0) return 0;
+
+        // Results involving a dead set must go before its ID is reused.
+        for (OpCache *opCache : { &unionCache, &complementCache, &intersectionCache })
+        {
+            for (typename OpCache::iterator it = opCache->begin(); it != opCache->end(); )
+            {
+                if (dead[it->first.first] || dead[it->first.second] || dead[it->second.result])
+                {
+                    it = opCache->erase(it);
+                    ++gcEvictions;
+                }
+                else ++it;
+            }
+        }
+
+        for (PointsToID id = 0; id < dead.size(); ++id)
+        {
+            if (!dead[id]) continue;
+            ptsToId.erase(*idToPts[id]);
+            idToPts[id].reset();
+            freeIds.push_back(id);
+        }
+
+        reclaimedPts += numDead;
+        ++garbageCollections;
+        return numDead;
+    }
+
     /// Unions lhs and rhs and returns their union's ID.
+    /// Ops performs the set operations (see DataSetOps); likewise below.
+    template <typename Ops = DataSetOps<Data>>
     PointsToID unionPts(PointsToID lhs, PointsToID rhs)
     {
         static const DataOp unionOp = [](const Data &lhs, const Data &rhs)
         {
-            return lhs | rhs;
+            Data result = lhs;
+            Ops::unionWith(result, rhs);
+            return result;
         };
 
         ++totalUnions;
@@ -151,7 +269,7 @@ public:
             // if x U y = z, then x U z = z,
             if (lhs != result)
             {
-                unionCache[std::minmax(lhs, result)] = result;
+                cacheOp(unionCache, std::minmax(lhs, result), result);
                 ++preemptiveUnions;
                 ++totalUnions;
             }
@@ -159,7 +277,7 @@ public:
             // and y U z = z.
             if (rhs != result)
             {
-                unionCache[std::minmax(rhs, result)] = result;
+                cacheOp(unionCache, std::minmax(rhs, result), result);
                 ++preemptiveUnions;
                 ++totalUnions;
             }
@@ -170,11 +288,14 @@ public:
     }
 
     /// Relatively complements lhs and rhs (lhs \ rhs) and returns it's ID.
+    template <typename Ops = DataSetOps<Data>>
     PointsToID complementPts(PointsToID lhs, PointsToID rhs)
     {
         static const DataOp complementOp = [](const Data &lhs, const Data &rhs)
         {
-            return lhs - rhs;
+            Data result = lhs;
+            Ops::intersectWithComplement(result, rhs);
+            return result;
         };
 
         ++totalComplements;
@@ -212,17 +333,17 @@ public:
             if (result != emptyPointsToId())
             {
                 // result AND rhs = EMPTY_SET,
-                intersectionCache[std::minmax(result, rhs)] = emptyPointsToId();
+                cacheOp(intersectionCache, std::minmax(result, rhs), emptyPointsToId());
                 ++preemptiveIntersections;
                 ++totalIntersections;
 
                 // and result AND lhs = result,
-                intersectionCache[std::minmax(result, lhs)] = result;
+                cacheOp(intersectionCache, std::minmax(result, lhs), result);
                 ++preemptiveIntersections;
                 ++totalIntersections;
 
                 // and result - rhs = result.
-                complementCache[std::make_pair(result, rhs)] = result;
+                cacheOp(complementCache, std::make_pair(result, rhs), result);
                 ++preemptiveComplements;
                 ++totalComplements;
             }
@@ -233,11 +354,14 @@ public:
     }
 
     /// Intersects lhs and rhs (lhs AND rhs) and returns the intersection's ID.
+    template <typename Ops = DataSetOps<Data>>
     PointsToID intersectPts(PointsToID lhs, PointsToID rhs)
     {
         static const DataOp intersectionOp = [](const Data &lhs, const Data &rhs)
         {
-            return lhs & rhs;
+            Data result = lhs;
+            Ops::intersectWith(result, rhs);
+            return result;
         };
 
         ++totalIntersections;
@@ -273,7 +397,7 @@ public:
                 // result AND rhs = result,
                 if (result != rhs)
                 {
-                    intersectionCache[std::minmax(result, rhs)] = result;
+                    cacheOp(intersectionCache, std::minmax(result, rhs), result);
                     ++preemptiveIntersections;
                     ++totalIntersections;
                 }
@@ -281,7 +405,7 @@ public:
                 // and result AND lhs = result,
                 if (result != lhs)
                 {
-                    intersectionCache[std::minmax(result, lhs)] = result;
+                    cacheOp(intersectionCache, std::minmax(result, lhs), result);
                     ++preemptiveIntersections;
                     ++totalIntersections;
                 }
@@ -290,7 +414,7 @@ public:
                 // result U lhs = result,
                 if (result != emptyPointsToId() && result != lhs)
                 {
-                    unionCache[std::minmax(lhs, result)] = lhs;
+                    cacheOp(unionCache, std::minmax(lhs, result), lhs);
                     ++preemptiveUnions;
                     ++totalUnions;
                 }
@@ -298,7 +422,7 @@ public:
                 // And result U rhs = rhs.
                 if (result != emptyPointsToId() && result != rhs)
                 {
-                    unionCache[std::minmax(rhs, result)] = rhs;
+                    cacheOp(unionCache, std::minmax(rhs, result), rhs);
                     ++preemptiveUnions;
                     ++totalUnions;
                 }
@@ -315,7 +439,7 @@ public:
         static const unsigned fieldWidth = 25;
         SVFUtil::outs().flags(std::ios::left);
 
-        SVFUtil::outs() << std::setw(fieldWidth) << "UniquePointsToSets"      << idToPts.size()          << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "UniquePointsToSets"      << idToPts.size() - freeIds.size() << "\n";
 
         SVFUtil::outs() << std::setw(fieldWidth) << "TotalUnions"             << totalUnions             << "\n";
         SVFUtil::outs() << std::setw(fieldWidth) << "PropertyUnions"          << propertyUnions          << "\n";
@@ -335,6 +459,17 @@ public:
         SVFUtil::outs() << std::setw(fieldWidth) << "LookupIntersections"     << lookupIntersections     << "\n";
         SVFUtil::outs() << std::setw(fieldWidth) << "PreemptiveIntersections" << preemptiveIntersections << "\n";
 
+        SVFUtil::outs() << std::setw(fieldWidth) << "OpCacheResults"          << numOpResults()          << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "OpCacheResultLimit"      << maxOpResults            << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "OpCacheHits"             << opCacheHits             << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "OpCacheMisses"           << opCacheMisses           << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "OpCacheEvictions"        << opCacheEvictions        << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "OpCacheSweeps"           << opCacheSweeps           << "\n";
+
+        SVFUtil::outs() << std::setw(fieldWidth) << "GarbageCollections"      << garbageCollections      << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "ReclaimedPointsToSets"   << reclaimedPts            << "\n";
+        SVFUtil::outs() << std::setw(fieldWidth) << "GCOpCacheEvictions"      << gcEvictions             << "\n";
+
         SVFUtil::outs().flush();
     }
 
@@ -345,15 +480,24 @@ public:
     Map<Data, unsigned> getAllPts(void)
     {
         Map<Data, unsigned> allPts;
-        for (const auto &d : idToPts) allPts[*d] = 1;
+        for (const auto &d : idToPts)
+        {
+            if (d != nullptr) allPts[*d] = 1;
+        }
+
         return allPts;
     }
 
-    // TODO: ref count API for garbage collection.
-
 private:
     PointsToID newPointsToId(void)
     {
+        if (!freeIds.empty())
+        {
+            const PointsToID id = freeIds.back();
+            freeIds.pop_back();
+            return id;
+        }
+
         // Make sure we don't overflow.
         assert(idCounter != emptyPointsToId() && "PPTC::newPointsToId: PointsToIDs exhausted! Try a larger type.");
         return idCounter++;
@@ -372,9 +516,15 @@ private:
         else operands = std::make_pair(lhs, rhs);
 
         // Check if we have performed this operation
-        OpCache::const_iterator foundResult = opCache.find(operands);
-        if (foundResult != opCache.end()) return foundResult->second;
+        typename OpCache::iterator foundResult = opCache.find(operands);
+        if (foundResult != opCache.end())
+        {
+            ++opCacheHits;
+            foundResult->second.lastUse = opGeneration;
+            return foundResult->second.result;
+        }
 
+        ++opCacheMisses;
         opPerformed = true;
 
         const Data &lhsPts = getActualPts(lhs);
@@ -386,19 +536,75 @@ private:
         // Intern points-to set: check if result already exists.
         typename PTSToIDMap::const_iterator foundId = ptsToId.find(result);
         if (foundId != ptsToId.end()) resultId = foundId->second;
-        else
-        {
-            resultId = newPointsToId();
-            idToPts.push_back(std::make_unique<Data>(result));
-            ptsToId[result] = resultId;
-        }
+        else resultId = insertPts(result);
 
         // Cache the result, for hash-consing.
-        opCache[operands] = resultId;
+        cacheOp(opCache, operands, resultId);
 
         return resultId;
     }
 
+    /// Interns pts, which must not be in the cache yet, under a new ID.
+    PointsToID insertPts(const Data &pts)
+    {
+        const PointsToID id = newPointsToId();
+        if (id < idToPts.size()) idToPts[id] = std::make_unique<Data>(pts);
+        else idToPts.push_back(std::make_unique<Data>(pts));
+        ptsToId[pts] = id;
+
+        // Nothing references the new set yet; it is garbage unless some PTData takes it.
+        if (refCounting) ++numOfUnreferenced;
+
+        return id;
+    }
+
+    /// Caches result as the result of an operation on operands in opCache,
+    /// sweeping the caches first if they are full.
+    inline void cacheOp(OpCache &opCache, const std::pair<PointsToID, PointsToID> &operands, PointsToID result)
+    {
+        if (maxOpResults != 0 && numOpResults() >= maxOpResults) sweepOpCaches();
+        opCache[operands] = OpResult{result, opGeneration};
+    }
+
+    inline size_t numOpResults(void) const
+    {
+        return unionCache.size() + complementCache.size() + intersectionCache.size();
+    }
+
+    /// Evicts the results not used since the last sweep (a coarse CLOCK). If
+    /// that frees less than a quarter of the limit, evicts further results
+    /// until the caches are at half the limit.
+    void sweepOpCaches(void)
+    {
+        ++opCacheSweeps;
+        for (OpCache *opCache : { &unionCache, &complementCache, &intersectionCache })
+        {
+            for (typename OpCache::iterator it = opCache->begin(); it != opCache->end(); )
+            {
+                if (it->second.lastUse != opGeneration)
+                {
+                    it = opCache->erase(it);
+                    ++opCacheEvictions;
+                }
+                else ++it;
+            }
+        }
+
+        if (numOpResults() > maxOpResults - maxOpResults / 4)
+        {
+            for (OpCache *opCache : { &unionCache, &complementCache, &intersectionCache })
+            {
+                while (!opCache->empty() && numOpResults() > maxOpResults / 2)
+                {
+                    opCache->erase(opCache->begin());
+                    ++opCacheEvictions;
+                }
+            }
+        }
+
+        ++opGeneration;
+    }
+
     /// Initialises statistics variables to 0.
     inline void initStats(void)
     {
@@ -418,6 +624,13 @@ private:
         propertyIntersections    = 0;
         lookupIntersections      = 0;
         preemptiveIntersections  = 0;
+        opCacheHits              = 0;
+        opCacheMisses            = 0;
+        opCacheEvictions         = 0;
+        opCacheSweeps            = 0;
+        garbageCollections       = 0;
+        reclaimedPts             = 0;
+        gcEvictions              = 0;
     }
 
 private:
@@ -440,6 +653,25 @@ private:
     /// Used to generate new PointsToIDs. Any non-zero is valid.
     PointsToID idCounter;
 
+    /// Approximate memory taken by a cached operation result.
+    static constexpr size_t OpResultBytes = sizeof(typename OpCache::value_type) + 3 * sizeof(void *);
+    /// Maximum number of cached operation results, 0 for no limit.
+    size_t maxOpResults;
+    /// Incremented on every sweep of the operation caches.
+    u32_t opGeneration;
+
+    /// Fewest unreferenced IDs worth a garbage collection.
+    static constexpr size_t MinGarbage = 1 << 14;
+    /// Whether references to points-to sets are counted (and sets reclaimed).
+    bool refCounting;
+    /// Number of PTData entries holding each ID.
+    std::vector<u32_t> refCounts;
+    /// Number of sets interned, or whose reference count dropped to 0, since
+    /// the last garbage collection; how much garbage there may be.
+    size_t numOfUnreferenced;
+    /// IDs of reclaimed points-to sets, to be reused.
+    std::vector<PointsToID> freeIds;
+
     // Statistics:
     u64_t totalUnions;
     u64_t uniqueUnions;
@@ -456,6 +688,13 @@ private:
     u64_t propertyIntersections;
     u64_t lookupIntersections;
     u64_t preemptiveIntersections;
+    u64_t opCacheHits;
+    u64_t opCacheMisses;
+    u64_t opCacheEvictions;
+    u64_t opCacheSweeps;
+    u64_t garbageCollections;
+    u64_t reclaimedPts;
+    u64_t gcEvictions;
 };
 
 } // End namespace SVF
@@ -21,24 +21,25 @@
 namespace SVF
 {
 
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
 class PersistentDFPTData;
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
 class PersistentIncDFPTData;
-template <typename Key, typename KeySet, typename Data, typename DataSet, typename VersionedKey, typename VersionedKeySet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename VersionedKey, typename VersionedKeySet, typename BitVectorTy = void>
 class PersistentVersionedPTData;
 
 /// PTData backed by a PersistentPointsToCache.
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
 class PersistentPTData : public PTData<Key, KeySet, Data, DataSet>
 {
-    template <typename K, typename KS, typename D, typename DS, typename VK, typename VKS>
+    template <typename K, typename KS, typename D, typename DS, typename VK, typename VKS, typename BV>
     friend class PersistentVersionedPTData;
-    friend class PersistentDFPTData<Key, KeySet, Data, DataSet>;
-    friend class PersistentIncDFPTData<Key, KeySet, Data, DataSet>;
+    friend class PersistentDFPTData<Key, KeySet, Data, DataSet, BitVectorTy>;
+    friend class PersistentIncDFPTData<Key, KeySet, Data, DataSet, BitVectorTy>;
 public:
     typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
+    typedef DataSetOps<DataSet, BitVectorTy> Ops;
 
     typedef Map<Key, PointsToID> KeyToIDMap;
     typedef Map<Data, KeySet> RevPtsMap;
@@ -51,6 +52,7 @@ public:
 
     inline void clear() override
     {
+        for (const typename KeyToIDMap::value_type &ki : ptsMap) ptCache.decRef(ki.second);
         ptsMap.clear();
         revPtsMap.clear();
     }
@@ -70,7 +72,7 @@ public:
     inline bool addPts(const Key &dstKey, const Data &element) override
     {
         DataSet srcPts;
-        srcPts.set(element);
+        Ops::testAndSet(srcPts, element);
         PointsToID srcId = ptCache.emplacePts(srcPts);
         return unionPtsFromId(dstKey, srcId);
     }
@@ -94,13 +96,13 @@ public:
     void clearPts(const Key &var, const Data &element) override
     {
         DataSet toRemoveData;
-        toRemoveData.set(element);
+        Ops::testAndSet(toRemoveData, element);
         PointsToID toRemoveId = ptCache.emplacePts(toRemoveData);
         PointsToID varId = ptsMap[var];
-        PointsToID complementId = ptCache.complementPts(varId, toRemoveId);
+        PointsToID complementId = ptCache.template complementPts<Ops>(varId, toRemoveId);
         if (varId != complementId)
         {
-            ptsMap[var] = complementId;
+            ptCache.assign(ptsMap[var], complementId);
             clearSingleRevPts(revPtsMap[element], var);
         }
     }
@@ -108,7 +110,7 @@ public:
     void clearFullPts(const Key& var) override
     {
         clearRevPts(getPts(var), var);
-        ptsMap[var] = PersistentPointsToCache<DataSet>::emptyPointsToId();
+        ptCache.assign(ptsMap[var], PersistentPointsToCache<DataSet>::emptyPointsToId());
     }
 
     void remapAllPts() override
@@ -134,9 +136,14 @@ public:
         return allPts;
     }
 
+    void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        for (const typename KeyToIDMap::value_type &ki : ptsMap) visitor(ki.first, ptCache.getActualPts(ki.second));
+    }
+
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const PersistentPTData<Key, KeySet, Data, DataSet> *)
+    static inline bool classof(const PersistentPTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
     {
         return true;
     }
@@ -153,12 +160,12 @@ private:
     inline bool unionPtsFromId(const Key &dstKey, PointsToID srcId)
     {
         PointsToID dstId = ptsMap[dstKey];
-        PointsToID newDstId = ptCache.unionPts(dstId, srcId);
+        PointsToID newDstId = ptCache.template unionPts<Ops>(dstId, srcId);
 
         bool changed = newDstId != dstId;
         if (changed)
         {
-            ptsMap[dstKey] = newDstId;
+            ptCache.assign(ptsMap[dstKey], newDstId);
 
             // Reverse points-to only needs to be handled when dst's
             // points-to set has changed (i.e., do it the first time only).
@@ -195,14 +202,15 @@ protected:
 };
 
 /// DiffPTData implemented with a persistent points-to backing.
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy = void>
 class PersistentDiffPTData : public DiffPTData<Key, KeySet, Data, DataSet>
 {
 public:
     typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
     typedef DiffPTData<Key, KeySet, Data, DataSet> BaseDiffPTData;
-    typedef PersistentPTData<Key, KeySet, Data, DataSet> BasePersPTData;
+    typedef PersistentPTData<Key, KeySet, Data, DataSet, BitVectorTy> BasePersPTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
+    typedef DataSetOps<DataSet, BitVectorTy> Ops;
 
     typedef typename BasePersPTData::KeyToIDMap KeyToIDMap;
     typedef typename BasePersPTData::RevPtsMap RevPtsMap;
@@ -216,6 +224,8 @@ public:
     void clear() override
     {
         persPTData.clear();
+        for (const typename KeyToIDMap::value_type &ki : diffPtsMap) ptCache.decRef(ki.second);
+        for (const typename KeyToIDMap::value_type &ki : propaPtsMap) ptCache.decRef(ki.second);
         diffPtsMap.clear();
         propaPtsMap.clear();
     }
@@ -277,11 +287,11 @@ public:
         PointsToID propaId = propaPtsMap[var];
         PointsToID allId = ptCache.emplacePts(all);
         // Diff is made up of the entire points-to set minus what has been propagated.
-        PointsToID diffId = ptCache.complementPts(allId, propaId);
-        diffPtsMap[var] = diffId;
+        PointsToID diffId = ptCache.template complementPts<Ops>(allId, propaId);
+        ptCache.assign(diffPtsMap[var], diffId);
 
         // We've now propagated the entire thing.
-        propaPtsMap[var] = allId;
+        ptCache.assign(propaPtsMap[var], allId);
 
         // Whether diff is empty or not; just need to check against the ID since it
         // is the only empty set.
@@ -292,12 +302,22 @@ public:
     {
         PointsToID dstId = propaPtsMap[dst];
         PointsToID srcId = propaPtsMap[src];
-        propaPtsMap[dst] = ptCache.intersectPts(dstId, srcId);
+        ptCache.assign(propaPtsMap[dst], ptCache.template intersectPts<Ops>(dstId, srcId));
     }
 
     inline void clearPropaPts(Key &var) override
     {
-        propaPtsMap[var] = ptCache.emptyPointsToId();
+        ptCache.assign(propaPtsMap[var], ptCache.emptyPointsToId());
+    }
+
+    inline const DataSet& getPropaPts(Key &var) override
+    {
+        return ptCache.getActualPts(propaPtsMap[var]);
+    }
+
+    inline void setPropaPts(Key &var, const DataSet &propa) override
+    {
+        ptCache.assign(propaPtsMap[var], ptCache.emplacePts(propa));
     }
 
     Map<DataSet, unsigned> getAllPts(bool liveOnly) const override
@@ -305,9 +325,16 @@ public:
         return persPTData.getAllPts(liveOnly);
     }
 
+    void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        persPTData.visitPts(visitor);
+        for (const typename KeyToIDMap::value_type &ki : diffPtsMap) visitor(ki.first, ptCache.getActualPts(ki.second));
+        for (const typename KeyToIDMap::value_type &ki : propaPtsMap) visitor(ki.first, ptCache.getActualPts(ki.second));
+    }
+
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const PersistentDiffPTData<Key, KeySet, Data, DataSet> *)
+    static inline bool classof(const PersistentDiffPTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
     {
         return true;
     }
@@ -321,7 +348,7 @@ public:
 private:
     PersistentPointsToCache<DataSet> &ptCache;
     /// Backing to implement basic PTData methods. Allows us to avoid multiple inheritance.
-    PersistentPTData<Key, KeySet, Data, DataSet> persPTData;
+    PersistentPTData<Key, KeySet, Data, DataSet, BitVectorTy> persPTData;
     /// Diff points-to to be propagated.
     KeyToIDMap diffPtsMap;
     /// Points-to already propagated.
@@ -329,14 +356,15 @@ private:
 };
 
 /// DFPTData backed by a PersistentPointsToCache.
-template <typename Key, typename KeySet, typename Data, typename DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy>
 class PersistentDFPTData : public DFPTData<Key, KeySet, Data, DataSet>
 {
 public:
     typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
+    typedef DataSetOps<DataSet, BitVectorTy> Ops;
     typedef DFPTData<Key, KeySet, Data, DataSet> BaseDFPTData;
-    typedef PersistentPTData<Key, KeySet, Data, DataSet> BasePersPTData;
+    typedef PersistentPTData<Key, KeySet, Data, DataSet, BitVectorTy> BasePersPTData;
 
     typedef typename BaseDFPTData::LocID LocID;
     typedef typename BasePersPTData::KeyToIDMap KeyToIDMap;
@@ -349,6 +377,14 @@ public:
 
     inline void clear() override
     {
+        for (const DFKeyToIDMap *dfPtsMap : { &dfInPtsMap, &dfOutPtsMap })
+        {
+            for (const typename DFKeyToIDMap::value_type &lki : *dfPtsMap)
+            {
+                for (const typename KeyToIDMap::value_type &ki : lki.second) ptCache.decRef(ki.second);
+            }
+        }
+
         dfInPtsMap.clear();
         dfOutPtsMap.clear();
         persPTData.clear();
@@ -486,6 +522,12 @@ public:
     {
     }
 
+    void initDFSets(LocID loc, bool in, bool out) override
+    {
+        if (in) dfInPtsMap[loc];
+        if (out) dfOutPtsMap[loc];
+    }
+
     /// Update points-to set of top-level pointers with IN[srcLoc:srcVar].
     bool updateTLVPts(LocID srcLoc, const Key &srcVar, const Key &dstVar) override
     {
@@ -530,9 +572,23 @@ public:
         return allPts;
     }
 
+    void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        persPTData.visitPts(visitor);
+        for (const typename DFKeyToIDMap::value_type &lki : dfInPtsMap)
+        {
+            for (const typename KeyToIDMap::value_type &ki : lki.second) visitor(ki.first, ptCache.getActualPts(ki.second));
+        }
+
+        for (const typename DFKeyToIDMap::value_type &lki : dfOutPtsMap)
+        {
+            for (const typename KeyToIDMap::value_type &ki : lki.second) visitor(ki.first, ptCache.getActualPts(ki.second));
+        }
+    }
+
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const PersistentDFPTData<Key, KeySet, Data, DataSet> *)
+    static inline bool classof(const PersistentDFPTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
     {
         return true;
     }
@@ -548,7 +604,7 @@ protected:
     inline bool unionPtsThroughIds(PointsToID &dst, PointsToID &src)
     {
         PointsToID oldDst = dst;
-        dst = ptCache.unionPts(dst, src);
+        ptCache.assign(dst, ptCache.template unionPts<Ops>(dst, src));
         return oldDst != dst;
     }
 
@@ -566,7 +622,7 @@ protected:
     PersistentPointsToCache<DataSet> &ptCache;
 
     /// PTData for top-level pointers. We will also use its cache for address-taken pointers.
-    PersistentPTData<Key, KeySet, Data, DataSet> persPTData;
+    PersistentPTData<Key, KeySet, Data, DataSet, BitVectorTy> persPTData;
 
     /// Address-taken points-to sets in IN-sets.
     DFKeyToIDMap dfInPtsMap;
@@ -575,14 +631,14 @@ protected:
 };
 
 /// Incremental version of the persistent data-flow points-to data structure.
-template <typename Key, typename KeySet, typename Data, typename DataSet>
-class PersistentIncDFPTData : public PersistentDFPTData<Key, KeySet, Data, DataSet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename BitVectorTy>
+class PersistentIncDFPTData : public PersistentDFPTData<Key, KeySet, Data, DataSet, BitVectorTy>
 {
 public:
     typedef PTData<Key, KeySet, Data, DataSet> BasePTData;
-    typedef PersistentPTData<Key, KeySet, Data, DataSet> BasePersPTData;
+    typedef PersistentPTData<Key, KeySet, Data, DataSet, BitVectorTy> BasePersPTData;
     typedef DFPTData<Key, KeySet, Data, DataSet> BaseDFPTData;
-    typedef PersistentDFPTData<Key, KeySet, Data, DataSet> BasePersDFPTData;
+    typedef PersistentDFPTData<Key, KeySet, Data, DataSet, BitVectorTy> BasePersDFPTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
 
     typedef typename BaseDFPTData::LocID LocID;
@@ -708,6 +764,13 @@ public:
         }
     }
 
+    inline void initDFSets(LocID loc, bool in, bool out) override
+    {
+        BasePersDFPTData::initDFSets(loc, in, out);
+        if (in) inUpdatedVarMap[loc];
+        if (out) outUpdatedVarMap[loc];
+    }
+
     inline void clear() override
     {
         outUpdatedVarMap.clear();
@@ -717,7 +780,7 @@ public:
 
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const PersistentIncDFPTData<Key, KeySet, Data, DataSet> *)
+    static inline bool classof(const PersistentIncDFPTData<Key, KeySet, Data, DataSet, BitVectorTy> *)
     {
         return true;
     }
@@ -800,7 +863,7 @@ private:
 /// Implemented as a wrapper around two PersistentPTDatas: one for Keys, one
 /// for VersionedKeys.
 /// They are constructed with the same PersistentPointsToCache.
-template <typename Key, typename KeySet, typename Data, typename DataSet, typename VersionedKey, typename VersionedKeySet>
+template <typename Key, typename KeySet, typename Data, typename DataSet, typename VersionedKey, typename VersionedKeySet, typename BitVectorTy>
 class PersistentVersionedPTData : public VersionedPTData<Key, KeySet, Data, DataSet, VersionedKey, VersionedKeySet>
 {
 public:
@@ -808,8 +871,8 @@ public:
     typedef VersionedPTData<Key, KeySet, Data, DataSet, VersionedKey, VersionedKeySet> BaseVersionedPTData;
     typedef typename BasePTData::PTDataTy PTDataTy;
 
-    typedef typename PersistentPTData<Key, KeySet, Data, DataSet>::KeyToIDMap KeyToIDMap;
-    typedef typename PersistentPTData<VersionedKey, VersionedKeySet, Data, DataSet>::KeyToIDMap VersionedKeyToIDMap;
+    typedef typename PersistentPTData<Key, KeySet, Data, DataSet, BitVectorTy>::KeyToIDMap KeyToIDMap;
+    typedef typename PersistentPTData<VersionedKey, VersionedKeySet, Data, DataSet, BitVectorTy>::KeyToIDMap VersionedKeyToIDMap;
 
     explicit PersistentVersionedPTData(PersistentPointsToCache<DataSet> &cache, bool reversePT = true, PTDataTy ty = PTDataTy::PersVersioned)
         : BaseVersionedPTData(reversePT, ty), tlPTData(cache, reversePT), atPTData(cache, reversePT) { }
@@ -922,6 +985,15 @@ public:
         return allPts;
     }
 
+    void visitPts(const std::function<void(const Key&, const DataSet&)>& visitor) const override
+    {
+        tlPTData.visitPts(visitor);
+        atPTData.visitPts([&visitor](const VersionedKey& vk, const DataSet& pts)
+        {
+            visitor(vk.first, pts);
+        });
+    }
+
     inline void dumpPTData() override
     {
         SVFUtil::outs() << "== Top-level points-to information\n";
@@ -932,7 +1004,7 @@ public:
 
     /// Methods to support type inquiry through isa, cast, and dyn_cast:
     ///@{
-    static inline bool classof(const PersistentVersionedPTData<Key, KeySet, Data, DataSet, VersionedKey, VersionedKeySet> *)
+    static inline bool classof(const PersistentVersionedPTData<Key, KeySet, Data, DataSet, VersionedKey, VersionedKeySet, BitVectorTy> *)
     {
         return true;
     }
@@ -945,9 +1017,9 @@ public:
 
 private:
     /// PTData for Keys (top-level pointers, generally).
-    PersistentPTData<Key, KeySet, Data, DataSet> tlPTData;
+    PersistentPTData<Key, KeySet, Data, DataSet, BitVectorTy> tlPTData;
     /// PTData for VersionedKeys (address-taken objects, generally).
-    PersistentPTData<VersionedKey, VersionedKeySet, Data, DataSet> atPTData;
+    PersistentPTData<VersionedKey, VersionedKeySet, Data, DataSet, BitVectorTy> atPTData;
 };
 
 } // End namespace SVF
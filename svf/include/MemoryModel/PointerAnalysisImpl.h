@@ -36,7 +36,9 @@
 #include "MemoryModel/AbstractPointsToDS.h"
 #include "MemoryModel/MutablePointsToDS.h"
 #include "MemoryModel/PersistentPointsToDS.h"
+#include "MemoryModel/CompactPointsToDS.h"
 #include "MemoryModel/ConditionalPT.h"
+#include "MemoryModel/PointsToProfiler.h"
 
 namespace SVF
 {
@@ -65,6 +67,8 @@ public:
     typedef PersistentIncDFPTData<NodeID, NodeSet, NodeID, PointsTo> PersIncDFPTDataTy;
     typedef PersistentVersionedPTData<NodeID, NodeSet, NodeID, PointsTo, VersionedVar, Set<VersionedVar>> PersVersionedPTDataTy;
 
+    typedef CompactDFPTData<NodeID, NodeSet, NodeID, PointsTo> CompactDFPTDataTy;
+
     /// Constructor
     BVDataPTAImpl(SVFIR* pag, PTATY type, bool alias_check = true);
 
@@ -76,6 +80,21 @@ public:
         return ptCache;
     }
 
+    /// Reclaim persistent points-to sets no longer referenced, if there are
+    /// enough of them (-ptcache-gc). Solvers call this between nodes or
+    /// iterations, when they hold no points-to set references.
+    inline void collectPtsGarbage()
+    {
+        ptCache.collectGarbage();
+    }
+
+    /// Write a partial points-to memory profile (-pts-profile) if one was
+    /// requested with SIGUSR1. Solvers call this alongside collectPtsGarbage.
+    inline void profilePtsIfRequested()
+    {
+        if (PointsToProfiler::takeRequest()) profilePts(true);
+    }
+
     static inline bool classof(const PointerAnalysis *pta)
     {
         return pta->getImplTy() == PTAImplTy::BVDataImpl;
@@ -148,6 +167,29 @@ public:
     virtual void readAndSetObjFieldSensitivity(std::ifstream& f, const std::string& delimiterStr);
     //@}
 
+    /// Binary (memory-mappable) analysis result storage, selected by -binary-ander.
+    /// readFromFile detects the format from the file header.
+    //@{
+    virtual void writeToBinaryFile(const std::string& filename);
+    virtual bool readFromBinaryFile(const std::string& filename);
+    static bool isBinaryPtsFile(const std::string& filename);
+    /// Fingerprint of the SVFIR nodes (ids and kinds) used to reject stale result files
+    u64_t getSVFIRFingerprint() const;
+    //@}
+
+    /// Analysis results read back from a file (either format) without updating the SVFIR
+    struct PtsSnapshot
+    {
+        std::vector<std::pair<NodeID, bool>> preSolveObjFI;
+        std::vector<PointsTo> ptsSets;                              ///< distinct points-to sets
+        std::vector<std::pair<NodeID, u32_t>> nodeToSet;            ///< node -> index into ptsSets
+        std::vector<std::tuple<NodeID, APOffset, NodeID>> gepObjs;  ///< base, offset, gep object
+        std::vector<std::pair<NodeID, bool>> postSolveObjFI;
+        u64_t fingerprint = 0;                                      ///< SVFIR fingerprint (binary format only)
+        u64_t numOfNodes = 0;                                       ///< SVFIR nodes after solving (binary format only)
+    };
+    virtual bool readSnapshotFromFile(const std::string& filename, PtsSnapshot& snapshot);
+
 protected:
     /// Get points-to data structure
     inline PTDataTy* getPTDataTy() const
@@ -159,6 +201,9 @@ protected:
     /// Finalization of pointer analysis, and normalize points-to information to Bit Vector representation
     void finalize() override;
 
+    /// Add the points-to sets held by ptD to a memory profile and write it.
+    void profilePts(bool partial);
+
     /// Update callgraph. This should be implemented by its subclass.
     virtual inline bool updateCallGraph(const CallSiteToFunPtrMap&)
     {
@@ -180,12 +225,12 @@ protected:
         return df;
     }
 
-    inline MutDFPTDataTy* getMutDFPTDataTy() const
-    {
-        MutDFPTDataTy* mdf = SVFUtil::dyn_cast<MutDFPTDataTy>(ptD.get());
-        assert(mdf && "BVDataPTAImpl::getMutDFPTDataTy: not a MutDFPTDataTy!");
-        return mdf;
-    }
+    /// Data-flow IN/OUT maps when ptD is a MutDFPTDataTy, whichever backing
+    /// its points-to sets were instantiated with.
+    ///@{
+    const MutDFPTDataTy::DFPtsMap& getMutDFIn() const;
+    const MutDFPTDataTy::DFPtsMap& getMutDFOut() const;
+    ///@}
 
     inline VersionedPTDataTy* getVersionedPTDataTy() const
     {
@@ -205,12 +250,25 @@ protected:
     /// i.e., replace fieldObj with baseObj if it is field-insensitive
     virtual void normalizePointsTo();
 
+    /// Whether -write-ander results are stored in the binary format
+    virtual bool writesBinaryPtsFile() const;
+
+    /// Recreate the field object of base at offset with a previously allocated id
+    void restoreGepObjVar(NodeID base, const APOffset& offset, NodeID id);
+
 private:
     /// Points-to data
     std::unique_ptr<PTDataTy> ptD;
 
     PersistentPointsToCache<PointsTo> ptCache;
 
+    /// Field-insensitive base objects and SVFIR fingerprint before solving,
+    /// recorded by writeObjVarToFile for the binary format
+    //@{
+    std::vector<std::pair<NodeID, bool>> preSolveObjFI;
+    u64_t preSolveFingerprint = 0;
+    //@}
+
 public:
     /// Interface expose to users of our pointer analysis, given Value infos
     AliasResult alias(const SVFVar* V1,
@@ -371,6 +429,14 @@ protected:
     {
         normalizePointsTo();
         PointerAnalysis::finalize();
+
+        // Conditional sets are not PointsTo, so profile their normalized form.
+        if (PointsToProfiler *profiler = PointsToProfiler::get())
+        {
+            profiler->begin(PTAName(), ptaTy, PTBackingType::Mutable);
+            for (const PtrToBVPtsMap::value_type &ppt : ptrToBVPtsMap) profiler->addPts(ppt.first, ppt.second);
+            profiler->end(false);
+        }
     }
     /// Union/add points-to, and add the reverse points-to for node collapse purpose
     /// To be noted that adding reverse pts might incur 10% total overhead during solving
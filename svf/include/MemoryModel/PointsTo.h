@@ -12,20 +12,29 @@
 #ifndef POINTSTO_H_
 #define POINTSTO_H_
 
+#include <limits.h>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "Util/GeneralType.h"
 #include "Util/BitVector.h"
 #include "Util/CoreBitVector.h"
+#include "Util/RoaringBitVector.h"
 #include "Util/SparseBitVector.h"
 
 namespace SVF
 {
 
+template <typename BitVectorTy>
+struct PointsToBacking;
+
 /// Wraps data structures to provide a points-to set.
 /// Underlying data structure can be changed globally.
 /// Includes support for mapping nodes for better internal representation.
+/// With Options::PtInline, sets of up to SmallSetSize elements are stored
+/// inline instead, and the backing data structure is only built when a set
+/// grows beyond that (and dropped again when it shrinks back).
 class PointsTo
 {
 public:
@@ -34,6 +43,7 @@ public:
         SBV,
         CBV,
         BV,
+        RBV,
     };
 
     class PointsToIterator;
@@ -42,6 +52,9 @@ public:
 
     typedef std::shared_ptr<std::vector<NodeID>> MappingPtr;
 
+    /// Number of elements held inline by small sets, filling the union.
+    static constexpr u32_t SmallSetSize = 8;
+
 public:
     /// Construct empty points-to set.
     PointsTo();
@@ -116,6 +129,26 @@ public:
     /// Put intersection of lhs with complement of rhs into this set (overwrites).
     void intersectWithComplement(const PointsTo &lhs, const PointsTo &rhs);
 
+    /// Like |=, &=, intersectWithComplement, test_and_set, and reset, but
+    /// with the backing data structure known to be BitVectorTy at compile
+    /// time so there is no dispatch on the type. BitVectorTy void means
+    /// unknown, i.e., the operations above. Small sets use the operations
+    /// above too.
+    //@{
+    template <typename BitVectorTy>
+    inline bool unionWith(const PointsTo &rhs);
+    template <typename BitVectorTy>
+    inline bool intersectWith(const PointsTo &rhs);
+    template <typename BitVectorTy>
+    inline bool intersectWithComplement(const PointsTo &rhs);
+    template <typename BitVectorTy>
+    inline void intersectWithComplement(const PointsTo &lhs, const PointsTo &rhs);
+    template <typename BitVectorTy>
+    inline bool testAndSet(u32_t n);
+    template <typename BitVectorTy>
+    inline void reset(u32_t n);
+    //@}
+
     /// Returns this points-to set as a NodeBS.
     NodeBS toNodeBS() const;
 
@@ -143,8 +176,16 @@ public:
                                           MappingPtr newCurrentBestReverseNodeMapping);
 
 private:
+    template <typename BitVectorTy>
+    friend struct PointsToBacking;
+
     /// Returns nodeMapping[n], checking for nullptr and size.
-    NodeID getInternalNode(NodeID n) const;
+    inline NodeID getInternalNode(NodeID n) const
+    {
+        if (nodeMapping == nullptr) return n;
+        assert(n < nodeMapping->size() && "PointsTo::getInternalNode: node not mapped!");
+        return (*nodeMapping)[n];
+    }
 
     /// Returns reverseNodeMapping[n], checking for nullptr and size.
     NodeID getExternalNode(NodeID n) const;
@@ -153,26 +194,60 @@ private:
     /// and reverseNodeMapping
     bool metaSame(const PointsTo &pt) const;
 
+    /// Returns true if the elements are held inline rather than in the backing.
+    inline bool isSmall() const
+    {
+        return smallCount != NotSmall;
+    }
+
+    /// Construct/destruct the (empty) backing data structure of type.
+    //@{
+    void constructBacking();
+    void destroyBacking();
+    //@}
+
+    /// Move the inline elements into a new backing data structure.
+    void promote();
+
+    /// Move the elements back inline if the backing holds few enough.
+    void demoteIfSmall();
+
+    /// Like test, test_and_set, and reset, but on internal nodes.
+    //@{
+    bool testInternal(u32_t n) const;
+    bool testAndSetInternal(u32_t n);
+    void resetInternal(u32_t n);
+    //@}
+
 private:
     /// Best node mapping we know of the for the analyses at hand.
     static MappingPtr currentBestNodeMapping;
     /// Likewise, but reversed.
     static MappingPtr currentBestReverseNodeMapping;
 
+    /// Value of smallCount when the backing data structure is in use.
+    static constexpr u32_t NotSmall = UINT_MAX;
+
     /// Holds backing data structure.
     /// TODO: std::variant when we move to C++17.
     union
     {
+        /// Sorted internal nodes of a small set.
+        NodeID smallSet[SmallSetSize];
         /// Sparse bit vector backing.
         SparseBitVector<> sbv;
         /// Core bit vector backing.
         CoreBitVector cbv;
         /// Bit vector backing.
         BitVector bv;
+        /// Roaring bit vector backing.
+        RoaringBitVector rbv;
     };
 
     /// Type of this points-to set.
     enum Type type;
+    /// Number of elements in smallSet, or NotSmall.
+    u32_t smallCount;
     /// External nodes -> internal nodes.
     MappingPtr nodeMapping;
     /// Internal nodes -> external nodes.
@@ -225,13 +300,221 @@ public:
         /// TODO: std::variant when we move to C++17.
         union
         {
+            /// Index into smallSet.
+            u32_t smallIt;
             SparseBitVector<>::iterator sbvIt;
             CoreBitVector::iterator cbvIt;
             BitVector::iterator bvIt;
+            RoaringBitVector::iterator rbvIt;
         };
     };
 };
 
+/// Gives the backing data structure of type BitVectorTy of a PointsTo.
+//@{
+template <>
+struct PointsToBacking<SparseBitVector<>>
+{
+    static constexpr PointsTo::Type type = PointsTo::SBV;
+    static inline SparseBitVector<> &get(PointsTo &pt)
+    {
+        return pt.sbv;
+    }
+    static inline const SparseBitVector<> &get(const PointsTo &pt)
+    {
+        return pt.sbv;
+    }
+};
+
+template <>
+struct PointsToBacking<CoreBitVector>
+{
+    static constexpr PointsTo::Type type = PointsTo::CBV;
+    static inline CoreBitVector &get(PointsTo &pt)
+    {
+        return pt.cbv;
+    }
+    static inline const CoreBitVector &get(const PointsTo &pt)
+    {
+        return pt.cbv;
+    }
+};
+
+template <>
+struct PointsToBacking<BitVector>
+{
+    static constexpr PointsTo::Type type = PointsTo::BV;
+    static inline BitVector &get(PointsTo &pt)
+    {
+        return pt.bv;
+    }
+    static inline const BitVector &get(const PointsTo &pt)
+    {
+        return pt.bv;
+    }
+};
+
+template <>
+struct PointsToBacking<RoaringBitVector>
+{
+    static constexpr PointsTo::Type type = PointsTo::RBV;
+    static inline RoaringBitVector &get(PointsTo &pt)
+    {
+        return pt.rbv;
+    }
+    static inline const RoaringBitVector &get(const PointsTo &pt)
+    {
+        return pt.rbv;
+    }
+};
+//@}
+
+template <typename BitVectorTy>
+inline bool PointsTo::unionWith(const PointsTo &rhs)
+{
+    if constexpr (std::is_void<BitVectorTy>::value) return *this |= rhs;
+    else
+    {
+        assert(metaSame(rhs) && "PointsTo::unionWith: mappings of operands do not match!");
+        if (isSmall() || rhs.isSmall()) return *this |= rhs;
+        assert(type == PointsToBacking<BitVectorTy>::type && "PointsTo::unionWith: wrong backing!");
+        return PointsToBacking<BitVectorTy>::get(*this) |= PointsToBacking<BitVectorTy>::get(rhs);
+    }
+}
+
+template <typename BitVectorTy>
+inline bool PointsTo::intersectWith(const PointsTo &rhs)
+{
+    if constexpr (std::is_void<BitVectorTy>::value) return *this &= rhs;
+    else
+    {
+        assert(metaSame(rhs) && "PointsTo::intersectWith: mappings of operands do not match!");
+        if (isSmall() || rhs.isSmall()) return *this &= rhs;
+        assert(type == PointsToBacking<BitVectorTy>::type && "PointsTo::intersectWith: wrong backing!");
+        const bool changed = PointsToBacking<BitVectorTy>::get(*this) &= PointsToBacking<BitVectorTy>::get(rhs);
+        if (changed) demoteIfSmall();
+        return changed;
+    }
+}
+
+template <typename BitVectorTy>
+inline bool PointsTo::intersectWithComplement(const PointsTo &rhs)
+{
+    if constexpr (std::is_void<BitVectorTy>::value) return intersectWithComplement(rhs);
+    else
+    {
+        assert(metaSame(rhs) && "PointsTo::intersectWithComplement: mappings of operands do not match!");
+        if (isSmall() || rhs.isSmall()) return intersectWithComplement(rhs);
+        assert(type == PointsToBacking<BitVectorTy>::type && "PointsTo::intersectWithComplement: wrong backing!");
+        const bool changed = PointsToBacking<BitVectorTy>::get(*this).intersectWithComplement(PointsToBacking<BitVectorTy>::get(rhs));
+        if (changed) demoteIfSmall();
+        return changed;
+    }
+}
+
+template <typename BitVectorTy>
+inline void PointsTo::intersectWithComplement(const PointsTo &lhs, const PointsTo &rhs)
+{
+    if constexpr (std::is_void<BitVectorTy>::value) intersectWithComplement(lhs, rhs);
+    else
+    {
+        assert(metaSame(lhs) && metaSame(rhs) && "PointsTo::intersectWithComplement: mappings of operands do not match!");
+        if (isSmall() || lhs.isSmall() || rhs.isSmall()) return intersectWithComplement(lhs, rhs);
+        assert(type == PointsToBacking<BitVectorTy>::type && "PointsTo::intersectWithComplement: wrong backing!");
+        PointsToBacking<BitVectorTy>::get(*this).intersectWithComplement(PointsToBacking<BitVectorTy>::get(lhs),
+                PointsToBacking<BitVectorTy>::get(rhs));
+        demoteIfSmall();
+    }
+}
+
+template <typename BitVectorTy>
+inline bool PointsTo::testAndSet(u32_t n)
+{
+    if constexpr (std::is_void<BitVectorTy>::value) return test_and_set(n);
+    else
+    {
+        if (isSmall()) return testAndSetInternal(getInternalNode(n));
+        assert(type == PointsToBacking<BitVectorTy>::type && "PointsTo::testAndSet: wrong backing!");
+        return PointsToBacking<BitVectorTy>::get(*this).test_and_set(getInternalNode(n));
+    }
+}
+
+template <typename BitVectorTy>
+inline void PointsTo::reset(u32_t n)
+{
+    if constexpr (std::is_void<BitVectorTy>::value) reset(n);
+    else
+    {
+        if (isSmall()) return resetInternal(getInternalNode(n));
+        assert(type == PointsToBacking<BitVectorTy>::type && "PointsTo::reset: wrong backing!");
+        PointsToBacking<BitVectorTy>::get(*this).reset(getInternalNode(n));
+        demoteIfSmall();
+    }
+}
+
+/// Set operations the points-to data structures (MutablePTData, PersistentPTData,
+/// etc.) perform on their DataSet. By default, DataSet's own operations. For
+/// PointsTo, the operations on a backing fixed to BitVectorTy.
+template <typename DataSet, typename BitVectorTy = void>
+struct DataSetOps
+{
+    static inline bool unionWith(DataSet &lhs, const DataSet &rhs)
+    {
+        return lhs |= rhs;
+    }
+    static inline bool intersectWith(DataSet &lhs, const DataSet &rhs)
+    {
+        return lhs &= rhs;
+    }
+    static inline bool intersectWithComplement(DataSet &lhs, const DataSet &rhs)
+    {
+        return lhs.intersectWithComplement(rhs);
+    }
+    static inline void intersectWithComplement(DataSet &result, const DataSet &lhs, const DataSet &rhs)
+    {
+        result.intersectWithComplement(lhs, rhs);
+    }
+    template <typename Data>
+    static inline bool testAndSet(DataSet &set, const Data &d)
+    {
+        return set.test_and_set(d);
+    }
+    template <typename Data>
+    static inline void reset(DataSet &set, const Data &d)
+    {
+        set.reset(d);
+    }
+};
+
+template <typename BitVectorTy>
+struct DataSetOps<PointsTo, BitVectorTy>
+{
+    static inline bool unionWith(PointsTo &lhs, const PointsTo &rhs)
+    {
+        return lhs.unionWith<BitVectorTy>(rhs);
+    }
+    static inline bool intersectWith(PointsTo &lhs, const PointsTo &rhs)
+    {
+        return lhs.intersectWith<BitVectorTy>(rhs);
+    }
+    static inline bool intersectWithComplement(PointsTo &lhs, const PointsTo &rhs)
+    {
+        return lhs.intersectWithComplement<BitVectorTy>(rhs);
+    }
+    static inline void intersectWithComplement(PointsTo &result, const PointsTo &lhs, const PointsTo &rhs)
+    {
+        result.intersectWithComplement<BitVectorTy>(lhs, rhs);
+    }
+    static inline bool testAndSet(PointsTo &set, NodeID n)
+    {
+        return set.testAndSet<BitVectorTy>(n);
+    }
+    static inline void reset(PointsTo &set, NodeID n)
+    {
+        set.reset<BitVectorTy>(n);
+    }
+};
+
 /// Returns a new lhs | rhs.
 PointsTo operator|(const PointsTo &lhs, const PointsTo &rhs);
 
@@ -0,0 +1,127 @@
+//===- PointsToProfiler.h -- Memory profile of points-to sets ----------------//
+
+/*
+ * PointsToProfiler.h
+ *
+ * Profiles where the memory of points-to sets goes, per analysis: set sizes,
+ * how much sets are shared, estimated bytes with each backing, and the largest
+ * sets with the nodes holding them. Profiles are written as JSON to the file
+ * given by -pts-profile when analyses finish, and on SIGUSR1 while solving.
+ */
+
+#ifndef POINTSTOPROFILER_H_
+#define POINTSTOPROFILER_H_
+
+#include <signal.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryModel/PointsTo.h"
+#include "MemoryModel/PTATY.h"
+
+namespace SVF
+{
+
+/// Collects the points-to sets a PTData holds (see PTData::visitPts) into a
+/// profile and writes the profiles of all analyses run so far.
+class PointsToProfiler
+{
+public:
+    /// Number of histogram buckets: sizes 0, 1, 2-3, 4-7, ..., and 2^30 up.
+    static const u32_t NumBuckets = 32;
+    /// Number of owners listed for each of the largest sets.
+    static const u32_t MaxOwners = 8;
+
+    /// Backings estimated: the PointsTo::Type values.
+    static const u32_t NumTypes = 4;
+
+    /// Estimated bytes of the data structure of each type holding pts,
+    /// excluding the PointsTo itself.
+    static void estimateBytes(const PointsTo &pts, u64_t bytes[NumTypes]);
+
+    /// Returns the profiler, or nullptr when -pts-profile is not set.
+    static PointsToProfiler *get(void);
+
+    /// Returns true once after a profile was requested with SIGUSR1.
+    static inline bool takeRequest(void)
+    {
+        if (!requested) return false;
+        requested = 0;
+        return true;
+    }
+
+    /// Starts the profile of analysis, which is of type ptaTy and keeps its
+    /// points-to sets in a PTData of backing.
+    void begin(const std::string &analysis, PTATY ptaTy, PTBackingType backing);
+
+    /// Adds pts, held by owner, to the current profile. pts must not change
+    /// or move until end is called.
+    void addPts(NodeID owner, const PointsTo &pts);
+
+    /// Finishes the current profile and writes all profiles. A partial
+    /// profile, taken while solving, is written but not kept.
+    void end(bool partial);
+
+private:
+    PointsToProfiler(void);
+
+    /// Hashes and compares points-to sets by value through pointers.
+    //@{
+    struct PtsPtrHash
+    {
+        size_t operator()(const PointsTo *pts) const
+        {
+            return pts->hash();
+        }
+    };
+    struct PtsPtrEqual
+    {
+        bool operator()(const PointsTo *lhs, const PointsTo *rhs) const
+        {
+            return *lhs == *rhs;
+        }
+    };
+    //@}
+
+    /// A distinct points-to set: how often it is held, and by whom.
+    struct SetInfo
+    {
+        u32_t occurrences = 0;
+        std::vector<NodeID> owners;
+    };
+
+    /// Returns the group of analyses ptaTy belongs to (Andersen, FS, ...).
+    static std::string analysisGroup(PTATY ptaTy);
+
+    /// Returns the JSON object of the current profile.
+    std::string toJSON(bool partial) const;
+
+    /// Writes the kept profiles and, if not empty, partial to -pts-profile.
+    void write(const std::string &partial) const;
+
+    static void handleSignal(int);
+
+private:
+    /// Set by SIGUSR1.
+    static volatile sig_atomic_t requested;
+
+    /// Current profile.
+    //@{
+    std::string analysis;
+    PTATY ptaTy;
+    PTBackingType backing;
+    std::unordered_map<const PointsTo *, SetInfo, PtsPtrHash, PtsPtrEqual> sets;
+    u64_t totalSets;
+    u64_t totalElements;
+    u64_t histogram[NumBuckets];
+    //@}
+
+    /// JSON of the finished profiles.
+    std::vector<std::string> profiles;
+};
+
+} // End namespace SVF
+
+#endif  // POINTSTOPROFILER_H_
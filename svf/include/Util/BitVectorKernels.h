@@ -0,0 +1,186 @@
+//===- BitVectorKernels.h -- SIMD kernels for bit vector operations ------------//
+
+/*
+ * BitVectorKernels.h
+ *
+ * Word-level kernels behind the bit vector set operations. Kernels over word
+ * arrays (CoreBitVector, BitVector) are chosen at run time according to the
+ * CPU; the two-word kernels for SparseBitVector elements are inlined and use
+ * the 128-bit SIMD every x86-64 (SSE2) and AArch64 (NEON) CPU has.
+ */
+
+#ifndef BITVECTORKERNELS_H_
+#define BITVECTORKERNELS_H_
+
+#include <stddef.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SVF_SIMD128_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SVF_SIMD128_NEON 1
+#endif
+
+namespace SVF
+{
+
+/// Kernels for set operations on arrays of words, with a scalar version and
+/// SSE4.2, AVX2 and NEON versions where the build and CPU support them.
+class BitVectorKernels
+{
+public:
+    typedef unsigned long long Word;
+
+    /// Instruction sets kernels are implemented with.
+    enum ISA
+    {
+        Scalar,
+        SSE42,
+        AVX2,
+        NEON,
+    };
+
+    /// Kernels over n words. Those writing to dst return true if dst changed.
+    struct Kernels
+    {
+        ISA isa;
+        const char *name;
+        /// dst |= src.
+        bool (*unionWith)(Word *dst, const Word *src, size_t n);
+        /// dst &= src.
+        bool (*intersectWith)(Word *dst, const Word *src, size_t n);
+        /// dst &= ~src.
+        bool (*intersectWithComplement)(Word *dst, const Word *src, size_t n);
+        /// Returns true if every bit of rhs is in lhs.
+        bool (*contains)(const Word *lhs, const Word *rhs, size_t n);
+        /// Returns true if lhs and rhs share a bit.
+        bool (*intersects)(const Word *lhs, const Word *rhs, size_t n);
+        /// Returns the number of set bits.
+        unsigned (*count)(const Word *words, size_t n);
+    };
+
+    /// Returns the best kernels for this CPU.
+    static inline const Kernels &get(void)
+    {
+        return *active;
+    }
+
+    /// Returns the kernels for isa, or nullptr if this build or CPU lacks isa.
+    static const Kernels *get(ISA isa);
+
+    /// Two-word kernels for SparseBitVector elements, same semantics as Kernels.
+    //@{
+    template <typename W>
+    static inline bool unionWith2(W *dst, const W *src)
+    {
+        static_assert(sizeof(W) == 8, "BitVectorKernels: 64-bit words expected");
+#if defined(SVF_SIMD128_SSE2)
+        const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+        const __m128i s = _mm_loadu_si128((const __m128i *)src);
+        _mm_storeu_si128((__m128i *)dst, _mm_or_si128(d, s));
+        return !isZero128(_mm_andnot_si128(d, s));
+#elif defined(SVF_SIMD128_NEON)
+        const uint64x2_t d = vld1q_u64((const uint64_t *)dst);
+        const uint64x2_t s = vld1q_u64((const uint64_t *)src);
+        vst1q_u64((uint64_t *)dst, vorrq_u64(d, s));
+        return !isZero128(vbicq_u64(s, d));
+#else
+        const W changed = (src[0] & ~dst[0]) | (src[1] & ~dst[1]);
+        dst[0] |= src[0];
+        dst[1] |= src[1];
+        return changed != 0;
+#endif
+    }
+
+    /// Also sets becameZero if dst ends up empty.
+    template <typename W>
+    static inline bool intersectWith2(W *dst, const W *src, bool &becameZero)
+    {
+        static_assert(sizeof(W) == 8, "BitVectorKernels: 64-bit words expected");
+#if defined(SVF_SIMD128_SSE2)
+        const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+        const __m128i s = _mm_loadu_si128((const __m128i *)src);
+        const __m128i r = _mm_and_si128(d, s);
+        _mm_storeu_si128((__m128i *)dst, r);
+        becameZero = isZero128(r);
+        return !isZero128(_mm_andnot_si128(s, d));
+#elif defined(SVF_SIMD128_NEON)
+        const uint64x2_t d = vld1q_u64((const uint64_t *)dst);
+        const uint64x2_t s = vld1q_u64((const uint64_t *)src);
+        const uint64x2_t r = vandq_u64(d, s);
+        vst1q_u64((uint64_t *)dst, r);
+        becameZero = isZero128(r);
+        return !isZero128(vbicq_u64(d, s));
+#else
+        const W changed = (dst[0] & ~src[0]) | (dst[1] & ~src[1]);
+        dst[0] &= src[0];
+        dst[1] &= src[1];
+        becameZero = (dst[0] | dst[1]) == 0;
+        return changed != 0;
+#endif
+    }
+
+    /// Also sets becameZero if dst ends up empty.
+    template <typename W>
+    static inline bool intersectWithComplement2(W *dst, const W *src, bool &becameZero)
+    {
+        static_assert(sizeof(W) == 8, "BitVectorKernels: 64-bit words expected");
+#if defined(SVF_SIMD128_SSE2)
+        const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+        const __m128i s = _mm_loadu_si128((const __m128i *)src);
+        const __m128i r = _mm_andnot_si128(s, d);
+        _mm_storeu_si128((__m128i *)dst, r);
+        becameZero = isZero128(r);
+        return !isZero128(_mm_and_si128(d, s));
+#elif defined(SVF_SIMD128_NEON)
+        const uint64x2_t d = vld1q_u64((const uint64_t *)dst);
+        const uint64x2_t s = vld1q_u64((const uint64_t *)src);
+        const uint64x2_t r = vbicq_u64(d, s);
+        vst1q_u64((uint64_t *)dst, r);
+        becameZero = isZero128(r);
+        return !isZero128(vandq_u64(d, s));
+#else
+        const W changed = (dst[0] & src[0]) | (dst[1] & src[1]);
+        dst[0] &= ~src[0];
+        dst[1] &= ~src[1];
+        becameZero = (dst[0] | dst[1]) == 0;
+        return changed != 0;
+#endif
+    }
+
+    template <typename W>
+    static inline bool contains2(const W *lhs, const W *rhs)
+    {
+        return ((rhs[0] & ~lhs[0]) | (rhs[1] & ~lhs[1])) == 0;
+    }
+
+    template <typename W>
+    static inline bool intersects2(const W *lhs, const W *rhs)
+    {
+        return ((lhs[0] & rhs[0]) | (lhs[1] & rhs[1])) != 0;
+    }
+    //@}
+
+private:
+    /// Kernels in use; scalar until the CPU has been checked.
+    static const Kernels *active;
+    /// Set once the CPU has been checked and active updated.
+    static const bool selected;
+
+#if defined(SVF_SIMD128_SSE2)
+    static inline bool isZero128(__m128i v)
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xFFFF;
+    }
+#elif defined(SVF_SIMD128_NEON)
+    static inline bool isZero128(uint64x2_t v)
+    {
+        return (vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1)) == 0;
+    }
+#endif
+};
+
+} // End namespace SVF
+
+#endif  // BITVECTORKERNELS_H_
@@ -199,6 +199,13 @@ public:
                                                 const size_t numObjects, const Map<NodeID, unsigned> &nodeMap,
                                                 double &distanceMatrixTime);
 
+        /// Orders the objects of a region such that objects occurring in similar points-to
+        /// sets are close, by sorting on (weighted) MinHash signatures. Near-linear in the
+        /// size of the points-to sets, unlike the distance matrix. Returns the region's
+        /// object indices (per nodeMap) in allocation order.
+        static std::vector<unsigned> minHashOrder(const std::vector<std::pair<const PointsTo *, unsigned>> &pointsToSets,
+                                                  const size_t numObjects, const Map<NodeID, unsigned> &nodeMap);
+
         /// Traverses the dendrogram produced by fastcluster, making node o, where o is the nth leaf (per
         /// recursive DFS) map to n. index is the dendrogram node to work off. The traversal should start
         /// at the top, which is the "last" (consider that it is 2D) element of the dendrogram, numObjects - 1.
@@ -45,6 +45,9 @@ public:
     /// Type of points-to set to use for all analyses.
     static const OptionMap<PointsTo::Type> PtType;
 
+    /// Hold small points-to sets inline rather than in a PtType data structure.
+    static const Option<bool> PtInline;
+
     /// Clustering method for ClusterFs/ClusterAnder.
     /// TODO: we can separate it into two options, and make Clusterer::cluster take in a method
     ///       argument rather than plugging Options::ClusterMethod *inside* Clusterer::cluster
@@ -57,6 +60,9 @@ public:
     /// Align identifiers in each region to a word.
     static const Option<bool> RegionAlign;
 
+    /// Number of threads clustering regions.
+    static const Option<u32_t> ClusterThreads;
+
     /// Predict occurrences of points-to sets in the staged points-to set to
     /// weigh more common points-to sets as more important.
     static const Option<bool> PredictPtOcc;
@@ -64,14 +70,45 @@ public:
     /// PTData type.
     static const OptionMap<PTBackingType> ptDataBacking;
 
+    /// Memory limit in MB of the persistent points-to cache's operation caches (0 for none).
+    static const Option<u32_t> PtCacheOpLimit;
+
+    /// Reclaim persistent points-to sets no longer referenced.
+    static const Option<bool> PtCacheGC;
+
+    /// File to write points-to memory profiles to (empty for none).
+    static const Option<std::string> PtsProfile;
+    /// Number of largest points-to sets listed in each profile.
+    static const Option<u32_t> PtsProfileTop;
+
+    /// Worklist order of the Andersen's and flow-sensitive solvers.
+    static const OptionMap<WorklistOrder> WPAWorklistOrder;
+
     /// Time limit for the main phase (i.e., the actual solving) of FS analyses.
     static const Option<u32_t> FsTimeLimit;
 
+    /// Threads for sparse flow-sensitive solving.
+    static const Option<u32_t> FsThreads;
+
     /// Time limit for the Andersen's analyses.
     static const Option<u32_t> AnderTimeLimit;
 
+    /// Number of threads for the load/store phase of wave propagation Andersen's.
+    static const Option<u32_t> AnderThreads;
+    static const Option<bool> AnderHU;
+    static const Option<bool> AnderSteensPartition;
+    /// File or FIFO receiving one JSON line per Andersen's iteration.
+    static const Option<std::string> AnderTelemetry;
+    /// Checkpoint file written periodically while solving Andersen's analysis, and its period in seconds.
+    static const Option<std::string> AnderCheckpoint;
+    static const Option<u32_t> AnderCheckpointInterval;
+    /// Resume Andersen's analysis from a checkpoint file.
+    static const Option<std::string> AnderResume;
+
     /// Number of threads for the versioning phase.
     static const Option<u32_t> VersioningThreads;
+    /// File caching the versioning of versioned flow-sensitive analysis.
+    static const Option<std::string> VersioningPlan;
 
     // ContextDDA.cpp
     static const Option<u32_t> CxtBudget;
@@ -130,9 +167,13 @@ public:
 
     // PointerAnalysisImpl.cpp
     static const Option<bool> INCDFPTData;
+    /// Compact IN/OUT sets for flow-sensitive analysis (CompactDFPTData).
+    static const Option<bool> CompactDFPTData;
 
     // Memory region (MemRegion.cpp)
     static const Option<bool> IgnoreDeadFun;
+    /// Number of threads building memory SSA and collecting mod-ref of loads/stores.
+    static const Option<u32_t> MSSAThreads;
 
     // Base class of pointer analyses (MemSSA.cpp)
     static const Option<bool> DumpMSSA;
@@ -202,6 +243,8 @@ public:
     static const Option<std::string> WriteAnder;
     // static const Option<string> ReadAnder;
     static const Option<std::string> ReadAnder;
+    static const Option<bool> BinaryAnder;
+    static const Option<std::string> IncrementalAnder;
     static const Option<bool> DiffPts;
     static Option<bool> DetectPWC;
     static const Option<bool> VtableInSVFIR;
@@ -0,0 +1,127 @@
+//===- PhaseRunner.h -- Phases run on a fixed set of threads-----------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * PhaseRunner.h
+ *
+ * A pool of threads kept across the phases of a solver, so that short phases
+ * do not pay for creating and joining threads.
+ */
+
+#ifndef INCLUDE_UTIL_PHASERUNNER_H_
+#define INCLUDE_UTIL_PHASERUNNER_H_
+
+#include "Util/GeneralType.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SVF
+{
+
+/// Runs phases on a fixed set of threads, the calling thread being thread 0.
+class PhaseRunner
+{
+public:
+    explicit PhaseRunner(u32_t numOfThreads)
+        : numOfThreads(numOfThreads), phase(nullptr), generation(0), busyThreads(0), done(false)
+    {
+        for (u32_t t = 1; t < numOfThreads; ++t) threads.push_back(std::thread(&PhaseRunner::work, this, t));
+    }
+
+    ~PhaseRunner()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        started.notify_all();
+        for (std::thread &thread : threads) thread.join();
+    }
+
+    inline u32_t getNumOfThreads() const
+    {
+        return numOfThreads;
+    }
+
+    /// Runs phase(t) on every thread t, returning once all have returned.
+    void run(const std::function<void(u32_t)> &phase)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->phase = &phase;
+            busyThreads = numOfThreads - 1;
+            ++generation;
+        }
+        started.notify_all();
+
+        phase(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]()
+        {
+            return busyThreads == 0;
+        });
+    }
+
+private:
+    void work(const u32_t t)
+    {
+        u32_t ranGeneration = 0;
+        while (true)
+        {
+            const std::function<void(u32_t)> *toRun;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                started.wait(lock, [&]()
+                {
+                    return done || generation != ranGeneration;
+                });
+                if (done) return;
+                ranGeneration = generation;
+                toRun = phase;
+            }
+
+            (*toRun)(t);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyThreads == 0) finished.notify_one();
+        }
+    }
+
+    const u32_t numOfThreads;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    const std::function<void(u32_t)> *phase;
+    u32_t generation;
+    u32_t busyThreads;
+    bool done;
+};
+
+} // End namespace SVF
+
+#endif /* INCLUDE_UTIL_PHASERUNNER_H_ */
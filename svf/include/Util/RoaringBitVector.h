@@ -0,0 +1,282 @@
+//===- RoaringBitVector.h -- Hybrid container bit vector data structure ------------//
+
+/*
+ * RoaringBitVector.h
+ *
+ * Bit vector split into 64K chunks, each stored as a sorted array, a bitmap,
+ * or a list of runs, whichever is smallest.
+ */
+
+#ifndef ROARINGBITVECTOR_H_
+#define ROARINGBITVECTOR_H_
+
+#include <assert.h>
+#include <vector>
+
+#include "Util/GeneralType.h"
+
+namespace SVF
+{
+
+/// A bit vector in the style of roaring bitmaps. Bits are grouped in chunks of
+/// 64K by their high 16 bits, and each non-empty chunk is held in a container:
+///  - an array container: sorted low 16 bits, for sparse chunks,
+///  - a bitmap container: 1024 words, for dense chunks,
+///  - a run container: sorted [start, last] pairs, for chunks made of long
+///    runs (e.g. the fields of an array or struct).
+/// Containers are always kept in the smallest of the three forms, so two equal
+/// sets have the same representation; equality and hashing are structural.
+/// Abbreviated RBV.
+class RoaringBitVector
+{
+public:
+    typedef unsigned long long Word;
+    static const size_t WordSize;
+
+    class RoaringBitVectorIterator;
+    typedef RoaringBitVectorIterator const_iterator;
+    typedef const_iterator iterator;
+
+public:
+    /// Construct empty RBV.
+    RoaringBitVector(void);
+
+    /// Copy constructor.
+    RoaringBitVector(const RoaringBitVector &rbv);
+
+    /// Move constructor.
+    RoaringBitVector(RoaringBitVector &&rbv);
+
+    /// Copy assignment.
+    RoaringBitVector &operator=(const RoaringBitVector &rhs);
+
+    /// Move assignment.
+    RoaringBitVector &operator=(RoaringBitVector &&rhs);
+
+    /// Returns true if no bits are set.
+    bool empty(void) const;
+
+    /// Returns number of bits set.
+    u32_t count(void) const;
+
+    /// Empty the RBV.
+    void clear(void);
+
+    /// Returns true if bit is set in this RBV.
+    bool test(u32_t bit) const;
+
+    /// Check if bit is set. If it is, returns false.
+    /// Otherwise, sets bit and returns true.
+    bool test_and_set(u32_t bit);
+
+    /// Sets bit in the RBV.
+    void set(u32_t bit);
+
+    /// Resets bit in the RBV.
+    void reset(u32_t bit);
+
+    /// Returns true if this RBV is a superset of rhs.
+    bool contains(const RoaringBitVector &rhs) const;
+
+    /// Returns true if this RBV and rhs share any set bits.
+    bool intersects(const RoaringBitVector &rhs) const;
+
+    /// Returns true if this RBV and rhs have the same bits set.
+    bool operator==(const RoaringBitVector &rhs) const;
+
+    /// Returns true if either this RBV or rhs has a bit set unique to the other.
+    bool operator!=(const RoaringBitVector &rhs) const;
+
+    /// Put union of this RBV and rhs into this RBV.
+    /// Returns true if RBV changed.
+    bool operator|=(const RoaringBitVector &rhs);
+
+    /// Put intersection of this RBV and rhs into this RBV.
+    /// Returns true if RBV changed.
+    bool operator&=(const RoaringBitVector &rhs);
+
+    /// Remove set bits in rhs from this RBV.
+    /// Returns true if RBV changed.
+    bool operator-=(const RoaringBitVector &rhs);
+
+    /// Put intersection of this RBV with complement of rhs into this RBV.
+    /// Returns true if this RBV changed.
+    bool intersectWithComplement(const RoaringBitVector &rhs);
+
+    /// Put intersection of lhs with complement of rhs into this RBV.
+    void intersectWithComplement(const RoaringBitVector &lhs, const RoaringBitVector &rhs);
+
+    /// Hash for this RBV.
+    size_t hash(void) const;
+
+    const_iterator begin(void) const;
+    const_iterator end(void) const;
+
+private:
+    /// Number of bits in a chunk, and limits of the container forms.
+    static const u32_t ChunkSize = 1 << 16;
+    static const u32_t BitmapWords = ChunkSize / 64;
+    static const u32_t MaxArraySize = 4096;
+
+    enum ContainerKind
+    {
+        ArrayContainer,
+        BitmapContainer,
+        RunContainer,
+    };
+
+    /// Bits of one chunk.
+    struct Container
+    {
+        /// High 16 bits of every bit in this container.
+        u32_t key;
+        ContainerKind kind;
+        /// Number of bits set.
+        u32_t card;
+        /// Number of maximal runs of consecutive set bits, whatever the kind.
+        u32_t runs;
+        /// ArrayContainer: sorted low bits.
+        /// RunContainer: start and last low bit of each run, in order.
+        std::vector<u16_t> vals;
+        /// BitmapContainer: BitmapWords words.
+        std::vector<Word> words;
+
+        Container(u32_t key) : key(key), kind(ArrayContainer), card(0), runs(0) { }
+
+        bool operator==(const Container &rhs) const
+        {
+            return key == rhs.key && kind == rhs.kind && card == rhs.card
+                   && vals == rhs.vals && words == rhs.words;
+        }
+    };
+
+    /// Run [first, second] of low bits.
+    typedef std::pair<u32_t, u32_t> Interval;
+    typedef std::vector<Interval> Intervals;
+
+    /// Binary operations on containers.
+    enum Op
+    {
+        OrOp,
+        AndOp,
+        AndNotOp,
+    };
+
+    /// Returns the container for key, or nullptr.
+    const Container *findContainer(u32_t key) const;
+
+    /// Returns the index of the container for key, or where it would be inserted.
+    size_t containerIndex(u32_t key) const;
+
+    /// Returns true if low is set in c.
+    static bool containerTest(const Container &c, u32_t low);
+
+    /// Sets low in c. Returns true if it was not set.
+    static bool containerSet(Container &c, u32_t low);
+
+    /// Resets low in c. Returns true if it was set.
+    static bool containerReset(Container &c, u32_t low);
+
+    /// Index of the run of c which starts at or before low, or runs if none.
+    static size_t runIndex(const Container &c, u32_t low);
+
+    /// Convert c to the smallest form for its cardinality and number of runs.
+    static void canonicalise(Container &c);
+
+    /// Returns the smallest form for a container.
+    static ContainerKind bestKind(u32_t card, u32_t runs);
+
+    /// Fills intervals with the runs of c.
+    static void toIntervals(const Container &c, Intervals &intervals);
+
+    /// Fills words (BitmapWords long) with the bits of c.
+    static void toWords(const Container &c, Word *words);
+
+    /// Rebuilds c, in its smallest form, from runs or words.
+    //@{
+    static void fromIntervals(Container &c, const Intervals &intervals);
+    static void fromWords(Container &c, const Word *words);
+    //@}
+
+    /// Returns lhs op rhs (same key).
+    static Container combine(const Container &lhs, const Container &rhs, Op op);
+
+    /// Returns the number of bits set in both lhs and rhs (same key).
+    static u32_t intersectionCount(const Container &lhs, const Container &rhs);
+
+    /// this = lhs op rhs. Returns true if this changed, assuming this is lhs.
+    bool apply(const RoaringBitVector &lhs, const RoaringBitVector &rhs, Op op);
+
+public:
+    class RoaringBitVectorIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = u32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = u32_t *;
+        using reference = u32_t &;
+
+        RoaringBitVectorIterator(void) = delete;
+
+        /// Returns an iterator to the beginning of rbv if end is false, and to
+        /// the end of rbv if end is true.
+        RoaringBitVectorIterator(const RoaringBitVector *rbv, bool end=false);
+
+        RoaringBitVectorIterator(const RoaringBitVectorIterator &rbv) = default;
+        RoaringBitVectorIterator(RoaringBitVectorIterator &&rbv) = default;
+
+        RoaringBitVectorIterator &operator=(const RoaringBitVectorIterator &rbv) = default;
+        RoaringBitVectorIterator &operator=(RoaringBitVectorIterator &&rbv) = default;
+
+        /// Pre-increment: ++it.
+        const RoaringBitVectorIterator &operator++(void);
+
+        /// Post-increment: it++.
+        const RoaringBitVectorIterator operator++(int);
+
+        /// Dereference: *it.
+        u32_t operator*(void) const;
+
+        /// Equality: *this == rhs.
+        bool operator==(const RoaringBitVectorIterator &rhs) const;
+
+        /// Inequality: *this != rhs.
+        bool operator!=(const RoaringBitVectorIterator &rhs) const;
+
+    private:
+        bool atEnd(void) const;
+
+        /// Moves to the first bit of the container at containerIdx, or to the
+        /// end if there is none.
+        void enterContainer(void);
+
+    private:
+        /// RoaringBitVector we are iterating over.
+        const RoaringBitVector *rbv;
+        /// Container we are looking at.
+        size_t containerIdx;
+        /// Array: index into vals. Run: index of the run.
+        /// Bitmap: unused.
+        u32_t pos;
+        /// Low bits of the current bit.
+        u32_t low;
+    };
+
+private:
+    /// Non-empty containers, ordered by key.
+    std::vector<Container> containers;
+};
+
+template <>
+struct Hash<RoaringBitVector>
+{
+    size_t operator()(const RoaringBitVector &rbv) const
+    {
+        return rbv.hash();
+    }
+};
+
+} // End namespace SVF
+
+#endif  // ROARINGBITVECTOR_H_
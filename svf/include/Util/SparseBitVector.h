@@ -17,6 +17,7 @@
 #include <list>
 
 #include "Util/Hash.h"
+#include "Util/BitVectorKernels.h"
 
 // Appease GCC?
 #ifdef __has_builtin
@@ -274,6 +275,9 @@ public:
     };
 
 private:
+    // Whether the two-word SIMD kernels apply to this element.
+    static constexpr bool UseKernels2 = BITWORDS_PER_ELEMENT == 2 && sizeof(BitWord) == 8;
+
     // Index of Element in terms of where first bit starts.
     unsigned ElementIndex = 0;
     BitWord Bits[BITWORDS_PER_ELEMENT] = {0};
@@ -406,6 +410,9 @@ public:
     // Union this element with RHS and return true if this one changed.
     bool unionWith(const SparseBitVectorElement &RHS)
     {
+        if constexpr (UseKernels2)
+            return BitVectorKernels::unionWith2(Bits, RHS.Bits);
+
         bool changed = false;
         for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i)
         {
@@ -421,6 +428,9 @@ public:
     // Return true if we have any bits in common with RHS
     bool intersects(const SparseBitVectorElement &RHS) const
     {
+        if constexpr (UseKernels2)
+            return BitVectorKernels::intersects2(Bits, RHS.Bits);
+
         for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i)
         {
             if (RHS.Bits[i] & Bits[i])
@@ -429,11 +439,28 @@ public:
         return false;
     }
 
+    // Return true if all bits set in RHS are also set in this element.
+    bool contains(const SparseBitVectorElement &RHS) const
+    {
+        if constexpr (UseKernels2)
+            return BitVectorKernels::contains2(Bits, RHS.Bits);
+
+        for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i)
+        {
+            if (RHS.Bits[i] & ~Bits[i])
+                return false;
+        }
+        return true;
+    }
+
     // Intersect this Element with RHS and return true if this one changed.
     // BecameZero is set to true if this element became all-zero bits.
     bool intersectWith(const SparseBitVectorElement &RHS,
                        bool &BecameZero)
     {
+        if constexpr (UseKernels2)
+            return BitVectorKernels::intersectWith2(Bits, RHS.Bits, BecameZero);
+
         bool changed = false;
         bool allzero = true;
 
@@ -459,6 +486,9 @@ public:
     bool intersectWithComplement(const SparseBitVectorElement &RHS,
                                  bool &BecameZero)
     {
+        if constexpr (UseKernels2)
+            return BitVectorKernels::intersectWithComplement2(Bits, RHS.Bits, BecameZero);
+
         bool changed = false;
         bool allzero = true;
 
@@ -1116,9 +1146,22 @@ public:
     // also set in RHS.
     bool contains(const SparseBitVector<ElementSize> &RHS) const
     {
-        SparseBitVector<ElementSize> Result(*this);
-        Result &= RHS;
-        return (Result == RHS);
+        ElementListConstIter Iter1 = Elements.begin();
+        ElementListConstIter Iter2 = RHS.Elements.begin();
+
+        // Every element of RHS needs a matching element here covering it.
+        for (; Iter2 != RHS.Elements.end(); ++Iter2)
+        {
+            while (Iter1 != Elements.end() && Iter1->index() < Iter2->index())
+                ++Iter1;
+
+            if (Iter1 == Elements.end() || Iter1->index() != Iter2->index())
+                return false;
+
+            if (!Iter1->contains(*Iter2))
+                return false;
+        }
+        return true;
     }
 
     // Return the first set bit in the bitmap.  Return -1 if no bits are set.
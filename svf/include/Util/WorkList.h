@@ -42,6 +42,9 @@
 #include <deque>
 #include <list>
 #include <set>
+#include <queue>
+#include <algorithm>
+#include <tuple>
 
 #include "Util/GeneralType.h"
 
@@ -189,6 +192,12 @@ public:
             return false;
     }
 
+    /// The data in the work list in pop order, without popping
+    inline std::vector<Data> toVector() const
+    {
+        return std::vector<Data>(data_list.begin(), data_list.end());
+    }
+
     /**
      * Remove a data from the END of work list, no return value
      */
@@ -341,6 +350,112 @@ private:
     DataVector data_list;    ///< work list using std::vector.
 };
 
+/**
+ * Worklist with "smallest priority first" order.
+ * Elements with equal priority are popped in the order they were pushed.
+ * Elements in the list are unique; pushing an element already in the list
+ * only lowers its priority.
+ */
+template<class Data, class Priority = u64_t>
+class PriorityWorkList
+{
+    typedef std::pair<Priority, u64_t> Key;   ///< priority and push sequence number
+    typedef std::tuple<Priority, u64_t, Data> Entry;
+    typedef std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> EntryQueue;
+    typedef Map<Data, Key> DataToKeyMap;
+public:
+    PriorityWorkList() : seq(0) {}
+
+    ~PriorityWorkList() {}
+
+    inline bool empty() const
+    {
+        return data_key.empty();
+    }
+
+    inline u32_t size() const
+    {
+        return data_key.size();
+    }
+
+    inline bool find(const Data &data) const
+    {
+        return data_key.find(data) != data_key.end();
+    }
+
+    /**
+     * Push a data into the work list, or lower its priority if it is already
+     * in the list. Return true if the data was not in the list.
+     */
+    inline bool push(const Data &data, Priority priority)
+    {
+        typename DataToKeyMap::iterator it = data_key.find(data);
+        if (it == data_key.end())
+        {
+            Key key = std::make_pair(priority, seq++);
+            data_key.emplace(data, key);
+            entries.emplace(key.first, key.second, data);
+            return true;
+        }
+        if (priority < it->second.first)
+        {
+            // The old entry becomes stale and is skipped by pop().
+            it->second = std::make_pair(priority, seq++);
+            entries.emplace(it->second.first, it->second.second, data);
+        }
+        return false;
+    }
+
+    /**
+     * Pop the data with the smallest priority.
+     */
+    inline Data pop()
+    {
+        assert(!empty() && "work list is empty");
+        while (true)
+        {
+            Entry entry = entries.top();
+            entries.pop();
+            const Data& data = std::get<2>(entry);
+            typename DataToKeyMap::iterator it = data_key.find(data);
+            if (it != data_key.end() && it->second == std::make_pair(std::get<0>(entry), std::get<1>(entry)))
+            {
+                data_key.erase(it);
+                return data;
+            }
+        }
+    }
+
+    /// The data in the work list in pop order, without popping
+    inline std::vector<Data> toVector() const
+    {
+        std::vector<std::pair<Key, Data>> keyed;
+        keyed.reserve(data_key.size());
+        for (const auto& it : data_key)
+            keyed.emplace_back(it.second, it.first);
+        std::sort(keyed.begin(), keyed.end());
+        std::vector<Data> vec;
+        vec.reserve(keyed.size());
+        for (const auto& it : keyed)
+            vec.push_back(it.second);
+        return vec;
+    }
+
+    /*!
+     * Clear all the data
+     */
+    inline void clear()
+    {
+        entries = EntryQueue();
+        data_key.clear();
+    }
+
+private:
+    DataToKeyMap data_key;  ///< current key of each data in the work list.
+    EntryQueue entries;     ///< may hold stale entries of re-prioritised data.
+    u64_t seq;
+};
+
 } // End namespace SVF
 
 #endif /* WORKLIST_H_ */
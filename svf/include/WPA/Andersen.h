@@ -42,6 +42,7 @@
 #include "Graphs/ConsG.h"
 #include "Util/GeneralType.h"
 #include "Util/Options.h"
+#include "Util/PhaseRunner.h"
 
 namespace SVF
 {
@@ -63,7 +64,8 @@ public:
 
     /// Constructor
     AndersenBase(SVFIR* _pag, PTATY type = PTATY::Andersen_BASE, bool alias_check = true)
-        :  BVDataPTAImpl(_pag, type, alias_check), consCG(nullptr)
+        :  BVDataPTAImpl(_pag, type, alias_check), consCG(nullptr), checkpointing(false),
+           resumedFromCheckpoint(false), checkpointSolveStart(0), lastCheckpoint(0), checkpointFingerprint(0)
     {
         iterationForPrintStat = OnTheFlyIterBudgetForStat;
     }
@@ -78,8 +80,21 @@ public:
 
     virtual void readPtsFromFile(const std::string& filename);
 
+    /// Re-analyze from a previous -write-ander result, reusing its points-to
+    /// sets where the constraints did not change. Solvers without incremental
+    /// support analyze from scratch.
+    virtual void incrementalSolve(const std::string& filename);
+
+    /// Continue solving from a -ander-checkpoint file. Solvers without
+    /// checkpoint support analyze from scratch.
+    virtual void resumeSolve(const std::string& filename);
+
     virtual void solveConstraints();
 
+    /// Write one JSON line describing the progress of the current iteration
+    /// to the -ander-telemetry sink
+    void writeTelemetry(std::ostream& os, double solveStart, u32_t newIndCallEdges);
+
     /// Initialize analysis
     virtual void initialize() override;
 
@@ -113,6 +128,8 @@ public:
                  || pta->getAnalysisTy() == PTATY::AndersenWaveDiff_WPA
                  || pta->getAnalysisTy() == PTATY::AndersenSCD_WPA
                  || pta->getAnalysisTy() == PTATY::AndersenSFR_WPA
+                 || pta->getAnalysisTy() == PTATY::AndersenLCD_WPA
+                 || pta->getAnalysisTy() == PTATY::AndersenHLCD_WPA
                  || pta->getAnalysisTy() == PTATY::TypeCPP_WPA
                  || pta->getAnalysisTy() == PTATY::Steensgaard_WPA);
     }
@@ -150,6 +167,22 @@ public:
     /// remove redundant gepnodes in constraint graph
     void cleanConsCG(NodeID id);
 
+    /// Constraints grouped by the function owning them, used to diff two runs
+    //@{
+    typedef std::tuple<ConstraintEdge::GEdgeKind, NodeID, NodeID, APOffset> ConstraintTuple;
+    typedef OrderedMap<std::string, std::vector<ConstraintTuple>> FunToConstraintsMap;
+    /// Identity of a node across runs, as any edit shifts the ids of the nodes
+    /// created after it: function, kind, name, and the ordinal among the nodes
+    /// sharing these three (in id order).
+    typedef std::tuple<std::string, u32_t, std::string, u32_t> NodeKey;
+    typedef Map<NodeID, NodeKey> NodeToKeyMap;
+    void collectConstraints(FunToConstraintsMap& funToCons) const;
+    void collectNodeKeys(NodeToKeyMap& nodeKeys) const;
+    void writeConstraintsToFile(const std::string& filename) const;
+    bool readConstraintsFromFile(const std::string& filename, FunToConstraintsMap& funToCons,
+                                 NodeToKeyMap& nodeKeys) const;
+    //@}
+
     NodeBS redundantGepNodes;
 
     /// Statistics
@@ -163,6 +196,7 @@ public:
     static u32_t numOfFieldExpand;
 
     static u32_t numOfSCCDetection;
+    static u32_t numOfSCCMerged;           /// Number of non-trivial SCCs merged
     static double timeOfSCCDetection;
     static double timeOfSCCMerges;
     static double timeOfCollapse;
@@ -171,11 +205,45 @@ public:
     static double timeOfProcessCopyGep;
     static double timeOfProcessLoadStore;
     static double timeOfUpdateCallGraph;
+    static double timeOfCollectLoadStore;
+    static double timeOfAddLoadStoreEdges;
+    static u32_t numOfIncChangedFuns;      /// Number of functions whose constraints changed
+    static u32_t numOfIncAddedCons;        /// Number of added constraints
+    static u32_t numOfIncRemovedCons;      /// Number of removed constraints
+    static u32_t numOfIncAffectedNodes;    /// Number of nodes recomputed from scratch
+    static u32_t numOfSteensPartitions;    /// Number of Steensgaard partitions
+    static u32_t numOfSolvedPartitions;    /// Number of partitions solved separately
+    static double timeOfPartitionSolve;
+    static double timeOfIncResume;
+    static u32_t numOfOfflineMerged;       /// Number of nodes merged by the offline pre-pass
+    static double timeOfOfflineReduction;
+    static u32_t numOfCheckpoints;
+    static double timeOfCheckpoint;
     //@}
 
 protected:
     /// Constraint Graph
     ConstraintGraph* consCG;
+
+    /// Checkpointing of the solver state (-ander-checkpoint, -ander-resume)
+    //@{
+    virtual bool isCheckpointable() const
+    {
+        return false;
+    }
+    virtual bool writeCheckpoint(const std::string&)
+    {
+        return false;
+    }
+    /// Write a checkpoint if the interval (or the time limit) has elapsed
+    void checkpointIfDue();
+
+    bool checkpointing;             ///< Whether checkpoints are written while solving
+    bool resumedFromCheckpoint;     ///< Whether the solver state was restored from a checkpoint
+    double checkpointSolveStart;
+    double lastCheckpoint;
+    u64_t checkpointFingerprint;    ///< SVFIR fingerprint before solving
+    //@}
     CallSite2DummyValPN
     callsite2DummyValPN; ///< Map an instruction to a dummy obj which
     ///< created at an indirect callsite, which invokes
@@ -211,6 +279,15 @@ public:
     /// Finalize analysis
     virtual void finalize();
 
+    /// Re-analyze from a previous -write-ander result
+    virtual void incrementalSolve(const std::string& filename) override;
+
+    /// Continue solving from a -ander-checkpoint file
+    virtual void resumeSolve(const std::string& filename) override;
+
+    /// Solve constraints, after the offline reduction if enabled
+    virtual void solveConstraints() override;
+
     /// Reset data
     inline void resetData()
     {
@@ -218,6 +295,8 @@ public:
         MaxPointsToSetSize = 0;
         timeOfProcessCopyGep = 0;
         timeOfProcessLoadStore = 0;
+        timeOfCollectLoadStore = 0;
+        timeOfAddLoadStoreEdges = 0;
     }
 
     /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -231,7 +310,9 @@ public:
         return (pta->getAnalysisTy() == PTATY::Andersen_WPA
                 || pta->getAnalysisTy() == PTATY::AndersenWaveDiff_WPA
                 || pta->getAnalysisTy() == PTATY::AndersenSCD_WPA
-                || pta->getAnalysisTy() == PTATY::AndersenSFR_WPA);
+                || pta->getAnalysisTy() == PTATY::AndersenSFR_WPA
+                || pta->getAnalysisTy() == PTATY::AndersenLCD_WPA
+                || pta->getAnalysisTy() == PTATY::AndersenHLCD_WPA);
     }
     //@}
 
@@ -300,7 +381,18 @@ protected:
         }
     }
 
-    virtual void initWorklist() {}
+    /// Rank the nodes once up front when the worklist is topologically ordered
+    virtual void initWorklist()
+    {
+        if (getWorklistOrder() == TopoWorklist)
+            SCCDetect();
+    }
+
+    /// Points-to set size, for the PtsDeltaWorklist order
+    virtual inline u32_t getWorklistWeight(NodeID id) override
+    {
+        return getPts(id).count();
+    }
 
     /// Override WPASolver function in order to use the default solver
     virtual void processNode(NodeID nodeId);
@@ -319,6 +411,18 @@ protected:
     virtual bool processGepPts(const PointsTo& pts, const GepCGEdge* edge);
     //@}
 
+    /// Whether processing a load/store on object node may introduce a copy edge
+    //@{
+    inline bool isLoadCopyCandidate(NodeID node, const ConstraintEdge* load) const
+    {
+        return !pag->isConstantObj(node) && pag->getSVFVar(load->getDstID())->isPointer();
+    }
+    inline bool isStoreCopyCandidate(NodeID node, const ConstraintEdge* store) const
+    {
+        return !pag->isConstantObj(node) && pag->getSVFVar(store->getSrcID())->isPointer();
+    }
+    //@}
+
     /// Add copy edge on constraint graph
     virtual inline bool addCopyEdge(NodeID src, NodeID dst)
     {
@@ -351,6 +455,12 @@ protected:
     /// Updates subnodes of its rep, and rep node of its subs
     void updateNodeRepAndSubs(NodeID nodeId,NodeID newRepId);
 
+    /// Merge the pointer-equivalent nodes found by the offline pre-pass
+    void mergeOfflineEquivalentNodes();
+
+    /// Solve each Steensgaard partition of the constraint graph separately
+    void solvePartitions();
+
     /// SCC detection
     virtual NodeStack& SCCDetect();
 
@@ -387,6 +497,26 @@ protected:
     /// Runs a Steensgaard analysis and performs clustering based on those
     /// results set the global best mapping.
     virtual void cluster(void) const;
+
+    /// Incremental analysis
+    //@{
+    /// Seed the solver from a previous result, returns false if it cannot be reused
+    bool resumeFromSnapshot(const PtsSnapshot& snapshot, const FunToConstraintsMap& prevCons,
+                            const NodeToKeyMap& prevNodeKeys);
+    /// Nodes whose points-to sets may shrink after removing the given constraints,
+    /// in addition to those already in affected
+    void computeAffectedNodes(const std::vector<ConstraintTuple>& removed, NodeBS& affected);
+    /// Re-add the copy edges implied by loads and stores under the current points-to sets
+    void rebuildLoadStoreCopyEdges();
+    //@}
+
+    /// Checkpointing
+    //@{
+    virtual bool isCheckpointable() const override;
+    virtual bool writeCheckpoint(const std::string& filename) override;
+    /// Restore the solver state from a checkpoint, returns false (changing nothing) if it cannot be used
+    bool readCheckpoint(const std::string& filename);
+    //@}
 };
 
 
@@ -428,6 +558,18 @@ public:
     virtual void postProcessNode(NodeID nodeId);
     virtual bool handleLoad(NodeID id, const ConstraintEdge* load);
     virtual bool handleStore(NodeID id, const ConstraintEdge* store);
+
+protected:
+    /// Load/store phase using Options::AnderThreads() threads.
+    /// New copy edges are discovered concurrently but added in worklist order,
+    /// so the constraint graph evolves exactly as in the sequential phase.
+    /// Subclasses (other analysis types) may change how loads and stores are
+    /// handled, so they always run the sequential phase.
+    virtual void parallelPostProcessNodes();
+
+private:
+    /// Threads of the parallel load/store phase, kept across waves
+    std::unique_ptr<PhaseRunner> loadStoreRunner;
 };
 
 } // End namespace SVF
@@ -0,0 +1,135 @@
+//===- AndersenLCD.h -- Lazy cycle detection based Andersen's analysis--------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * AndersenLCD.h
+ *
+ * Lazy cycle detection (LCD) and its hybrid with offline pointer
+ * equivalence, following Hardekopf and Lin, "The Ant and the Grasshopper:
+ * Fast and Accurate Pointer Analysis for Millions of Lines of Code", PLDI'07.
+ */
+
+#ifndef INCLUDE_WPA_ANDERSENLCD_H_
+#define INCLUDE_WPA_ANDERSENLCD_H_
+
+#include "WPA/Andersen.h"
+#include "MemoryModel/PTATY.h"
+
+namespace SVF
+{
+
+/*!
+ * Lazy Cycle Detection Based Andersen Analysis
+ *
+ * Instead of running an SCC detection over the whole constraint graph every
+ * wave, nodes are solved in worklist order and a cycle is only looked for when
+ * propagating along a copy edge src-->dst leaves pts(src) == pts(dst), which is
+ * what a cycle through that edge would produce. Each edge triggers at most one
+ * detection, and the detection only visits nodes reachable from the triggers.
+ */
+class AndersenLCD : public AndersenWaveDiff
+{
+protected:
+    static AndersenLCD* lcdAndersen;
+    NodeSet lcdCandidates;      ///< Nodes to start the next cycle detection from
+    NodePairSet checkedEdges;   ///< Copy edges which have already triggered a detection
+
+public:
+    AndersenLCD(SVFIR* _pag, PTATY type = PTATY::AndersenLCD_WPA, bool alias_check = true) :
+        AndersenWaveDiff(_pag, type, alias_check)
+    {
+    }
+
+    /// Create an singleton instance directly instead of invoking llvm pass manager
+    static AndersenLCD* createAndersenLCD(SVFIR* _pag)
+    {
+        if (lcdAndersen == nullptr)
+        {
+            lcdAndersen = new AndersenLCD(_pag);
+            lcdAndersen->analyze();
+            return lcdAndersen;
+        }
+        return lcdAndersen;
+    }
+
+    static void releaseAndersenLCD()
+    {
+        if (lcdAndersen)
+            delete lcdAndersen;
+        lcdAndersen = nullptr;
+    }
+
+    virtual void solveWorklist();
+
+protected:
+    /// Process a node as Andersen's does, loads and stores included
+    virtual void processNode(NodeID nodeId);
+
+    virtual bool processCopy(NodeID node, const ConstraintEdge* edge);
+
+    /// SCC detection starting from the lazy candidates only
+    virtual NodeStack& SCCDetect();
+};
+
+/*!
+ * Hybrid Lazy Cycle Detection Based Andersen Analysis
+ *
+ * Pointers which are equivalent by construction (including every node of an
+ * initial copy cycle) are merged offline before solving, and cycles created
+ * during solving are left to lazy cycle detection.
+ */
+class AndersenHLCD : public AndersenLCD
+{
+private:
+    static AndersenHLCD* hlcdAndersen;
+
+public:
+    AndersenHLCD(SVFIR* _pag, PTATY type = PTATY::AndersenHLCD_WPA, bool alias_check = true) :
+        AndersenLCD(_pag, type, alias_check)
+    {
+    }
+
+    /// Create an singleton instance directly instead of invoking llvm pass manager
+    static AndersenHLCD* createAndersenHLCD(SVFIR* _pag)
+    {
+        if (hlcdAndersen == nullptr)
+        {
+            hlcdAndersen = new AndersenHLCD(_pag);
+            hlcdAndersen->analyze();
+            return hlcdAndersen;
+        }
+        return hlcdAndersen;
+    }
+
+    static void releaseAndersenHLCD()
+    {
+        if (hlcdAndersen)
+            delete hlcdAndersen;
+        hlcdAndersen = nullptr;
+    }
+
+    virtual void solveConstraints();
+};
+
+} // End namespace SVF
+
+#endif /* INCLUDE_WPA_ANDERSENLCD_H_ */
@@ -35,6 +35,10 @@
 #include "MSSA/SVFGBuilder.h"
 #include "WPA/WPAFSSolver.h"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
 namespace SVF
 {
 
@@ -67,6 +71,13 @@ public:
         numOfProcessedPhi = numOfProcessedActualParam = numOfProcessedFormalRet = 0;
         numOfProcessedMSSANode = 0;
         maxSCCSize = numOfSCC = numOfNodesInSCC = 0;
+        numOfSolveThreads = 1;
+        numOfSCCLevels = maxSCCLevelWidth = numOfParallelSCCLevels = numOfStolenSCCs = 0;
+        numOfForwardedDFIns = 0;
+        hasBudget = false;
+        budgetHasExpired = false;
+        numOfFallbackPtrs = 0;
+        fallbackTime = 0;
         iterationForPrintStat = OnTheFlyIterBudgetForStat;
     }
 
@@ -135,6 +146,13 @@ public:
         return svfg;
     }
 
+    /// SVFG nodes which were not at a fixed point when the time budget
+    /// (-fs-time-limit) expired. Pointers they define have Andersen's sets.
+    inline const NodeBS& getFallbackNodes() const
+    {
+        return fallbackNodes;
+    }
+
 protected:
     /// SCC detection
     NodeStack& SCCDetect() override;
@@ -212,6 +230,9 @@ protected:
     }
     //@}
 
+    /// Solve until the worklist is empty or the time budget expires.
+    void solveWorklist() override;
+
     /// Handle various constraints
     //@{
     void processNode(NodeID nodeId) override;
@@ -224,6 +245,52 @@ protected:
     virtual bool processStore(const StoreSVFGNode* store);
     //@}
 
+    /// Parallel solving (-fs-threads), see FlowSensitiveParallel.cpp
+    //@{
+    /// Number of threads solveConstraints solves with.
+    virtual u32_t getNumOfSolveThreads() const;
+    /// Solve all SVFG nodes, level by level of the SCC DAG.
+    virtual void solveInParallel();
+    /// Solve the SCC represented by rep to a fixed point using worklist.
+    /// Returns false if the time budget expired first.
+    bool solveSCC(NodeID rep, FIFOWorkList<NodeID>& worklist);
+    /// Create every set solving may insert into a shared map.
+    virtual void prepareParallelSolve();
+    /// Create every field object solving may, so it does not add to the SVFIR.
+    void createGepObjVars();
+    /// Fall back to solving sequentially if the SVFIR grew while solving.
+    void stopParallelSolveIfPAGGrew(u32_t numOfPAGNodes);
+    /// Create the points-to sets of the top-level pointers node uses or defines.
+    void initTopLevelPts(const SVFGNode* node);
+    //@}
+
+    /// Time budget (-fs-time-limit)
+    //@{
+    /// Returns true once the time budget of solving has expired.
+    bool budgetExpired();
+    /// Give every node which is not at a fixed point, i.e. in the worklist or
+    /// depending on a node which is, the Andersen's sets of what it defines.
+    void fallBackToAnder();
+    /// Push the nodes whose points-to sets depend on those of node.
+    virtual void pushDependentNodes(const SVFGNode* node, FIFOWorkList<NodeID>& worklist);
+    /// Union the Andersen's points-to set of the top-level pointer node defines
+    /// into its own. Returns true if it changed.
+    bool fallBackNodeToAnder(const SVFGNode* node);
+    //@}
+
+    /// Forward the IN sets of nodes which only pass on those of a single
+    /// predecessor, when the DFPTData supports it (-compact-df).
+    void forwardDFInSets();
+
+    /// Add the time between start and end to time, which threads may share.
+    inline void addTime(double& time, double start, double end)
+    {
+        // Unmarked clocks all read 0 with -marked-clocks-only (see SVFStat::getClk).
+        if (start == end) return;
+        std::lock_guard<std::mutex> guard(timeMutex);
+        time += (end - start) / TIMEINTERVAL;
+    }
+
     /// Update call graph
     //@{
     /// Update call graph.
@@ -258,11 +325,11 @@ protected:
     ///@{
     inline const DFInOutMap& getDFInputMap() const
     {
-        return getMutDFPTDataTy()->getDFIn();
+        return getMutDFIn();
     }
     inline const DFInOutMap& getDFOutputMap() const
     {
-        return getMutDFPTDataTy()->getDFOut();
+        return getMutDFOut();
     }
     ///@}
 
@@ -279,22 +346,40 @@ protected:
     /// Save candidate mappings for evaluation's sake.
     std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> candidateMappings;
 
+    /// Synchronisation of parallel solving.
+    //@{
+    /// Number of locks propagation into other SCCs is striped over.
+    static const u32_t NumPropaMutexes = 1024;
+    /// Held when propagating into node n from another SCC, n % NumPropaMutexes.
+    std::unique_ptr<std::mutex[]> propaMutexes;
+    std::mutex suMutex;	///< Held when updating svfgHasSU.
+    std::mutex timeMutex;	///< Held when adding to timers.
+    //@}
+
     /// Statistics.
     //@{
-    u32_t numOfProcessedAddr;	/// Number of processed Addr node
-    u32_t numOfProcessedCopy;	/// Number of processed Copy node
-    u32_t numOfProcessedGep;	/// Number of processed Gep node
-    u32_t numOfProcessedPhi;	/// Number of processed Phi node
-    u32_t numOfProcessedLoad;	/// Number of processed Load node
-    u32_t numOfProcessedStore;	/// Number of processed Store node
-    u32_t numOfProcessedActualParam;	/// Number of processed actual param node
-    u32_t numOfProcessedFormalRet;	/// Number of processed formal ret node
-    u32_t numOfProcessedMSSANode;	/// Number of processed mssa node
+    std::atomic<u32_t> numOfProcessedAddr;	/// Number of processed Addr node
+    std::atomic<u32_t> numOfProcessedCopy;	/// Number of processed Copy node
+    std::atomic<u32_t> numOfProcessedGep;	/// Number of processed Gep node
+    std::atomic<u32_t> numOfProcessedPhi;	/// Number of processed Phi node
+    std::atomic<u32_t> numOfProcessedLoad;	/// Number of processed Load node
+    std::atomic<u32_t> numOfProcessedStore;	/// Number of processed Store node
+    std::atomic<u32_t> numOfProcessedActualParam;	/// Number of processed actual param node
+    std::atomic<u32_t> numOfProcessedFormalRet;	/// Number of processed formal ret node
+    std::atomic<u32_t> numOfProcessedMSSANode;	/// Number of processed mssa node
 
     u32_t maxSCCSize;
     u32_t numOfSCC;
     u32_t numOfNodesInSCC;
 
+    u32_t numOfSolveThreads;	///< Number of threads solving.
+    u32_t numOfSCCLevels;	///< Number of levels of the SCC DAG.
+    u32_t maxSCCLevelWidth;	///< Most SCCs in a level.
+    u32_t numOfParallelSCCLevels;	///< Number of levels solved in parallel.
+    u32_t numOfStolenSCCs;	///< Number of SCCs solved by a thread they were not given to.
+    u32_t numOfForwardedDFIns;	///< Number of SVFG nodes whose IN sets are those of their predecessor.
+    u32_t numOfFallbackPtrs;	///< Number of pointers whose points-to sets grew to Andersen's.
+
     double solveTime;	///< time of solve.
     double sccTime;	///< time of SCC detection.
     double processTime;	///< time of processNode.
@@ -309,10 +394,19 @@ protected:
     double storeTime;	///< time of store edges
     double phiTime;	///< time of phi nodes.
     double updateCallGraphTime; ///< time of updating call graph
+    double fallbackTime;	///< time of falling back to Andersen's.
 
     NodeBS svfgHasSU;
     //@}
 
+    /// Time budget.
+    //@{
+    bool hasBudget;	///< Whether solving has a time budget.
+    std::chrono::steady_clock::time_point budgetDeadline;	///< When the budget expires.
+    std::atomic<bool> budgetHasExpired;	///< Set once budgetExpired finds the deadline passed.
+    NodeBS fallbackNodes;	///< Nodes not at a fixed point when the budget expired.
+    //@}
+
     void svfgStat();
 };
 
@@ -108,6 +108,22 @@ protected:
     /// Override since we want to assign different weights based on versioning.
     virtual void cluster(void) override;
 
+    /// Also push the statements relying on the versions node yields (a store)
+    /// or propagates (a DummyVersionPropSVFGNode), and on those relying on them.
+    virtual void pushDependentNodes(const SVFGNode* node, FIFOWorkList<NodeID>& worklist) override;
+
+    /// Parallel solving (-fs-threads), see VersionedFlowSensitiveParallel.cpp
+    //@{
+    virtual u32_t getNumOfSolveThreads() const override;
+    /// Solve in rounds, each computed in parallel then applied in parallel.
+    virtual void solveInParallel() override;
+    virtual void prepareParallelSolve() override;
+    /// Buffered until the end of the round when solving in parallel.
+    virtual bool unionPts(NodeID id, const PointsTo& target) override;
+    virtual bool unionPts(NodeID id, NodeID ptd) override;
+    virtual bool addPts(NodeID id, NodeID ptd) override;
+    //@}
+
 public:
     /// Returns true if l is a store node.
     virtual bool isStore(const NodeID l) const;
@@ -144,6 +160,12 @@ public:
 
     void readPtsFromFile(const std::string& filename) override;
 
+    /// Versioned results interleave with the text format, so never write binary.
+    virtual bool writesBinaryPtsFile() const override
+    {
+        return false;
+    }
+
     /// Dumps a MeldVersion to stdout.
     static void dumpMeldVersion(MeldVersion &v);
 
@@ -155,6 +177,17 @@ private:
     /// Melds v2 into v1 (in place), returns whether a change occurred.
     static bool meld(MeldVersion &mv1, const MeldVersion &mv2);
 
+    /// Versioning plan (-versioning-plan), see VersionedFlowSensitivePlan.cpp
+    //@{
+    /// Fingerprint of what prelabel and meldLabel depend on.
+    u64_t getVersioningFingerprint(void) const;
+    /// Reads consume, yield, the reliance maps, and equivalentObject from
+    /// filename. Returns false (changing nothing) when they cannot be used.
+    bool readVersioningPlan(const std::string &filename, u64_t fingerprint);
+    /// Writes what readVersioningPlan reads.
+    void writeVersioningPlan(const std::string &filename, u64_t fingerprint) const;
+    //@}
+
     /// Removes all indirect edges in the SVFG.
     void removeAllIndirectSVFGEdges(void);
 
@@ -167,6 +200,9 @@ private:
     /// taken itself.
     void propagateVersion(const NodeID o, const Version v, const Version vp, bool time=true);
 
+    /// Pushes the DummyVersionPropSVFGNode of o:v, created if need be, into the worklist.
+    void pushVersionIntoWorklist(const NodeID o, const Version v);
+
     /// Fills in isStoreMap and isLoadMap.
     virtual void buildIsStoreLoadMaps(void);
 
@@ -181,6 +217,43 @@ private:
     /// edge to a delta node due to on-the-fly callgraph construction.
     virtual bool deltaSource(const NodeID l) const;
 
+    struct SolveThread;
+
+    /// Unions src into the points-to set of dst, buffered when solving in parallel.
+    bool unionVersionedPts(const VersionedVar &dst, const PointsTo &src);
+    /// Key-to-key unions of loads and stores. Sequentially, these go straight
+    /// to vPtD (e.g., ID-level unions of persistent data); in parallel, they
+    /// are buffered as set unions.
+    //@{
+    bool unionVersionedPts(const VersionedVar &dst, NodeID src);
+    bool unionVersionedPts(const VersionedVar &dst, const VersionedVar &src);
+    bool unionPtsFromVersion(NodeID dst, const VersionedVar &src);
+    //@}
+
+    /// The thread's state when computing a round of parallel solving, else
+    /// nullptr. Sequential solving does not look at the thread_local.
+    inline SolveThread *getSolveThread() const
+    {
+        return numOfSolveThreads > 1 ? solveThread : nullptr;
+    }
+
+    /// Parallel solving.
+    //@{
+    /// Processes n, buffering updates into st.
+    void computeNode(SolveThread &st, NodeID n);
+    /// Propagates ov to the versions relying on it, buffering updates into st.
+    void computeVersion(SolveThread &st, const VersionedVar &ov);
+    /// Buffers pts to be unioned into var (version is invalidVersion) or
+    /// var:version, and notify, or its successors, pushed if it changes.
+    bool bufferUpdate(SolveThread &st, NodeID var, Version version, const PointsTo &pts,
+                      NodeID notify, bool notifySuccessors);
+    /// Applies all updates to the sets owner owns, collecting the next round into st.
+    void applyUpdates(std::vector<SolveThread> &threads, u32_t owner, SolveThread &st);
+    /// getReliantVersions and getStmtReliance without inserting, or nullptr.
+    const std::vector<Version> *findReliantVersions(const NodeID o, const Version v) const;
+    const NodeBS *findStmtReliance(const NodeID o, const Version v) const;
+    //@}
+
     /// Shared code for setConsume and setYield. They wrap this function.
     void setVersion(const NodeID l, const NodeID o, const Version v, LocVersionMap &lvm);
 
@@ -242,8 +315,21 @@ private:
     double prelabelingTime;  ///< Time to prelabel SVFG.
     double meldLabelingTime; ///< Time to meld label SVFG.
     double versionPropTime;  ///< Time to propagate versions to versions which rely on them.
+    double versioningPlanTime; ///< Time to read or write the versioning plan.
+    bool versioningPlanReused; ///< Whether versioning was read from -versioning-plan.
+
+    u32_t numOfSolveRounds;       ///< Rounds of parallel solving.
+    u64_t numOfBufferedUpdates;   ///< Updates buffered in parallel solving.
+    u64_t numOfRedundantUpdates;  ///< Buffered updates which changed nothing once applied.
+    u64_t numOfUniqueUpdateSets;  ///< Distinct points-to sets of the buffered updates, summed over rounds.
+    double parallelSolveTime;     ///< Wall time of parallel solving.
+    double threadBusyTime;        ///< Time threads spent computing and applying rounds.
+    double threadIdleTime;        ///< Time threads waited for others in parallel rounds.
     //@}
 
+    /// The thread's state when computing a round of parallel solving, else nullptr.
+    static thread_local SolveThread *solveThread;
+
     static VersionedFlowSensitive *vfspta;
 
     class SCC
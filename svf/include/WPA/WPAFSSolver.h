@@ -87,6 +87,7 @@ protected:
             }
         }
 
+        this->recordTopoOrder(nodeStack);
         return nodeStack;
     }
 };
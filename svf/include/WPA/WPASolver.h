@@ -33,6 +33,7 @@
 
 #include "Util/WorkList.h"
 #include "Util/GeneralType.h"
+#include "MemoryModel/PTATY.h"
 
 namespace SVF
 {
@@ -54,11 +55,13 @@ public:
     typedef SCCDetection<GraphType> SCC;
 
     typedef FIFOWorkList<NodeID> WorkList;
+    typedef PriorityWorkList<NodeID> PrioWorkList;
 
 protected:
 
     /// Constructor
-    WPASolver(): reanalyze(false), iterationForPrintStat(1000), _graph(nullptr), numOfIteration(0)
+    WPASolver(): reanalyze(false), iterationForPrintStat(1000), _graph(nullptr), wlOrder(FIFOWorklist),
+        numOfPops(0), numOfIteration(0)
     {
     }
     /// Destructor
@@ -87,14 +90,25 @@ protected:
     virtual inline NodeStack& SCCDetect()
     {
         getSCCDetector()->find();
+        recordTopoOrder(getSCCDetector()->topoNodeStack());
         return getSCCDetector()->topoNodeStack();
     }
     virtual inline NodeStack& SCCDetect(NodeSet& candidates)
     {
         getSCCDetector()->find(candidates);
+        recordTopoOrder(getSCCDetector()->topoNodeStack());
         return getSCCDetector()->topoNodeStack();
     }
 
+    /// Rank the nodes of a topological order (top first) for TopoWorklist
+    inline void recordTopoOrder(NodeStack nodeStack)
+    {
+        if (wlOrder != TopoWorklist)
+            return;
+        for (u32_t rank = 0; !nodeStack.empty(); ++rank, nodeStack.pop())
+            topoRank[nodeStack.top()] = rank;
+    }
+
     virtual inline void initWorklist()
     {
         NodeStack& nodeStack = SCCDetect();
@@ -147,24 +161,98 @@ protected:
         return getSCCDetector()->repNode(id);
     }
 
+    /// Worklist order, FIFO unless set by the solver (e.g. from -wl-order)
+    //@{
+    inline void setWorklistOrder(WorklistOrder order)
+    {
+        wlOrder = order;
+    }
+    inline WorklistOrder getWorklistOrder() const
+    {
+        return wlOrder;
+    }
+    //@}
+
+    /// Size of what a node propagates (e.g. its points-to set), for PtsDeltaWorklist
+    virtual inline u32_t getWorklistWeight(NodeID)
+    {
+        return 0;
+    }
+
+    /// Priority of a node in a priority-ordered worklist (smaller is popped first)
+    virtual u64_t getWorklistPriority(NodeID id)
+    {
+        switch (wlOrder)
+        {
+        case TopoWorklist:
+        {
+            // Nodes created after the last SCC detection go last.
+            Map<NodeID, u32_t>::const_iterator it = topoRank.find(id);
+            return it != topoRank.end() ? it->second : UINT_MAX;
+        }
+        case LRFWorklist:
+        {
+            Map<NodeID, u64_t>::const_iterator it = lastFired.find(id);
+            return it != lastFired.end() ? it->second : 0;
+        }
+        case PtsDeltaWorklist:
+        {
+            u32_t weight = getWorklistWeight(id);
+            Map<NodeID, u32_t>::const_iterator it = weightAtPop.find(id);
+            u32_t lastWeight = it != weightAtPop.end() ? it->second : 0;
+            return UINT_MAX - (weight > lastWeight ? weight - lastWeight : 0);
+        }
+        default:
+            return 0;
+        }
+    }
+
     /// Worklist operations
     //@{
     inline NodeID popFromWorklist()
     {
-        return sccRepNode(worklist.pop());
+        if (wlOrder == FIFOWorklist)
+            return sccRepNode(worklist.pop());
+
+        NodeID id = prioWorklist.pop();
+        if (wlOrder == LRFWorklist)
+            lastFired[id] = ++numOfPops;
+        else if (wlOrder == PtsDeltaWorklist)
+            weightAtPop[id] = getWorklistWeight(id);
+        return sccRepNode(id);
     }
 
     virtual inline void pushIntoWorklist(NodeID id)
     {
-        worklist.push(sccRepNode(id));
+        if (wlOrder == FIFOWorklist)
+            worklist.push(sccRepNode(id));
+        else
+        {
+            NodeID rep = sccRepNode(id);
+            prioWorklist.push(rep, getWorklistPriority(rep));
+        }
     }
     inline bool isWorklistEmpty()
     {
-        return worklist.empty();
+        return wlOrder == FIFOWorklist ? worklist.empty() : prioWorklist.empty();
     }
     inline bool isInWorklist(NodeID id)
     {
-        return worklist.find(id);
+        return wlOrder == FIFOWorklist ? worklist.find(id) : prioWorklist.find(id);
+    }
+    inline u32_t getWorklistSize()
+    {
+        return wlOrder == FIFOWorklist ? worklist.size() : prioWorklist.size();
+    }
+    /// The worklist in pop order, leaving it and the pop history untouched
+    inline std::vector<NodeID> getWorklistSnapshot() const
+    {
+        return wlOrder == FIFOWorklist ? worklist.toVector() : prioWorklist.toVector();
+    }
+    inline void clearWorklist()
+    {
+        worklist.clear();
+        prioWorklist.clear();
     }
     //@}
 
@@ -196,6 +284,16 @@ protected:
     /// Worklist for resolution
     WorkList worklist;
 
+    /// Priority worklist, used instead of worklist unless the order is FIFO
+    //@{
+    WorklistOrder wlOrder;
+    PrioWorkList prioWorklist;
+    Map<NodeID, u32_t> topoRank;      ///< TopoWorklist: rank in the last topological order
+    Map<NodeID, u64_t> lastFired;     ///< LRFWorklist: pop count when last popped
+    Map<NodeID, u32_t> weightAtPop;   ///< PtsDeltaWorklist: weight when last popped
+    u64_t numOfPops;
+    //@}
+
 public:
     /// num of iterations during constraint solving
     u32_t numOfIteration;
@@ -178,6 +178,221 @@ void ConstraintGraph::clearSolitaries()
         removeConstraintNode(node);
 }
 
+/*!
+ * SCCs of the copy/gep graph in topological order (Tarjan's algorithm).
+ * Gep edges are followed whatever -pwc is (SFR turns it off), so this walks
+ * the direct edge sets itself rather than going through SCCDetection.
+ */
+static void directSCCsInTopoOrder(ConstraintGraph* graph, std::vector<NodeBS>& sccs)
+{
+    typedef ConstraintEdge::ConstraintNodeEdgeSetTy::const_iterator EdgeIter;
+    Map<NodeID, u32_t> index;
+    Map<NodeID, u32_t> lowLink;
+    NodeBS onStack;
+    std::vector<NodeID> sccStack;
+    std::vector<std::pair<NodeID, EdgeIter>> dfsStack;
+
+    auto enter = [&](NodeID id)
+    {
+        u32_t idx = index.size();
+        index[id] = idx;
+        lowLink[id] = idx;
+        sccStack.push_back(id);
+        onStack.set(id);
+        dfsStack.emplace_back(id, graph->getConstraintNode(id)->getDirectOutEdges().begin());
+    };
+
+    for (ConstraintGraph::iterator it = graph->begin(), eit = graph->end(); it != eit; ++it)
+    {
+        if (index.count(it->first))
+            continue;
+        enter(it->first);
+        while (!dfsStack.empty())
+        {
+            NodeID v = dfsStack.back().first;
+            const ConstraintEdge::ConstraintNodeEdgeSetTy& outs = graph->getConstraintNode(v)->getDirectOutEdges();
+            if (dfsStack.back().second != outs.end())
+            {
+                NodeID w = (*dfsStack.back().second)->getDstID();
+                ++dfsStack.back().second;
+                if (!index.count(w))
+                    enter(w);
+                else if (onStack.test(w))
+                    lowLink[v] = std::min(lowLink[v], index[w]);
+                continue;
+            }
+
+            dfsStack.pop_back();
+            if (!dfsStack.empty())
+            {
+                NodeID parent = dfsStack.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[v]);
+            }
+            if (lowLink[v] != index[v])
+                continue;
+
+            NodeBS members;
+            NodeID w;
+            do
+            {
+                w = sccStack.back();
+                sccStack.pop_back();
+                onStack.reset(w);
+                members.set(w);
+            }
+            while (w != v);
+            sccs.push_back(members);
+        }
+    }
+
+    // Tarjan's algorithm finds an SCC after all of those it reaches.
+    std::reverse(sccs.begin(), sccs.end());
+}
+
+/*!
+ * Offline pointer equivalence (HU, Hardekopf and Lin, SAS'07).
+ * Nodes are labelled in topological order of the copy/gep graph, each SCC
+ * of it receiving the union of the labels flowing into it.
+ */
+void ConstraintGraph::computePointerEquivalence(std::vector<NodeBS>& classes)
+{
+    /// Functions whose parameters may be connected by the on-the-fly call graph
+    Set<const FunObjVar*> addrTakenFuns;
+    for (const ConstraintEdge* edge : AddrCGEdgeSet)
+    {
+        const BaseObjVar* obj = pag->getBaseObject(edge->getSrcID());
+        if (obj && obj->isFunction())
+        {
+            const FunObjVar* fun = SVFUtil::cast<FunObjVar>(obj)->getFunction();
+            addrTakenFuns.insert(fun);
+            addrTakenFuns.insert(fun->getDefFunForMultipleModule());
+        }
+    }
+    NodeBS retFromIndCalls;
+    for (auto cs_pair : pag->getIndirectCallsites())
+    {
+        const RetICFGNode* retBlockNode = cs_pair.first->getRetICFGNode();
+        if (pag->callsiteHasRet(retBlockNode))
+            retFromIndCalls.set(pag->getCallSiteRet(retBlockNode)->getId());
+    }
+    auto mayGainInEdges = [&](NodeID id)
+    {
+        const SVFVar* var = pag->getSVFVar(id);
+        if (SVFUtil::isa<ObjVar>(var) || !getConstraintNode(id)->getLoadInEdges().empty()
+                || retFromIndCalls.test(id))
+            return true;
+        if (const ArgValVar* arg = SVFUtil::dyn_cast<ArgValVar>(var))
+            return addrTakenFuns.count(arg->getParent()) != 0;
+        if (SVFUtil::isa<VarArgValPN>(var))
+            return addrTakenFuns.count(var->getFunction()) != 0;
+        return false;
+    };
+
+    /// Label sets are hash-consed; labels are fresh ids for addressed objects,
+    /// for nodes that may gain edges, and for each (label set, gep) pair.
+    NodeID numOfLabels = 0;
+    std::vector<NodeBS> labelSets(1);               // 0 is the empty set
+    Map<NodeBS, u32_t> labelSetIds = {{NodeBS(), 0}};
+    auto labelSetId = [&](const NodeBS& labels)
+    {
+        auto inserted = labelSetIds.emplace(labels, labelSets.size());
+        if (inserted.second)
+            labelSets.push_back(labels);
+        return inserted.first->second;
+    };
+    auto freshLabelSet = [&]()
+    {
+        NodeBS labels;
+        labels.set(numOfLabels++);
+        return labelSetId(labels);
+    };
+    Map<NodeID, NodeID> objLabels;
+    Map<std::pair<u32_t, APOffset>, NodeID> normalGepLabels;
+    Map<u32_t, NodeID> variantGepLabels;
+    auto gepLabel = [&](const ConstraintEdge* edge, u32_t srcSet) -> NodeID
+    {
+        auto inserted = SVFUtil::isa<NormalGepCGEdge>(edge)
+                        ? normalGepLabels.emplace(std::make_pair(srcSet,
+                                SVFUtil::cast<NormalGepCGEdge>(edge)->getConstantFieldIdx()), numOfLabels).first->second
+                        : variantGepLabels.emplace(srcSet, numOfLabels).first->second;
+        if (inserted == numOfLabels)
+            numOfLabels++;
+        return inserted;
+    };
+
+    /// Order nodes over copy and gep edges alike, so that the source of a gep
+    /// is always labelled before its destination.
+    std::vector<NodeBS> topoOrder;
+    directSCCsInTopoOrder(this, topoOrder);
+    Map<NodeID, u32_t> nodeLabelSet;
+    OrderedMap<u32_t, NodeBS> setToPointers;
+    for (const NodeBS& members : topoOrder)
+    {
+        bool fresh = false;
+        bool gepInCycle = false;
+        for (NodeID n : members)
+        {
+            fresh |= mayGainInEdges(n);
+            for (const ConstraintEdge* edge : getConstraintNode(n)->getGepInEdges())
+                gepInCycle |= members.test(edge->getSrcID());
+        }
+
+        if (gepInCycle)
+        {
+            /// A positive weight cycle: keep its nodes apart
+            for (NodeID n : members)
+                nodeLabelSet[n] = freshLabelSet();
+            continue;
+        }
+
+        u32_t set = 0;
+        if (fresh)
+            set = freshLabelSet();
+        else
+        {
+            NodeBS labels;
+            for (NodeID n : members)
+            {
+                const ConstraintNode* node = getConstraintNode(n);
+                for (const ConstraintEdge* edge : node->getAddrInEdges())
+                {
+                    auto inserted = objLabels.emplace(edge->getSrcID(), numOfLabels);
+                    if (inserted.second)
+                        numOfLabels++;
+                    labels.set(inserted.first->second);
+                }
+                for (const ConstraintEdge* edge : node->getCopyInEdges())
+                {
+                    if (!members.test(edge->getSrcID()))
+                        labels |= labelSets[nodeLabelSet[edge->getSrcID()]];
+                }
+                for (const ConstraintEdge* edge : node->getGepInEdges())
+                {
+                    u32_t srcSet = nodeLabelSet[edge->getSrcID()];
+                    if (srcSet != 0)
+                        labels.set(gepLabel(edge, srcSet));
+                }
+            }
+            set = labelSetId(labels);
+        }
+        if (set == 0)
+            continue;
+        for (NodeID n : members)
+        {
+            nodeLabelSet[n] = set;
+            const SVFVar* var = pag->getSVFVar(n);
+            if (var->isPointer() && SVFUtil::isa<ValVar>(var))
+                setToPointers[set].set(n);
+        }
+    }
+
+    for (const auto& it : setToPointers)
+    {
+        if (it.second.count() > 1)
+            classes.push_back(it.second);
+    }
+}
+
 /*!
  * Memory has been cleaned up at GenericGraph
  */
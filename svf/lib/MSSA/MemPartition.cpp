@@ -49,7 +49,7 @@ void DistinctMRG::partitionMRs()
         NodeBS mergePts;
         for(PointsToList::iterator cit = it->second.begin(), ecit = it->second.end(); cit!=ecit; ++cit)
         {
-            const NodeBS& pts = *cit;
+            const NodeBS& pts = getCPts(*cit);
             mergePts |= pts;
         }
         createDistinctMR(fun, mergePts);
@@ -75,10 +75,11 @@ void DistinctMRG::createDistinctMR(const FunObjVar* func, const NodeBS& pts)
         newPts.set(id);
 
         // set the rep cpts as itself.
-        cptsToRepCPtsMap[newPts] = newPts;
+        PointsToID newPtsID = emplaceCPts(newPts);
+        cptsToRepCPtsMap[newPtsID] = newPtsID;
 
         // add memory region for this points-to target.
-        createMR(func, newPts);
+        createMR(func, newPtsID);
     }
 }
 
@@ -101,10 +102,7 @@ void DistinctMRG::getMRsForLoad(MRSet& mrs, const NodeBS& pts, const FunObjVar*)
         NodeBS newPts;
         newPts.set(id);
 
-        MemRegion mr(newPts);
-        MRSet::iterator mit = memRegSet.find(&mr);
-        assert(mit!=memRegSet.end() && "memory region not found!!");
-        mrs.insert(*mit);
+        mrs.insert(getMR(newPts));
     }
 }
 
@@ -129,29 +127,28 @@ void IntraDisjointMRG::partitionMRs()
         for(PointsToList::iterator cit = it->second.begin(), ecit = it->second.end();
                 cit!=ecit; ++cit)
         {
-            const NodeBS& cpts = *cit;
-
-            PointsToList& inters = getIntersList(fun);
-            computeIntersections(cpts, inters);
+            InterList& inters = getIntersList(fun);
+            computeIntersections(*cit, inters);
         }
 
         /// Create memory regions.
-        const PointsToList& inters = getIntersList(fun);
+        const PointsToList& inters = getIntersList(fun).inters;
         for (PointsToList::const_iterator interIt = inters.begin(), interEit = inters.end();
                 interIt != interEit; ++interIt)
         {
-            const NodeBS& inter = *interIt;
-            createDisjointMR(fun, inter);
+            createDisjointMR(fun, *interIt);
         }
     }
 }
 
 /**
  * Compute intersections between cpts and computed cpts intersections before.
+ * Only the intersections overlapping cpts are visited, in ID order.
  */
-void IntraDisjointMRG::computeIntersections(const NodeBS& cpts, PointsToList& inters)
+void IntraDisjointMRG::computeIntersections(PointsToID cptsID, InterList& inters)
 {
-    if (inters.find(cpts) != inters.end())
+    const NodeBS& cpts = getCPts(cptsID);
+    if (inters.inters.find(cptsID) != inters.inters.end())
     {
         // Skip this cpts if it is already in the map.
         return;
@@ -160,7 +157,7 @@ void IntraDisjointMRG::computeIntersections(const NodeBS& cpts, PointsToList& in
     {
         // If this cpts has only one element, it will not intersect with any cpts in inters,
         // just add it into intersection set.
-        inters.insert(cpts);
+        inters.insert(cptsID, cpts);
         return;
     }
     else
@@ -170,11 +167,14 @@ void IntraDisjointMRG::computeIntersections(const NodeBS& cpts, PointsToList& in
 
         NodeBS cpts_copy = cpts;	// make a copy since cpts may be changed.
 
+        PointsToList overlapping;
+        inters.getOverlapping(overlapping, cpts);
+
         // check intersections with existing cpts in subSetMap
-        for (PointsToList::const_iterator interIt = inters.begin(), interEit = inters.end();
+        for (PointsToList::const_iterator interIt = overlapping.begin(), interEit = overlapping.end();
                 interIt != interEit; ++interIt)
         {
-            const NodeBS& inter = *interIt;
+            const NodeBS& inter = getCPts(*interIt);
 
             if (cpts_copy.intersects(inter))
             {
@@ -185,15 +185,15 @@ void IntraDisjointMRG::computeIntersections(const NodeBS& cpts, PointsToList& in
                 // remove old intersection and add new one if possible
                 if (new_inter != inter)
                 {
-                    toBeDeleted.insert(inter);
-                    newInters.insert(new_inter);
+                    toBeDeleted.insert(*interIt);
+                    newInters.insert(emplaceCPts(new_inter));
 
                     // compute complement after intersection
                     NodeBS complement = inter;
                     complement.intersectWithComplement(new_inter);
                     if (complement.empty() == false)
                     {
-                        newInters.insert(complement);
+                        newInters.insert(emplaceCPts(complement));
                     }
                 }
 
@@ -208,28 +208,26 @@ void IntraDisjointMRG::computeIntersections(const NodeBS& cpts, PointsToList& in
         for (PointsToList::const_iterator it = toBeDeleted.begin(), eit = toBeDeleted.end();
                 it != eit; ++it)
         {
-            const NodeBS& temp_cpts = *it;
-            inters.erase(temp_cpts);
+            inters.erase(*it, getCPts(*it));
         }
 
         // add new intersections
         for (PointsToList::const_iterator it = newInters.begin(), eit = newInters.end();
                 it != eit; ++it)
         {
-            const NodeBS& temp_cpts = *it;
-            inters.insert(temp_cpts);
+            inters.insert(*it, getCPts(*it));
         }
 
         // add remaining set into inters
         if (cpts_copy.empty() == false)
-            inters.insert(cpts_copy);
+            inters.insert(emplaceCPts(cpts_copy), cpts_copy);
     }
 }
 
 /**
  * Create memory regions for each points-to target.
  */
-void IntraDisjointMRG::createDisjointMR(const FunObjVar* func, const NodeBS& cpts)
+void IntraDisjointMRG::createDisjointMR(const FunObjVar* func, PointsToID cpts)
 {
     // set the rep cpts as itself.
     cptsToRepCPtsMap[cpts] = cpts;
@@ -238,23 +236,25 @@ void IntraDisjointMRG::createDisjointMR(const FunObjVar* func, const NodeBS& cpt
     createMR(func, cpts);
 }
 
-void IntraDisjointMRG::getMRsForLoadFromInterList(MRSet& mrs, const NodeBS& cpts, const PointsToList& inters)
+void IntraDisjointMRG::getContainedInters(PointsToList& contained, const NodeBS& cpts, const InterList& inters) const
 {
-    PointsToList::const_iterator it = inters.begin();
-    PointsToList::const_iterator eit = inters.end();
-    for (; it != eit; ++it)
+    PointsToList overlapping;
+    inters.getOverlapping(overlapping, cpts);
+    for (PointsToID inter : overlapping)
     {
-        const NodeBS& inter = *it;
-        if (cpts.contains(inter))
-        {
-            MemRegion mr(inter);
-            MRSet::iterator mit = memRegSet.find(&mr);
-            assert(mit!=memRegSet.end() && "memory region not found!!");
-            mrs.insert(*mit);
-        }
+        if (cpts.contains(getCPts(inter)))
+            contained.insert(inter);
     }
 }
 
+void IntraDisjointMRG::getMRsForLoadFromInterList(MRSet& mrs, const NodeBS& cpts, const InterList& inters)
+{
+    PointsToList contained;
+    getContainedInters(contained, cpts, inters);
+    for (PointsToID inter : contained)
+        mrs.insert(getMR(inter));
+}
+
 /**
  * Get memory regions to be inserted at a load statement.
  * Just process as getMRsForLoad().
@@ -275,9 +275,7 @@ void InterDisjointMRG::partitionMRs()
         for(PointsToList::iterator cit = it->second.begin(), ecit = it->second.end();
                 cit!=ecit; ++cit)
         {
-            const NodeBS& cpts = *cit;
-
-            computeIntersections(cpts, inters);
+            computeIntersections(*cit, inters);
         }
     }
 
@@ -290,15 +288,10 @@ void InterDisjointMRG::partitionMRs()
         for(PointsToList::iterator cit = it->second.begin(), ecit = it->second.end();
                 cit!=ecit; ++cit)
         {
-            const NodeBS& cpts = *cit;
-
-            for (PointsToList::const_iterator interIt = inters.begin(), interEit = inters.end();
-                    interIt != interEit; ++interIt)
-            {
-                const NodeBS& inter = *interIt;
-                if (cpts.contains(inter))
-                    createDisjointMR(fun, inter);
-            }
+            PointsToList contained;
+            getContainedInters(contained, getCPts(*cit), inters);
+            for (PointsToID inter : contained)
+                createDisjointMR(fun, inter);
         }
     }
 }
@@ -33,6 +33,10 @@
 #include "MSSA/MSSAMuChi.h"
 #include "Graphs/CallGraph.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using namespace SVF;
 using namespace SVFUtil;
 
@@ -67,35 +71,43 @@ void MRGenerator::destroy()
 /*!
  * Generate a memory region and put in into functions which use it
  */
-void MRGenerator::createMR(const FunObjVar* fun, const NodeBS& cpts)
+void MRGenerator::createMR(const FunObjVar* fun, PointsToID cpts)
 {
-    const NodeBS& repCPts = getRepPointsTo(cpts);
-    MemRegion mr(repCPts);
-    MRSet::const_iterator mit = memRegSet.find(&mr);
-    if(mit!=memRegSet.end())
+    PointsToID repCPts = getRepPointsTo(cpts);
+    PtsToMRMap::const_iterator mit = cptsToMRMap.find(repCPts);
+    if(mit!=cptsToMRMap.end())
     {
-        const MemRegion* mr = *mit;
-        MRSet& mrs = funToMRsMap[fun];
-        if(mrs.find(mr)==mrs.end())
-            mrs.insert(mr);
+        funToMRsMap[fun].insert(mit->second);
     }
     else
     {
-        MemRegion* m = new MemRegion(repCPts);
+        MemRegion* m = new MemRegion(getCPts(repCPts));
         memRegSet.insert(m);
+        cptsToMRMap[repCPts] = m;
         funToMRsMap[fun].insert(m);
     }
 }
 
 /*!
- * Generate a memory region and put in into functions which use it
+ * Get the memory region of the rep of cpts
+ */
+const MemRegion* MRGenerator::getMR(PointsToID cpts) const
+{
+    PtsToMRMap::const_iterator mit = cptsToMRMap.find(getRepPointsTo(cpts));
+    assert(mit!=cptsToMRMap.end() && "memory region not found!!");
+    return mit->second;
+}
+
+/*!
+ * Hash-cons cpts
  */
-const MemRegion* MRGenerator::getMR(const NodeBS& cpts) const
+PointsToID MRGenerator::emplaceCPts(const NodeBS& cpts)
 {
-    MemRegion mr(getRepPointsTo(cpts));
-    MRSet::iterator mit = memRegSet.find(&mr);
-    assert(mit!=memRegSet.end() && "memory region not found!!");
-    return *mit;
+    std::pair<PtsToIDMap::iterator, bool> it = cptsToIDMap.emplace(cpts, idToCPts.size());
+    // Keys of the map stay where they are, so can be referred to by ID.
+    if (it.second)
+        idToCPts.push_back(&it.first->first);
+    return it.first->second;
 }
 
 
@@ -170,9 +182,24 @@ SVFIR::SVFStmtList& MRGenerator::getSVFStmtsFromInst(const ICFGNode* node)
 
 /*!
  * Generate memory regions for loads/stores
+ *
+ * Looking up the statements and points-to sets may insert into shared maps,
+ * so it is done first, in order. The points-to sets of each function are
+ * then turned into NodeBSs and filtered into refs/mods with -mssa-threads,
+ * and added in function order as if done sequentially.
  */
 void MRGenerator::collectModRefForLoadStore()
 {
+    /// Loads/stores of a function and what they point to
+    struct FunLoadStores
+    {
+        const FunObjVar* fun;
+        std::vector<std::pair<const PAGEdge*, const PointsTo*>> ptrs;
+        std::vector<std::pair<const PAGEdge*, NodeBS>> cptsList;
+        NodeBS refs;
+        NodeBS mods;
+    };
+    std::vector<FunLoadStores> funLoadStores;
 
     const CallGraph* svfirCallGraph = PAG::getPAG()->getCallGraph();
     for (const auto& item: *svfirCallGraph)
@@ -183,6 +210,9 @@ void MRGenerator::collectModRefForLoadStore()
         if (Options::IgnoreDeadFun() && fun.isUncalledFunction())
             continue;
 
+        funLoadStores.push_back(FunLoadStores());
+        FunLoadStores& fls = funLoadStores.back();
+        fls.fun = &fun;
         for (FunObjVar::const_bb_iterator iter = fun.begin(), eiter = fun.end();
                 iter != eiter; ++iter)
         {
@@ -196,28 +226,71 @@ void MRGenerator::collectModRefForLoadStore()
                     const PAGEdge* inst = *bit;
                     pagEdgeToFunMap[inst] = &fun;
                     if (const StoreStmt *st = SVFUtil::dyn_cast<StoreStmt>(inst))
-                    {
-                        NodeBS cpts(pta->getPts(st->getLHSVarID()).toNodeBS());
-                        // TODO: change this assertion check later when we have conditional points-to set
-                        if (cpts.empty())
-                            continue;
-                        assert(!cpts.empty() && "null pointer!!");
-                        addCPtsToStore(cpts, st, &fun);
-                    }
-
+                        fls.ptrs.push_back(std::make_pair(inst, &pta->getPts(st->getLHSVarID())));
                     else if (const LoadStmt *ld = SVFUtil::dyn_cast<LoadStmt>(inst))
-                    {
-                        NodeBS cpts(pta->getPts(ld->getRHSVarID()).toNodeBS());
-                        // TODO: change this assertion check later when we have conditional points-to set
-                        if (cpts.empty())
-                            continue;
-                        assert(!cpts.empty() && "null pointer!!");
-                        addCPtsToLoad(cpts, ld, &fun);
-                    }
+                        fls.ptrs.push_back(std::make_pair(inst, &pta->getPts(ld->getRHSVarID())));
                 }
             }
         }
     }
+
+    auto collectFun = [this](FunLoadStores& fls)
+    {
+        for (const auto& ptr : fls.ptrs)
+        {
+            NodeBS cpts(ptr.second->toNodeBS());
+            // TODO: change this assertion check later when we have conditional points-to set
+            if (cpts.empty())
+                continue;
+            assert(!cpts.empty() && "null pointer!!");
+            for (NodeID o : cpts)
+            {
+                if (!isNonLocalObject(o, fls.fun))
+                    continue;
+                if (SVFUtil::isa<StoreStmt>(ptr.first))
+                    fls.mods.set(o);
+                else
+                    fls.refs.set(o);
+            }
+            fls.cptsList.push_back(std::make_pair(ptr.first, std::move(cpts)));
+        }
+    };
+
+    const u32_t numOfThreads = std::min<size_t>(Options::MSSAThreads(), funLoadStores.size());
+    if (numOfThreads <= 1)
+    {
+        for (FunLoadStores& fls : funLoadStores)
+            collectFun(fls);
+    }
+    else
+    {
+        std::atomic<size_t> nextFun(0);
+        auto collectWorker = [&]()
+        {
+            for (size_t f = nextFun++; f < funLoadStores.size(); f = nextFun++)
+                collectFun(funLoadStores[f]);
+        };
+
+        std::vector<std::thread> workers;
+        for (u32_t t = 0; t < numOfThreads; ++t) workers.push_back(std::thread(collectWorker));
+        for (std::thread &worker : workers) worker.join();
+    }
+
+    for (FunLoadStores& fls : funLoadStores)
+    {
+        for (auto& cpts : fls.cptsList)
+        {
+            funToPointsToMap[fls.fun].insert(emplaceCPts(cpts.second));
+            if (const StoreStmt *st = SVFUtil::dyn_cast<StoreStmt>(cpts.first))
+                storesToPointsToMap[st] = std::move(cpts.second);
+            else
+                loadsToPointsToMap[SVFUtil::cast<LoadStmt>(cpts.first)] = std::move(cpts.second);
+        }
+        if (!fls.refs.empty())
+            funToRefsMap[fls.fun] |= fls.refs;
+        if (!fls.mods.empty())
+            funToModsMap[fls.fun] |= fls.mods;
+    }
 }
 
 
@@ -278,35 +351,62 @@ void MRGenerator::collectModRefForCall()
  * Always map it to its superset(rep) cpts according to existing items
  * 1) map cpts to its superset(rep) which exists in the map, otherwise its superset is itself
  * 2) adjust existing items in the map if their supersets are cpts
+ * Items are grouped by their rep (repCPtsToCPtsMap) so each rep is compared once.
+ * When several reps contain cpts, the one whose greatest item comes last in
+ * NodeBS order wins, as when the items were visited in NodeBS order.
  */
-void MRGenerator::sortPointsTo(const NodeBS& cpts)
+void MRGenerator::sortPointsTo(PointsToID cpts)
 {
 
     if(cptsToRepCPtsMap.find(cpts)!=cptsToRepCPtsMap.end())
         return;
 
-    PointsToList subSetList;
-    NodeBS repCPts = cpts;
-    for(PtsToRepPtsSetMap::iterator it = cptsToRepCPtsMap.begin(),
-            eit = cptsToRepCPtsMap.end(); it!=eit; ++it)
+    const NodeBS& cptsSet = getCPts(cpts);
+    PointsToList subSetReps;
+    PointsToID repCPts = cpts;
+    for(RepPtsToPtsSetMap::iterator it = repCPtsToCPtsMap.begin(),
+            eit = repCPtsToCPtsMap.end(); it!=eit; ++it)
     {
-        NodeBS& existCPts = it->second;
-        if(cpts.contains(existCPts))
+        const NodeBS& existCPts = getCPts(it->first);
+        if(cptsSet.contains(existCPts))
         {
-            subSetList.insert(it->first);
+            subSetReps.insert(it->first);
         }
-        else if(existCPts.contains(cpts))
+        else if(existCPts.contains(cptsSet))
         {
-            repCPts = existCPts;
+            if (repCPts == cpts || cptsBefore(repCPtsToMaxCPtsMap[repCPts], repCPtsToMaxCPtsMap[it->first]))
+                repCPts = it->first;
         }
     }
 
-    for(PointsToList::iterator it = subSetList.begin(), eit = subSetList.end(); it!=eit; ++it)
+    PointsToList& subSetList = repCPtsToCPtsMap[cpts];
+    for(PointsToList::iterator it = subSetReps.begin(), eit = subSetReps.end(); it!=eit; ++it)
     {
-        cptsToRepCPtsMap[*it] = cpts;
+        PointsToList& subs = repCPtsToCPtsMap[*it];
+        for(PointsToID sub : subs)
+            cptsToRepCPtsMap[sub] = cpts;
+        subSetList.insert(subs.begin(), subs.end());
+        addToMaxCPts(cpts, repCPtsToMaxCPtsMap[*it]);
+        repCPtsToCPtsMap.erase(*it);
+        repCPtsToMaxCPtsMap.erase(*it);
     }
 
+    // Nothing maps to cpts itself, so it is not a rep.
+    if (subSetList.empty() && repCPts != cpts)
+        repCPtsToCPtsMap.erase(cpts);
     cptsToRepCPtsMap[cpts] = repCPts;
+    repCPtsToCPtsMap[repCPts].insert(cpts);
+    addToMaxCPts(repCPts, cpts);
+}
+
+/*!
+ * Record that cpts is mapped to rep, for the greatest cpts of rep
+ */
+void MRGenerator::addToMaxCPts(PointsToID rep, PointsToID cpts)
+{
+    std::pair<PtsToRepPtsSetMap::iterator, bool> it = repCPtsToMaxCPtsMap.emplace(rep, cpts);
+    if (!it.second && cptsBefore(it.first->second, cpts))
+        it.first->second = cpts;
 }
 
 /*!
@@ -319,22 +419,29 @@ void MRGenerator::partitionMRs()
     /// TODO: we may need some refined region partitioning algorithm here
     /// For now, we just collapse all refs/mods objects at callsites into one region
     /// Consider modularly partition memory regions to speed up analysis (only partition regions within function scope)
+    /// The cpts of each function are visited in NodeBS order, which decides
+    /// the reps sortPointsTo picks and the order regions are created in.
+    std::vector<std::pair<const FunObjVar*, std::vector<PointsToID>>> funToSortedCPts;
     for(FunToPointsTosMap::iterator it = getFunToPointsToList().begin(), eit = getFunToPointsToList().end();
             it!=eit; ++it)
     {
-        for(PointsToList::iterator cit = it->second.begin(), ecit = it->second.end(); cit!=ecit; ++cit)
+        std::vector<PointsToID> sorted(it->second.begin(), it->second.end());
+        std::sort(sorted.begin(), sorted.end(), [this](PointsToID lhs, PointsToID rhs)
+        {
+            return cptsBefore(lhs, rhs);
+        });
+        for(PointsToID cpts : sorted)
         {
-            sortPointsTo(*cit);
+            sortPointsTo(cpts);
         }
+        funToSortedCPts.emplace_back(it->first, std::move(sorted));
     }
     /// Generate memory regions according to condition pts after computing superset
-    for(FunToPointsTosMap::iterator it = getFunToPointsToList().begin(), eit = getFunToPointsToList().end();
-            it!=eit; ++it)
+    for(const auto& funCPts : funToSortedCPts)
     {
-        const FunObjVar* fun = it->first;
-        for(PointsToList::iterator cit = it->second.begin(), ecit = it->second.end(); cit!=ecit; ++cit)
+        for(PointsToID cpts : funCPts.second)
         {
-            createMR(fun,*cit);
+            createMR(funCPts.first, cpts);
         }
     }
 
@@ -35,6 +35,9 @@
 #include "Graphs/CallGraph.h"
 #include "SVFIR/SVFVariables.h"
 
+#include <atomic>
+#include <thread>
+
 using namespace SVF;
 using namespace SVFUtil;
 
@@ -72,6 +75,76 @@ SVFIR* MemSSA::getPAG()
  * Start building memory SSA
  */
 void MemSSA::buildMemSSA(const FunObjVar& fun)
+{
+    FunBuildState fs;
+    buildFunMemSSA(fun, fs);
+    mergeFunBuildState(fs);
+}
+
+/*!
+ * Build memory SSA for all of funs. Functions are independent once mod-ref
+ * is known, so threads each take a function at a time, building it into its
+ * own FunBuildState. They are merged in the order of funs afterwards.
+ */
+void MemSSA::buildMemSSA(const std::vector<const FunObjVar*>& funs)
+{
+    const u32_t numOfThreads = std::min<size_t>(Options::MSSAThreads(), funs.size());
+    if (numOfThreads <= 1)
+    {
+        for (const FunObjVar* fun : funs)
+            buildMemSSA(*fun);
+        return;
+    }
+
+    prepareParallelBuild(funs);
+
+    std::vector<FunBuildState> states(funs.size());
+    std::atomic<size_t> nextFun(0);
+    auto buildWorker = [&]()
+    {
+        for (size_t f = nextFun++; f < funs.size(); f = nextFun++)
+            buildFunMemSSA(*funs[f], states[f]);
+    };
+
+    std::vector<std::thread> workers;
+    for (u32_t t = 0; t < numOfThreads; ++t) workers.push_back(std::thread(buildWorker));
+    for (std::thread &worker : workers) worker.join();
+
+    for (FunBuildState& fs : states)
+        mergeFunBuildState(fs);
+}
+
+/*!
+ * Create the MR set of every load and store funs would look up, as building
+ * them sequentially does on the way, so that threads never insert into them.
+ */
+void MemSSA::prepareParallelBuild(const std::vector<const FunObjVar*>& funs)
+{
+    for (const FunObjVar* fun : funs)
+    {
+        for (const SVFBasicBlock* bb : fun->getReachableBBs())
+        {
+            for (const auto& inst: bb->getICFGNodeList())
+            {
+                if (!mrGen->hasSVFStmtList(inst))
+                    continue;
+
+                for (const PAGEdge* edge : mrGen->getSVFStmtsFromInst(inst))
+                {
+                    if (const LoadStmt* load = SVFUtil::dyn_cast<LoadStmt>(edge))
+                        mrGen->getLoadMRSet(load);
+                    else if (const StoreStmt* store = SVFUtil::dyn_cast<StoreStmt>(edge))
+                        mrGen->getStoreMRSet(store);
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * Build memory SSA for fun into fs
+ */
+void MemSSA::buildFunMemSSA(const FunObjVar& fun, FunBuildState& fs)
 {
 
     assert(!isExtCall(&fun) && "we do not build memory ssa for external functions");
@@ -79,34 +152,72 @@ void MemSSA::buildMemSSA(const FunObjVar& fun)
     DBOUT(DMSSA, outs() << "Building Memory SSA for function " << fun.getName()
           << " \n");
 
-    usedRegs.clear();
-    reg2BBMap.clear();
-
     /// Create mus/chis for loads/stores/calls for memory regions
     double muchiStart = stat->getClk(true);
-    createMUCHI(fun);
+    createMUCHI(fun, fs);
     double muchiEnd = stat->getClk(true);
-    timeOfCreateMUCHI += (muchiEnd - muchiStart)/TIMEINTERVAL;
+    fs.timeOfCreateMUCHI += (muchiEnd - muchiStart)/TIMEINTERVAL;
 
     /// Insert PHI for memory regions
     double phiStart = stat->getClk(true);
-    insertPHI(fun);
+    insertPHI(fun, fs);
     double phiEnd = stat->getClk(true);
-    timeOfInsertingPHI += (phiEnd - phiStart)/TIMEINTERVAL;
+    fs.timeOfInsertingPHI += (phiEnd - phiStart)/TIMEINTERVAL;
 
     /// SSA rename for memory regions
     double renameStart = stat->getClk(true);
-    SSARename(fun);
+    SSARename(fun, fs);
     double renameEnd = stat->getClk(true);
-    timeOfSSARenaming += (renameEnd - renameStart)/TIMEINTERVAL;
+    fs.timeOfSSARenaming += (renameEnd - renameStart)/TIMEINTERVAL;
+
+    // Only needed while building.
+    fs.usedRegs.clear();
+    fs.reg2BBMap.clear();
+    fs.varKills.clear();
+    fs.mr2VerStackMap.clear();
+    fs.mr2CounterMap.clear();
+}
+
+/*!
+ * Move the mus/chis/phis and MRVers of fs into this MemSSA. MRVers are
+ * numbered here, in order of creation, so that IDs do not depend on which
+ * functions were built concurrently.
+ */
+void MemSSA::mergeFunBuildState(FunBuildState& fs)
+{
+    for (LoadToMUSetMap::value_type& it : fs.load2MuSetMap)
+        load2MuSetMap[it.first] = std::move(it.second);
+    for (StoreToChiSetMap::value_type& it : fs.store2ChiSetMap)
+        store2ChiSetMap[it.first] = std::move(it.second);
+    for (CallSiteToMUSetMap::value_type& it : fs.callsiteToMuSetMap)
+        callsiteToMuSetMap[it.first] = std::move(it.second);
+    for (CallSiteToCHISetMap::value_type& it : fs.callsiteToChiSetMap)
+        callsiteToChiSetMap[it.first] = std::move(it.second);
+    for (BBToPhiSetMap::value_type& it : fs.bb2PhiSetMap)
+        bb2PhiSetMap[it.first] = std::move(it.second);
+    for (FunToEntryChiSetMap::value_type& it : fs.funToEntryChiSetMap)
+        funToEntryChiSetMap[it.first] = std::move(it.second);
+    for (FunToReturnMuSetMap::value_type& it : fs.funToReturnMuSetMap)
+        funToReturnMuSetMap[it.first] = std::move(it.second);
+
+    for (std::unique_ptr<MRVer>& mrVer : fs.mrVers)
+    {
+        mrVer->vid = MRVer::totalVERNum++;
+        usedMRVers.push_back(std::move(mrVer));
+    }
+
+    timeOfCreateMUCHI += fs.timeOfCreateMUCHI;
+    timeOfInsertingPHI += fs.timeOfInsertingPHI;
+    timeOfSSARenaming += fs.timeOfSSARenaming;
 
+    fs = FunBuildState();
 }
 
 /*!
  * Create mu/chi according to memory regions
  * collect used mrs in usedRegs and construction map from region to BB for prune SSA phi insertion
  */
-void MemSSA::createMUCHI(const FunObjVar& fun)
+void MemSSA::createMUCHI(const FunObjVar& fun, FunBuildState& fs)
 {
 
 
@@ -135,7 +246,7 @@ void MemSSA::createMUCHI(const FunObjVar& fun)
             iter != eiter; ++iter)
     {
         const SVFBasicBlock* bb = *iter;
-        varKills.clear();
+        fs.varKills.clear();
         for (const auto& inst: bb->getICFGNodeList())
         {
             if(mrGen->hasSVFStmtList(inst))
@@ -146,43 +257,43 @@ void MemSSA::createMUCHI(const FunObjVar& fun)
                 {
                     const PAGEdge* inst = *bit;
                     if (const LoadStmt* load = SVFUtil::dyn_cast<LoadStmt>(inst))
-                        AddLoadMU(bb, load, mrGen->getLoadMRSet(load));
+                        AddLoadMU(fs, bb, load, mrGen->getLoadMRSet(load));
                     else if (const StoreStmt* store = SVFUtil::dyn_cast<StoreStmt>(inst))
-                        AddStoreCHI(bb, store, mrGen->getStoreMRSet(store));
+                        AddStoreCHI(fs, bb, store, mrGen->getStoreMRSet(store));
                 }
             }
             if (isNonInstricCallSite(inst))
             {
                 const CallICFGNode* cs = cast<CallICFGNode>(inst);
                 if(mrGen->hasRefMRSet(cs))
-                    AddCallSiteMU(cs,mrGen->getCallSiteRefMRSet(cs));
+                    AddCallSiteMU(fs,cs,mrGen->getCallSiteRefMRSet(cs));
 
                 if(mrGen->hasModMRSet(cs))
-                    AddCallSiteCHI(cs,mrGen->getCallSiteModMRSet(cs));
+                    AddCallSiteCHI(fs,cs,mrGen->getCallSiteModMRSet(cs));
             }
         }
     }
 
     // create entry chi for this function including all memory regions
     // initialize them with version 0 and 1 r_1 = chi (r_0)
-    for (MRSet::iterator iter = usedRegs.begin(), eiter = usedRegs.end();
+    for (MRSet::iterator iter = fs.usedRegs.begin(), eiter = fs.usedRegs.end();
             iter != eiter; ++iter)
     {
         const MemRegion* mr = *iter;
         // initialize mem region version and stack for renaming phase
-        mr2CounterMap[mr] = 0;
-        mr2VerStackMap[mr].clear();
+        fs.mr2CounterMap[mr] = 0;
+        fs.mr2VerStackMap[mr].clear();
         ENTRYCHI* chi = new ENTRYCHI(&fun, mr);
-        chi->setOpVer(newSSAName(mr,chi));
-        chi->setResVer(newSSAName(mr,chi));
-        funToEntryChiSetMap[&fun].insert(chi);
+        chi->setOpVer(newSSAName(fs,mr,chi));
+        chi->setResVer(newSSAName(fs,mr,chi));
+        fs.funToEntryChiSetMap[&fun].insert(chi);
 
         /// if the function does not have a reachable return instruction from function entry
         /// then we won't create return mu for it
         if(fun.hasReturn())
         {
             RETMU* mu = new RETMU(&fun, mr);
-            funToReturnMuSetMap[&fun].insert(mu);
+            fs.funToReturnMuSetMap[&fun].insert(mu);
         }
 
     }
@@ -192,7 +303,7 @@ void MemSSA::createMUCHI(const FunObjVar& fun)
 /*
  * Insert phi node
  */
-void MemSSA::insertPHI(const FunObjVar& fun)
+void MemSSA::insertPHI(const FunObjVar& fun, FunBuildState& fs)
 {
 
     DBOUT(DMSSA,
@@ -203,12 +314,12 @@ void MemSSA::insertPHI(const FunObjVar& fun)
     BBToMRSetMap bb2MRSetMap;
 
     // start inserting phi node
-    for (MRSet::iterator iter = usedRegs.begin(), eiter = usedRegs.end();
+    for (MRSet::iterator iter = fs.usedRegs.begin(), eiter = fs.usedRegs.end();
             iter != eiter; ++iter)
     {
         const MemRegion* mr = *iter;
 
-        BBList bbs = reg2BBMap[mr];
+        BBList bbs = fs.reg2BBMap[mr];
         while (!bbs.empty())
         {
             const SVFBasicBlock* bb = bbs.back();
@@ -227,7 +338,7 @@ void MemSSA::insertPHI(const FunObjVar& fun)
                 {
                     bb2MRSetMap[pbb].insert(mr);
                     // insert phi node
-                    AddMSSAPHI(pbb,mr);
+                    AddMSSAPHI(fs,pbb,mr);
                     // continue to insert phi in its iterative dominate frontiers
                     bbs.push_back(pbb);
                 }
@@ -240,20 +351,20 @@ void MemSSA::insertPHI(const FunObjVar& fun)
 /*!
  * SSA construction algorithm
  */
-void MemSSA::SSARename(const FunObjVar& fun)
+void MemSSA::SSARename(const FunObjVar& fun, FunBuildState& fs)
 {
 
     DBOUT(DMSSA,
           outs() << "\t ssa rename for function " << fun.getName() << "\n");
 
-    SSARenameBB(*fun.getEntryBlock());
+    SSARenameBB(*fun.getEntryBlock(), fs);
 }
 
 /*!
  * Renaming for each memory regions
  * See the renaming algorithm in book Engineering A Compiler (Figure 9.12)
  */
-void MemSSA::SSARenameBB(const SVFBasicBlock& bb)
+void MemSSA::SSARenameBB(const SVFBasicBlock& bb, FunBuildState& fs)
 {
 
     // record which mem region needs to pop stack
@@ -262,8 +373,8 @@ void MemSSA::SSARenameBB(const SVFBasicBlock& bb)
     // rename phi result op
     // for each r = phi (...)
     // 		rewrite r as new name
-    if (hasPHISet(&bb))
-        RenamePhiRes(getPHISet(&bb),memRegs);
+    if (fs.bb2PhiSetMap.find(&bb) != fs.bb2PhiSetMap.end())
+        RenamePhiRes(fs, fs.bb2PhiSetMap[&bb],memRegs);
 
 
     // process mu and chi
@@ -283,10 +394,10 @@ void MemSSA::SSARenameBB(const SVFBasicBlock& bb)
             {
                 const PAGEdge* inst = *bit;
                 if (const LoadStmt* load = SVFUtil::dyn_cast<LoadStmt>(inst))
-                    RenameMuSet(getMUSet(load));
+                    RenameMuSet(fs, fs.load2MuSetMap[load]);
 
                 else if (const StoreStmt* store = SVFUtil::dyn_cast<StoreStmt>(inst))
-                    RenameChiSet(getCHISet(store),memRegs);
+                    RenameChiSet(fs, fs.store2ChiSetMap[store],memRegs);
 
             }
         }
@@ -294,15 +405,15 @@ void MemSSA::SSARenameBB(const SVFBasicBlock& bb)
         {
             const CallICFGNode* cs = cast<CallICFGNode>(pNode);
             if(mrGen->hasRefMRSet(cs))
-                RenameMuSet(getMUSet(cs));
+                RenameMuSet(fs, fs.callsiteToMuSetMap[cs]);
 
             if(mrGen->hasModMRSet(cs))
-                RenameChiSet(getCHISet(cs),memRegs);
+                RenameChiSet(fs, fs.callsiteToChiSetMap[cs],memRegs);
         }
         else if(isRetInstNode(pNode))
         {
             const FunObjVar* fun = bb.getParent();
-            RenameMuSet(getReturnMuSet(fun));
+            RenameMuSet(fs, fs.funToReturnMuSetMap[fun]);
         }
     }
 
@@ -311,8 +422,8 @@ void MemSSA::SSARenameBB(const SVFBasicBlock& bb)
     for (const SVFBasicBlock* succ : bb.getSuccessors())
     {
         u32_t pos = bb.getBBPredecessorPos(succ);
-        if (hasPHISet(succ))
-            RenamePhiOps(getPHISet(succ),pos,memRegs);
+        if (fs.bb2PhiSetMap.find(succ) != fs.bb2PhiSetMap.end())
+            RenamePhiOps(fs, fs.bb2PhiSetMap[succ],pos,memRegs);
     }
 
     // for succ basic block in dominator tree
@@ -324,7 +435,7 @@ void MemSSA::SSARenameBB(const SVFBasicBlock& bb)
         const Set<const SVFBasicBlock*>& dtBBs = mapIter->second;
         for (const SVFBasicBlock* dtbb : dtBBs)
         {
-            SSARenameBB(*dtbb);
+            SSARenameBB(*dtbb, fs);
         }
     }
     // for each r = chi(..), and r = phi(..)
@@ -333,24 +444,25 @@ void MemSSA::SSARenameBB(const SVFBasicBlock& bb)
     {
         const MemRegion* mr = memRegs.back();
         memRegs.pop_back();
-        mr2VerStackMap[mr].pop_back();
+        fs.mr2VerStackMap[mr].pop_back();
     }
 
 }
 
-MRVer* MemSSA::newSSAName(const MemRegion* mr, MSSADEF* def)
+MRVer* MemSSA::newSSAName(FunBuildState& fs, const MemRegion* mr, MSSADEF* def)
 {
-    assert(0 != mr2CounterMap.count(mr)
+    assert(0 != fs.mr2CounterMap.count(mr)
            && "did not find initial version in map? ");
-    assert(0 != mr2VerStackMap.count(mr)
+    assert(0 != fs.mr2VerStackMap.count(mr)
            && "did not find initial stack in map? ");
 
-    MRVERSION version = mr2CounterMap[mr];
-    mr2CounterMap[mr] = version + 1;
-    auto mrVer = std::make_unique<MRVer>(mr, version, def);
-    auto mrVerPtr = mrVer.get();
-    mr2VerStackMap[mr].push_back(mrVerPtr);
-    usedMRVers.push_back(std::move(mrVer));
+    MRVERSION version = fs.mr2CounterMap[mr];
+    fs.mr2CounterMap[mr] = version + 1;
+    // Numbered by mergeFunBuildState.
+    std::unique_ptr<MRVer> mrVer(new MRVer(mr, version, def, 0));
+    MRVer* mrVerPtr = mrVer.get();
+    fs.mr2VerStackMap[mr].push_back(mrVerPtr);
+    fs.mrVers.push_back(std::move(mrVer));
     return mrVerPtr;
 }
 
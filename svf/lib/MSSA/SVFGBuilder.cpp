@@ -122,6 +122,7 @@ std::unique_ptr<MemSSA> SVFGBuilder::buildMSSA(BVDataPTAImpl* pta,
 
     auto mssa = std::make_unique<MemSSA>(pta, createMRGenerator(pta, ptrOnlyMSSA));
 
+    std::vector<const FunObjVar*> funs;
     const CallGraph* svfirCallGraph = PAG::getPAG()->getCallGraph();
     for (const auto& item : *svfirCallGraph)
     {
@@ -130,8 +131,9 @@ std::unique_ptr<MemSSA> SVFGBuilder::buildMSSA(BVDataPTAImpl* pta,
         if (isExtCall(fun))
             continue;
 
-        mssa->buildMemSSA(*fun);
+        funs.push_back(fun);
     }
+    mssa->buildMemSSA(funs);
 
     mssa->performStat();
     if (Options::DumpMSSA())
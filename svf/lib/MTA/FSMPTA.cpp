@@ -104,6 +104,7 @@ void FSMPTA<SVFGGraph>::initialize()
     svfg = mtaSVFGBuilder.buildPTROnlySVFG(ander);
 
     setGraph(svfg);
+    forwardDFInSets();
 }
 
 // The two SVFGs the solver runs on; the implementation above is written once.
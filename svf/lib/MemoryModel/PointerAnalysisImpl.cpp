@@ -33,8 +33,14 @@
 #include "MemoryModel/PTATY.h"
 #include "MemoryModel/PointerAnalysisImpl.h"
 #include "Util/Options.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "Graphs/CallGraph.h"
 
@@ -42,49 +48,129 @@ using namespace SVF;
 using namespace SVFUtil;
 using namespace std;
 
+namespace
+{
+
+/// The points-to data structures of BVDataPTAImpl with all points-to sets backed by
+/// BitVectorTy, so their set operations do not dispatch on the backing.
+///@{
+template <typename BitVectorTy>
+using MutDiffPTDataOf = MutableDiffPTData<NodeID, NodeSet, NodeID, PointsTo, BitVectorTy>;
+template <typename BitVectorTy>
+using MutDFPTDataOf = MutableDFPTData<NodeID, NodeSet, NodeID, PointsTo, BitVectorTy>;
+template <typename BitVectorTy>
+using MutIncDFPTDataOf = MutableIncDFPTData<NodeID, NodeSet, NodeID, PointsTo, BitVectorTy>;
+template <typename BitVectorTy>
+using MutVersionedPTDataOf = MutableVersionedPTData<NodeID, NodeSet, NodeID, PointsTo, VersionedVar, Set<VersionedVar>, BitVectorTy>;
+template <typename BitVectorTy>
+using PersDiffPTDataOf = PersistentDiffPTData<NodeID, NodeSet, NodeID, PointsTo, BitVectorTy>;
+template <typename BitVectorTy>
+using PersDFPTDataOf = PersistentDFPTData<NodeID, NodeSet, NodeID, PointsTo, BitVectorTy>;
+template <typename BitVectorTy>
+using PersIncDFPTDataOf = PersistentIncDFPTData<NodeID, NodeSet, NodeID, PointsTo, BitVectorTy>;
+template <typename BitVectorTy>
+using CompactDFPTDataOf = CompactDFPTData<NodeID, NodeSet, NodeID, PointsTo, BitVectorTy>;
+template <typename BitVectorTy>
+using PersVersionedPTDataOf = PersistentVersionedPTData<NodeID, NodeSet, NodeID, PointsTo, VersionedVar, Set<VersionedVar>, BitVectorTy>;
+///@}
+
+/// Returns a new PTDataImpl instantiated for the backing of points-to sets (Options::PtType).
+/// The backing is only dispatched on here rather than on every set operation.
+template <template <typename> class PTDataImpl, typename... Args>
+std::unique_ptr<BVDataPTAImpl::PTDataTy> createPTData(Args&&... args)
+{
+    switch (Options::PtType())
+    {
+    case PointsTo::SBV:
+        return std::make_unique<PTDataImpl<SparseBitVector<>>>(std::forward<Args>(args)...);
+    case PointsTo::CBV:
+        return std::make_unique<PTDataImpl<CoreBitVector>>(std::forward<Args>(args)...);
+    case PointsTo::BV:
+        return std::make_unique<PTDataImpl<BitVector>>(std::forward<Args>(args)...);
+    case PointsTo::RBV:
+        return std::make_unique<PTDataImpl<RoaringBitVector>>(std::forward<Args>(args)...);
+    default:
+        assert(false && "createPTData: unknown points-to set type!");
+        abort();
+    }
+}
+
+/// Returns f(ptD), ptD being cast to the PTDataImpl createPTData created it as.
+template <template <typename> class PTDataImpl, typename F>
+decltype(auto) visitPTData(BVDataPTAImpl::PTDataTy *ptD, F f)
+{
+    switch (Options::PtType())
+    {
+    case PointsTo::SBV:
+        return f(SVFUtil::cast<PTDataImpl<SparseBitVector<>>>(ptD));
+    case PointsTo::CBV:
+        return f(SVFUtil::cast<PTDataImpl<CoreBitVector>>(ptD));
+    case PointsTo::BV:
+        return f(SVFUtil::cast<PTDataImpl<BitVector>>(ptD));
+    case PointsTo::RBV:
+        return f(SVFUtil::cast<PTDataImpl<RoaringBitVector>>(ptD));
+    default:
+        assert(false && "visitPTData: unknown points-to set type!");
+        abort();
+    }
+}
+
+}  // End anonymous namespace
+
 /*!
  * Constructor
  */
 BVDataPTAImpl::BVDataPTAImpl(SVFIR* p, PTATY type, bool alias_check) :
     PointerAnalysis(p, type, alias_check), ptCache()
 {
+    ptCache.setOpCacheLimit((size_t)Options::PtCacheOpLimit() * 1024 * 1024);
+    ptCache.setRefCounting(Options::PtCacheGC());
+    // Installs the SIGUSR1 handler for partial profiles.
+    PointsToProfiler::get();
+
     if (type == PTATY::Andersen_BASE || type == PTATY::Andersen_WPA || type == PTATY::AndersenWaveDiff_WPA
             || type == PTATY::TypeCPP_WPA || type == PTATY::FlowS_DDA
-            || type == PTATY::AndersenSCD_WPA || type == PTATY::AndersenSFR_WPA || type == PTATY::CFLFICI_WPA || type == PTATY::CFLFSCS_WPA)
+            || type == PTATY::AndersenSCD_WPA || type == PTATY::AndersenSFR_WPA
+            || type == PTATY::AndersenLCD_WPA || type == PTATY::AndersenHLCD_WPA || type == PTATY::CFLFICI_WPA || type == PTATY::CFLFSCS_WPA)
     {
         // Only maintain reverse points-to when the analysis is field-sensitive, as objects turning
         // field-insensitive is all it is used for.
         bool maintainRevPts = Options::MaxFieldLimit() != 0;
-        if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = std::make_unique<MutDiffPTDataTy>(maintainRevPts);
-        else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = std::make_unique<PersDiffPTDataTy>(getPtCache(), maintainRevPts);
+        if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = createPTData<MutDiffPTDataOf>(maintainRevPts);
+        else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = createPTData<PersDiffPTDataOf>(getPtCache(), maintainRevPts);
         else assert(false && "BVDataPTAImpl::BVDataPTAImpl: unexpected points-to backing type!");
     }
     else if (type == PTATY::Steensgaard_WPA)
     {
         // Steensgaard is only field-insensitive (for now?), so no reverse points-to.
-        if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = std::make_unique<MutDiffPTDataTy>(false);
-        else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = std::make_unique<PersDiffPTDataTy>(getPtCache(), false);
+        if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = createPTData<MutDiffPTDataOf>(false);
+        else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = createPTData<PersDiffPTDataOf>(getPtCache(), false);
         else assert(false && "BVDataPTAImpl::BVDataPTAImpl: unexpected points-to backing type!");
     }
     else if (type == PTATY::FSSPARSE_WPA)
     {
-        if (Options::INCDFPTData())
+        if (Options::CompactDFPTData())
+        {
+            // Sets are stored directly, whatever the backing.
+            ptD = createPTData<CompactDFPTDataOf>(false);
+        }
+        else if (Options::INCDFPTData())
         {
-            if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = std::make_unique<MutIncDFPTDataTy>(false);
-            else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = std::make_unique<PersIncDFPTDataTy>(getPtCache(), false);
+            if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = createPTData<MutIncDFPTDataOf>(false);
+            else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = createPTData<PersIncDFPTDataOf>(getPtCache(), false);
             else assert(false && "BVDataPTAImpl::BVDataPTAImpl: unexpected points-to backing type!");
         }
         else
         {
-            if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = std::make_unique<MutDFPTDataTy>(false);
-            else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = std::make_unique<PersDFPTDataTy>(getPtCache(), false);
+            if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = createPTData<MutDFPTDataOf>(false);
+            else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = createPTData<PersDFPTDataOf>(getPtCache(), false);
             else assert(false && "BVDataPTAImpl::BVDataPTAImpl: unexpected points-to backing type!");
         }
     }
     else if (type == PTATY::VFS_WPA)
     {
-        if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = std::make_unique<MutVersionedPTDataTy>(false);
-        else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = std::make_unique<PersVersionedPTDataTy>(getPtCache(), false);
+        if (Options::ptDataBacking() == PTBackingType::Mutable) ptD = createPTData<MutVersionedPTDataOf>(false);
+        else if (Options::ptDataBacking() == PTBackingType::Persistent) ptD = createPTData<PersVersionedPTDataOf>(getPtCache(), false);
         else assert(false && "BVDataPTAImpl::BVDataPTAImpl: unexpected points-to backing type!");
     }
     else assert(false && "no points-to data available");
@@ -92,6 +178,22 @@ BVDataPTAImpl::BVDataPTAImpl(SVFIR* p, PTATY type, bool alias_check) :
     ptaImplTy = PTAImplTy::BVDataImpl;
 }
 
+const BVDataPTAImpl::MutDFPTDataTy::DFPtsMap& BVDataPTAImpl::getMutDFIn() const
+{
+    return visitPTData<MutDFPTDataOf>(ptD.get(), [](auto *mdf) -> const MutDFPTDataTy::DFPtsMap&
+    {
+        return mdf->getDFIn();
+    });
+}
+
+const BVDataPTAImpl::MutDFPTDataTy::DFPtsMap& BVDataPTAImpl::getMutDFOut() const
+{
+    return visitPTData<MutDFPTDataOf>(ptD.get(), [](auto *mdf) -> const MutDFPTDataTy::DFPtsMap&
+    {
+        return mdf->getDFOut();
+    });
+}
+
 void BVDataPTAImpl::finalize()
 {
     normalizePointsTo();
@@ -106,7 +208,8 @@ void BVDataPTAImpl::finalize()
 
         std::string subtitle;
 
-        if(ptaTy >= PTATY::Andersen_BASE && ptaTy <= PTATY::Steensgaard_WPA)
+        if((ptaTy >= PTATY::Andersen_BASE && ptaTy <= PTATY::Steensgaard_WPA)
+                || ptaTy == PTATY::AndersenLCD_WPA || ptaTy == PTATY::AndersenHLCD_WPA)
             subtitle = "Andersen's analysis bitvector";
         else if(ptaTy >= PTATY::FSDATAFLOW_WPA && ptaTy <= PTATY::FSCS_WPA)
             subtitle = "flow-sensitive analysis bitvector";
@@ -127,6 +230,20 @@ void BVDataPTAImpl::finalize()
         SVFUtil::outs().flush();
     }
 
+    if (PointsToProfiler::get() != nullptr) profilePts(false);
+}
+
+void BVDataPTAImpl::profilePts(bool partial)
+{
+    PointsToProfiler *profiler = PointsToProfiler::get();
+    if (profiler == nullptr) return;
+
+    profiler->begin(PTAName(), ptaTy, Options::ptDataBacking());
+    ptD->visitPts([profiler](const NodeID& var, const PointsTo& pts)
+    {
+        profiler->addPts(var, pts);
+    });
+    profiler->end(partial);
 }
 
 /*!
@@ -163,6 +280,23 @@ void BVDataPTAImpl::remapPointsToSets(void)
 
 void BVDataPTAImpl::writeObjVarToFile(const string& filename)
 {
+    if (writesBinaryPtsFile())
+    {
+        // The binary file is written in one go by writeToFile; only remember
+        // what the SVFIR looked like before solving.
+        preSolveFingerprint = getSVFIRFingerprint();
+        preSolveObjFI.clear();
+        NodeBS baseIDs;
+        for (auto it = pag->begin(), ie = pag->end(); it != ie; ++it)
+        {
+            if (!isa<ObjVar>(it->second)) continue;
+            NodeID n = pag->getBaseObjVarID(it->first);
+            if (baseIDs.test_and_set(n))
+                preSolveObjFI.push_back(std::make_pair(n, isFieldInsensitive(n)));
+        }
+        return;
+    }
+
     outs() << "Storing ObjVar to '" << filename << "'...";
     error_code err;
     std::fstream f(filename.c_str(), std::ios_base::out);
@@ -247,6 +381,11 @@ void BVDataPTAImpl::writeGepObjVarMapToFile(std::fstream& f)
  */
 void BVDataPTAImpl::writeToFile(const string& filename)
 {
+    if (writesBinaryPtsFile())
+    {
+        writeToBinaryFile(filename);
+        return;
+    }
 
     outs() << "Storing pointer analysis results to '" << filename << "'...";
 
@@ -412,6 +551,8 @@ void BVDataPTAImpl::readAndSetObjFieldSensitivity(std::ifstream& F, const std::s
  */
 bool BVDataPTAImpl::readFromFile(const string& filename)
 {
+    if (isBinaryPtsFile(filename))
+        return readFromBinaryFile(filename);
 
     outs() << "Loading pointer analysis results from '" << filename << "'...";
 
@@ -440,6 +581,550 @@ bool BVDataPTAImpl::readFromFile(const string& filename)
 }
 
 
+void BVDataPTAImpl::restoreGepObjVar(NodeID base, const APOffset& offset, NodeID id)
+{
+    pag->addGepObjNode(pag->getBaseObject(base), offset, id);
+    NodeIDAllocator::get()->increaseNumOfObjAndNodes();
+}
+
+bool BVDataPTAImpl::writesBinaryPtsFile() const
+{
+    return Options::BinaryAnder();
+}
+
+/*
+ * Binary analysis result format (native endianness, all offsets in bytes):
+ *
+ *   BinPtsHeader
+ *   BinPtsSection[numSections]
+ *   section payloads, each 8-byte aligned
+ *
+ * Sections:
+ *   PreObjFI   {u32 base, u32 insensitive}*    base objects before solving
+ *   PtsSets    u32 numSets, u32 numElems, u32 offsets[numSets + 1], u32 elems[numElems]
+ *              each distinct points-to set is stored once; set 0 is the empty set
+ *   NodeToSet  {u32 node, u32 setId}*          one entry per SVFIR node
+ *   GepObjs    {u32 base, u32 id, s64 offset}*  gep objects created while solving
+ *   PostObjFI  {u32 base, u32 insensitive}*    base objects after solving
+ */
+namespace
+{
+
+const char BinPtsMagic[8] = {'S', 'V', 'F', 'P', 'T', 'S', '\0', '\0'};
+const u32_t BinPtsVersion = 1;
+
+enum BinPtsSectionKind : u32_t
+{
+    PreObjFI,
+    PtsSets,
+    NodeToSet,
+    GepObjs,
+    PostObjFI,
+    NumOfBinPtsSections
+};
+
+struct BinPtsHeader
+{
+    char magic[8];
+    u32_t version;
+    u32_t numSections;
+    u64_t fingerprint;
+    u64_t numOfNodes;
+};
+
+struct BinPtsSection
+{
+    u32_t kind;
+    u32_t reserved;
+    u64_t offset;
+    u64_t size;
+};
+
+struct BinGepObj
+{
+    u32_t base;
+    u32_t id;
+    s64_t offset;
+};
+
+template <typename T>
+inline void appendBinPts(std::string& buf, const T* data, size_t num)
+{
+    buf.append(reinterpret_cast<const char*>(data), num * sizeof(T));
+}
+
+} // End anonymous namespace
+
+/*!
+ * FNV-1a over the id and kind of every SVFIR node
+ */
+u64_t BVDataPTAImpl::getSVFIRFingerprint() const
+{
+    u64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](u64_t v)
+    {
+        for (u32_t i = 0; i < sizeof(v); ++i)
+        {
+            hash ^= (v >> (i * 8)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(pag->getTotalNodeNum());
+    for (auto it = pag->begin(), ie = pag->end(); it != ie; ++it)
+    {
+        mix(it->first);
+        mix(it->second->getNodeKind());
+    }
+    return hash;
+}
+
+bool BVDataPTAImpl::isBinaryPtsFile(const std::string& filename)
+{
+    ifstream F(filename.c_str(), std::ios::binary);
+    char magic[sizeof(BinPtsMagic)];
+    if (!F.read(magic, sizeof(magic)))
+        return false;
+    return memcmp(magic, BinPtsMagic, sizeof(magic)) == 0;
+}
+
+/*!
+ * Store pointer analysis results in the binary format.
+ * writeObjVarToFile must have been called before solving.
+ */
+void BVDataPTAImpl::writeToBinaryFile(const std::string& filename)
+{
+    outs() << "Storing pointer analysis results (binary) to '" << filename << "'...";
+
+    std::string payload[NumOfBinPtsSections];
+
+    for (const std::pair<NodeID, bool>& fi : preSolveObjFI)
+    {
+        u32_t entry[2] = {fi.first, fi.second};
+        appendBinPts(payload[PreObjFI], entry, 2);
+    }
+
+    // Deduplicate points-to sets; set 0 is the empty set.
+    Map<PointsTo, u32_t> ptsToSetId;
+    ptsToSetId[PointsTo()] = 0;
+    std::vector<u32_t> offsets = {0, 0};
+    std::vector<u32_t> elems;
+    for (auto it = pag->begin(), ie = pag->end(); it != ie; ++it)
+    {
+        const PointsTo& pts = getPts(it->first);
+        auto inserted = ptsToSetId.emplace(pts, offsets.size() - 1);
+        if (inserted.second)
+        {
+            for (NodeID o : pts) elems.push_back(o);
+            offsets.push_back(elems.size());
+        }
+        u32_t entry[2] = {it->first, inserted.first->second};
+        appendBinPts(payload[NodeToSet], entry, 2);
+    }
+    u32_t numSets = offsets.size() - 1;
+    u32_t numElems = elems.size();
+    appendBinPts(payload[PtsSets], &numSets, 1);
+    appendBinPts(payload[PtsSets], &numElems, 1);
+    appendBinPts(payload[PtsSets], offsets.data(), offsets.size());
+    appendBinPts(payload[PtsSets], elems.data(), elems.size());
+
+    const SVFIR::OffsetToGepVarMap& gepObjVarMap = pag->getGepObjNodeMap();
+    for (const auto& gep : gepObjVarMap)
+    {
+        BinGepObj entry = {gep.first.first, gep.second, gep.first.second};
+        appendBinPts(payload[GepObjs], &entry, 1);
+    }
+
+    NodeBS baseIDs;
+    for (auto it = pag->begin(), ie = pag->end(); it != ie; ++it)
+    {
+        if (!isa<ObjVar>(it->second)) continue;
+        NodeID n = pag->getBaseObjVarID(it->first);
+        if (!baseIDs.test_and_set(n)) continue;
+        u32_t entry[2] = {n, isFieldInsensitive(n)};
+        appendBinPts(payload[PostObjFI], entry, 2);
+    }
+
+    BinPtsHeader header;
+    memcpy(header.magic, BinPtsMagic, sizeof(BinPtsMagic));
+    header.version = BinPtsVersion;
+    header.numSections = NumOfBinPtsSections;
+    header.fingerprint = preSolveFingerprint;
+    header.numOfNodes = pag->getTotalNodeNum();
+
+    BinPtsSection sections[NumOfBinPtsSections];
+    u64_t offset = sizeof(header) + sizeof(sections);
+    for (u32_t k = 0; k < NumOfBinPtsSections; ++k)
+    {
+        offset = (offset + 7) & ~7ULL;
+        sections[k] = {k, 0, offset, payload[k].size()};
+        offset += payload[k].size();
+    }
+
+    std::ofstream f(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!f.good())
+    {
+        outs() << "  error opening file for writing!\n";
+        return;
+    }
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    f.write(reinterpret_cast<const char*>(sections), sizeof(sections));
+    for (u32_t k = 0; k < NumOfBinPtsSections; ++k)
+    {
+        static const char zeros[8] = {0};
+        f.write(zeros, sections[k].offset - f.tellp());
+        f.write(payload[k].data(), payload[k].size());
+    }
+
+    f.close();
+    if (f.good())
+        outs() << "\n";
+    else
+        outs() << "  error writing file!\n";
+}
+
+namespace
+{
+
+/*!
+ * A binary result file mapped into memory, its header, section table and
+ * points-to section checked when opened. Sections are read straight from
+ * the mapping, which lasts as long as this.
+ */
+class BinPtsFile
+{
+public:
+    BinPtsFile() : mapped(MAP_FAILED), fileSize(0), base(nullptr), sections(nullptr) {}
+
+    ~BinPtsFile()
+    {
+        if (mapped != MAP_FAILED)
+            munmap(mapped, fileSize);
+    }
+
+    BinPtsFile(const BinPtsFile&) = delete;
+    BinPtsFile& operator=(const BinPtsFile&) = delete;
+
+    /// Map and check filename, printing why it can not be read if so
+    bool open(const std::string& filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(BinPtsHeader))
+        {
+            if (fd >= 0) close(fd);
+            outs() << "  error opening file for reading!\n";
+            return false;
+        }
+        fileSize = st.st_size;
+        mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            outs() << "  error mapping file!\n";
+            return false;
+        }
+        base = static_cast<const char*>(mapped);
+
+        auto fail = [](const char* msg)
+        {
+            outs() << "  " << msg << "\n";
+            return false;
+        };
+
+        if (getHeader().version != BinPtsVersion || getHeader().numSections != NumOfBinPtsSections
+                || fileSize < sizeof(BinPtsHeader) + NumOfBinPtsSections * sizeof(BinPtsSection))
+            return fail("unsupported binary format version!");
+
+        sections = reinterpret_cast<const BinPtsSection*>(base + sizeof(BinPtsHeader));
+        for (u32_t k = 0; k < NumOfBinPtsSections; ++k)
+        {
+            if (sections[k].kind != k || sections[k].offset + sections[k].size > fileSize)
+                return fail("corrupt section table!");
+        }
+
+        const u32_t* ptsSets = data(PtsSets);
+        if (words(PtsSets) < 2 || words(PtsSets) != 2 + (size_t)ptsSets[0] + 1 + ptsSets[1])
+            return fail("corrupt points-to section!");
+        const u32_t* offsets = ptsSets + 2;
+        for (u32_t setId = 0; setId < getNumOfSets(); ++setId)
+        {
+            if (offsets[setId] > offsets[setId + 1] || offsets[setId + 1] > ptsSets[1])
+                return fail("corrupt points-to section!");
+        }
+
+        const u32_t* nodeToSet = data(NodeToSet);
+        for (size_t i = 0; i + 1 < words(NodeToSet); i += 2)
+        {
+            if (nodeToSet[i + 1] >= getNumOfSets())
+                return fail("corrupt node to points-to set entry!");
+        }
+
+        return true;
+    }
+
+    inline const BinPtsHeader& getHeader() const
+    {
+        return *reinterpret_cast<const BinPtsHeader*>(base);
+    }
+    inline const u32_t* data(BinPtsSectionKind k) const
+    {
+        return reinterpret_cast<const u32_t*>(base + sections[k].offset);
+    }
+    inline size_t words(BinPtsSectionKind k) const
+    {
+        return sections[k].size / sizeof(u32_t);
+    }
+
+    /// Points-to sets
+    //@{
+    inline u32_t getNumOfSets() const
+    {
+        return data(PtsSets)[0];
+    }
+    /// Objects of setId, in [setBegin(setId), setEnd(setId))
+    inline const u32_t* setBegin(u32_t setId) const
+    {
+        const u32_t* offsets = data(PtsSets) + 2;
+        return offsets + getNumOfSets() + 1 + offsets[setId];
+    }
+    inline const u32_t* setEnd(u32_t setId) const
+    {
+        const u32_t* offsets = data(PtsSets) + 2;
+        return offsets + getNumOfSets() + 1 + offsets[setId + 1];
+    }
+    //@}
+
+    /// Gep objects
+    //@{
+    inline size_t getNumOfGepObjs() const
+    {
+        return sections[GepObjs].size / sizeof(BinGepObj);
+    }
+    inline const BinGepObj& getGepObj(size_t i) const
+    {
+        return reinterpret_cast<const BinGepObj*>(base + sections[GepObjs].offset)[i];
+    }
+    //@}
+
+    /// Read the {base, insensitive} entries of PreObjFI or PostObjFI
+    void readObjFI(BinPtsSectionKind k, std::vector<std::pair<NodeID, bool>>& objFI) const
+    {
+        const u32_t* fi = data(k);
+        for (size_t i = 0; i + 1 < words(k); i += 2)
+            objFI.push_back(std::make_pair(fi[i], fi[i + 1] != 0));
+    }
+
+private:
+    void* mapped;
+    size_t fileSize;
+    const char* base;
+    const BinPtsSection* sections;
+};
+
+} // End anonymous namespace
+
+/*!
+ * Load pointer analysis results stored in the binary format.
+ * Points-to sets are decoded from the mapped file straight into the
+ * points-to data, each distinct set once, so only one is held at a time.
+ */
+bool BVDataPTAImpl::readFromBinaryFile(const std::string& filename)
+{
+    outs() << "Loading pointer analysis results (binary) from '" << filename << "'...";
+
+    BinPtsFile file;
+    if (!file.open(filename))
+        return false;
+
+    if (file.getHeader().fingerprint != getSVFIRFingerprint())
+    {
+        outs() << "  SVFIR does not match the one the results were computed on!\n";
+        return false;
+    }
+
+    // The gep objects of the file must bring the SVFIR to the size it had
+    // after solving, which is checked before anything is changed.
+    const SVFIR::OffsetToGepVarMap& gepObjVarMap = pag->getGepObjNodeMap();
+    u64_t numOfNodes = pag->getTotalNodeNum();
+    for (size_t i = 0; i < file.getNumOfGepObjs(); ++i)
+    {
+        const BinGepObj& gep = file.getGepObj(i);
+        if (gepObjVarMap.find(std::make_pair(gep.base, gep.offset)) == gepObjVarMap.end())
+            ++numOfNodes;
+    }
+    if (numOfNodes != file.getHeader().numOfNodes)
+    {
+        outs() << "  number of SVFIR nodes does not match the one after solving!\n";
+        return false;
+    }
+
+    std::vector<std::pair<NodeID, bool>> objFI;
+    file.readObjFI(PreObjFI, objFI);
+    for (const std::pair<NodeID, bool>& fi : objFI)
+    {
+        if (fi.second) setObjFieldInsensitive(fi.first);
+    }
+
+    // Group the nodes by set to decode each set once. Set 0 is the empty set.
+    std::vector<std::pair<u32_t, NodeID>> setToNode;
+    const u32_t* nodeToSet = file.data(NodeToSet);
+    for (size_t i = 0; i + 1 < file.words(NodeToSet); i += 2)
+    {
+        if (nodeToSet[i + 1] != 0)
+            setToNode.push_back(std::make_pair(nodeToSet[i + 1], nodeToSet[i]));
+    }
+    std::sort(setToNode.begin(), setToNode.end());
+
+    PTDataTy *ptD = getPTDataTy();
+    PointsTo pts;
+    for (size_t i = 0; i < setToNode.size(); ++i)
+    {
+        const u32_t setId = setToNode[i].first;
+        if (i == 0 || setToNode[i - 1].first != setId)
+        {
+            pts.clear();
+            for (const u32_t* o = file.setBegin(setId), *oe = file.setEnd(setId); o != oe; ++o)
+                pts.set(*o);
+        }
+        ptD->unionPts(setToNode[i].second, pts);
+    }
+
+    for (size_t i = 0; i < file.getNumOfGepObjs(); ++i)
+    {
+        const BinGepObj& gep = file.getGepObj(i);
+        if (gepObjVarMap.find(std::make_pair(gep.base, gep.offset)) == gepObjVarMap.end())
+            restoreGepObjVar(gep.base, gep.offset, gep.id);
+    }
+
+    objFI.clear();
+    file.readObjFI(PostObjFI, objFI);
+    for (const std::pair<NodeID, bool>& fi : objFI)
+    {
+        if (fi.second) setObjFieldInsensitive(fi.first);
+    }
+
+    // Update callgraph
+    updateCallGraph(pag->getIndirectCallsites());
+
+    outs() << "\n";
+    return true;
+}
+
+/*!
+ * Read a binary result file into a snapshot.
+ */
+static bool readBinarySnapshot(const std::string& filename, BVDataPTAImpl::PtsSnapshot& snapshot)
+{
+    BinPtsFile file;
+    if (!file.open(filename))
+        return false;
+    snapshot.fingerprint = file.getHeader().fingerprint;
+    snapshot.numOfNodes = file.getHeader().numOfNodes;
+
+    file.readObjFI(PreObjFI, snapshot.preSolveObjFI);
+
+    snapshot.ptsSets.resize(file.getNumOfSets());
+    for (u32_t setId = 0; setId < file.getNumOfSets(); ++setId)
+    {
+        for (const u32_t* o = file.setBegin(setId), *oe = file.setEnd(setId); o != oe; ++o)
+            snapshot.ptsSets[setId].set(*o);
+    }
+
+    const u32_t* nodeToSet = file.data(NodeToSet);
+    for (size_t i = 0; i + 1 < file.words(NodeToSet); i += 2)
+    {
+        // Set 0 is the empty set.
+        if (nodeToSet[i + 1] != 0)
+            snapshot.nodeToSet.push_back(std::make_pair(nodeToSet[i], nodeToSet[i + 1]));
+    }
+
+    for (size_t i = 0; i < file.getNumOfGepObjs(); ++i)
+    {
+        const BinGepObj& gep = file.getGepObj(i);
+        snapshot.gepObjs.push_back(std::make_tuple(gep.base, gep.offset, gep.id));
+    }
+
+    file.readObjFI(PostObjFI, snapshot.postSolveObjFI);
+    return true;
+}
+
+/*!
+ * Read stored pointer analysis results into a snapshot, leaving the SVFIR
+ * and the points-to data of this analysis untouched.
+ */
+bool BVDataPTAImpl::readSnapshotFromFile(const std::string& filename, PtsSnapshot& snapshot)
+{
+    if (isBinaryPtsFile(filename))
+        return readBinarySnapshot(filename, snapshot);
+
+    ifstream F(filename.c_str());
+    if (!F.is_open())
+    {
+        outs() << "  error opening file for reading!\n";
+        return false;
+    }
+
+    string line;
+    auto readObjFI = [&](std::vector<std::pair<NodeID, bool>>& objFI, const std::string& delimiterStr)
+    {
+        while (getline(F, line))
+        {
+            if (line.empty() || line == delimiterStr)
+                break;
+            istringstream ss(line);
+            NodeID base;
+            bool insensitive;
+            ss >> base >> insensitive;
+            objFI.push_back(std::make_pair(base, insensitive));
+        }
+    };
+
+    readObjFI(snapshot.preSolveObjFI, "------");
+
+    // Parse "var -> { obj1 obj2 obj3 }" lines, sharing identical sets.
+    Map<std::string, u32_t> strToSet;
+    const string delimiter1 = " -> { ";
+    const string delimiter2 = " }";
+    while (getline(F, line))
+    {
+        if (line.empty() || line.at(0) == '[' || line == "---VERSIONED---") continue;
+        if (line == "------")   break;
+        size_t pos = line.find(delimiter1);
+        if (pos == string::npos || line.back() != '}')  break;
+
+        NodeID var = atoi(line.substr(0, pos).c_str());
+        pos = pos + delimiter1.length();
+        string objs = line.substr(pos, line.length() - pos - delimiter2.length());
+        if (objs.find_first_not_of(' ') == string::npos) continue;
+
+        auto inserted = strToSet.emplace(objs, snapshot.ptsSets.size());
+        if (inserted.second)
+        {
+            snapshot.ptsSets.emplace_back();
+            istringstream ss(objs);
+            NodeID obj;
+            while (ss >> obj)
+                snapshot.ptsSets.back().set(obj);
+        }
+        snapshot.nodeToSet.push_back(std::make_pair(var, inserted.first->second));
+    }
+
+    // Parse "baseID offset gepObjNodeId" lines.
+    while (getline(F, line))
+    {
+        if (line == "------")   break;
+        istringstream ss(line);
+        NodeID base, id;
+        APOffset offset;
+        if (ss >> base >> offset >> id)
+            snapshot.gepObjs.push_back(std::make_tuple(base, offset, id));
+    }
+
+    readObjFI(snapshot.postSolveObjFI, "");
+
+    return true;
+}
+
 /*!
  * Dump points-to of each pag node
  */
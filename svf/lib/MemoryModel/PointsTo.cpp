@@ -9,6 +9,7 @@
  *      Author: Mohamad Barbar
  */
 
+#include <algorithm>
 #include <new>
 #include <utility>
 
@@ -22,42 +23,67 @@ namespace SVF
 PointsTo::MappingPtr PointsTo::currentBestNodeMapping = nullptr;
 PointsTo::MappingPtr PointsTo::currentBestReverseNodeMapping = nullptr;
 
+namespace
+{
+
+/// Copies the (internal) elements of bv into elems if there are at most
+/// max of them. Returns their number, or max + 1 if there are more.
+template <typename BitVectorTy>
+u32_t collectSmall(const BitVectorTy &bv, NodeID *elems, u32_t max)
+{
+    u32_t n = 0;
+    for (const NodeID o : bv)
+    {
+        if (n == max) return max + 1;
+        elems[n++] = o;
+    }
+
+    return n;
+}
+
+}  // End anonymous namespace
+
 PointsTo::PointsTo()
-    : type(Options::PtType()), nodeMapping(currentBestNodeMapping),
-      reverseNodeMapping(currentBestReverseNodeMapping)
+    : type(Options::PtType()), smallCount(Options::PtInline() ? 0 : NotSmall),
+      nodeMapping(currentBestNodeMapping), reverseNodeMapping(currentBestReverseNodeMapping)
 {
-    if (type == SBV) new (&sbv) SparseBitVector<>();
-    else if (type == CBV) new (&cbv) CoreBitVector();
-    else if (type == BV) new (&bv) BitVector();
-    else assert(false && "PointsTo::PointsTo: unknown type");
+    if (!isSmall()) constructBacking();
 }
 
 PointsTo::PointsTo(const PointsTo &pt)
-    : type(pt.type), nodeMapping(pt.nodeMapping),
+    : type(pt.type), smallCount(pt.smallCount), nodeMapping(pt.nodeMapping),
       reverseNodeMapping(pt.reverseNodeMapping)
 {
-    if (type == SBV) new (&sbv) SparseBitVector<>(pt.sbv);
+    if (isSmall()) std::copy(pt.smallSet, pt.smallSet + smallCount, smallSet);
+    else if (type == SBV) new (&sbv) SparseBitVector<>(pt.sbv);
     else if (type == CBV) new (&cbv) CoreBitVector(pt.cbv);
     else if (type == BV) new (&bv) BitVector(pt.bv);
+    else if (type == RBV) new (&rbv) RoaringBitVector(pt.rbv);
     else assert(false && "PointsTo::PointsTo&: unknown type");
 }
 
 PointsTo::PointsTo(PointsTo &&pt)
-noexcept     : type(pt.type), nodeMapping(std::move(pt.nodeMapping)),
+noexcept     : type(pt.type), smallCount(pt.smallCount), nodeMapping(std::move(pt.nodeMapping)),
     reverseNodeMapping(std::move(pt.reverseNodeMapping))
 {
-    if (type == SBV) new (&sbv) SparseBitVector<>(std::move(pt.sbv));
+    if (isSmall()) std::copy(pt.smallSet, pt.smallSet + smallCount, smallSet);
+    else if (type == SBV) new (&sbv) SparseBitVector<>(std::move(pt.sbv));
     else if (type == CBV) new (&cbv) CoreBitVector(std::move(pt.cbv));
     else if (type == BV) new (&bv) BitVector(std::move(pt.bv));
+    else if (type == RBV) new (&rbv) RoaringBitVector(std::move(pt.rbv));
     else assert(false && "PointsTo::PointsTo&&: unknown type");
+
+    // Leave pt as a valid (empty) small set.
+    if (Options::PtInline() && !pt.isSmall())
+    {
+        pt.destroyBacking();
+        pt.smallCount = 0;
+    }
 }
 
 PointsTo::~PointsTo()
 {
-    if (type == SBV) sbv.~SparseBitVector<>();
-    else if (type == CBV) cbv.~CoreBitVector();
-    else if (type == BV) bv.~BitVector();
-    else assert(false && "PointsTo::~PointsTo: unknown type");
+    if (!isSmall()) destroyBacking();
 
     nodeMapping = nullptr;
     reverseNodeMapping = nullptr;
@@ -67,14 +93,18 @@ PointsTo &PointsTo::operator=(const PointsTo &rhs)
 {
     if (this == &rhs)
         return *this;
+    if (!isSmall()) destroyBacking();
     this->type = rhs.type;
+    this->smallCount = rhs.smallCount;
     this->nodeMapping = rhs.nodeMapping;
     this->reverseNodeMapping = rhs.reverseNodeMapping;
     // Placement new because if type has changed, we have
     // not constructed the new type yet.
-    if (type == SBV) new (&sbv) SparseBitVector<>(rhs.sbv);
+    if (isSmall()) std::copy(rhs.smallSet, rhs.smallSet + smallCount, smallSet);
+    else if (type == SBV) new (&sbv) SparseBitVector<>(rhs.sbv);
     else if (type == CBV) new (&cbv) CoreBitVector(rhs.cbv);
     else if (type == BV) new (&bv) BitVector(rhs.bv);
+    else if (type == RBV) new (&rbv) RoaringBitVector(rhs.rbv);
     else assert(false && "PointsTo::PointsTo=&: unknown type");
 
     return *this;
@@ -83,23 +113,38 @@ PointsTo &PointsTo::operator=(const PointsTo &rhs)
 PointsTo &PointsTo::operator=(PointsTo &&rhs)
 noexcept
 {
+    if (this == &rhs)
+        return *this;
+    if (!isSmall()) destroyBacking();
     this->type = rhs.type;
+    this->smallCount = rhs.smallCount;
     this->nodeMapping = rhs.nodeMapping;
     this->reverseNodeMapping = rhs.reverseNodeMapping;
     // See comment in copy assignment.
-    if (type == SBV) new (&sbv) SparseBitVector<>(std::move(rhs.sbv));
+    if (isSmall()) std::copy(rhs.smallSet, rhs.smallSet + smallCount, smallSet);
+    else if (type == SBV) new (&sbv) SparseBitVector<>(std::move(rhs.sbv));
     else if (type == CBV) new (&cbv) CoreBitVector(std::move(rhs.cbv));
     else if (type == BV) new (&bv) BitVector(std::move(rhs.bv));
+    else if (type == RBV) new (&rbv) RoaringBitVector(std::move(rhs.rbv));
     else assert(false && "PointsTo::PointsTo=&&: unknown type");
 
+    // See comment in move constructor.
+    if (Options::PtInline() && !rhs.isSmall())
+    {
+        rhs.destroyBacking();
+        rhs.smallCount = 0;
+    }
+
     return *this;
 }
 
 bool PointsTo::empty() const
 {
-    if (type == CBV) return cbv.empty();
+    if (isSmall()) return smallCount == 0;
+    else if (type == CBV) return cbv.empty();
     else if (type == SBV) return sbv.empty();
     else if (type == BV) return bv.empty();
+    else if (type == RBV) return rbv.empty();
     else
     {
         assert(false && "PointsTo::empty: unknown type");
@@ -110,9 +155,11 @@ bool PointsTo::empty() const
 /// Returns number of elements.
 u32_t PointsTo::count(void) const
 {
-    if (type == CBV) return cbv.count();
+    if (isSmall()) return smallCount;
+    else if (type == CBV) return cbv.count();
     else if (type == SBV) return sbv.count();
     else if (type == BV) return bv.count();
+    else if (type == RBV) return rbv.count();
     else
     {
         assert(false && "PointsTo::count: unknown type");
@@ -122,18 +169,46 @@ u32_t PointsTo::count(void) const
 
 void PointsTo::clear()
 {
-    if (type == CBV) cbv.clear();
+    if (isSmall()) smallCount = 0;
+    else if (Options::PtInline())
+    {
+        destroyBacking();
+        smallCount = 0;
+    }
+    else if (type == CBV) cbv.clear();
     else if (type == SBV) sbv.clear();
     else if (type == BV) bv.clear();
+    else if (type == RBV) rbv.clear();
     else assert(false && "PointsTo::clear: unknown type");
 }
 
 bool PointsTo::test(u32_t n) const
 {
-    n = getInternalNode(n);
-    if (type == CBV) return cbv.test(n);
+    return testInternal(getInternalNode(n));
+}
+
+bool PointsTo::test_and_set(u32_t n)
+{
+    return testAndSetInternal(getInternalNode(n));
+}
+
+void PointsTo::set(u32_t n)
+{
+    testAndSetInternal(getInternalNode(n));
+}
+
+void PointsTo::reset(u32_t n)
+{
+    resetInternal(getInternalNode(n));
+}
+
+bool PointsTo::testInternal(u32_t n) const
+{
+    if (isSmall()) return std::binary_search(smallSet, smallSet + smallCount, n);
+    else if (type == CBV) return cbv.test(n);
     else if (type == SBV) return sbv.test(n);
     else if (type == BV) return bv.test(n);
+    else if (type == RBV) return rbv.test(n);
     else
     {
         assert(false && "PointsTo::test: unknown type");
@@ -141,12 +216,27 @@ bool PointsTo::test(u32_t n) const
     }
 }
 
-bool PointsTo::test_and_set(u32_t n)
+bool PointsTo::testAndSetInternal(u32_t n)
 {
-    n = getInternalNode(n);
+    if (isSmall())
+    {
+        NodeID *pos = std::lower_bound(smallSet, smallSet + smallCount, n);
+        if (pos != smallSet + smallCount && *pos == n) return false;
+        if (smallCount < SmallSetSize)
+        {
+            std::copy_backward(pos, smallSet + smallCount, smallSet + smallCount + 1);
+            *pos = n;
+            ++smallCount;
+            return true;
+        }
+
+        promote();
+    }
+
     if (type == CBV) return cbv.test_and_set(n);
     else if (type == SBV) return sbv.test_and_set(n);
     else if (type == BV) return bv.test_and_set(n);
+    else if (type == RBV) return rbv.test_and_set(n);
     else
     {
         assert(false && "PointsTo::test_and_set: unknown type");
@@ -154,31 +244,95 @@ bool PointsTo::test_and_set(u32_t n)
     }
 }
 
-void PointsTo::set(u32_t n)
+void PointsTo::resetInternal(u32_t n)
 {
-    n = getInternalNode(n);
-    if (type == CBV) cbv.set(n);
-    else if (type == SBV) sbv.set(n);
-    else if (type == BV) bv.set(n);
-    else assert(false && "PointsTo::set: unknown type");
-}
+    if (isSmall())
+    {
+        NodeID *pos = std::lower_bound(smallSet, smallSet + smallCount, n);
+        if (pos == smallSet + smallCount || *pos != n) return;
+        std::copy(pos + 1, smallSet + smallCount, pos);
+        --smallCount;
+        return;
+    }
 
-void PointsTo::reset(u32_t n)
-{
-    n = getInternalNode(n);
     if (type == CBV) cbv.reset(n);
     else if (type == SBV) sbv.reset(n);
     else if (type == BV) bv.reset(n);
+    else if (type == RBV) rbv.reset(n);
     else assert(false && "PointsTo::reset: unknown type");
+
+    demoteIfSmall();
+}
+
+void PointsTo::constructBacking()
+{
+    if (type == SBV) new (&sbv) SparseBitVector<>();
+    else if (type == CBV) new (&cbv) CoreBitVector();
+    else if (type == BV) new (&bv) BitVector();
+    else if (type == RBV) new (&rbv) RoaringBitVector();
+    else assert(false && "PointsTo::PointsTo: unknown type");
+}
+
+void PointsTo::destroyBacking()
+{
+    if (type == SBV) sbv.~SparseBitVector<>();
+    else if (type == CBV) cbv.~CoreBitVector();
+    else if (type == BV) bv.~BitVector();
+    else if (type == RBV) rbv.~RoaringBitVector();
+    else assert(false && "PointsTo::~PointsTo: unknown type");
+}
+
+void PointsTo::promote()
+{
+    assert(isSmall() && "PointsTo::promote: already promoted!");
+    // smallSet shares storage with the backing.
+    NodeID elems[SmallSetSize];
+    const u32_t n = smallCount;
+    std::copy(smallSet, smallSet + n, elems);
+
+    smallCount = NotSmall;
+    constructBacking();
+    for (u32_t i = 0; i < n; ++i) testAndSetInternal(elems[i]);
+}
+
+void PointsTo::demoteIfSmall()
+{
+    if (isSmall() || !Options::PtInline()) return;
+
+    // Stops after SmallSetSize + 1 elements, so this is cheap on large sets.
+    NodeID elems[SmallSetSize];
+    u32_t n = 0;
+    if (type == CBV) n = collectSmall(cbv, elems, SmallSetSize);
+    else if (type == SBV) n = collectSmall(sbv, elems, SmallSetSize);
+    else if (type == BV) n = collectSmall(bv, elems, SmallSetSize);
+    else if (type == RBV) n = collectSmall(rbv, elems, SmallSetSize);
+    else assert(false && "PointsTo::demoteIfSmall: unknown type");
+
+    if (n > SmallSetSize) return;
+
+    destroyBacking();
+    std::copy(elems, elems + n, smallSet);
+    smallCount = n;
 }
 
 bool PointsTo::contains(const PointsTo &rhs) const
 {
     assert(metaSame(rhs) && "PointsTo::contains: mappings of operands do not match!");
 
-    if (type == CBV) return cbv.contains(rhs.cbv);
+    if (rhs.isSmall())
+    {
+        for (u32_t i = 0; i < rhs.smallCount; ++i)
+        {
+            if (!testInternal(rhs.smallSet[i])) return false;
+        }
+        return true;
+    }
+    // rhs has more elements than a small set can hold.
+    else if (isSmall()) return false;
+    else if (type == CBV) return cbv.contains(rhs.cbv);
     else if (type == SBV) return sbv.contains(rhs.sbv);
     else if (type == BV) return bv.contains(rhs.bv);
+    else if (type == RBV) return rbv.contains(rhs.rbv);
     else
     {
         assert(false && "PointsTo::contains: unknown type");
@@ -190,9 +344,20 @@ bool PointsTo::intersects(const PointsTo &rhs) const
 {
     assert(metaSame(rhs) && "PointsTo::intersects: mappings of operands do not match!");
 
-    if (type == CBV) return cbv.intersects(rhs.cbv);
+    if (isSmall() || rhs.isSmall())
+    {
+        const PointsTo &small = isSmall() ? *this : rhs;
+        const PointsTo &other = isSmall() ? rhs : *this;
+        for (u32_t i = 0; i < small.smallCount; ++i)
+        {
+            if (other.testInternal(small.smallSet[i])) return true;
+        }
+        return false;
+    }
+    else if (type == CBV) return cbv.intersects(rhs.cbv);
     else if (type == SBV) return sbv.intersects(rhs.sbv);
     else if (type == BV) return bv.intersects(rhs.bv);
+    else if (type == RBV) return rbv.intersects(rhs.rbv);
     else
     {
         assert(false && "PointsTo::intersects: unknown type");
@@ -210,9 +375,16 @@ bool PointsTo::operator==(const PointsTo &rhs) const
 {
     assert(metaSame(rhs) && "PointsTo::==: mappings of operands do not match!");
 
-    if (type == CBV) return cbv == rhs.cbv;
+    // Sets are held inline exactly when they are small enough.
+    if (isSmall() || rhs.isSmall())
+    {
+        return smallCount == rhs.smallCount
+               && std::equal(smallSet, smallSet + smallCount, rhs.smallSet);
+    }
+    else if (type == CBV) return cbv == rhs.cbv;
     else if (type == SBV) return sbv == rhs.sbv;
     else if (type == BV) return bv == rhs.bv;
+    else if (type == RBV) return rbv == rhs.rbv;
     else
     {
         assert(false && "PointsTo::==: unknown type");
@@ -232,9 +404,23 @@ bool PointsTo::operator|=(const PointsTo &rhs)
 {
     assert(metaSame(rhs) && "PointsTo::|=: mappings of operands do not match!");
 
+    if (rhs.isSmall())
+    {
+        bool changed = false;
+        for (u32_t i = 0; i < rhs.smallCount; ++i)
+        {
+            if (testAndSetInternal(rhs.smallSet[i])) changed = true;
+        }
+        return changed;
+    }
+
+    // rhs has more elements than a small set can hold.
+    if (isSmall()) promote();
+
     if (type == CBV) return cbv |= rhs.cbv;
     else if (type == SBV) return sbv |= rhs.sbv;
     else if (type == BV) return bv |= rhs.bv;
+    else if (type == RBV) return rbv |= rhs.rbv;
     else
     {
         assert(false && "PointsTo::|=: unknown type");
@@ -259,40 +445,90 @@ bool PointsTo::operator&=(const PointsTo &rhs)
 {
     assert(metaSame(rhs) && "PointsTo::&=: mappings of operands do not match!");
 
-    if (type == CBV) return cbv &= rhs.cbv;
-    else if (type == SBV) return sbv &= rhs.sbv;
-    else if (type == BV) return bv &= rhs.bv;
+    if (isSmall() || rhs.isSmall())
+    {
+        // The result is small: the elements of the small side in the other.
+        const PointsTo &small = isSmall() ? *this : rhs;
+        const PointsTo &other = isSmall() ? rhs : *this;
+        NodeID elems[SmallSetSize];
+        u32_t n = 0;
+        for (u32_t i = 0; i < small.smallCount; ++i)
+        {
+            if (other.testInternal(small.smallSet[i])) elems[n++] = small.smallSet[i];
+        }
+
+        // A large set always loses elements.
+        const bool changed = !isSmall() || n != smallCount;
+        if (!isSmall()) destroyBacking();
+        std::copy(elems, elems + n, smallSet);
+        smallCount = n;
+        return changed;
+    }
+
+    bool changed = false;
+    if (type == CBV) changed = cbv &= rhs.cbv;
+    else if (type == SBV) changed = sbv &= rhs.sbv;
+    else if (type == BV) changed = bv &= rhs.bv;
+    else if (type == RBV) changed = rbv &= rhs.rbv;
     else
     {
         assert(false && "PointsTo::&=: unknown type");
         abort();
     }
+
+    if (changed) demoteIfSmall();
+    return changed;
 }
 
 bool PointsTo::operator-=(const PointsTo &rhs)
 {
     assert(metaSame(rhs) && "PointsTo::-=: mappings of operands do not match!");
 
-    if (type == CBV) return cbv.intersectWithComplement(rhs.cbv);
-    else if (type == SBV) return sbv.intersectWithComplement(rhs.sbv);
-    else if (type == BV) return bv.intersectWithComplement(rhs.bv);
-    else
-    {
-        assert(false && "PointsTo::-=: unknown type");
-        abort();
-    }
+    return intersectWithComplement(rhs);
 }
 
 bool PointsTo::intersectWithComplement(const PointsTo &rhs)
 {
     assert(metaSame(rhs) && "PointsTo::intersectWithComplement: mappings of operands do not match!");
 
-    if (type == CBV) return cbv.intersectWithComplement(rhs.cbv);
-    else if (type == SBV) return sbv.intersectWithComplement(rhs.sbv);
-    else if (type == BV) return bv.intersectWithComplement(rhs.bv);
+    if (isSmall())
+    {
+        // Nothing is overwritten when this is rhs, since everything is removed.
+        u32_t n = 0;
+        for (u32_t i = 0; i < smallCount; ++i)
+        {
+            if (!rhs.testInternal(smallSet[i])) smallSet[n++] = smallSet[i];
+        }
+
+        const bool changed = n != smallCount;
+        smallCount = n;
+        return changed;
+    }
+    else if (rhs.isSmall())
+    {
+        bool changed = false;
+        for (u32_t i = 0; i < rhs.smallCount; ++i)
+        {
+            if (!testInternal(rhs.smallSet[i])) continue;
+            resetInternal(rhs.smallSet[i]);
+            changed = true;
+        }
+        return changed;
+    }
 
-    assert(false && "PointsTo::intersectWithComplement(PT): unknown type");
-    abort();
+    bool changed = false;
+    if (type == CBV) changed = cbv.intersectWithComplement(rhs.cbv);
+    else if (type == SBV) changed = sbv.intersectWithComplement(rhs.sbv);
+    else if (type == BV) changed = bv.intersectWithComplement(rhs.bv);
+    else if (type == RBV) changed = rbv.intersectWithComplement(rhs.rbv);
+    else
+    {
+        assert(false && "PointsTo::intersectWithComplement(PT): unknown type");
+        abort();
+    }
+
+    if (changed) demoteIfSmall();
+    return changed;
 }
 
 void PointsTo::intersectWithComplement(const PointsTo &lhs, const PointsTo &rhs)
@@ -300,14 +536,24 @@ void PointsTo::intersectWithComplement(const PointsTo &lhs, const PointsTo &rhs)
     assert(metaSame(rhs) && "PointsTo::intersectWithComplement: mappings of operands do not match!");
     assert(metaSame(lhs) && "PointsTo::intersectWithComplement: mappings of operands do not match!");
 
-    if (type == CBV) cbv.intersectWithComplement(lhs.cbv, rhs.cbv);
+    if (isSmall() || lhs.isSmall() || rhs.isSmall())
+    {
+        PointsTo result(lhs);
+        result.intersectWithComplement(rhs);
+        *this = std::move(result);
+        return;
+    }
+    else if (type == CBV) cbv.intersectWithComplement(lhs.cbv, rhs.cbv);
     else if (type == SBV) sbv.intersectWithComplement(lhs.sbv, rhs.sbv);
     else if (type == BV) bv.intersectWithComplement(lhs.bv, rhs.bv);
+    else if (type == RBV) rbv.intersectWithComplement(lhs.rbv, rhs.rbv);
     else
     {
         assert(false && "PointsTo::intersectWithComplement(PT, PT): unknown type");
         abort();
     }
+
+    demoteIfSmall();
 }
 
 NodeBS PointsTo::toNodeBS() const
@@ -319,13 +565,24 @@ NodeBS PointsTo::toNodeBS() const
 
 size_t PointsTo::hash() const
 {
-    if (type == CBV) return cbv.hash();
+    if (isSmall())
+    {
+        // As CoreBitVector::hash.
+        size_t h = smallCount;
+        for (u32_t i = 0; i < smallCount; ++i)
+        {
+            h ^= smallSet[i] + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+    else if (type == CBV) return cbv.hash();
     else if (type == SBV)
     {
         std::hash<SparseBitVector<>> h;
         return h(sbv);
     }
     else if (type == BV) return bv.hash();
+    else if (type == RBV) return rbv.hash();
 
     else
     {
@@ -339,13 +596,6 @@ PointsTo::MappingPtr PointsTo::getNodeMapping() const
     return nodeMapping;
 }
 
-NodeID PointsTo::getInternalNode(NodeID n) const
-{
-    if (nodeMapping == nullptr) return n;
-    assert(n < nodeMapping->size());
-    return nodeMapping->at(n);
-}
-
 NodeID PointsTo::getExternalNode(NodeID n) const
 {
     if (reverseNodeMapping == nullptr) return n;
@@ -389,7 +639,11 @@ void PointsTo::checkAndRemap()
 PointsTo::PointsToIterator::PointsToIterator(const PointsTo *pt, bool end)
     : pt(pt)
 {
-    if (pt->type == Type::CBV)
+    if (pt->isSmall())
+    {
+        smallIt = end ? pt->smallCount : 0;
+    }
+    else if (pt->type == Type::CBV)
     {
         new (&cbvIt) CoreBitVector::iterator(end ? pt->cbv.end() : pt->cbv.begin());
     }
@@ -401,6 +655,10 @@ PointsTo::PointsToIterator::PointsToIterator(const PointsTo *pt, bool end)
     {
         new (&bvIt) BitVector::iterator(end ? pt->bv.end() : pt->bv.begin());
     }
+    else if (pt->type == Type::RBV)
+    {
+        new (&rbvIt) RoaringBitVector::iterator(end ? pt->rbv.end() : pt->rbv.begin());
+    }
     else
     {
         assert(false && "PointsToIterator::PointsToIterator: unknown type");
@@ -411,7 +669,11 @@ PointsTo::PointsToIterator::PointsToIterator(const PointsTo *pt, bool end)
 PointsTo::PointsToIterator::PointsToIterator(const PointsToIterator &pt)
     : pt(pt.pt)
 {
-    if (this->pt->type == PointsTo::Type::SBV)
+    if (this->pt->isSmall())
+    {
+        smallIt = pt.smallIt;
+    }
+    else if (this->pt->type == PointsTo::Type::SBV)
     {
         new (&sbvIt) SparseBitVector<>::iterator(pt.sbvIt);
     }
@@ -423,6 +685,10 @@ PointsTo::PointsToIterator::PointsToIterator(const PointsToIterator &pt)
     {
         new (&bvIt) BitVector::iterator(pt.bvIt);
     }
+    else if (this->pt->type == PointsTo::Type::RBV)
+    {
+        new (&rbvIt) RoaringBitVector::iterator(pt.rbvIt);
+    }
     else
     {
         assert(false && "PointsToIterator::PointsToIterator&: unknown type");
@@ -433,7 +699,11 @@ PointsTo::PointsToIterator::PointsToIterator(const PointsToIterator &pt)
 PointsTo::PointsToIterator::PointsToIterator(PointsToIterator &&pt)
 noexcept     : pt(pt.pt)
 {
-    if (this->pt->type == PointsTo::Type::SBV)
+    if (this->pt->isSmall())
+    {
+        smallIt = pt.smallIt;
+    }
+    else if (this->pt->type == PointsTo::Type::SBV)
     {
         new (&sbvIt) SparseBitVector<>::iterator(std::move(pt.sbvIt));
     }
@@ -445,6 +715,10 @@ noexcept     : pt(pt.pt)
     {
         new (&bvIt) BitVector::iterator(std::move(pt.bvIt));
     }
+    else if (this->pt->type == PointsTo::Type::RBV)
+    {
+        new (&rbvIt) RoaringBitVector::iterator(std::move(pt.rbvIt));
+    }
     else
     {
         assert(false && "PointsToIterator::PointsToIterator&&: unknown type");
@@ -456,7 +730,11 @@ PointsTo::PointsToIterator &PointsTo::PointsToIterator::operator=(const PointsTo
 {
     this->pt = rhs.pt;
 
-    if (this->pt->type == PointsTo::Type::SBV)
+    if (this->pt->isSmall())
+    {
+        smallIt = rhs.smallIt;
+    }
+    else if (this->pt->type == PointsTo::Type::SBV)
     {
         new (&sbvIt) SparseBitVector<>::iterator(rhs.sbvIt);
     }
@@ -468,6 +746,10 @@ PointsTo::PointsToIterator &PointsTo::PointsToIterator::operator=(const PointsTo
     {
         new (&bvIt) BitVector::iterator(rhs.bvIt);
     }
+    else if (this->pt->type == PointsTo::Type::RBV)
+    {
+        new (&rbvIt) RoaringBitVector::iterator(rhs.rbvIt);
+    }
     else assert(false && "PointsToIterator::PointsToIterator&: unknown type");
 
     return *this;
@@ -477,7 +759,11 @@ PointsTo::PointsToIterator &PointsTo::PointsToIterator::operator=(PointsToIterat
 {
     this->pt = rhs.pt;
 
-    if (this->pt->type == PointsTo::Type::SBV)
+    if (this->pt->isSmall())
+    {
+        smallIt = rhs.smallIt;
+    }
+    else if (this->pt->type == PointsTo::Type::SBV)
     {
         new (&sbvIt) SparseBitVector<>::iterator(std::move(rhs.sbvIt));
     }
@@ -489,6 +775,10 @@ PointsTo::PointsToIterator &PointsTo::PointsToIterator::operator=(PointsToIterat
     {
         new (&bvIt) BitVector::iterator(std::move(rhs.bvIt));
     }
+    else if (this->pt->type == PointsTo::Type::RBV)
+    {
+        new (&rbvIt) RoaringBitVector::iterator(std::move(rhs.rbvIt));
+    }
     else assert(false && "PointsToIterator::PointsToIterator&&: unknown type");
 
     return *this;
@@ -497,9 +787,11 @@ PointsTo::PointsToIterator &PointsTo::PointsToIterator::operator=(PointsToIterat
 const PointsTo::PointsToIterator &PointsTo::PointsToIterator::operator++()
 {
     assert(!atEnd() && "PointsToIterator::++(pre): incrementing past end!");
-    if (pt->type == Type::CBV) ++cbvIt;
+    if (pt->isSmall()) ++smallIt;
+    else if (pt->type == Type::CBV) ++cbvIt;
     else if (pt->type == Type::SBV) ++sbvIt;
     else if (pt->type == Type::BV) ++bvIt;
+    else if (pt->type == Type::RBV) ++rbvIt;
     else assert(false && "PointsToIterator::++(void): unknown type");
 
     return *this;
@@ -516,9 +808,11 @@ const PointsTo::PointsToIterator PointsTo::PointsToIterator::operator++(int)
 NodeID PointsTo::PointsToIterator::operator*() const
 {
     assert(!atEnd() && "PointsToIterator: dereferencing end!");
-    if (pt->type == Type::CBV) return pt->getExternalNode(*cbvIt);
+    if (pt->isSmall()) return pt->getExternalNode(pt->smallSet[smallIt]);
+    else if (pt->type == Type::CBV) return pt->getExternalNode(*cbvIt);
     else if (pt->type == Type::SBV) return pt->getExternalNode(*sbvIt);
     else if (pt->type == Type::BV) return pt->getExternalNode(*bvIt);
+    else if (pt->type == Type::RBV) return pt->getExternalNode(*rbvIt);
     else
     {
         assert(false && "PointsToIterator::*: unknown type");
@@ -532,9 +826,11 @@ bool PointsTo::PointsToIterator::operator==(const PointsToIterator &rhs) const
            && "PointsToIterator::==: comparing iterators from different PointsTos!");
 
     // Handles end implicitly.
-    if (pt->type == Type::CBV) return cbvIt == rhs.cbvIt;
+    if (pt->isSmall()) return smallIt == rhs.smallIt;
+    else if (pt->type == Type::CBV) return cbvIt == rhs.cbvIt;
     else if (pt->type == Type::SBV) return sbvIt == rhs.sbvIt;
     else if (pt->type == Type::BV) return bvIt == rhs.bvIt;
+    else if (pt->type == Type::RBV) return rbvIt == rhs.rbvIt;
     else
     {
         assert(false && "PointsToIterator::==: unknown type");
@@ -552,9 +848,11 @@ bool PointsTo::PointsToIterator::operator!=(const PointsToIterator &rhs) const
 bool PointsTo::PointsToIterator::atEnd() const
 {
     assert(pt != nullptr && "PointsToIterator::atEnd: iterator iterating over nothing!");
-    if (pt->type == Type::CBV) return cbvIt == pt->cbv.end();
+    if (pt->isSmall()) return smallIt == pt->smallCount;
+    else if (pt->type == Type::CBV) return cbvIt == pt->cbv.end();
     else if (pt->type == Type::SBV) return sbvIt == pt->sbv.end();
     else if (pt->type == Type::BV) return bvIt == pt->bv.end();
+    else if (pt->type == Type::RBV) return rbvIt == pt->rbv.end();
     else
     {
         assert(false && "PointsToIterator::atEnd: unknown type");
@@ -0,0 +1,272 @@
+//===- PointsToProfiler.cpp -- Memory profile of points-to sets --------------//
+
+/*
+ * PointsToProfiler.cpp
+ *
+ * Profiles where the memory of points-to sets goes (implementation).
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "MemoryModel/PointsToProfiler.h"
+#include "Util/Options.h"
+#include "Util/SVFUtil.h"
+
+using namespace SVF;
+
+volatile sig_atomic_t PointsToProfiler::requested = 0;
+
+namespace
+{
+
+const char *const TypeNames[PointsToProfiler::NumTypes] = { "sbv", "cbv", "bv", "rbv" };
+
+/// Approximate size of a RoaringBitVector container besides its contents.
+const u64_t RoaringContainerBytes = 64;
+/// Node overhead of the std::list holding SparseBitVector elements.
+const u64_t ListNodeBytes = 2 * sizeof(void *);
+
+}  // End anonymous namespace
+
+PointsToProfiler *PointsToProfiler::get(void)
+{
+    if (Options::PtsProfile().empty()) return nullptr;
+
+    static PointsToProfiler *profiler = nullptr;
+    if (profiler == nullptr)
+    {
+        profiler = new PointsToProfiler();
+        signal(SIGUSR1, &handleSignal);
+    }
+
+    return profiler;
+}
+
+PointsToProfiler::PointsToProfiler(void)
+    : ptaTy(PTATY::Default_PTA), backing(PTBackingType::Mutable), totalSets(0), totalElements(0)
+{
+    std::fill(histogram, histogram + NumBuckets, 0);
+}
+
+void PointsToProfiler::handleSignal(int)
+{
+    requested = 1;
+}
+
+void PointsToProfiler::begin(const std::string &analysis, PTATY ptaTy, PTBackingType backing)
+{
+    this->analysis = analysis;
+    this->ptaTy = ptaTy;
+    this->backing = backing;
+    sets.clear();
+    totalSets = 0;
+    totalElements = 0;
+    std::fill(histogram, histogram + NumBuckets, 0);
+}
+
+void PointsToProfiler::addPts(NodeID owner, const PointsTo &pts)
+{
+    const u32_t size = pts.count();
+    ++totalSets;
+    totalElements += size;
+
+    u32_t bucket = 0;
+    while (bucket + 1 < NumBuckets && (1u << bucket) <= size) ++bucket;
+    ++histogram[bucket];
+
+    SetInfo &info = sets[&pts];
+    ++info.occurrences;
+    if (info.owners.size() < MaxOwners) info.owners.push_back(owner);
+}
+
+void PointsToProfiler::end(bool partial)
+{
+    const std::string json = toJSON(partial);
+    if (partial) write(json);
+    else
+    {
+        profiles.push_back(json);
+        write("");
+    }
+
+    sets.clear();
+}
+
+void PointsToProfiler::estimateBytes(const PointsTo &pts, u64_t bytes[NumTypes])
+{
+    std::fill(bytes, bytes + NumTypes, 0);
+    if (pts.empty()) return;
+    if (Options::PtInline() && pts.count() <= PointsTo::SmallSetSize) return;
+
+    // Sizes depend on the internal node IDs, not those we iterate over.
+    const PointsTo::MappingPtr mapping = pts.getNodeMapping();
+    std::vector<NodeID> nodes;
+    nodes.reserve(pts.count());
+    for (const NodeID o : pts) nodes.push_back(mapping == nullptr ? o : (*mapping)[o]);
+    std::sort(nodes.begin(), nodes.end());
+
+    const u64_t wordBits = 64;
+    const u64_t sbvBits = SparseBitVectorElement<>::BITS_PER_ELEMENT;
+    const u64_t chunkBits = 1 << 16;
+
+    u64_t sbvElements = 0;
+    u64_t lastSbvElement = UINT64_MAX;
+    u64_t lastChunk = UINT64_MAX;
+    u64_t chunkCard = 0;
+    u64_t chunkRuns = 0;
+    u64_t rbvBytes = 0;
+    auto finishChunk = [&]()
+    {
+        if (chunkCard == 0) return;
+        u64_t contents = std::min<u64_t>(4 * chunkRuns, chunkBits / 8);
+        if (chunkCard <= 4096) contents = std::min<u64_t>(contents, 2 * chunkCard);
+        rbvBytes += RoaringContainerBytes + contents;
+    };
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const u64_t n = nodes[i];
+        if (n / sbvBits != lastSbvElement)
+        {
+            lastSbvElement = n / sbvBits;
+            ++sbvElements;
+        }
+
+        if (n / chunkBits != lastChunk)
+        {
+            finishChunk();
+            lastChunk = n / chunkBits;
+            chunkCard = 0;
+            chunkRuns = 0;
+        }
+
+        ++chunkCard;
+        if (chunkCard == 1 || nodes[i - 1] + 1 != n) ++chunkRuns;
+    }
+
+    finishChunk();
+
+    bytes[PointsTo::SBV] = sbvElements * (sizeof(SparseBitVectorElement<>) + ListNodeBytes);
+    bytes[PointsTo::CBV] = (nodes.back() / wordBits - nodes.front() / wordBits + 1) * sizeof(u64_t);
+    bytes[PointsTo::BV] = (nodes.back() / wordBits + 1) * sizeof(u64_t);
+    bytes[PointsTo::RBV] = rbvBytes;
+}
+
+std::string PointsToProfiler::analysisGroup(PTATY ptaTy)
+{
+    if ((ptaTy >= PTATY::Andersen_BASE && ptaTy <= PTATY::Steensgaard_WPA)
+            || ptaTy == PTATY::AndersenLCD_WPA || ptaTy == PTATY::AndersenHLCD_WPA) return "Andersen";
+    else if (ptaTy == PTATY::VFS_WPA) return "VFS";
+    else if (ptaTy >= PTATY::FSDATAFLOW_WPA && ptaTy <= PTATY::FSCS_WPA) return "FS";
+    else if (ptaTy >= PTATY::CFLFICI_WPA && ptaTy <= PTATY::CFLFSCS_WPA) return "CFL";
+    else if (ptaTy == PTATY::TypeCPP_WPA) return "Type";
+    else if (ptaTy >= PTATY::FieldS_DDA && ptaTy <= PTATY::Cxt_DDA) return "DDA";
+    else return "Other";
+}
+
+/*!
+ * Mutable bytes are those of every held set, persistent bytes those of every
+ * distinct set plus an ID per held set. Map overheads are not counted.
+ */
+std::string PointsToProfiler::toJSON(bool partial) const
+{
+    u64_t distinctElements = 0;
+    u64_t emptySets = 0;
+    u64_t mutableBytes[NumTypes] = { 0 };
+    u64_t persistentBytes[NumTypes] = { 0 };
+    std::vector<std::pair<u32_t, const PointsTo *>> bySize;
+    bySize.reserve(sets.size());
+    for (const auto &setInfo : sets)
+    {
+        const PointsTo &pts = *setInfo.first;
+        const u32_t occurrences = setInfo.second.occurrences;
+        const u32_t size = pts.count();
+        distinctElements += size;
+        if (size == 0) emptySets += occurrences;
+        bySize.push_back(std::make_pair(size, &pts));
+
+        u64_t bytes[NumTypes];
+        estimateBytes(pts, bytes);
+        for (u32_t t = 0; t < NumTypes; ++t)
+        {
+            mutableBytes[t] += occurrences * (sizeof(PointsTo) + bytes[t]);
+            persistentBytes[t] += sizeof(PointsTo) + bytes[t];
+        }
+    }
+
+    for (u32_t t = 0; t < NumTypes; ++t) persistentBytes[t] += totalSets * sizeof(PointsToID);
+
+    const size_t top = std::min<size_t>(Options::PtsProfileTop(), bySize.size());
+    std::partial_sort(bySize.begin(), bySize.begin() + top, bySize.end(),
+                      [](const std::pair<u32_t, const PointsTo *> &a, const std::pair<u32_t, const PointsTo *> &b)
+    {
+        return a.first > b.first;
+    });
+
+    std::ostringstream os;
+    os << "{\"analysis\":\"" << analysis << "\""
+       << ",\"group\":\"" << analysisGroup(ptaTy) << "\""
+       << ",\"partial\":" << (partial ? "true" : "false")
+       << ",\"ptData\":\"" << (backing == PTBackingType::Persistent ? "persistent" : "mutable") << "\""
+       << ",\"ptType\":\"" << TypeNames[Options::PtType()] << "\""
+       << ",\"clustered\":" << (PointsTo::getCurrentBestNodeMapping() != nullptr ? "true" : "false")
+       << ",\"totalSets\":" << totalSets
+       << ",\"distinctSets\":" << sets.size()
+       << ",\"emptySets\":" << emptySets
+       << ",\"sharingRatio\":" << (sets.empty() ? 0.0 : (double)totalSets / sets.size())
+       << ",\"totalElements\":" << totalElements
+       << ",\"distinctElements\":" << distinctElements;
+
+    os << ",\"sizeHistogram\":[";
+    for (u32_t b = 0; b < NumBuckets; ++b)
+    {
+        if (b != 0) os << ",";
+        const u64_t min = b == 0 ? 0 : (u64_t)1 << (b - 1);
+        const u64_t max = b == 0 ? 0 : b + 1 == NumBuckets ? UINT32_MAX : ((u64_t)1 << b) - 1;
+        os << "{\"min\":" << min << ",\"max\":" << max << ",\"sets\":" << histogram[b] << "}";
+    }
+    os << "]";
+
+    os << ",\"estimatedBytes\":{";
+    for (u32_t t = 0; t < NumTypes; ++t)
+    {
+        if (t != 0) os << ",";
+        os << "\"" << TypeNames[t] << "\":{\"mutable\":" << mutableBytes[t]
+           << ",\"persistent\":" << persistentBytes[t] << "}";
+    }
+    os << "}";
+
+    u32_t vmrss = 0, vmsize = 0;
+    SVFUtil::getMemoryUsageKB(&vmrss, &vmsize);
+    os << ",\"vmrssKB\":" << vmrss;
+
+    os << ",\"largestSets\":[";
+    for (size_t i = 0; i < top; ++i)
+    {
+        const SetInfo &info = sets.at(bySize[i].second);
+        if (i != 0) os << ",";
+        os << "{\"size\":" << bySize[i].first << ",\"occurrences\":" << info.occurrences << ",\"owners\":[";
+        for (size_t o = 0; o < info.owners.size(); ++o) os << (o == 0 ? "" : ",") << info.owners[o];
+        os << "]}";
+    }
+    os << "]}";
+
+    return os.str();
+}
+
+void PointsToProfiler::write(const std::string &partial) const
+{
+    std::ofstream f(Options::PtsProfile(), std::ios::out | std::ios::trunc);
+    if (!f.is_open())
+    {
+        SVFUtil::writeWrnMsg("Cannot open points-to profile " + Options::PtsProfile());
+        return;
+    }
+
+    f << "{\"analyses\":[";
+    for (size_t i = 0; i < profiles.size(); ++i) f << (i == 0 ? "" : ",") << "\n" << profiles[i];
+    if (!partial.empty()) f << (profiles.empty() ? "" : ",") << "\n" << partial;
+    f << "\n]}\n";
+}
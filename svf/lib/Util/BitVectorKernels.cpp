@@ -0,0 +1,464 @@
+//===- BitVectorKernels.cpp -- SIMD kernels for bit vector operations ------------//
+
+/*
+ * BitVectorKernels.cpp
+ *
+ * Word-level kernels behind the bit vector set operations (implementation).
+ * The SSE4.2 and AVX2 kernels are compiled for their target regardless of the
+ * build flags, and only used when the CPU reports support for them.
+ */
+
+#include "Util/SparseBitVector.h"  // For LLVM's countPopulation.
+#include "Util/BitVectorKernels.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define SVF_KERNELS_X86 1
+#endif
+
+namespace SVF
+{
+
+typedef BitVectorKernels::Word Word;
+typedef BitVectorKernels::Kernels Kernels;
+
+namespace
+{
+
+/// Scalar kernels, also used for the tail of the SIMD ones.
+//@{
+bool unionWithScalar(Word *dst, const Word *src, size_t n)
+{
+    Word changed = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        changed |= src[i] & ~dst[i];
+        dst[i] |= src[i];
+    }
+
+    return changed != 0;
+}
+
+bool intersectWithScalar(Word *dst, const Word *src, size_t n)
+{
+    Word changed = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        changed |= dst[i] & ~src[i];
+        dst[i] &= src[i];
+    }
+
+    return changed != 0;
+}
+
+bool intersectWithComplementScalar(Word *dst, const Word *src, size_t n)
+{
+    Word changed = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        changed |= dst[i] & src[i];
+        dst[i] &= ~src[i];
+    }
+
+    return changed != 0;
+}
+
+bool containsScalar(const Word *lhs, const Word *rhs, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (rhs[i] & ~lhs[i]) return false;
+    }
+
+    return true;
+}
+
+bool intersectsScalar(const Word *lhs, const Word *rhs, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (lhs[i] & rhs[i]) return true;
+    }
+
+    return false;
+}
+
+unsigned countScalar(const Word *words, size_t n)
+{
+    unsigned c = 0;
+    for (size_t i = 0; i < n; ++i) c += countPopulation(words[i]);
+    return c;
+}
+//@}
+
+const Kernels scalarKernels =
+{
+    BitVectorKernels::Scalar, "scalar",
+    unionWithScalar, intersectWithScalar, intersectWithComplementScalar,
+    containsScalar, intersectsScalar, countScalar
+};
+
+#if defined(SVF_KERNELS_X86)
+
+/// SSE4.2 kernels: two words at a time, and the popcnt instruction.
+//@{
+__attribute__((target("sse4.2,popcnt")))
+bool unionWithSSE42(Word *dst, const Word *src, size_t n)
+{
+    __m128i changed = _mm_setzero_si128();
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        changed = _mm_or_si128(changed, _mm_andnot_si128(d, s));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(d, s));
+    }
+
+    const bool tailChanged = unionWithScalar(dst + i, src + i, n - i);
+    return !_mm_testz_si128(changed, changed) || tailChanged;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+bool intersectWithSSE42(Word *dst, const Word *src, size_t n)
+{
+    __m128i changed = _mm_setzero_si128();
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        changed = _mm_or_si128(changed, _mm_andnot_si128(s, d));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_and_si128(d, s));
+    }
+
+    const bool tailChanged = intersectWithScalar(dst + i, src + i, n - i);
+    return !_mm_testz_si128(changed, changed) || tailChanged;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+bool intersectWithComplementSSE42(Word *dst, const Word *src, size_t n)
+{
+    __m128i changed = _mm_setzero_si128();
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        changed = _mm_or_si128(changed, _mm_and_si128(d, s));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_andnot_si128(s, d));
+    }
+
+    const bool tailChanged = intersectWithComplementScalar(dst + i, src + i, n - i);
+    return !_mm_testz_si128(changed, changed) || tailChanged;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+bool containsSSE42(const Word *lhs, const Word *rhs, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const __m128i l = _mm_loadu_si128((const __m128i *)(lhs + i));
+        const __m128i r = _mm_loadu_si128((const __m128i *)(rhs + i));
+        // testc: are all bits of r set in l?
+        if (!_mm_testc_si128(l, r)) return false;
+    }
+
+    return containsScalar(lhs + i, rhs + i, n - i);
+}
+
+__attribute__((target("sse4.2,popcnt")))
+bool intersectsSSE42(const Word *lhs, const Word *rhs, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const __m128i l = _mm_loadu_si128((const __m128i *)(lhs + i));
+        const __m128i r = _mm_loadu_si128((const __m128i *)(rhs + i));
+        if (!_mm_testz_si128(l, r)) return true;
+    }
+
+    return intersectsScalar(lhs + i, rhs + i, n - i);
+}
+
+__attribute__((target("sse4.2,popcnt")))
+unsigned countSSE42(const Word *words, size_t n)
+{
+    unsigned long long c = 0;
+    for (size_t i = 0; i < n; ++i) c += _mm_popcnt_u64(words[i]);
+    return c;
+}
+//@}
+
+const Kernels sse42Kernels =
+{
+    BitVectorKernels::SSE42, "sse4.2",
+    unionWithSSE42, intersectWithSSE42, intersectWithComplementSSE42,
+    containsSSE42, intersectsSSE42, countSSE42
+};
+
+/// AVX2 kernels: four words at a time; count uses the nibble lookup table
+/// method (vpshufb), summed with vpsadbw.
+//@{
+__attribute__((target("avx2,popcnt")))
+bool unionWithAVX2(Word *dst, const Word *src, size_t n)
+{
+    __m256i changed = _mm256_setzero_si256();
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4)
+    {
+        const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        changed = _mm256_or_si256(changed, _mm256_andnot_si256(d, s));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_or_si256(d, s));
+    }
+
+    const bool tailChanged = unionWithScalar(dst + i, src + i, n - i);
+    return !_mm256_testz_si256(changed, changed) || tailChanged;
+}
+
+__attribute__((target("avx2,popcnt")))
+bool intersectWithAVX2(Word *dst, const Word *src, size_t n)
+{
+    __m256i changed = _mm256_setzero_si256();
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4)
+    {
+        const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        changed = _mm256_or_si256(changed, _mm256_andnot_si256(s, d));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_and_si256(d, s));
+    }
+
+    const bool tailChanged = intersectWithScalar(dst + i, src + i, n - i);
+    return !_mm256_testz_si256(changed, changed) || tailChanged;
+}
+
+__attribute__((target("avx2,popcnt")))
+bool intersectWithComplementAVX2(Word *dst, const Word *src, size_t n)
+{
+    __m256i changed = _mm256_setzero_si256();
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4)
+    {
+        const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        changed = _mm256_or_si256(changed, _mm256_and_si256(d, s));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_andnot_si256(s, d));
+    }
+
+    const bool tailChanged = intersectWithComplementScalar(dst + i, src + i, n - i);
+    return !_mm256_testz_si256(changed, changed) || tailChanged;
+}
+
+__attribute__((target("avx2,popcnt")))
+bool containsAVX2(const Word *lhs, const Word *rhs, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4)
+    {
+        const __m256i l = _mm256_loadu_si256((const __m256i *)(lhs + i));
+        const __m256i r = _mm256_loadu_si256((const __m256i *)(rhs + i));
+        if (!_mm256_testc_si256(l, r)) return false;
+    }
+
+    return containsScalar(lhs + i, rhs + i, n - i);
+}
+
+__attribute__((target("avx2,popcnt")))
+bool intersectsAVX2(const Word *lhs, const Word *rhs, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4)
+    {
+        const __m256i l = _mm256_loadu_si256((const __m256i *)(lhs + i));
+        const __m256i r = _mm256_loadu_si256((const __m256i *)(rhs + i));
+        if (!_mm256_testz_si256(l, r)) return true;
+    }
+
+    return intersectsScalar(lhs + i, rhs + i, n - i);
+}
+
+__attribute__((target("avx2,popcnt")))
+unsigned countAVX2(const Word *words, size_t n)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4)
+    {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(words + i));
+        const __m256i lo = _mm256_and_si256(v, lowNibbles);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibbles);
+        const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                              _mm256_shuffle_epi8(lookup, hi));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+
+    unsigned long long c = _mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1)
+                           + _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3);
+    for ( ; i < n; ++i) c += _mm_popcnt_u64(words[i]);
+    return c;
+}
+//@}
+
+const Kernels avx2Kernels =
+{
+    BitVectorKernels::AVX2, "avx2",
+    unionWithAVX2, intersectWithAVX2, intersectWithComplementAVX2,
+    containsAVX2, intersectsAVX2, countAVX2
+};
+
+#endif  // SVF_KERNELS_X86
+
+#if defined(SVF_SIMD128_NEON)
+
+/// NEON kernels: two words at a time, and vcnt for count.
+//@{
+inline bool anySetNEON(uint64x2_t v)
+{
+    return (vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1)) != 0;
+}
+
+bool unionWithNEON(Word *dst, const Word *src, size_t n)
+{
+    uint64x2_t changed = vdupq_n_u64(0);
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const uint64x2_t d = vld1q_u64((const uint64_t *)(dst + i));
+        const uint64x2_t s = vld1q_u64((const uint64_t *)(src + i));
+        changed = vorrq_u64(changed, vbicq_u64(s, d));
+        vst1q_u64((uint64_t *)(dst + i), vorrq_u64(d, s));
+    }
+
+    const bool tailChanged = unionWithScalar(dst + i, src + i, n - i);
+    return anySetNEON(changed) || tailChanged;
+}
+
+bool intersectWithNEON(Word *dst, const Word *src, size_t n)
+{
+    uint64x2_t changed = vdupq_n_u64(0);
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const uint64x2_t d = vld1q_u64((const uint64_t *)(dst + i));
+        const uint64x2_t s = vld1q_u64((const uint64_t *)(src + i));
+        changed = vorrq_u64(changed, vbicq_u64(d, s));
+        vst1q_u64((uint64_t *)(dst + i), vandq_u64(d, s));
+    }
+
+    const bool tailChanged = intersectWithScalar(dst + i, src + i, n - i);
+    return anySetNEON(changed) || tailChanged;
+}
+
+bool intersectWithComplementNEON(Word *dst, const Word *src, size_t n)
+{
+    uint64x2_t changed = vdupq_n_u64(0);
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const uint64x2_t d = vld1q_u64((const uint64_t *)(dst + i));
+        const uint64x2_t s = vld1q_u64((const uint64_t *)(src + i));
+        changed = vorrq_u64(changed, vandq_u64(d, s));
+        vst1q_u64((uint64_t *)(dst + i), vbicq_u64(d, s));
+    }
+
+    const bool tailChanged = intersectWithComplementScalar(dst + i, src + i, n - i);
+    return anySetNEON(changed) || tailChanged;
+}
+
+bool containsNEON(const Word *lhs, const Word *rhs, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const uint64x2_t l = vld1q_u64((const uint64_t *)(lhs + i));
+        const uint64x2_t r = vld1q_u64((const uint64_t *)(rhs + i));
+        if (anySetNEON(vbicq_u64(r, l))) return false;
+    }
+
+    return containsScalar(lhs + i, rhs + i, n - i);
+}
+
+bool intersectsNEON(const Word *lhs, const Word *rhs, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        const uint64x2_t l = vld1q_u64((const uint64_t *)(lhs + i));
+        const uint64x2_t r = vld1q_u64((const uint64_t *)(rhs + i));
+        if (anySetNEON(vandq_u64(l, r))) return true;
+    }
+
+    return intersectsScalar(lhs + i, rhs + i, n - i);
+}
+
+unsigned countNEON(const Word *words, size_t n)
+{
+    unsigned c = 0;
+    size_t i = 0;
+    for ( ; i + 2 <= n; i += 2)
+    {
+        // At most 128 bits per vector, so the byte sum cannot overflow.
+        c += vaddvq_u8(vcntq_u8(vld1q_u8((const uint8_t *)(words + i))));
+    }
+
+    return c + countScalar(words + i, n - i);
+}
+//@}
+
+const Kernels neonKernels =
+{
+    BitVectorKernels::NEON, "neon",
+    unionWithNEON, intersectWithNEON, intersectWithComplementNEON,
+    containsNEON, intersectsNEON, countNEON
+};
+
+#endif  // SVF_SIMD128_NEON
+
+const Kernels *bestKernels(void)
+{
+    if (const Kernels *k = BitVectorKernels::get(BitVectorKernels::AVX2)) return k;
+    if (const Kernels *k = BitVectorKernels::get(BitVectorKernels::SSE42)) return k;
+    if (const Kernels *k = BitVectorKernels::get(BitVectorKernels::NEON)) return k;
+    return &scalarKernels;
+}
+
+}  // End anonymous namespace
+
+// Constant-initialised, so bit vectors built during static initialisation
+// (before the CPU check below) use the scalar kernels.
+const Kernels *BitVectorKernels::active = &scalarKernels;
+
+const bool BitVectorKernels::selected = (active = bestKernels(), true);
+
+const Kernels *BitVectorKernels::get(ISA isa)
+{
+    switch (isa)
+    {
+    case Scalar:
+        return &scalarKernels;
+#if defined(SVF_KERNELS_X86)
+    case SSE42:
+        // May run before the constructor initialising the CPU model.
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt") ? &sse42Kernels : nullptr;
+    case AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") ? &avx2Kernels : nullptr;
+#endif
+#if defined(SVF_SIMD128_NEON)
+    case NEON:
+        // Always available on AArch64.
+        return &neonKernels;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+} // End namespace SVF
@@ -11,8 +11,8 @@
 
 #include <limits.h>
 
-#include "Util/SparseBitVector.h"  // For LLVM's countPopulation.
 #include "Util/CoreBitVector.h"
+#include "Util/BitVectorKernels.h"
 
 namespace SVF
 {
@@ -57,9 +57,7 @@ bool CoreBitVector::empty(void) const
 
 u32_t CoreBitVector::count(void) const
 {
-    u32_t n = 0;
-    for (const Word &w : words) n += countPopulation(w);
-    return n;
+    return BitVectorKernels::get().count(words.data(), words.size());
 }
 
 void CoreBitVector::clear(void)
@@ -104,9 +102,28 @@ void CoreBitVector::reset(u32_t bit)
 
 bool CoreBitVector::contains(const CoreBitVector &rhs) const
 {
-    CoreBitVector tmp(*this);
-    tmp &= rhs;
-    return tmp == rhs;
+    if (rhs.words.empty()) return true;
+    if (words.empty()) return rhs.empty();
+
+    // Words of rhs outside of this must be empty, the others covered by this.
+    const u32_t greaterOffset = std::max(offset, rhs.offset);
+    const u32_t lesserFinalBit = std::min(finalBit(), rhs.finalBit());
+    if (greaterOffset > lesserFinalBit) return rhs.empty();
+
+    const size_t thisIndex = indexForBit(greaterOffset);
+    const size_t rhsIndex = rhs.indexForBit(greaterOffset);
+    const size_t length = (lesserFinalBit - greaterOffset + 1) / WordSize;
+    for (size_t i = 0; i < rhsIndex; ++i)
+    {
+        if (rhs.words[i]) return false;
+    }
+
+    for (size_t i = rhsIndex + length; i < rhs.words.size(); ++i)
+    {
+        if (rhs.words[i]) return false;
+    }
+
+    return BitVectorKernels::get().contains(&words[thisIndex], &rhs.words[rhsIndex], length);
 }
 
 bool CoreBitVector::intersects(const CoreBitVector &rhs) const
@@ -121,21 +138,13 @@ bool CoreBitVector::intersects(const CoreBitVector &rhs) const
     size_t laterOffset = (offset > rhs.offset ? offset : rhs.offset) / WordSize;
     laterOffset -= earlierOffset;
 
-    const Word *eWords = &earlierOffsetCBV.words[0];
+    const Word *eWords = earlierOffsetCBV.words.data();
     const size_t eSize = earlierOffsetCBV.words.size();
-    const Word *lWords = &laterOffsetCBV.words[0];
+    const Word *lWords = laterOffsetCBV.words.data();
     const size_t lSize = laterOffsetCBV.words.size();
 
-    size_t e = 0;
-    for ( ; e != laterOffset && e != eSize; ++e) { }
-
-    size_t l = 0;
-    for ( ; e != eSize && l != lSize; ++e, ++l)
-    {
-        if (eWords[e] & lWords[l]) return true;
-    }
-
-    return false;
+    const size_t e = std::min(laterOffset, eSize);
+    return BitVectorKernels::get().intersects(eWords + e, lWords, std::min(eSize - e, lSize));
 }
 
 bool CoreBitVector::operator==(const CoreBitVector &rhs) const
@@ -195,20 +204,10 @@ bool CoreBitVector::operator|=(const CoreBitVector &rhs)
     Word *thisWords = &words[thisIndex];
     const Word *rhsWords = &rhs.words[rhsIndex];
     const size_t length = rhs.words.size();
-    Word changed = 0;
 
     // Can start counting from 0 because we took the addresses of both
     // word vectors at the correct index.
-    // #pragma omp simd
-    for (size_t i = 0 ; i < length; ++i)
-    {
-        const Word oldWord = thisWords[i];
-        // Is there anything in rhs not in *this?
-        thisWords[i] = thisWords[i] | rhsWords[i];
-        changed |= oldWord ^ thisWords[i];
-    }
-
-    return changed;
+    return BitVectorKernels::get().unionWith(thisWords, rhsWords, length);
 }
 
 bool CoreBitVector::operator&=(const CoreBitVector &rhs)
@@ -242,13 +241,9 @@ bool CoreBitVector::operator&=(const CoreBitVector &rhs)
         words[i] = 0;
     }
 
-    Word oldWord;
-    for ( ; thisIndex < words.size() && rhsIndex < rhs.words.size(); ++thisIndex, ++rhsIndex)
-    {
-        if (!changed) oldWord = words[thisIndex];
-        words[thisIndex] &= rhs.words[rhsIndex];
-        if (!changed) changed = oldWord != words[thisIndex];
-    }
+    const size_t length = std::min(words.size() - thisIndex, rhs.words.size() - rhsIndex);
+    if (BitVectorKernels::get().intersectWith(&words[thisIndex], &rhs.words[rhsIndex], length)) changed = true;
+    thisIndex += length;
 
     // Clear the remaining bits with no rhs analogue.
     for ( ; thisIndex < words.size(); ++thisIndex)
@@ -269,18 +264,10 @@ bool CoreBitVector::operator-=(const CoreBitVector &rhs)
     // No overlap if either cannot hold the greater offset.
     if (!canHold(greaterOffset) || !rhs.canHold(greaterOffset)) return false;
 
-    bool changed = false;
     size_t thisIndex = indexForBit(greaterOffset);
     size_t rhsIndex = rhs.indexForBit(greaterOffset);
-    Word oldWord;
-    for ( ; thisIndex < words.size() && rhsIndex < rhs.words.size(); ++thisIndex, ++rhsIndex)
-    {
-        if (!changed) oldWord = words[thisIndex];
-        words[thisIndex] &= ~rhs.words[rhsIndex];
-        if (!changed) changed = oldWord != words[thisIndex];
-    }
-
-    return changed;
+    const size_t length = std::min(words.size() - thisIndex, rhs.words.size() - rhsIndex);
+    return BitVectorKernels::get().intersectWithComplement(&words[thisIndex], &rhs.words[rhsIndex], length);
 }
 
 bool CoreBitVector::intersectWithComplement(const CoreBitVector &rhs)
@@ -4,6 +4,10 @@
 #include <iostream>
 #include <queue>
 #include <cmath>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <thread>
 
 #include "FastCluster/fastcluster.h"
 #include "MemoryModel/PointerAnalysisImpl.h"
@@ -321,71 +325,127 @@ std::vector<NodeID> NodeIDAllocator::Clusterer::cluster(
         methods.push_back(HCLUST_METHOD_SINGLE);
         methods.push_back(HCLUST_METHOD_COMPLETE);
         methods.push_back(HCLUST_METHOD_AVERAGE);
+        methods.push_back(HCLUST_METHOD_SVF_MINHASH);
     }
     else
     {
         methods.push_back((enum hclust_fast_methods)Options::ClusterMethod());
     }
 
+    // Where each region starts in the new allocation. Regions are laid out
+    // one after another, each aligned to a word if requested.
+    std::vector<unsigned> regionStarts(numRegions);
+    std::vector<unsigned> bigRegions;
+    unsigned numGtIntRegions = 0;
+    unsigned largestRegion = 0;
+    unsigned nonTrivialRegionObjects = 0;
+    unsigned allocCounter = 0;
+    for (unsigned region = 0; region < numRegions; ++region)
+    {
+        const size_t regionNumObjects = regionsObjects[region].size();
+        // Round up to next Word: ceiling of current allocation to get how
+        // many words and multiply to get the number of bits; if we're aligning.
+        if (Options::RegionAlign())
+        {
+            allocCounter =
+                ((allocCounter + NATIVE_INT_SIZE - 1) / NATIVE_INT_SIZE) * NATIVE_INT_SIZE;
+        }
+
+        regionStarts[region] = allocCounter;
+        allocCounter += regionNumObjects;
+
+        if (regionNumObjects > largestRegion) largestRegion = regionNumObjects;
+
+        // Regions with fewer than 64 objects will be in the one int regardless.
+        if (regionNumObjects < NATIVE_INT_SIZE) continue;
+
+        ++numGtIntRegions;
+        nonTrivialRegionObjects += regionNumObjects;
+        bigRegions.push_back(region);
+    }
+
+    // Hand out the largest regions first so threads finish close together.
+    std::sort(bigRegions.begin(), bigRegions.end(), [&regionsObjects](unsigned a, unsigned b)
+    {
+        return regionsObjects[a].size() > regionsObjects[b].size();
+    });
+
+    overallStats[NumGtIntRegions] = std::to_string(numGtIntRegions);
+    overallStats[LargestRegion] = std::to_string(largestRegion);
+    overallStats[NumNonTrivialRegionObjects] = std::to_string(nonTrivialRegionObjects);
+
     for (const hclust_fast_methods method : methods)
     {
         std::vector<NodeID> nodeMap(numObjects, UINT_MAX);
 
-        unsigned numGtIntRegions = 0;
-        unsigned largestRegion = 0;
-        unsigned nonTrivialRegionObjects = 0;
-        unsigned allocCounter = 0;
+        // Small regions are allocated however.
         for (unsigned region = 0; region < numRegions; ++region)
         {
-            const size_t regionNumObjects = regionsObjects[region].size();
-            // Round up to next Word: ceiling of current allocation to get how
-            // many words and multiply to get the number of bits; if we're aligning.
-            if (Options::RegionAlign())
+            if (regionsObjects[region].size() >= NATIVE_INT_SIZE) continue;
+            unsigned regionCounter = regionStarts[region];
+            for (NodeID o : regionsObjects[region]) nodeMap[o] = regionCounter++;
+        }
+
+        // Regions are independent: each thread takes the next region and
+        // writes the entries of nodeMap for that region's objects only.
+        std::atomic<size_t> nextRegion(0);
+        std::mutex timeMutex;
+        auto clusterRegions = [&]()
+        {
+            double threadDistanceMatrixTime = 0.0;
+            double threadFastClusterTime = 0.0;
+            double threadDendrogramTraversalTime = 0.0;
+            for (size_t i = nextRegion++; i < bigRegions.size(); i = nextRegion++)
             {
-                allocCounter =
-                    ((allocCounter + NATIVE_INT_SIZE - 1) / NATIVE_INT_SIZE) * NATIVE_INT_SIZE;
-            }
+                const unsigned region = bigRegions[i];
+                const size_t regionNumObjects = regionsObjects[region].size();
+                unsigned regionCounter = regionStarts[region];
 
-            if (regionNumObjects > largestRegion) largestRegion = regionNumObjects;
+                if (method == HCLUST_METHOD_SVF_MINHASH)
+                {
+                    const double start = PTAStat::getClk(true);
+                    const std::vector<unsigned> order = minHashOrder(regionsPointsTos[region], regionNumObjects,
+                                                        regionReverseMappings[region]);
+                    for (const unsigned mo : order) nodeMap[regionMappings[region][mo]] = regionCounter++;
+                    threadFastClusterTime += (PTAStat::getClk(true) - start) / TIMEINTERVAL;
+                    continue;
+                }
 
-            // For regions with fewer than 64 objects, we can just allocate them
-            // however as they will be in the one int regardless..
-            if (regionNumObjects < NATIVE_INT_SIZE)
-            {
-                for (NodeID o : regionsObjects[region]) nodeMap[o] = allocCounter++;
-                continue;
+                double *distMatrix = getDistanceMatrix(regionsPointsTos[region], regionNumObjects,
+                                                       regionReverseMappings[region], threadDistanceMatrixTime);
+
+                double start = PTAStat::getClk(true);
+                int *dendrogram = new int[2 * (regionNumObjects - 1)];
+                double *height = new double[regionNumObjects - 1];
+                hclust_fast(regionNumObjects, distMatrix, method, dendrogram, height);
+                delete[] distMatrix;
+                delete[] height;
+                threadFastClusterTime += (PTAStat::getClk(true) - start) / TIMEINTERVAL;
+
+                start = PTAStat::getClk(true);
+                Set<int> visited;
+                traverseDendrogram(nodeMap, dendrogram, regionNumObjects, regionCounter,
+                                   visited, regionNumObjects - 1, regionMappings[region]);
+                delete[] dendrogram;
+                threadDendrogramTraversalTime += (PTAStat::getClk(true) - start) / TIMEINTERVAL;
             }
 
-            ++numGtIntRegions;
-            nonTrivialRegionObjects += regionNumObjects;
-
-            double *distMatrix = getDistanceMatrix(regionsPointsTos[region], regionNumObjects,
-                                                   regionReverseMappings[region], distanceMatrixTime);
-
-            clkStart = PTAStat::getClk(true);
-            int *dendrogram = new int[2 * (regionNumObjects - 1)];
-            double *height = new double[regionNumObjects - 1];
-            hclust_fast(regionNumObjects, distMatrix, method, dendrogram, height);
-            delete[] distMatrix;
-            delete[] height;
-            clkEnd = PTAStat::getClk(true);
-            fastClusterTime += (clkEnd - clkStart) / TIMEINTERVAL;
-
-            clkStart = PTAStat::getClk(true);
-            Set<int> visited;
-            traverseDendrogram(nodeMap, dendrogram, regionNumObjects, allocCounter,
-                               visited, regionNumObjects - 1, regionMappings[region]);
-            delete[] dendrogram;
-            clkEnd = PTAStat::getClk(true);
-            dendrogramTraversalTime += (clkEnd - clkStart) / TIMEINTERVAL;
+            std::lock_guard<std::mutex> guard(timeMutex);
+            distanceMatrixTime += threadDistanceMatrixTime;
+            fastClusterTime += threadFastClusterTime;
+            dendrogramTraversalTime += threadDendrogramTraversalTime;
+        };
+
+        const size_t numThreads = std::min<size_t>(std::max<u32_t>(1, Options::ClusterThreads()), bigRegions.size());
+        if (numThreads <= 1) clusterRegions();
+        else
+        {
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < numThreads; ++t) workers.push_back(std::thread(clusterRegions));
+            for (std::thread &worker : workers) worker.join();
         }
 
         candidates.push_back(std::make_pair(method, nodeMap));
-
-        // Though we "update" these in the loop, they will be the same every iteration.
-        overallStats[NumGtIntRegions] = std::to_string(numGtIntRegions);
-        overallStats[LargestRegion] = std::to_string(largestRegion);
-        overallStats[NumNonTrivialRegionObjects] = std::to_string(nonTrivialRegionObjects);
     }
 
     // Work out which of the mappings we generated looks best.
@@ -511,6 +571,63 @@ double *NodeIDAllocator::Clusterer::getDistanceMatrix(const std::vector<std::pai
     return distMatrix;
 }
 
+std::vector<unsigned> NodeIDAllocator::Clusterer::minHashOrder(const std::vector<std::pair<const PointsTo *, unsigned>> &pointsToSets,
+        const size_t numObjects, const Map<NodeID, unsigned> &nodeMap)
+{
+    // Signature of each object: for each of MinHashes hash functions, the
+    // smallest hash amongst the points-to sets the object occurs in. Hashes
+    // are exponentially distributed and divided by the set's occurrences, so
+    // frequent sets are more likely to be the minimum (weighted MinHash).
+    // Objects whose sets are similar likely share signature prefixes, so
+    // sorting by signature puts them next to each other, like the dendrogram
+    // traversal would.
+    static const unsigned MinHashes = 4;
+    std::vector<double> signatures(numObjects * MinHashes, std::numeric_limits<double>::infinity());
+
+    for (size_t p = 0; p < pointsToSets.size(); ++p)
+    {
+        const PointsTo *pts = pointsToSets[p].first;
+        assert(pts != nullptr);
+        const double occ = pointsToSets[p].second == 0 ? 1.0 : pointsToSets[p].second;
+
+        double hashes[MinHashes];
+        for (unsigned k = 0; k < MinHashes; ++k)
+        {
+            // SplitMix64 of (p, k), mapped into (0, 1].
+            u64_t h = (u64_t)p * MinHashes + k + 0x9E3779B97F4A7C15ULL;
+            h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+            h ^= h >> 31;
+            const double u = ((h >> 11) + 1) * (1.0 / 9007199254740992.0);
+            hashes[k] = -std::log(u) / occ;
+        }
+
+        for (const NodeID o : *pts)
+        {
+            const Map<NodeID, unsigned>::const_iterator mo = nodeMap.find(o);
+            assert(mo != nodeMap.end());
+            double *signature = &signatures[mo->second * MinHashes];
+            for (unsigned k = 0; k < MinHashes; ++k) signature[k] = std::min(signature[k], hashes[k]);
+        }
+    }
+
+    std::vector<unsigned> order(numObjects);
+    for (unsigned i = 0; i < numObjects; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&signatures](unsigned a, unsigned b)
+    {
+        const double *sa = &signatures[a * MinHashes];
+        const double *sb = &signatures[b * MinHashes];
+        for (unsigned k = 0; k < MinHashes; ++k)
+        {
+            if (sa[k] != sb[k]) return sa[k] < sb[k];
+        }
+
+        return a < b;
+    });
+
+    return order;
+}
+
 void NodeIDAllocator::Clusterer::traverseDendrogram(std::vector<NodeID> &nodeMap, const int *dendrogram, const size_t numObjects, unsigned &allocCounter, Set<int> &visited, const int index, const std::vector<NodeID> &regionNodeMap)
 {
     if (visited.find(index) != visited.end()) return;
@@ -694,6 +811,8 @@ std::pair<hclust_fast_methods, std::vector<NodeID>> NodeIDAllocator::Clusterer::
             size_t candidateWords = 0;
             if (Options::PtType() == PointsTo::SBV) candidateWords = std::stoull(candidateStats[NewSbvNumWords]);
             else if (Options::PtType() == PointsTo::CBV) candidateWords = std::stoull(candidateStats[NewBvNumWords]);
+            // Like SBV, an RBV only stores the chunks it needs.
+            else if (Options::PtType() == PointsTo::RBV) candidateWords = std::stoull(candidateStats[NewSbvNumWords]);
             else assert(false && "Clusterer::cluster: unsupported BV type for clustering.");
 
             if (candidateWords < bestWords)
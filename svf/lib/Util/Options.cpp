@@ -55,24 +55,114 @@ const OptionMap<PTBackingType> Options::ptDataBacking(
 }
 );
 
+const Option<u32_t> Options::PtCacheOpLimit(
+    "ptcache-op-limit",
+    "Memory limit in MB of the persistent points-to cache's operation caches, results unused since the last CLOCK (second-chance) sweep are evicted (0 for no limit)",
+    0
+);
+
+const Option<bool> Options::PtCacheGC(
+    "ptcache-gc",
+    "Reclaim persistent points-to sets no longer referenced by any pointer",
+    false
+);
+
+const Option<std::string> Options::PtsProfile(
+    "pts-profile",
+    "Write a JSON profile of points-to set sizes, sharing and estimated memory per backing to this file when analyses finish (and on SIGUSR1)",
+    ""
+);
+
+const Option<u32_t> Options::PtsProfileTop(
+    "pts-profile-top",
+    "Number of largest points-to sets, with their owning nodes, listed in each -pts-profile profile",
+    10
+);
+
+const OptionMap<WorklistOrder> Options::WPAWorklistOrder(
+    "wl-order",
+    "Order in which the Andersen's and flow-sensitive solvers pop worklist nodes",
+    WorklistOrder::FIFOWorklist,
+{
+    {WorklistOrder::FIFOWorklist, "fifo", "first in first out"},
+    {WorklistOrder::TopoWorklist, "topo", "topological order of the last SCC detection"},
+    {WorklistOrder::LRFWorklist, "lrf", "least recently fired node first"},
+    {WorklistOrder::PtsDeltaWorklist, "delta", "largest points-to growth since last popped first"},
+}
+);
+
 const Option<u32_t> Options::FsTimeLimit(
     "fs-time-limit",
-    "time limit for main phase of flow-sensitive analyses",
+    "time limit (seconds) for main phase of flow-sensitive analyses, after which nodes not at a fixed point fall back to Andersen's points-to sets",
     0
 );
 
+const Option<u32_t> Options::FsThreads(
+    "fs-threads",
+    "number of threads solving sparse and versioned flow-sensitive analysis in parallel (mutable points-to data only)",
+    1
+);
+
 const Option<u32_t> Options::VersioningThreads(
     "versioning-threads",
     "number of threads to use in the versioning phase of versioned flow-sensitive analysis",
     1
 );
 
+const Option<std::string> Options::VersioningPlan(
+    "versioning-plan",
+    "File caching the versioning of versioned flow-sensitive analysis: read if made for the same SVFG, written otherwise",
+    ""
+);
+
 const Option<u32_t> Options::AnderTimeLimit(
     "ander-time-limit",
-    "time limit for Andersen's analyses (ignored when -fs-time-limit set)",
+    "time limit (seconds) for Andersen's analyses, after which a last checkpoint is written if -ander-checkpoint is set (0 for no limit)",
     0
 );
 
+const Option<u32_t> Options::AnderThreads(
+    "ander-threads",
+    "number of threads to use in the load/store phase of wave propagation Andersen's analysis and in -ander-steens-partition",
+    1
+);
+
+const Option<bool> Options::AnderHU(
+    "ander-hu",
+    "Merge pointer-equivalent constraint nodes found offline (HU) before solving Andersen's analysis",
+    false
+);
+
+const Option<bool> Options::AnderSteensPartition(
+    "ander-steens-partition",
+    "Solve the partitions of Andersen's constraints found by Steensgaard's analysis separately (in parallel with -ander-threads) before solving the whole program",
+    false
+);
+
+const Option<std::string> Options::AnderTelemetry(
+    "ander-telemetry",
+    "Write one JSON line of progress per Andersen's iteration to a file or FIFO",
+    ""
+);
+
+const Option<std::string> Options::AnderCheckpoint(
+    "ander-checkpoint",
+    "Periodically checkpoint the state of Andersen's analysis to a file (also written when -ander-time-limit is reached)",
+    ""
+);
+
+const Option<u32_t> Options::AnderCheckpointInterval(
+    "ander-checkpoint-interval",
+    "Seconds between two -ander-checkpoint checkpoints",
+    1800
+);
+
+const Option<std::string> Options::AnderResume(
+    "ander-resume",
+    "Resume Andersen's analysis from a -ander-checkpoint file",
+    ""
+);
+
 // ContextDDA.cpp
 const Option<u32_t> Options::CxtBudget(
     "cxt-bg",
@@ -332,6 +422,12 @@ const Option<bool> Options::INCDFPTData(
     true
 );
 
+const Option<bool> Options::CompactDFPTData(
+    "compact-df",
+    "Store the IN/OUT sets of flow-sensitive analysis compactly, forwarding those of nodes which only pass them on (overrides -inc-data and -ptd)",
+    false
+);
+
 const Option<bool> Options::ClusterAnder(
     "cluster-ander",
     "Stage Andersen's with Steensgard's and cluster based on that",
@@ -358,9 +454,16 @@ const OptionMap<PointsTo::Type> Options::PtType(
     {PointsTo::Type::SBV, "sbv", "sparse bit-vector"},
     {PointsTo::Type::CBV, "cbv", "core bit-vector (dynamic bit-vector without leading and trailing 0s)"},
     {PointsTo::Type::BV, "bv", "bit-vector (dynamic bit-vector without trailing 0s)"},
+    {PointsTo::Type::RBV, "rbv", "roaring bit-vector (array, bitmap or run container per 64K chunk)"},
 }
 );
 
+const Option<bool> Options::PtInline(
+    "pt-inline",
+    "Store points-to sets of up to 8 elements inline, without allocating a pt-type data structure",
+    false
+);
+
 const OptionMap<u32_t> Options::ClusterMethod(
     "cluster-method",
     "hierarchical clustering method for objects",
@@ -369,7 +472,8 @@ const OptionMap<u32_t> Options::ClusterMethod(
     {HCLUST_METHOD_SINGLE,     "single", "single linkage; minimum spanning tree algorithm"},
     {HCLUST_METHOD_COMPLETE, "complete", "complete linkage; nearest-neighbour-chain algorithm"},
     {HCLUST_METHOD_AVERAGE,   "average", "unweighted average linkage; nearest-neighbour-chain algorithm"},
-    {HCLUST_METHOD_SVF_BEST,     "best", "try all linkage criteria; choose best"},
+    {HCLUST_METHOD_SVF_MINHASH, "minhash", "order objects by MinHash signatures of their points-to sets; near-linear"},
+    {HCLUST_METHOD_SVF_BEST,     "best", "try all linkage criteria and minhash; choose best"},
 }
 );
 
@@ -386,6 +490,12 @@ const Option<bool> Options::RegionAlign(
     true
 );
 
+const Option<u32_t> Options::ClusterThreads(
+    "cluster-threads",
+    "number of threads clustering regions in parallel",
+    1
+);
+
 const Option<bool> Options::PredictPtOcc(
     "cluster-predict-occ",
     "try to predict which points-to sets are more important in staged analysis",
@@ -399,6 +509,12 @@ const Option<bool> Options::IgnoreDeadFun(
     false
 );
 
+const Option<u32_t> Options::MSSAThreads(
+    "mssa-threads",
+    "number of threads building memory SSA per function and collecting mod-ref of loads/stores",
+    1
+);
+
 
 // Base class of pointer analyses (MemSSA.cpp)
 const Option<bool> Options::DumpMSSA(
@@ -626,6 +742,18 @@ const Option<std::string> Options::ReadAnder(
     ""
 );
 
+const Option<bool> Options::BinaryAnder(
+    "binary-ander",
+    "Write -write-ander results in the binary format (-read-ander detects the format)",
+    false
+);
+
+const Option<std::string> Options::IncrementalAnder(
+    "incremental-ander",
+    "Re-analyze incrementally from a previous -write-ander result and its .cons constraint file",
+    ""
+);
+
 const Option<bool> Options::DiffPts(
     "diff",
     "Enable differential point-to set",
@@ -677,6 +805,8 @@ OptionMultiple<PTATY> Options::PASelected(
     {PTATY::AndersenSCD_WPA, "sander", "Selective cycle detection inclusion-based analysis"},
     {PTATY::AndersenSFR_WPA, "sfrander", "Stride-based field representation inclusion-based analysis"},
     {PTATY::AndersenWaveDiff_WPA, "ander", "Diff wave propagation inclusion-based analysis"},
+    {PTATY::AndersenLCD_WPA, "lander", "Lazy cycle detection inclusion-based analysis"},
+    {PTATY::AndersenHLCD_WPA, "hlander", "Hybrid (offline + lazy) cycle detection inclusion-based analysis"},
     {PTATY::Steensgaard_WPA, "steens", "Steensgaard's pointer analysis"},
     // Disabled till further work is done.
     {PTATY::FSSPARSE_WPA, "fspta", "Sparse flow sensitive pointer analysis"},
@@ -130,7 +130,8 @@ void PTAStat::callgraphStat()
     PTNumStatMap["TotalEdge"] = totalEdge;
     PTNumStatMap["CalRetPairInCycle"] = edgeInCycle;
 
-    if(pta->getAnalysisTy() >= PTATY::Andersen_BASE && pta->getAnalysisTy() <= PTATY::Steensgaard_WPA)
+    if((pta->getAnalysisTy() >= PTATY::Andersen_BASE && pta->getAnalysisTy() <= PTATY::Steensgaard_WPA)
+            || pta->getAnalysisTy() == PTATY::AndersenLCD_WPA || pta->getAnalysisTy() == PTATY::AndersenHLCD_WPA)
         SVFStat::printStat("PTACallGraph Stats (Andersen analysis)");
     else if(pta->getAnalysisTy() >= PTATY::FSDATAFLOW_WPA && pta->getAnalysisTy() <= PTATY::FSCS_WPA)
         SVFStat::printStat("PTACallGraph Stats (Flow-sensitive analysis)");
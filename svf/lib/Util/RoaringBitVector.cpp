@@ -0,0 +1,820 @@
+//===- RoaringBitVector.cpp -- Hybrid container bit vector data structure ------------//
+
+/*
+ * RoaringBitVector.cpp
+ *
+ * Bit vector split into 64K chunks, each stored as a sorted array, a bitmap,
+ * or a list of runs, whichever is smallest (implementation).
+ */
+
+#include <limits.h>
+#include <algorithm>
+
+#include "Util/SparseBitVector.h"  // For LLVM's countPopulation and countTrailingZeros.
+#include "Util/RoaringBitVector.h"
+
+namespace SVF
+{
+
+const size_t RoaringBitVector::WordSize = sizeof(Word) * CHAR_BIT;
+const u32_t RoaringBitVector::ChunkSize;
+const u32_t RoaringBitVector::BitmapWords;
+const u32_t RoaringBitVector::MaxArraySize;
+
+namespace
+{
+
+typedef RoaringBitVector::Word Word;
+
+/// Sets bits first to last (inclusive) in words.
+void setWordRange(Word *words, u32_t first, u32_t last)
+{
+    const u32_t firstWord = first / 64;
+    const u32_t lastWord = last / 64;
+    const Word firstMask = ~(Word)0 << (first % 64);
+    const Word lastMask = ~(Word)0 >> (63 - last % 64);
+    if (firstWord == lastWord)
+    {
+        words[firstWord] |= firstMask & lastMask;
+        return;
+    }
+
+    words[firstWord] |= firstMask;
+    for (u32_t i = firstWord + 1; i < lastWord; ++i) words[i] = ~(Word)0;
+    words[lastWord] |= lastMask;
+}
+
+/// Returns the first set bit at or after from in words (numWords long),
+/// or numWords * 64 if there is none.
+u32_t nextSetBit(const Word *words, u32_t numWords, u32_t from)
+{
+    u32_t i = from / 64;
+    if (i >= numWords) return numWords * 64;
+    Word w = words[i] & (~(Word)0 << (from % 64));
+    while (w == 0)
+    {
+        if (++i == numWords) return numWords * 64;
+        w = words[i];
+    }
+
+    return i * 64 + countTrailingZeros(w);
+}
+
+}  // End anonymous namespace
+
+RoaringBitVector::RoaringBitVector(void) { }
+
+RoaringBitVector::RoaringBitVector(const RoaringBitVector &rbv)
+    : containers(rbv.containers) { }
+
+RoaringBitVector::RoaringBitVector(RoaringBitVector &&rbv)
+    : containers(std::move(rbv.containers)) { }
+
+RoaringBitVector &RoaringBitVector::operator=(const RoaringBitVector &rhs)
+{
+    this->containers = rhs.containers;
+    return *this;
+}
+
+RoaringBitVector &RoaringBitVector::operator=(RoaringBitVector &&rhs)
+{
+    this->containers = std::move(rhs.containers);
+    return *this;
+}
+
+bool RoaringBitVector::empty(void) const
+{
+    // Empty containers are always removed.
+    return containers.empty();
+}
+
+u32_t RoaringBitVector::count(void) const
+{
+    u32_t n = 0;
+    for (const Container &c : containers) n += c.card;
+    return n;
+}
+
+void RoaringBitVector::clear(void)
+{
+    containers.clear();
+    containers.shrink_to_fit();
+}
+
+bool RoaringBitVector::test(u32_t bit) const
+{
+    const Container *c = findContainer(bit >> 16);
+    return c != nullptr && containerTest(*c, bit & 0xFFFF);
+}
+
+bool RoaringBitVector::test_and_set(u32_t bit)
+{
+    const u32_t key = bit >> 16;
+    const size_t i = containerIndex(key);
+    if (i == containers.size() || containers[i].key != key)
+    {
+        containers.insert(containers.begin() + i, Container(key));
+    }
+
+    return containerSet(containers[i], bit & 0xFFFF);
+}
+
+void RoaringBitVector::set(u32_t bit)
+{
+    test_and_set(bit);
+}
+
+void RoaringBitVector::reset(u32_t bit)
+{
+    const u32_t key = bit >> 16;
+    const size_t i = containerIndex(key);
+    if (i == containers.size() || containers[i].key != key) return;
+
+    containerReset(containers[i], bit & 0xFFFF);
+    if (containers[i].card == 0) containers.erase(containers.begin() + i);
+}
+
+bool RoaringBitVector::contains(const RoaringBitVector &rhs) const
+{
+    for (const Container &rc : rhs.containers)
+    {
+        const Container *c = findContainer(rc.key);
+        if (c == nullptr || c->card < rc.card) return false;
+        if (intersectionCount(*c, rc) != rc.card) return false;
+    }
+
+    return true;
+}
+
+bool RoaringBitVector::intersects(const RoaringBitVector &rhs) const
+{
+    size_t i = 0, j = 0;
+    while (i < containers.size() && j < rhs.containers.size())
+    {
+        if (containers[i].key < rhs.containers[j].key) ++i;
+        else if (rhs.containers[j].key < containers[i].key) ++j;
+        else
+        {
+            if (intersectionCount(containers[i], rhs.containers[j]) != 0) return true;
+            ++i;
+            ++j;
+        }
+    }
+
+    return false;
+}
+
+bool RoaringBitVector::operator==(const RoaringBitVector &rhs) const
+{
+    // Containers are canonical, so equal sets are represented identically.
+    return containers == rhs.containers;
+}
+
+bool RoaringBitVector::operator!=(const RoaringBitVector &rhs) const
+{
+    return !(*this == rhs);
+}
+
+bool RoaringBitVector::operator|=(const RoaringBitVector &rhs)
+{
+    if (this == &rhs) return false;
+    return apply(*this, rhs, OrOp);
+}
+
+bool RoaringBitVector::operator&=(const RoaringBitVector &rhs)
+{
+    if (this == &rhs) return false;
+    return apply(*this, rhs, AndOp);
+}
+
+bool RoaringBitVector::operator-=(const RoaringBitVector &rhs)
+{
+    if (this == &rhs)
+    {
+        const bool changed = !empty();
+        clear();
+        return changed;
+    }
+
+    return apply(*this, rhs, AndNotOp);
+}
+
+bool RoaringBitVector::intersectWithComplement(const RoaringBitVector &rhs)
+{
+    return *this -= rhs;
+}
+
+void RoaringBitVector::intersectWithComplement(const RoaringBitVector &lhs, const RoaringBitVector &rhs)
+{
+    RoaringBitVector result(lhs);
+    result -= rhs;
+    *this = std::move(result);
+}
+
+size_t RoaringBitVector::hash(void) const
+{
+    // Same combination as CoreBitVector::hash.
+    size_t h = containers.size();
+    for (const Container &c : containers)
+    {
+        h ^= c.key + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= c.card + 0x9e3779b9 + (h << 6) + (h >> 2);
+        for (const u16_t v : c.vals) h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+        for (const Word &w : c.words) h ^= w + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+
+    return h;
+}
+
+RoaringBitVector::const_iterator RoaringBitVector::begin(void) const
+{
+    return RoaringBitVectorIterator(this);
+}
+
+RoaringBitVector::const_iterator RoaringBitVector::end(void) const
+{
+    return RoaringBitVectorIterator(this, true);
+}
+
+const RoaringBitVector::Container *RoaringBitVector::findContainer(u32_t key) const
+{
+    const size_t i = containerIndex(key);
+    if (i == containers.size() || containers[i].key != key) return nullptr;
+    return &containers[i];
+}
+
+size_t RoaringBitVector::containerIndex(u32_t key) const
+{
+    size_t lo = 0, hi = containers.size();
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (containers[mid].key < key) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+bool RoaringBitVector::containerTest(const Container &c, u32_t low)
+{
+    if (c.kind == ArrayContainer)
+    {
+        return std::binary_search(c.vals.begin(), c.vals.end(), low);
+    }
+    else if (c.kind == BitmapContainer)
+    {
+        return (c.words[low / 64] >> (low % 64)) & 1;
+    }
+    else
+    {
+        const size_t r = runIndex(c, low);
+        return r < c.runs && low <= c.vals[2 * r + 1];
+    }
+}
+
+bool RoaringBitVector::containerSet(Container &c, u32_t low)
+{
+    if (c.kind == ArrayContainer)
+    {
+        std::vector<u16_t>::iterator it = std::lower_bound(c.vals.begin(), c.vals.end(), low);
+        if (it != c.vals.end() && *it == low) return false;
+
+        const bool left = it != c.vals.begin() && *(it - 1) + 1u == low;
+        const bool right = it != c.vals.end() && *it == low + 1;
+        c.vals.insert(it, low);
+        if (!left && !right) ++c.runs;
+        else if (left && right) --c.runs;
+    }
+    else if (c.kind == BitmapContainer)
+    {
+        Word &w = c.words[low / 64];
+        const Word mask = (Word)1 << (low % 64);
+        if (w & mask) return false;
+
+        const bool left = low > 0 && containerTest(c, low - 1);
+        const bool right = low + 1 < ChunkSize && containerTest(c, low + 1);
+        w |= mask;
+        if (!left && !right) ++c.runs;
+        else if (left && right) --c.runs;
+    }
+    else
+    {
+        // First run starting after low.
+        size_t next = runIndex(c, low);
+        next = next == c.runs ? 0 : next + 1;
+        if (next > 0 && low <= c.vals[2 * next - 1]) return false;
+
+        const bool left = next > 0 && c.vals[2 * next - 1] + 1u == low;
+        const bool right = next < c.runs && c.vals[2 * next] == low + 1;
+        if (left && right)
+        {
+            // Join the runs either side of low.
+            c.vals[2 * next - 1] = c.vals[2 * next + 1];
+            c.vals.erase(c.vals.begin() + 2 * next, c.vals.begin() + 2 * next + 2);
+            --c.runs;
+        }
+        else if (left) c.vals[2 * next - 1] = low;
+        else if (right) c.vals[2 * next] = low;
+        else
+        {
+            const u16_t run[] = { (u16_t)low, (u16_t)low };
+            c.vals.insert(c.vals.begin() + 2 * next, run, run + 2);
+            ++c.runs;
+        }
+    }
+
+    ++c.card;
+    canonicalise(c);
+    return true;
+}
+
+bool RoaringBitVector::containerReset(Container &c, u32_t low)
+{
+    if (c.kind == ArrayContainer)
+    {
+        std::vector<u16_t>::iterator it = std::lower_bound(c.vals.begin(), c.vals.end(), low);
+        if (it == c.vals.end() || *it != low) return false;
+
+        const bool left = it != c.vals.begin() && *(it - 1) + 1u == low;
+        const bool right = it + 1 != c.vals.end() && *(it + 1) == low + 1;
+        c.vals.erase(it);
+        if (!left && !right) --c.runs;
+        else if (left && right) ++c.runs;
+    }
+    else if (c.kind == BitmapContainer)
+    {
+        Word &w = c.words[low / 64];
+        const Word mask = (Word)1 << (low % 64);
+        if (!(w & mask)) return false;
+
+        const bool left = low > 0 && containerTest(c, low - 1);
+        const bool right = low + 1 < ChunkSize && containerTest(c, low + 1);
+        w &= ~mask;
+        if (!left && !right) --c.runs;
+        else if (left && right) ++c.runs;
+    }
+    else
+    {
+        const size_t r = runIndex(c, low);
+        if (r == c.runs || low > c.vals[2 * r + 1]) return false;
+
+        const u32_t start = c.vals[2 * r];
+        const u32_t last = c.vals[2 * r + 1];
+        if (start == last)
+        {
+            c.vals.erase(c.vals.begin() + 2 * r, c.vals.begin() + 2 * r + 2);
+            --c.runs;
+        }
+        else if (low == start) c.vals[2 * r] = low + 1;
+        else if (low == last) c.vals[2 * r + 1] = low - 1;
+        else
+        {
+            // Split the run around low.
+            const u16_t run[] = { (u16_t)(low + 1), (u16_t)last };
+            c.vals[2 * r + 1] = low - 1;
+            c.vals.insert(c.vals.begin() + 2 * r + 2, run, run + 2);
+            ++c.runs;
+        }
+    }
+
+    --c.card;
+    if (c.card != 0) canonicalise(c);
+    return true;
+}
+
+size_t RoaringBitVector::runIndex(const Container &c, u32_t low)
+{
+    assert(c.kind == RunContainer && "RBV::runIndex: not a run container!");
+    // First run starting after low.
+    size_t lo = 0, hi = c.runs;
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (c.vals[2 * mid] <= low) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo == 0 ? c.runs : lo - 1;
+}
+
+RoaringBitVector::ContainerKind RoaringBitVector::bestKind(u32_t card, u32_t runs)
+{
+    // Sizes in bytes: array 2 * card, bitmap 8192, runs 4 * runs.
+    const u32_t bitmapBytes = BitmapWords * sizeof(Word);
+    if (4 * runs < std::min(2 * card, bitmapBytes)) return RunContainer;
+    if (card <= MaxArraySize) return ArrayContainer;
+    return BitmapContainer;
+}
+
+void RoaringBitVector::canonicalise(Container &c)
+{
+    if (bestKind(c.card, c.runs) == c.kind) return;
+
+    if (c.kind == BitmapContainer)
+    {
+        std::vector<Word> words = std::move(c.words);
+        fromWords(c, words.data());
+    }
+    else
+    {
+        Intervals intervals;
+        toIntervals(c, intervals);
+        fromIntervals(c, intervals);
+    }
+}
+
+void RoaringBitVector::toIntervals(const Container &c, Intervals &intervals)
+{
+    intervals.clear();
+    intervals.reserve(c.runs);
+    if (c.kind == ArrayContainer)
+    {
+        for (const u16_t v : c.vals)
+        {
+            if (!intervals.empty() && intervals.back().second + 1 == v) intervals.back().second = v;
+            else intervals.push_back(Interval(v, v));
+        }
+    }
+    else if (c.kind == RunContainer)
+    {
+        for (size_t r = 0; r < c.runs; ++r) intervals.push_back(Interval(c.vals[2 * r], c.vals[2 * r + 1]));
+    }
+    else
+    {
+        const Word *words = c.words.data();
+        u32_t start = nextSetBit(words, BitmapWords, 0);
+        while (start < ChunkSize)
+        {
+            // Runs end at the first unset bit.
+            u32_t i = start / 64;
+            Word w = ~words[i] & (~(Word)0 << (start % 64));
+            while (w == 0 && ++i < BitmapWords) w = ~words[i];
+            const u32_t end = i < BitmapWords ? i * 64 + countTrailingZeros(w) : ChunkSize;
+            intervals.push_back(Interval(start, end - 1));
+            start = nextSetBit(words, BitmapWords, end);
+        }
+    }
+}
+
+void RoaringBitVector::toWords(const Container &c, Word *words)
+{
+    if (c.kind == BitmapContainer)
+    {
+        std::copy(c.words.begin(), c.words.end(), words);
+        return;
+    }
+
+    std::fill(words, words + BitmapWords, 0);
+    if (c.kind == ArrayContainer)
+    {
+        for (const u16_t v : c.vals) words[v / 64] |= (Word)1 << (v % 64);
+    }
+    else
+    {
+        for (size_t r = 0; r < c.runs; ++r) setWordRange(words, c.vals[2 * r], c.vals[2 * r + 1]);
+    }
+}
+
+void RoaringBitVector::fromIntervals(Container &c, const Intervals &intervals)
+{
+    c.card = 0;
+    for (const Interval &i : intervals) c.card += i.second - i.first + 1;
+    c.runs = intervals.size();
+    c.kind = bestKind(c.card, c.runs);
+    c.vals.clear();
+    c.words.clear();
+
+    if (c.kind == RunContainer)
+    {
+        c.vals.reserve(2 * c.runs);
+        for (const Interval &i : intervals)
+        {
+            c.vals.push_back(i.first);
+            c.vals.push_back(i.second);
+        }
+    }
+    else if (c.kind == ArrayContainer)
+    {
+        c.vals.reserve(c.card);
+        for (const Interval &i : intervals)
+        {
+            for (u32_t v = i.first; v <= i.second; ++v) c.vals.push_back(v);
+        }
+    }
+    else
+    {
+        c.words.assign(BitmapWords, 0);
+        for (const Interval &i : intervals) setWordRange(c.words.data(), i.first, i.second);
+    }
+
+    c.vals.shrink_to_fit();
+}
+
+void RoaringBitVector::fromWords(Container &c, const Word *words)
+{
+    c.card = 0;
+    c.runs = 0;
+    Word carry = 0;
+    for (u32_t i = 0; i < BitmapWords; ++i)
+    {
+        // A run starts at every set bit whose predecessor is unset.
+        c.card += countPopulation(words[i]);
+        c.runs += countPopulation(words[i] & ~((words[i] << 1) | carry));
+        carry = words[i] >> 63;
+    }
+
+    ContainerKind kind = bestKind(c.card, c.runs);
+    if (kind == BitmapContainer)
+    {
+        c.kind = kind;
+        c.vals.clear();
+        c.vals.shrink_to_fit();
+        c.words.assign(words, words + BitmapWords);
+    }
+    else if (kind == ArrayContainer)
+    {
+        c.kind = kind;
+        c.words.clear();
+        c.words.shrink_to_fit();
+        c.vals.clear();
+        c.vals.reserve(c.card);
+        for (u32_t v = nextSetBit(words, BitmapWords, 0); v < ChunkSize; v = nextSetBit(words, BitmapWords, v + 1))
+        {
+            c.vals.push_back(v);
+        }
+    }
+    else
+    {
+        // Go through a bitmap container to find the runs.
+        Container bitmap(c.key);
+        bitmap.kind = BitmapContainer;
+        bitmap.words.assign(words, words + BitmapWords);
+        Intervals intervals;
+        toIntervals(bitmap, intervals);
+        fromIntervals(c, intervals);
+    }
+}
+
+RoaringBitVector::Container RoaringBitVector::combine(const Container &lhs, const Container &rhs, Op op)
+{
+    assert(lhs.key == rhs.key && "RBV::combine: different chunks!");
+    Container result(lhs.key);
+
+    if (lhs.kind != BitmapContainer && rhs.kind != BitmapContainer)
+    {
+        // Arrays and runs: merge the sorted runs of both sides.
+        Intervals l, r, out;
+        toIntervals(lhs, l);
+        toIntervals(rhs, r);
+        auto push = [&out](u32_t first, u32_t last)
+        {
+            if (!out.empty() && out.back().second + 1 >= first)
+                out.back().second = std::max(out.back().second, last);
+            else out.push_back(Interval(first, last));
+        };
+
+        if (op == OrOp)
+        {
+            size_t i = 0, j = 0;
+            while (i < l.size() || j < r.size())
+            {
+                if (j == r.size() || (i < l.size() && l[i].first < r[j].first))
+                {
+                    push(l[i].first, l[i].second);
+                    ++i;
+                }
+                else
+                {
+                    push(r[j].first, r[j].second);
+                    ++j;
+                }
+            }
+        }
+        else if (op == AndOp)
+        {
+            size_t i = 0, j = 0;
+            while (i < l.size() && j < r.size())
+            {
+                const u32_t first = std::max(l[i].first, r[j].first);
+                const u32_t last = std::min(l[i].second, r[j].second);
+                if (first <= last) push(first, last);
+                if (l[i].second < r[j].second) ++i;
+                else ++j;
+            }
+        }
+        else
+        {
+            size_t j = 0;
+            for (const Interval &i : l)
+            {
+                u32_t cur = i.first;
+                while (j < r.size() && r[j].second < cur) ++j;
+                for (size_t k = j; k < r.size() && r[k].first <= i.second && cur <= i.second; ++k)
+                {
+                    if (r[k].first > cur) push(cur, r[k].first - 1);
+                    cur = std::max(cur, r[k].second + 1);
+                }
+
+                if (cur <= i.second) push(cur, i.second);
+            }
+        }
+
+        fromIntervals(result, out);
+        return result;
+    }
+
+    // At least one bitmap: work word by word.
+    Word l[BitmapWords], r[BitmapWords];
+    toWords(lhs, l);
+    toWords(rhs, r);
+    for (u32_t i = 0; i < BitmapWords; ++i)
+    {
+        if (op == OrOp) l[i] |= r[i];
+        else if (op == AndOp) l[i] &= r[i];
+        else l[i] &= ~r[i];
+    }
+
+    fromWords(result, l);
+    return result;
+}
+
+u32_t RoaringBitVector::intersectionCount(const Container &lhs, const Container &rhs)
+{
+    if (lhs.kind == ArrayContainer && rhs.kind == BitmapContainer)
+    {
+        u32_t n = 0;
+        for (const u16_t v : lhs.vals) n += containerTest(rhs, v);
+        return n;
+    }
+    else if (lhs.kind == BitmapContainer && rhs.kind == ArrayContainer)
+    {
+        return intersectionCount(rhs, lhs);
+    }
+    else if (lhs.kind == BitmapContainer || rhs.kind == BitmapContainer)
+    {
+        Word l[BitmapWords], r[BitmapWords];
+        toWords(lhs, l);
+        toWords(rhs, r);
+        u32_t n = 0;
+        for (u32_t i = 0; i < BitmapWords; ++i) n += countPopulation(l[i] & r[i]);
+        return n;
+    }
+
+    Intervals l, r;
+    toIntervals(lhs, l);
+    toIntervals(rhs, r);
+    u32_t n = 0;
+    size_t i = 0, j = 0;
+    while (i < l.size() && j < r.size())
+    {
+        const u32_t first = std::max(l[i].first, r[j].first);
+        const u32_t last = std::min(l[i].second, r[j].second);
+        if (first <= last) n += last - first + 1;
+        if (l[i].second < r[j].second) ++i;
+        else ++j;
+    }
+
+    return n;
+}
+
+bool RoaringBitVector::apply(const RoaringBitVector &lhs, const RoaringBitVector &rhs, Op op)
+{
+    assert(this == &lhs && "RBV::apply: only in place!");
+    const u32_t oldCount = count();
+
+    if (op == AndOp)
+    {
+        std::vector<Container> result;
+        size_t i = 0, j = 0;
+        while (i < containers.size() && j < rhs.containers.size())
+        {
+            if (containers[i].key < rhs.containers[j].key) ++i;
+            else if (rhs.containers[j].key < containers[i].key) ++j;
+            else
+            {
+                Container c = combine(containers[i], rhs.containers[j], AndOp);
+                if (c.card != 0) result.push_back(std::move(c));
+                ++i;
+                ++j;
+            }
+        }
+
+        containers = std::move(result);
+        return count() != oldCount;
+    }
+
+    for (const Container &rc : rhs.containers)
+    {
+        const size_t i = containerIndex(rc.key);
+        if (i == containers.size() || containers[i].key != rc.key)
+        {
+            if (op == OrOp) containers.insert(containers.begin() + i, rc);
+            continue;
+        }
+
+        Container &c = containers[i];
+        if (c.kind == BitmapContainer && rc.kind == ArrayContainer)
+        {
+            // Cheaper than going through 1024 words twice.
+            for (const u16_t v : rc.vals)
+            {
+                if (op == OrOp) containerSet(c, v);
+                else if (containerReset(c, v) && c.card == 0) break;
+            }
+        }
+        else c = combine(c, rc, op);
+
+        if (c.card == 0) containers.erase(containers.begin() + i);
+    }
+
+    // Union only grows and difference only shrinks the set.
+    return count() != oldCount;
+}
+
+RoaringBitVector::RoaringBitVectorIterator::RoaringBitVectorIterator(const RoaringBitVector *rbv, bool end)
+    : rbv(rbv), containerIdx(end ? rbv->containers.size() : 0), pos(0), low(0)
+{
+    enterContainer();
+}
+
+const RoaringBitVector::RoaringBitVectorIterator &RoaringBitVector::RoaringBitVectorIterator::operator++(void)
+{
+    assert(!atEnd() && "RoaringBitVectorIterator::++(pre): incrementing past end!");
+
+    const Container &c = rbv->containers[containerIdx];
+    if (c.kind == ArrayContainer)
+    {
+        if (++pos < c.card)
+        {
+            low = c.vals[pos];
+            return *this;
+        }
+    }
+    else if (c.kind == RunContainer)
+    {
+        if (low < c.vals[2 * pos + 1])
+        {
+            ++low;
+            return *this;
+        }
+        else if (++pos < c.runs)
+        {
+            low = c.vals[2 * pos];
+            return *this;
+        }
+    }
+    else
+    {
+        low = nextSetBit(c.words.data(), BitmapWords, low + 1);
+        if (low < ChunkSize) return *this;
+    }
+
+    ++containerIdx;
+    enterContainer();
+    return *this;
+}
+
+const RoaringBitVector::RoaringBitVectorIterator RoaringBitVector::RoaringBitVectorIterator::operator++(int)
+{
+    assert(!atEnd() && "RoaringBitVectorIterator::++(pre): incrementing past end!");
+    RoaringBitVectorIterator old = *this;
+    ++*this;
+    return old;
+}
+
+u32_t RoaringBitVector::RoaringBitVectorIterator::operator*(void) const
+{
+    assert(!atEnd() && "RoaringBitVectorIterator::*: dereferencing end!");
+    return (rbv->containers[containerIdx].key << 16) | low;
+}
+
+bool RoaringBitVector::RoaringBitVectorIterator::operator==(const RoaringBitVectorIterator &rhs) const
+{
+    assert(rbv == rhs.rbv && "RoaringBitVectorIterator::==: comparing iterators from different RBVs");
+    return containerIdx == rhs.containerIdx && low == rhs.low;
+}
+
+bool RoaringBitVector::RoaringBitVectorIterator::operator!=(const RoaringBitVectorIterator &rhs) const
+{
+    assert(rbv == rhs.rbv && "RoaringBitVectorIterator::!=: comparing iterators from different RBVs");
+    return !(*this == rhs);
+}
+
+bool RoaringBitVector::RoaringBitVectorIterator::atEnd(void) const
+{
+    return containerIdx >= rbv->containers.size();
+}
+
+void RoaringBitVector::RoaringBitVectorIterator::enterContainer(void)
+{
+    pos = 0;
+    low = 0;
+    if (atEnd()) return;
+
+    const Container &c = rbv->containers[containerIdx];
+    if (c.kind == BitmapContainer) low = nextSetBit(c.words.data(), BitmapWords, 0);
+    else low = c.vals[0];
+}
+
+};  // namespace SVF
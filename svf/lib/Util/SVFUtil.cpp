@@ -263,6 +263,8 @@ std::string SVFUtil::hclustMethodToString(hclust_fast_methods method)
         return "median";
     case HCLUST_METHOD_SVF_BEST:
         return "svf-best";
+    case HCLUST_METHOD_SVF_MINHASH:
+        return "svf-minhash";
     default:
         assert(false && "SVFUtil::hclustMethodToString: unknown method");
         abort();
@@ -36,6 +36,8 @@
 #include "Util/Options.h"
 #include "Util/SVFUtil.h"
 
+#include <fstream>
+
 using namespace SVF;
 using namespace SVFUtil;
 using namespace std;
@@ -50,6 +52,7 @@ u32_t AndersenBase::numOfSfrs = 0;
 u32_t AndersenBase::numOfFieldExpand = 0;
 
 u32_t AndersenBase::numOfSCCDetection = 0;
+u32_t AndersenBase::numOfSCCMerged = 0;
 double AndersenBase::timeOfSCCDetection = 0;
 double AndersenBase::timeOfSCCMerges = 0;
 double AndersenBase::timeOfCollapse = 0;
@@ -59,6 +62,20 @@ u32_t AndersenBase::MaxPointsToSetSize = 0;
 double AndersenBase::timeOfProcessCopyGep = 0;
 double AndersenBase::timeOfProcessLoadStore = 0;
 double AndersenBase::timeOfUpdateCallGraph = 0;
+double AndersenBase::timeOfCollectLoadStore = 0;
+double AndersenBase::timeOfAddLoadStoreEdges = 0;
+u32_t AndersenBase::numOfIncChangedFuns = 0;
+u32_t AndersenBase::numOfIncAddedCons = 0;
+u32_t AndersenBase::numOfIncRemovedCons = 0;
+u32_t AndersenBase::numOfIncAffectedNodes = 0;
+u32_t AndersenBase::numOfSteensPartitions = 0;
+u32_t AndersenBase::numOfSolvedPartitions = 0;
+double AndersenBase::timeOfPartitionSolve = 0;
+double AndersenBase::timeOfIncResume = 0;
+u32_t AndersenBase::numOfOfflineMerged = 0;
+double AndersenBase::timeOfOfflineReduction = 0;
+u32_t AndersenBase::numOfCheckpoints = 0;
+double AndersenBase::timeOfCheckpoint = 0;
 
 /*!
  * Destructor
@@ -81,6 +98,7 @@ void AndersenBase::initialize()
     /// Build Constraint Graph
     consCG = new ConstraintGraph(pag);
     setGraph(consCG);
+    setWorklistOrder(Options::WPAWorklistOrder());
     if (Options::ConsCGDotGraph())
         consCG->dump("consCG_initial");
 }
@@ -104,7 +122,23 @@ void AndersenBase::solveConstraints()
     // Start solving constraints
     DBOUT(DGENERAL, outs() << SVFUtil::pasMsg("Start Solving Constraints\n"));
 
-    bool limitTimerSet = SVFUtil::startAnalysisLimitTimer(Options::AnderTimeLimit());
+    // With checkpoints, the time limit is checked by checkpointIfDue() so that
+    // a last checkpoint can be written before exiting.
+    checkpointing = !Options::AnderCheckpoint().empty() && isCheckpointable();
+    if (!Options::AnderCheckpoint().empty() && !checkpointing)
+        writeWrnMsg(PTAName() + " does not support -ander-checkpoint");
+    bool limitTimerSet = !checkpointing && SVFUtil::startAnalysisLimitTimer(Options::AnderTimeLimit());
+    checkpointSolveStart = lastCheckpoint = stat->getClk(true);
+
+    // A FIFO sink blocks here until a reader opens it.
+    std::ofstream telemetry;
+    if (!Options::AnderTelemetry().empty())
+    {
+        telemetry.open(Options::AnderTelemetry(), std::ios::out | std::ios::trunc);
+        if (!telemetry.is_open())
+            SVFUtil::writeWrnMsg("Cannot open telemetry sink " + Options::AnderTelemetry());
+    }
+    double solveStart = stat->getClk();
 
     initWorklist();
     do
@@ -116,12 +150,20 @@ void AndersenBase::solveConstraints()
         reanalyze = false;
 
         solveWorklist();
+        collectPtsGarbage();
+        profilePtsIfRequested();
 
+        u32_t numOfIndCallEdges = getNumOfResolvedIndCallEdge();
         if (updateCallGraph(getIndirectCallsites()))
             reanalyze = true;
 
+        if (telemetry.is_open())
+            writeTelemetry(telemetry, solveStart, getNumOfResolvedIndCallEdge() - numOfIndCallEdges);
+
+        checkpointIfDue();
     }
     while (reanalyze);
+    checkpointing = false;
 
     // Analysis is finished, reset the alarm if we set it.
     SVFUtil::stopAnalysisLimitTimer(limitTimerSet);
@@ -129,6 +171,50 @@ void AndersenBase::solveConstraints()
     DBOUT(DGENERAL, outs() << SVFUtil::pasMsg("Finish Solving Constraints\n"));
 }
 
+/*!
+ * One JSON object per line. Counters are cumulative since the start of the
+ * analysis, except newIndCallEdges which is for this iteration only.
+ */
+void AndersenBase::writeTelemetry(std::ostream& os, double solveStart, u32_t newIndCallEdges)
+{
+    u32_t maxPtsSize = 0;
+    u64_t totalPtsSize = 0;
+    u32_t numOfPointers = 0;
+    for (ConstraintGraph::const_iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it)
+    {
+        NodeID id = it->first;
+        if (sccRepNode(id) != id)
+            continue;
+        u32_t size = getPts(id).count();
+        if (size == 0)
+            continue;
+        maxPtsSize = std::max(maxPtsSize, size);
+        totalPtsSize += size;
+        numOfPointers++;
+    }
+
+    u32_t vmrss = 0, vmsize = 0;
+    SVFUtil::getMemoryUsageKB(&vmrss, &vmsize);
+
+    os << "{\"iteration\":" << numOfIteration
+       << ",\"time\":" << (stat->getClk() - solveStart) / TIMEINTERVAL
+       << ",\"timeLimit\":" << Options::AnderTimeLimit()
+       << ",\"worklist\":" << getWorklistSize()
+       << ",\"addrProcessed\":" << numOfProcessedAddr
+       << ",\"copyProcessed\":" << numOfProcessedCopy
+       << ",\"gepProcessed\":" << numOfProcessedGep
+       << ",\"loadProcessed\":" << numOfProcessedLoad
+       << ",\"storeProcessed\":" << numOfProcessedStore
+       << ",\"sccDetections\":" << numOfSCCDetection
+       << ",\"sccMerged\":" << numOfSCCMerged
+       << ",\"newIndCallEdges\":" << newIndCallEdges
+       << ",\"indCallEdges\":" << getNumOfResolvedIndCallEdge()
+       << ",\"maxPtsSize\":" << maxPtsSize
+       << ",\"avgPtsSize\":" << (numOfPointers ? (double)totalPtsSize / numOfPointers : 0)
+       << ",\"vmrssKB\":" << vmrss
+       << "}" << std::endl;
+}
+
 /*!
  * Andersen analysis
  */
@@ -138,6 +224,14 @@ void AndersenBase::analyze()
     {
         readPtsFromFile(Options::ReadAnder());
     }
+    else if(!Options::IncrementalAnder().empty())
+    {
+        incrementalSolve(Options::IncrementalAnder());
+    }
+    else if(!Options::AnderResume().empty())
+    {
+        resumeSolve(Options::AnderResume());
+    }
     else
     {
         if(Options::WriteAnder().empty())
@@ -172,13 +266,52 @@ void AndersenBase:: solveAndwritePtsToFile(const std::string& filename)
     /// Initialization for the Solver
     initialize();
     if (!filename.empty())
+    {
         this->writeObjVarToFile(filename);
+        writeConstraintsToFile(filename + ".cons");
+    }
     solveConstraints();
     if (!filename.empty())
         this->writeToFile(filename);
     finalize();
 }
 
+/*!
+ * Incremental analysis is not supported by this solver: analyze from scratch
+ */
+void AndersenBase::incrementalSolve(const std::string&)
+{
+    writeWrnMsg(PTAName() + " does not support -incremental-ander, analyzing from scratch");
+    if(Options::WriteAnder().empty())
+    {
+        initialize();
+        solveConstraints();
+        finalize();
+    }
+    else
+    {
+        solveAndwritePtsToFile(Options::WriteAnder());
+    }
+}
+
+/*!
+ * Resuming is not supported by this solver: analyze from scratch
+ */
+void AndersenBase::resumeSolve(const std::string&)
+{
+    writeWrnMsg(PTAName() + " does not support -ander-resume, analyzing from scratch");
+    if(Options::WriteAnder().empty())
+    {
+        initialize();
+        solveConstraints();
+        finalize();
+    }
+    else
+    {
+        solveAndwritePtsToFile(Options::WriteAnder());
+    }
+}
+
 void AndersenBase::cleanConsCG(NodeID id)
 {
     consCG->resetSubs(consCG->getRep(id));
@@ -424,6 +557,10 @@ void Andersen::initialize()
 
     if (Options::ClusterAnder()) cluster();
 
+    /// Checkpoints are only resumed on the same SVFIR
+    if (!Options::AnderCheckpoint().empty() || !Options::AnderResume().empty())
+        checkpointFingerprint = getSVFIRFingerprint();
+
     /// Initialize worklist
     processAllAddr();
 }
@@ -453,6 +590,50 @@ void Andersen::finalize()
     AndersenBase::finalize();
 }
 
+/*!
+ * Solve constraints
+ */
+void Andersen::solveConstraints()
+{
+    // A checkpoint already includes the effects of the pre-passes.
+    if (!resumedFromCheckpoint)
+    {
+        if (Options::AnderHU())
+            mergeOfflineEquivalentNodes();
+        if (Options::AnderSteensPartition())
+            solvePartitions();
+    }
+    AndersenBase::solveConstraints();
+}
+
+/*!
+ * Merge pointers whose points-to sets are equal by construction, so that they
+ * are propagated once and share one points-to set.
+ */
+void Andersen::mergeOfflineEquivalentNodes()
+{
+    double start = stat->getClk();
+
+    std::vector<NodeBS> classes;
+    consCG->computePointerEquivalence(classes);
+    for (const NodeBS& eqClass : classes)
+    {
+        NodeID rep = sccRepNode(eqClass.find_first());
+        for (NodeID n : eqClass)
+        {
+            NodeID sub = sccRepNode(n);
+            if (sub == rep)
+                continue;
+            mergeNodeToRep(sub, rep);
+            pushIntoWorklist(rep);
+            numOfOfflineMerged++;
+        }
+    }
+
+    double end = stat->getClk();
+    timeOfOfflineReduction += (end - start) / TIMEINTERVAL;
+}
+
 /*!
  * Start constraint solving
  */
@@ -560,7 +741,7 @@ bool Andersen::processLoad(NodeID node, const ConstraintEdge* load)
     ///       make gcc in spec 2000 pass the flow-sensitive analysis.
     ///       Try to handle black hole obj in an appropriate way.
 //	if (pag->isBlkObjOrConstantObj(node))
-    if (pag->isConstantObj(node) || pag->getSVFVar(load->getDstID())->isPointer() == false)
+    if (!isLoadCopyCandidate(node, load))
         return false;
 
     numOfProcessedLoad++;
@@ -580,7 +761,7 @@ bool Andersen::processStore(NodeID node, const ConstraintEdge* store)
     ///       make gcc in spec 2000 pass the flow-sensitive analysis.
     ///       Try to handle black hole obj in an appropriate way
 //	if (pag->isBlkObjOrConstantObj(node))
-    if (pag->isConstantObj(node) || pag->getSVFVar(store->getSrcID())->isPointer() == false)
+    if (!isStoreCopyCandidate(node, store))
         return false;
 
     numOfProcessedStore++;
@@ -706,6 +887,7 @@ inline void Andersen::collapseFields()
         if (collapseField(node))
             reanalyze = true;
     }
+    checkpointIfDue();
 }
 
 /*
@@ -724,6 +906,7 @@ void Andersen::mergeSccCycle()
         mergeSccNodes(repNodeId, subNodes);
         if (subNodes.count() > 1)
         {
+            numOfSCCMerged++;
             pushIntoWorklist(repNodeId);
             reanalyze = true;
         }
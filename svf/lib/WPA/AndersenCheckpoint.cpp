@@ -0,0 +1,454 @@
+//===- AndersenCheckpoint.cpp -- Checkpointing Andersen's analysis-----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * AndersenCheckpoint.cpp
+ *
+ * Checkpoint and resume of Andersen's constraint solving.
+ *
+ * With -ander-checkpoint=<file>, the solver state is written to <file> every
+ * -ander-checkpoint-interval seconds, and when -ander-time-limit is reached.
+ * Checkpoints are only taken between two nodes, when no field is waiting to
+ * be collapsed. A checkpoint stores, one record per line,
+ *   G base offset id     gep objects created while solving
+ *   F base               field-insensitive objects
+ *   R sub rep            merged nodes
+ *   X id                 gep nodes made redundant by field collapsing
+ *   C src dst            copy edges
+ *   P id objs...         points-to sets
+ *   Q id objs...         propagated points-to sets which differ from P
+ *   W id                 worklist, in order
+ *   I callsite callee    resolved indirect calls
+ * -ander-resume=<file> restores them on the same SVFIR and carries on.
+ */
+
+#include "Graphs/CallGraph.h"
+#include "Graphs/ICFG.h"
+#include "MemoryModel/PointsTo.h"
+#include "WPA/Andersen.h"
+#include "WPA/WPAStat.h"
+#include "Util/Options.h"
+#include "Util/SVFUtil.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace SVF;
+using namespace SVFUtil;
+using namespace std;
+
+namespace
+{
+
+const std::string CheckpointMagic = "ANDERSEN-CHECKPOINT";
+const u32_t CheckpointVersion = 1;
+
+/// Solver state read back from a checkpoint file
+struct AndersenCheckpoint
+{
+    u64_t fingerprint = 0;
+    u32_t numOfIteration = 0;
+    std::vector<std::tuple<NodeID, APOffset, NodeID>> gepObjs;
+    std::vector<NodeID> fieldInsensitiveObjs;
+    std::vector<NodePair> reps;
+    std::vector<NodeID> redundantGepNodes;
+    std::vector<NodePair> copyEdges;
+    std::vector<std::pair<NodeID, PointsTo>> pts;
+    std::vector<std::pair<NodeID, PointsTo>> propaPts;
+    std::vector<NodeID> worklist;
+    std::vector<NodePair> indCallEdges;
+};
+
+void writePtsRecord(std::ostream& os, char tag, NodeID id, const PointsTo& pts)
+{
+    os << tag << " " << id;
+    for (NodeID o : pts)
+        os << " " << o;
+    os << "\n";
+}
+
+bool readCheckpointFile(const std::string& filename, AndersenCheckpoint& cp)
+{
+    ifstream F(filename.c_str());
+    if (!F.is_open())
+    {
+        outs() << "  error opening file for reading!\n";
+        return false;
+    }
+
+    std::string magic;
+    u32_t version = 0;
+    if (!(F >> magic >> version >> cp.fingerprint >> cp.numOfIteration)
+            || magic != CheckpointMagic || version != CheckpointVersion)
+    {
+        outs() << "  not a checkpoint file!\n";
+        return false;
+    }
+
+    std::string line;
+    while (getline(F, line))
+    {
+        if (line.empty())
+            continue;
+        istringstream ss(line.substr(1));
+        NodeID a = 0, b = 0;
+        bool ok = true;
+        switch (line[0])
+        {
+        case 'G':
+        {
+            APOffset offset = 0;
+            ok = static_cast<bool>(ss >> a >> offset >> b);
+            cp.gepObjs.push_back(std::make_tuple(a, offset, b));
+            break;
+        }
+        case 'F':
+            ok = static_cast<bool>(ss >> a);
+            cp.fieldInsensitiveObjs.push_back(a);
+            break;
+        case 'R':
+            ok = static_cast<bool>(ss >> a >> b);
+            cp.reps.push_back(std::make_pair(a, b));
+            break;
+        case 'X':
+            ok = static_cast<bool>(ss >> a);
+            cp.redundantGepNodes.push_back(a);
+            break;
+        case 'C':
+            ok = static_cast<bool>(ss >> a >> b);
+            cp.copyEdges.push_back(std::make_pair(a, b));
+            break;
+        case 'P':
+        case 'Q':
+        {
+            PointsTo pts;
+            ok = static_cast<bool>(ss >> a);
+            while (ss >> b)
+                pts.set(b);
+            (line[0] == 'P' ? cp.pts : cp.propaPts).push_back(std::make_pair(a, pts));
+            break;
+        }
+        case 'W':
+            ok = static_cast<bool>(ss >> a);
+            cp.worklist.push_back(a);
+            break;
+        case 'I':
+            ok = static_cast<bool>(ss >> a >> b);
+            cp.indCallEdges.push_back(std::make_pair(a, b));
+            break;
+        default:
+            ok = false;
+            break;
+        }
+        if (!ok)
+        {
+            outs() << "  malformed checkpoint file!\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // End anonymous namespace
+
+/*!
+ * Called between two nodes while solving
+ */
+void AndersenBase::checkpointIfDue()
+{
+    if (!checkpointing)
+        return;
+
+    double now = stat->getClk(true);
+    bool timeUp = Options::AnderTimeLimit() != 0
+                  && now - checkpointSolveStart >= Options::AnderTimeLimit() * TIMEINTERVAL;
+    if (!timeUp && now - lastCheckpoint < Options::AnderCheckpointInterval() * TIMEINTERVAL)
+        return;
+
+    if (writeCheckpoint(Options::AnderCheckpoint()))
+        numOfCheckpoints++;
+    lastCheckpoint = stat->getClk(true);
+    timeOfCheckpoint += (lastCheckpoint - now) / TIMEINTERVAL;
+
+    if (timeUp)
+    {
+        outs() << "WPA: time limit reached, resume with -ander-resume=" << Options::AnderCheckpoint() << "\n";
+        outs().flush();
+        exit(101);
+    }
+}
+
+/*!
+ * SCD and SFR keep solver state (SCC candidates, field strides) outside of
+ * what a checkpoint stores.
+ */
+bool Andersen::isCheckpointable() const
+{
+    return getAnalysisTy() != PTATY::AndersenSCD_WPA && getAnalysisTy() != PTATY::AndersenSFR_WPA;
+}
+
+/*!
+ * Write the solver state to a temporary file first, so that the previous
+ * checkpoint survives if the process is killed while writing.
+ */
+bool Andersen::writeCheckpoint(const std::string& filename)
+{
+    outs() << "Writing checkpoint to '" << filename << "'...";
+
+    const std::string tmpFile = filename + ".tmp";
+    std::ofstream f(tmpFile.c_str(), std::ios::out | std::ios::trunc);
+    if (!f.good())
+    {
+        outs() << "  error opening file for writing!\n";
+        return false;
+    }
+
+    f << CheckpointMagic << " " << CheckpointVersion << " " << checkpointFingerprint
+      << " " << numOfIteration << "\n";
+
+    /// Gep objects in the order of their ids, i.e., the order they were created
+    std::vector<std::tuple<NodeID, NodeID, APOffset>> gepObjs;
+    for (const auto& it : pag->getGepObjNodeMap())
+        gepObjs.push_back(std::make_tuple(it.second, it.first.first, it.first.second));
+    std::sort(gepObjs.begin(), gepObjs.end());
+    for (const auto& gep : gepObjs)
+        f << "G " << std::get<1>(gep) << " " << std::get<2>(gep) << " " << std::get<0>(gep) << "\n";
+
+    NodeBS baseIds;
+    for (SVFIR::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it)
+    {
+        if (!SVFUtil::isa<ObjVar>(it->second))
+            continue;
+        NodeID base = pag->getBaseObjVarID(it->first);
+        if (baseIds.test_and_set(base) && isFieldInsensitive(base))
+            f << "F " << base << "\n";
+    }
+
+    for (SVFIR::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it)
+    {
+        NodeID rep = sccRepNode(it->first);
+        if (rep != it->first)
+            f << "R " << it->first << " " << rep << "\n";
+    }
+
+    for (NodeID id : redundantGepNodes)
+        f << "X " << id << "\n";
+
+    for (const ConstraintEdge* edge : consCG->getDirectCGEdges())
+    {
+        if (SVFUtil::isa<CopyCGEdge>(edge))
+            f << "C " << edge->getSrcID() << " " << edge->getDstID() << "\n";
+    }
+
+    for (ConstraintGraph::const_iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it)
+    {
+        NodeID id = it->first;
+        const PointsTo& pts = getPts(id);
+        if (!pts.empty())
+            writePtsRecord(f, 'P', id, pts);
+        if (Options::DiffPts())
+        {
+            const PointsTo& propa = getDiffPTDataTy()->getPropaPts(id);
+            if (propa != pts)
+                writePtsRecord(f, 'Q', id, propa);
+        }
+    }
+
+    for (NodeID id : getWorklistSnapshot())
+        f << "W " << id << "\n";
+
+    for (const auto& it : getIndCallMap())
+    {
+        for (const FunObjVar* callee : it.second)
+            f << "I " << it.first->getId() << " " << callee->getId() << "\n";
+    }
+
+    f.close();
+    if (!f.good() || std::rename(tmpFile.c_str(), filename.c_str()) != 0)
+    {
+        outs() << "  error writing file!\n";
+        return false;
+    }
+    outs() << "\n";
+    return true;
+}
+
+/*!
+ * Restore the solver state right after initialize(). Everything is checked
+ * before the first change, so nothing is modified when false is returned.
+ */
+bool Andersen::readCheckpoint(const std::string& filename)
+{
+    AndersenCheckpoint cp;
+    if (!readCheckpointFile(filename, cp))
+        return false;
+
+    if (cp.fingerprint != checkpointFingerprint)
+    {
+        outs() << "  checkpoint of a different SVFIR!\n";
+        return false;
+    }
+
+    /// Gep objects must be recreated with their previous ids, as they were in
+    /// a run which created them in the same order.
+    Set<NodeID> gepIds;
+    for (const auto& gep : cp.gepObjs)
+    {
+        NodeID base = std::get<0>(gep);
+        NodeID id = std::get<2>(gep);
+        if (!pag->hasGNode(base) || !SVFUtil::isa<ObjVar>(pag->getGNode(base)))
+            return false;
+        SVFIR::OffsetToGepVarMap::const_iterator it =
+            pag->getGepObjNodeMap().find(std::make_pair(base, std::get<1>(gep)));
+        if (it != pag->getGepObjNodeMap().end() ? it->second != id : pag->hasGNode(id))
+            return false;
+        gepIds.insert(id);
+    }
+    auto isKnown = [&](NodeID id)
+    {
+        return pag->hasGNode(id) || gepIds.count(id);
+    };
+    for (NodeID id : cp.fieldInsensitiveObjs)
+    {
+        if (!isKnown(id))
+            return false;
+    }
+    for (const std::vector<NodePair>* pairs : {&cp.reps, &cp.copyEdges})
+    {
+        for (const NodePair& pair : *pairs)
+        {
+            if (!isKnown(pair.first) || !isKnown(pair.second))
+                return false;
+        }
+    }
+    for (const std::vector<std::pair<NodeID, PointsTo>>* sets : {&cp.pts, &cp.propaPts})
+    {
+        for (const std::pair<NodeID, PointsTo>& nodePts : *sets)
+        {
+            if (!isKnown(nodePts.first))
+                return false;
+            for (NodeID o : nodePts.second)
+            {
+                if (!isKnown(o))
+                    return false;
+            }
+        }
+    }
+    std::vector<std::pair<const CallICFGNode*, const FunObjVar*>> indCalls;
+    for (const NodePair& edge : cp.indCallEdges)
+    {
+        const CallICFGNode* cs = pag->getICFG()->hasGNode(edge.first)
+                                 ? SVFUtil::dyn_cast<CallICFGNode>(pag->getICFG()->getICFGNode(edge.first)) : nullptr;
+        const FunObjVar* callee = pag->hasGNode(edge.second)
+                                  ? SVFUtil::dyn_cast<FunObjVar>(pag->getGNode(edge.second)) : nullptr;
+        if (cs == nullptr || callee == nullptr)
+            return false;
+        indCalls.push_back(std::make_pair(cs, callee));
+    }
+
+    /// Objects
+    for (const auto& gep : cp.gepObjs)
+    {
+        NodeID id = std::get<2>(gep);
+        if (pag->hasGNode(id))
+            continue;
+        restoreGepObjVar(std::get<0>(gep), std::get<1>(gep), id);
+        consCG->addConstraintNode(new ConstraintNode(id), id);
+    }
+    for (NodeID base : cp.fieldInsensitiveObjs)
+    {
+        if (!isFieldInsensitive(base))
+            setObjFieldInsensitive(base);
+    }
+
+    /// Constraint graph
+    for (const NodePair& rep : cp.reps)
+    {
+        NodeID sub = sccRepNode(rep.first);
+        if (sub != rep.second && consCG->hasConstraintNode(sub) && consCG->hasConstraintNode(rep.second))
+            mergeNodeToRep(sub, rep.second);
+    }
+    for (NodeID id : cp.redundantGepNodes)
+        redundantGepNodes.set(id);
+    for (const NodePair& edge : cp.copyEdges)
+        consCG->addCopyCGEdge(sccRepNode(edge.first), sccRepNode(edge.second));
+
+    /// Points-to sets, everything but the recorded differences has been propagated
+    for (const std::pair<NodeID, PointsTo>& nodePts : cp.pts)
+        unionPts(nodePts.first, nodePts.second);
+    if (Options::DiffPts())
+    {
+        for (ConstraintGraph::const_iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it)
+            computeDiffPts(it->first);
+        for (const std::pair<NodeID, PointsTo>& nodePts : cp.propaPts)
+        {
+            NodeID rep = sccRepNode(nodePts.first);
+            getDiffPTDataTy()->setPropaPts(rep, nodePts.second);
+        }
+    }
+
+    clearWorklist();
+    for (NodeID id : cp.worklist)
+        pushIntoWorklist(id);
+
+    /// Call graph, whose parameter copy edges have been restored above
+    for (const auto& call : indCalls)
+    {
+        if (getIndCallMap()[call.first].insert(call.second).second)
+            callgraph->addIndirectCallGraphEdge(call.first, call.first->getCaller(), call.second);
+    }
+
+    numOfIteration = cp.numOfIteration;
+    return true;
+}
+
+/*!
+ * Continue solving from a checkpoint
+ */
+void Andersen::resumeSolve(const std::string& filename)
+{
+    initialize();
+
+    const std::string& writeFile = Options::WriteAnder();
+    if (!writeFile.empty())
+    {
+        writeObjVarToFile(writeFile);
+        writeConstraintsToFile(writeFile + ".cons");
+    }
+
+    if (!isCheckpointable())
+        writeWrnMsg(PTAName() + " does not support -ander-resume, analyzing from scratch");
+    else
+    {
+        outs() << "Resuming Andersen's analysis from checkpoint '" << filename << "'...";
+        resumedFromCheckpoint = readCheckpoint(filename);
+        outs() << "\n";
+        if (!resumedFromCheckpoint)
+            writeWrnMsg("checkpoint cannot be used, analyzing from scratch");
+    }
+
+    solveConstraints();
+
+    if (!writeFile.empty())
+        writeToFile(writeFile);
+    finalize();
+}
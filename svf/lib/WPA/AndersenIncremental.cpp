@@ -0,0 +1,635 @@
+//===- AndersenIncremental.cpp -- Incremental Andersen's analysis-------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * AndersenIncremental.cpp
+ *
+ * Incremental re-analysis from a previous -write-ander result.
+ *
+ * Next to the result file, -write-ander stores the initial constraints of the
+ * run (<file>.cons), grouped by the function owning them. A later run with
+ * -incremental-ander=<file> diffs them against the constraints of the new
+ * SVFIR, and then
+ *  - reuses the previous points-to sets of all nodes which cannot lose
+ *    points-to targets because of removed constraints,
+ *  - recomputes the nodes affected by removed constraints from scratch,
+ *  - seeds the solver only with the nodes feeding added constraints and
+ *    the recomputed nodes.
+ * Node ids shift with any edit, so the .cons file also keeps a stable key of
+ * each node (see NodeKey), and previous ids are translated to the ids of the
+ * same nodes in the new SVFIR before diffing.
+ */
+
+#include "Graphs/ThreadCallGraph.h"
+#include "MemoryModel/PointsTo.h"
+#include "WPA/Andersen.h"
+#include "WPA/WPAStat.h"
+#include "Util/Options.h"
+#include "Util/SVFUtil.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+using namespace SVF;
+using namespace SVFUtil;
+using namespace std;
+
+/*!
+ * Collect the constraints of the constraint graph, grouped by the function
+ * of their destination (or source) node. Globals are grouped under "".
+ */
+void AndersenBase::collectConstraints(FunToConstraintsMap& funToCons) const
+{
+    auto funName = [this](const ConstraintEdge* edge) -> std::string
+    {
+        const FunObjVar* fun = pag->getSVFVar(edge->getDstID())->getFunction();
+        if (fun == nullptr)
+            fun = pag->getSVFVar(edge->getSrcID())->getFunction();
+        return fun ? fun->getName() : "";
+    };
+    auto collect = [&](const ConstraintEdge::ConstraintEdgeSetTy& edges)
+    {
+        for (const ConstraintEdge* edge : edges)
+        {
+            APOffset offset = 0;
+            if (const NormalGepCGEdge* gep = SVFUtil::dyn_cast<NormalGepCGEdge>(edge))
+                offset = gep->getConstantFieldIdx();
+            funToCons[funName(edge)].push_back(std::make_tuple(edge->getEdgeKind(),
+                                               edge->getSrcID(), edge->getDstID(), offset));
+        }
+    };
+
+    collect(consCG->getAddrCGEdges());
+    collect(consCG->getDirectCGEdges());
+    collect(consCG->getLoadCGEdges());
+    collect(consCG->getStoreCGEdges());
+
+    for (auto& it : funToCons)
+        std::sort(it.second.begin(), it.second.end());
+}
+
+/*!
+ * Key every node of the SVFIR by function, kind, name and ordinal
+ */
+void AndersenBase::collectNodeKeys(NodeToKeyMap& nodeKeys) const
+{
+    std::vector<NodeID> ids;
+    for (SVFIR::const_iterator it = pag->begin(), eit = pag->end(); it != eit; ++it)
+        ids.push_back(it->first);
+    std::sort(ids.begin(), ids.end());
+
+    Map<std::string, u32_t> ordinals;
+    for (NodeID id : ids)
+    {
+        const SVFVar* var = pag->getSVFVar(id);
+        const FunObjVar* fun = var->getFunction();
+        NodeKey key = std::make_tuple(fun ? fun->getName() : "", (u32_t) var->getNodeKind(), var->getName(), 0u);
+        std::ostringstream prefix;
+        prefix << std::get<0>(key) << '\n' << std::get<1>(key) << '\n' << std::get<2>(key);
+        std::get<3>(key) = ordinals[prefix.str()]++;
+        nodeKeys[id] = key;
+    }
+}
+
+/*!
+ * Store the node keys and then the constraints of each function in the form of
+ *   N id kind ordinal funLen:fun nameLen:name
+ *   F funName
+ *   kind src dst offset
+ */
+void AndersenBase::writeConstraintsToFile(const std::string& filename) const
+{
+    outs() << "Storing constraints to '" << filename << "'...";
+
+    std::fstream f(filename.c_str(), std::ios_base::out);
+    if (!f.good())
+    {
+        outs() << "  error opening file for writing!\n";
+        return;
+    }
+
+    NodeToKeyMap nodeKeys;
+    collectNodeKeys(nodeKeys);
+    OrderedMap<NodeID, NodeKey> orderedKeys(nodeKeys.begin(), nodeKeys.end());
+    for (const auto& it : orderedKeys)
+    {
+        const NodeKey& key = it.second;
+        f << "N " << it.first << " " << std::get<1>(key) << " " << std::get<3>(key) << " "
+          << std::get<0>(key).size() << ":" << std::get<0>(key) << " "
+          << std::get<2>(key).size() << ":" << std::get<2>(key) << "\n";
+    }
+
+    FunToConstraintsMap funToCons;
+    collectConstraints(funToCons);
+    for (const auto& it : funToCons)
+    {
+        f << "F " << it.first << "\n";
+        for (const ConstraintTuple& cons : it.second)
+        {
+            f << std::get<0>(cons) << " " << std::get<1>(cons) << " "
+              << std::get<2>(cons) << " " << std::get<3>(cons) << "\n";
+        }
+    }
+
+    f.close();
+    if (f.good())
+        outs() << "\n";
+    else
+        outs() << "  error writing file!\n";
+}
+
+bool AndersenBase::readConstraintsFromFile(const std::string& filename, FunToConstraintsMap& funToCons,
+        NodeToKeyMap& nodeKeys) const
+{
+    ifstream F(filename.c_str());
+    if (!F.is_open())
+    {
+        outs() << "  error opening '" << filename << "' for reading!\n";
+        return false;
+    }
+
+    std::vector<ConstraintTuple>* cons = nullptr;
+    string line;
+    while (getline(F, line))
+    {
+        if (line.empty()) continue;
+        if (line[0] == 'F')
+        {
+            cons = &funToCons[line.size() > 2 ? line.substr(2) : ""];
+            continue;
+        }
+        if (line[0] == 'N')
+        {
+            // Names are length-prefixed as they may contain spaces.
+            istringstream ss(line.substr(1));
+            auto readStr = [&ss](std::string& str)
+            {
+                size_t len;
+                char colon;
+                if (!(ss >> len >> colon) || colon != ':')
+                    return false;
+                str.resize(len);
+                return len == 0 || (bool)ss.read(&str[0], len);
+            };
+            NodeID id;
+            NodeKey key;
+            if (!(ss >> id >> std::get<1>(key) >> std::get<3>(key))
+                    || !readStr(std::get<0>(key)) || !readStr(std::get<2>(key)))
+            {
+                outs() << "  malformed constraint file '" << filename << "'!\n";
+                return false;
+            }
+            nodeKeys[id] = key;
+            continue;
+        }
+        istringstream ss(line);
+        ConstraintEdge::GEdgeKind kind;
+        NodeID src, dst;
+        APOffset offset;
+        if (cons == nullptr || !(ss >> kind >> src >> dst >> offset))
+        {
+            outs() << "  malformed constraint file '" << filename << "'!\n";
+            return false;
+        }
+        cons->push_back(std::make_tuple(kind, src, dst, offset));
+    }
+    // Older writers may not have sorted the constraints.
+    for (auto& it : funToCons)
+        std::sort(it.second.begin(), it.second.end());
+    return true;
+}
+
+/*!
+ * Incremental Andersen analysis
+ */
+void Andersen::incrementalSolve(const std::string& filename)
+{
+    initialize();
+
+    // Read the previous run before -write-ander may overwrite it.
+    outs() << "Resuming Andersen's analysis from '" << filename << "'...";
+    PtsSnapshot snapshot;
+    FunToConstraintsMap prevCons;
+    NodeToKeyMap prevNodeKeys;
+    bool resumable = readConstraintsFromFile(filename + ".cons", prevCons, prevNodeKeys)
+                     && readSnapshotFromFile(filename, snapshot);
+    outs() << "\n";
+
+    const std::string& writeFile = Options::WriteAnder();
+    if (!writeFile.empty())
+    {
+        writeObjVarToFile(writeFile);
+        writeConstraintsToFile(writeFile + ".cons");
+    }
+
+    double resumeStart = stat->getClk();
+    if (!resumable || !resumeFromSnapshot(snapshot, prevCons, prevNodeKeys))
+        writeWrnMsg("previous analysis results cannot be reused, analyzing from scratch");
+    double resumeEnd = stat->getClk();
+    timeOfIncResume += (resumeEnd - resumeStart) / TIMEINTERVAL;
+
+    solveConstraints();
+
+    if (!writeFile.empty())
+        writeToFile(writeFile);
+    finalize();
+}
+
+/*!
+ * Load the previous points-to sets and seed the worklist with the changes.
+ * Nothing is modified when false is returned.
+ */
+bool Andersen::resumeFromSnapshot(const PtsSnapshot& snapshot, const FunToConstraintsMap& prevCons,
+                                  const NodeToKeyMap& prevNodeKeys)
+{
+    /// Files without node keys (or without any node) cannot be matched
+    if (prevNodeKeys.empty())
+        return false;
+
+    /// Translate previous ids to the ids of the same nodes now. Nodes which
+    /// are gone are left out; whatever they fed is affected below.
+    NodeToKeyMap curNodeKeys;
+    collectNodeKeys(curNodeKeys);
+    OrderedMap<NodeKey, NodeID> keyToCurId;
+    for (const auto& it : curNodeKeys)
+        keyToCurId[it.second] = it.first;
+    Map<NodeID, NodeID> idMap;
+    for (const auto& it : prevNodeKeys)
+    {
+        auto curIt = keyToCurId.find(it.second);
+        if (curIt != keyToCurId.end())
+            idMap[it.first] = curIt->second;
+    }
+
+    /// Gep objects are created while solving: map each previous gep object to
+    /// the one of the same (translated) base and offset.
+    std::vector<std::tuple<NodeID, APOffset, NodeID>> gepObjs;
+    for (const auto& gep : snapshot.gepObjs)
+    {
+        auto baseIt = idMap.find(std::get<0>(gep));
+        if (baseIt == idMap.end())
+            continue;
+        if (!consCG->hasConstraintNode(baseIt->second) || !SVFUtil::isa<ObjVar>(pag->getSVFVar(baseIt->second)))
+            return false;
+        gepObjs.push_back(std::make_tuple(baseIt->second, std::get<1>(gep), std::get<2>(gep)));
+    }
+    for (const auto& gep : gepObjs)
+        idMap[std::get<2>(gep)] = consCG->getGepObjVar(std::get<0>(gep), std::get<1>(gep));
+
+    auto mapPts = [&idMap](const PointsTo& prevPts)
+    {
+        PointsTo pts;
+        for (NodeID o : prevPts)
+        {
+            auto it = idMap.find(o);
+            if (it != idMap.end())
+                pts.set(it->second);
+        }
+        return pts;
+    };
+    std::vector<PointsTo> ptsSets;
+    for (const PointsTo& pts : snapshot.ptsSets)
+        ptsSets.push_back(mapPts(pts));
+
+    /// Diff the translated constraints function by function. A previous
+    /// constraint on a node which is gone is removed; only what it fed in
+    /// the previous solution can be affected now.
+    NodeBS affected;
+    Map<NodeID, u32_t> prevNodeToSet(snapshot.nodeToSet.begin(), snapshot.nodeToSet.end());
+    auto translate = [&](const std::vector<ConstraintTuple>& prev, std::vector<ConstraintTuple>& translated)
+    {
+        bool lost = false;
+        for (const ConstraintTuple& cons : prev)
+        {
+            auto srcIt = idMap.find(std::get<1>(cons));
+            auto dstIt = idMap.find(std::get<2>(cons));
+            if (srcIt != idMap.end() && dstIt != idMap.end())
+            {
+                translated.push_back(std::make_tuple(std::get<0>(cons), srcIt->second, dstIt->second,
+                                                     std::get<3>(cons)));
+                continue;
+            }
+            lost = true;
+            numOfIncRemovedCons++;
+            if (std::get<0>(cons) != ConstraintEdge::Store)
+            {
+                if (dstIt != idMap.end())
+                    affected.set(dstIt->second);
+            }
+            else
+            {
+                // Stored through a pointer which is gone: its previous targets.
+                auto setIt = prevNodeToSet.find(std::get<2>(cons));
+                if (setIt != prevNodeToSet.end())
+                    affected |= ptsSets[setIt->second].toNodeBS();
+            }
+        }
+        std::sort(translated.begin(), translated.end());
+        return lost;
+    };
+
+    FunToConstraintsMap curCons;
+    collectConstraints(curCons);
+    std::vector<ConstraintTuple> added, removed;
+    const std::vector<ConstraintTuple> noCons;
+    OrderedSet<std::string> funNames;
+    for (const auto& it : prevCons) funNames.insert(it.first);
+    for (const auto& it : curCons) funNames.insert(it.first);
+    for (const std::string& fun : funNames)
+    {
+        auto prevIt = prevCons.find(fun);
+        auto curIt = curCons.find(fun);
+        std::vector<ConstraintTuple> prev;
+        bool lost = prevIt != prevCons.end() && translate(prevIt->second, prev);
+        const std::vector<ConstraintTuple>& cur = curIt != curCons.end() ? curIt->second : noCons;
+        if (!lost && prev == cur) continue;
+        numOfIncChangedFuns++;
+        std::set_difference(cur.begin(), cur.end(), prev.begin(), prev.end(), std::back_inserter(added));
+        std::set_difference(prev.begin(), prev.end(), cur.begin(), cur.end(), std::back_inserter(removed));
+    }
+    numOfIncAddedCons = added.size();
+    numOfIncRemovedCons += removed.size();
+
+    /// Previous points-to sets
+    for (const std::pair<NodeID, u32_t>& nodeSet : snapshot.nodeToSet)
+    {
+        auto it = idMap.find(nodeSet.first);
+        if (it != idMap.end())
+            unionPts(it->second, ptsSets[nodeSet.second]);
+    }
+
+    /// Drop the points-to sets which removed constraints may have contributed to
+    computeAffectedNodes(removed, affected);
+    for (NodeID n : affected)
+    {
+        if (consCG->hasConstraintNode(n))
+            clearFullPts(n);
+    }
+    numOfIncAffectedNodes = affected.count();
+
+    /// Objects which had been collapsed are collapsed again
+    for (const std::pair<NodeID, bool>& fi : snapshot.postSolveObjFI)
+    {
+        auto it = idMap.find(fi.first);
+        if (fi.second && it != idMap.end() && !isFieldInsensitive(it->second))
+            consCG->addNodeToBeCollapsed(it->second);
+    }
+    collapseFields();
+
+    rebuildLoadStoreCopyEdges();
+
+    /// Everything loaded so far has been propagated
+    for (ConstraintGraph::const_iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it)
+        computeDiffPts(it->first);
+
+    clearWorklist();
+    auto seed = [this](NodeID id)
+    {
+        clearPropaPts(id);
+        pushIntoWorklist(id);
+    };
+
+    /// Recompute affected nodes from their incoming constraints
+    for (NodeID n : affected)
+    {
+        if (!consCG->hasConstraintNode(n) || sccRepNode(n) != n)
+            continue;
+        ConstraintNode* node = consCG->getConstraintNode(n);
+        for (ConstraintEdge* edge : node->getAddrInEdges())
+            processAddr(SVFUtil::cast<AddrCGEdge>(edge));
+        for (ConstraintEdge* edge : node->getDirectInEdges())
+        {
+            if (!affected.test(edge->getSrcID()))
+                seed(edge->getSrcID());
+        }
+    }
+
+    /// Propagate along added constraints
+    for (const ConstraintTuple& cons : added)
+    {
+        NodeID src = std::get<1>(cons);
+        NodeID dst = std::get<2>(cons);
+        switch (std::get<0>(cons))
+        {
+        case ConstraintEdge::Addr:
+            seed(dst);
+            break;
+        case ConstraintEdge::Load:
+            // The copy edges of the load exist already, push its objects along them.
+            for (NodeID o : getPts(src))
+                seed(o);
+            break;
+        default:
+            seed(src);
+            break;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * Nodes whose points-to sets may shrink because of removed constraints:
+ * the forward closure of the removed constraints' destinations over the
+ * previous solution, including the copy edges it implies through loads,
+ * stores and indirect calls.
+ */
+void Andersen::computeAffectedNodes(const std::vector<ConstraintTuple>& removed, NodeBS& affected)
+{
+    FIFOWorkList<NodeID> affectedList;
+    auto affect = [&](NodeID id)
+    {
+        if (affected.test_and_set(id))
+            affectedList.push(id);
+    };
+    for (NodeID id : affected)
+        affectedList.push(id);
+
+    for (const ConstraintTuple& cons : removed)
+    {
+        NodeID dst = std::get<2>(cons);
+        if (std::get<0>(cons) != ConstraintEdge::Store)
+            affect(dst);
+        else if (consCG->hasConstraintNode(dst))
+        {
+            for (NodeID o : getPts(dst))
+                affect(o);
+        }
+    }
+    if (affected.empty())
+        return;
+
+    /// Copy edges implied by the previous solution
+    Map<NodeID, NodeBS> derivedSuccs;
+    for (const ConstraintEdge* load : consCG->getLoadCGEdges())
+    {
+        for (NodeID o : getPts(load->getSrcID()))
+            derivedSuccs[o].set(load->getDstID());
+    }
+
+    /// Parameter passing at indirect calls and forks resolved by the previous solution.
+    /// A change of the function pointer affects all the parameters.
+    Map<NodeID, NodeBS> ptrSuccs;
+    auto connectCallee = [&](const CallICFGNode* cs, const FunObjVar* callee, NodeID ptr)
+    {
+        const RetICFGNode* retBlockNode = cs->getRetICFGNode();
+        if (pag->funHasRet(callee) && pag->callsiteHasRet(retBlockNode))
+        {
+            NodeID csRet = pag->getCallSiteRet(retBlockNode)->getId();
+            derivedSuccs[pag->getFunRet(callee)->getId()].set(csRet);
+            ptrSuccs[ptr].set(csRet);
+        }
+        if (pag->hasCallSiteArgsMap(cs) && pag->hasFunArgsList(callee))
+        {
+            const SVFIR::ValVarList& csArgList = pag->getCallSiteArgsList(cs);
+            const SVFIR::ValVarList& funArgList = pag->getFunArgsList(callee);
+            auto csArgIt = csArgList.begin();
+            for (auto funArgIt = funArgList.begin(); funArgIt != funArgList.end() && csArgIt != csArgList.end();
+                    ++funArgIt, ++csArgIt)
+            {
+                derivedSuccs[(*csArgIt)->getId()].set((*funArgIt)->getId());
+                ptrSuccs[ptr].set((*funArgIt)->getId());
+            }
+            if (callee->isVarArg())
+            {
+                NodeID vaF = pag->getVarargNode(callee);
+                for (; csArgIt != csArgList.end(); ++csArgIt)
+                    derivedSuccs[(*csArgIt)->getId()].set(vaF);
+                ptrSuccs[ptr].set(vaF);
+            }
+        }
+    };
+    auto calleeOf = [this](NodeID o) -> const FunObjVar*
+    {
+        if (!pag->getObjVar(o))
+            return nullptr;
+        const BaseObjVar* obj = pag->getBaseObject(o);
+        if (!obj->isFunction())
+            return nullptr;
+        return SVFUtil::cast<FunObjVar>(obj)->getFunction()->getDefFunForMultipleModule();
+    };
+    for (const auto& it : pag->getIndirectCallsites())
+    {
+        const CallICFGNode* cs = it.first;
+        if (cs->isVirtualCall())
+        {
+            NodeID vtbl = cs->getVtablePtr()->getId();
+            VFunSet vfns;
+            getVFnsFromPts(cs, getPts(vtbl), vfns);
+            for (const FunObjVar* callee : vfns)
+                connectCallee(cs, callee, vtbl);
+        }
+        else
+        {
+            for (NodeID o : getPts(it.second))
+            {
+                if (const FunObjVar* callee = calleeOf(o))
+                    connectCallee(cs, callee, it.second);
+            }
+        }
+    }
+    if (ThreadCallGraph* tdCallGraph = SVFUtil::dyn_cast<ThreadCallGraph>(callgraph))
+    {
+        for (auto it = tdCallGraph->forksitesBegin(), eit = tdCallGraph->forksitesEnd(); it != eit; ++it)
+        {
+            const ValVar* forkedFun = tdCallGraph->getThreadAPI()->getForkedFun(*it);
+            const PAGNode* csArg = tdCallGraph->getThreadAPI()->getActualParmAtForkSite(*it);
+            for (NodeID o : getPts(forkedFun->getId()))
+            {
+                const FunObjVar* callee = calleeOf(o);
+                if (callee == nullptr || !pag->hasFunArgsList(callee))
+                    continue;
+                NodeID funArg = tdCallGraph->getThreadAPI()->getFormalParmOfForkedFun(callee)->getId();
+                derivedSuccs[csArg->getId()].set(funArg);
+                ptrSuccs[forkedFun->getId()].set(funArg);
+            }
+        }
+    }
+
+    while (!affectedList.empty())
+    {
+        NodeID n = affectedList.pop();
+        if (!consCG->hasConstraintNode(n))
+            continue;
+        ConstraintNode* node = consCG->getConstraintNode(n);
+        for (const ConstraintEdge* edge : node->getDirectOutEdges())
+            affect(edge->getDstID());
+        for (const ConstraintEdge* edge : node->getLoadOutEdges())
+            affect(edge->getDstID());
+        // n is stored: the objects it is stored into
+        for (const ConstraintEdge* edge : node->getStoreOutEdges())
+        {
+            for (NodeID o : getPts(edge->getDstID()))
+                affect(o);
+        }
+        // n is stored through: the objects it pointed to
+        if (!node->getStoreInEdges().empty())
+        {
+            for (NodeID o : getPts(n))
+                affect(o);
+        }
+        auto derivedIt = derivedSuccs.find(n);
+        if (derivedIt != derivedSuccs.end())
+        {
+            for (NodeID succ : derivedIt->second)
+                affect(succ);
+        }
+        auto ptrIt = ptrSuccs.find(n);
+        if (ptrIt != ptrSuccs.end())
+        {
+            for (NodeID succ : ptrIt->second)
+                affect(succ);
+        }
+    }
+}
+
+/*!
+ * Add the copy edges implied by the load and store constraints under the
+ * current points-to sets, without propagating along them.
+ */
+void Andersen::rebuildLoadStoreCopyEdges()
+{
+    for (ConstraintGraph::const_iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it)
+    {
+        const PointsTo& pts = getPts(it->first);
+        if (pts.empty())
+            continue;
+        const ConstraintNode* node = it->second;
+        for (const ConstraintEdge* load : node->getLoadOutEdges())
+        {
+            for (NodeID o : pts)
+            {
+                if (isLoadCopyCandidate(o, load))
+                    consCG->addCopyCGEdge(o, load->getDstID());
+            }
+        }
+        for (const ConstraintEdge* store : node->getStoreInEdges())
+        {
+            for (NodeID o : pts)
+            {
+                if (isStoreCopyCandidate(o, store))
+                    consCG->addCopyCGEdge(store->getSrcID(), o);
+            }
+        }
+    }
+}
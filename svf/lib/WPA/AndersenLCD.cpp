@@ -0,0 +1,121 @@
+//===- AndersenLCD.cpp -- Lazy cycle detection based Andersen's analysis------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * AndersenLCD.cpp
+ *
+ * Lazy cycle detection (LCD) and hybrid LCD Andersen's analysis
+ */
+
+#include "WPA/AndersenLCD.h"
+#include "MemoryModel/PointsTo.h"
+#include "Util/Options.h"
+#include "Util/PTAStat.h"
+
+using namespace SVF;
+using namespace SVFUtil;
+using namespace std;
+
+AndersenLCD* AndersenLCD::lcdAndersen = nullptr;
+AndersenHLCD* AndersenHLCD::hlcdAndersen = nullptr;
+
+/*!
+ * Solve the worklist. Cycle detection is only run when a copy edge has
+ * flagged a candidate, and only from the candidates.
+ */
+void AndersenLCD::solveWorklist()
+{
+    while (!isWorklistEmpty())
+    {
+        if (!lcdCandidates.empty())
+            SCCDetect();
+
+        NodeID nodeId = popFromWorklist();
+        collapsePWCNode(nodeId);
+        processNode(nodeId);
+        collapseFields();
+        collectPtsGarbage();
+        profilePtsIfRequested();
+    }
+}
+
+/*!
+ * Process a node as the standard worklist solver does: load/store edges over
+ * the whole points-to set, then copy/gep edges over the diff points-to set.
+ * AndersenWaveDiff::processNode only handles copy/gep edges, leaving loads and
+ * stores to a separate wave which LCD does not have.
+ */
+void AndersenLCD::processNode(NodeID nodeId)
+{
+    Andersen::processNode(nodeId);
+}
+
+/*!
+ * Process copy edges
+ *	src --copy--> dst,
+ *	union pts(dst) with pts(src), and flag src for cycle detection when the two
+ *	points-to sets are already equal before propagation, for the first time on
+ *	this edge.
+ */
+bool AndersenLCD::processCopy(NodeID node, const ConstraintEdge* edge)
+{
+    NodeID dst = edge->getDstID();
+    if (node != dst && getPts(node) == getPts(dst)
+            && checkedEdges.insert(std::make_pair(node, dst)).second)
+        lcdCandidates.insert(sccRepNode(node));
+
+    return Andersen::processCopy(node, edge);
+}
+
+/*!
+ * SCC detection for LCD, visiting only nodes reachable from the candidates
+ */
+NodeStack& AndersenLCD::SCCDetect()
+{
+    numOfSCCDetection++;
+
+    double sccStart = stat->getClk();
+    getSCCDetector()->find(lcdCandidates);
+    double sccEnd = stat->getClk();
+    timeOfSCCDetection += (sccEnd - sccStart) / TIMEINTERVAL;
+
+    double mergeStart = stat->getClk();
+    mergeSccCycle();
+    double mergeEnd = stat->getClk();
+    timeOfSCCMerges += (mergeEnd - mergeStart) / TIMEINTERVAL;
+
+    lcdCandidates.clear();
+
+    return getSCCDetector()->topoNodeStack();
+}
+
+/*!
+ * Merge offline equivalent pointers (which subsumes the cycles of the initial
+ * constraint graph) before lazily solving the rest.
+ */
+void AndersenHLCD::solveConstraints()
+{
+    // Andersen::solveConstraints() already does it under -ander-hu.
+    if (!Options::AnderHU() && !resumedFromCheckpoint)
+        mergeOfflineEquivalentNodes();
+    AndersenLCD::solveConstraints();
+}
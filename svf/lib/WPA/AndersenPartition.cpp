@@ -0,0 +1,434 @@
+//===- AndersenPartition.cpp -- Steensgaard-partitioned Andersen's analysis--//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * AndersenPartition.cpp
+ *
+ * Split the constraint graph into partitions which cannot exchange points-to
+ * information according to Steensgaard's analysis, and solve them in parallel.
+ */
+
+#include "WPA/Andersen.h"
+#include "WPA/Steensgaard.h"
+#include "MemoryModel/PointsTo.h"
+#include "Util/Options.h"
+#include "Util/PTAStat.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace SVF;
+using namespace SVFUtil;
+using namespace std;
+
+namespace
+{
+
+/*!
+ * Andersen's constraints of one partition, indexed by local node ids.
+ * Everything a worker reads is copied in here beforehand.
+ */
+struct ConstraintPartition
+{
+    std::vector<NodeID> nodes;              ///< local id -> node
+    Map<NodeID, u32_t> localIds;            ///< node -> local id
+    std::vector<std::vector<u32_t>> copyOuts;
+    std::vector<std::vector<std::pair<u32_t, APOffset>>> gepOuts;
+    std::vector<std::vector<u32_t>> loadOuts;   ///< pointer dsts of load edges
+    std::vector<std::vector<u32_t>> storeIns;   ///< pointer srcs of store edges
+    std::vector<bool> constObjs;
+    std::vector<PointsTo> pts;
+    std::vector<PointsTo> propaPts;
+    Set<std::pair<u32_t, u32_t>> copyEdges;
+    std::vector<NodePair> newCopyEdges;     ///< copy edges added for loads/stores
+    u32_t numOfCopy = 0;
+    u32_t numOfGep = 0;
+    u32_t numOfLoad = 0;
+    u32_t numOfStore = 0;
+    bool hasVariantGep = false;
+    bool solved = false;
+
+    u32_t addNode(NodeID id, bool constObj)
+    {
+        u32_t local = nodes.size();
+        nodes.push_back(id);
+        localIds[id] = local;
+        copyOuts.emplace_back();
+        gepOuts.emplace_back();
+        loadOuts.emplace_back();
+        storeIns.emplace_back();
+        constObjs.push_back(constObj);
+        pts.emplace_back();
+        propaPts.emplace_back();
+        return local;
+    }
+};
+
+/// Field object of an object, and whether an object is constant; both read
+/// (and for fields, extend) the SVFIR and constraint graph, so they are
+/// called under a lock.
+typedef std::function<NodeID(NodeID, const APOffset&)> FieldObjFn;
+typedef std::function<bool(NodeID)> ConstObjFn;
+
+/*!
+ * Solve one partition with diff propagation. Return false if an object from
+ * outside the partition shows up, in which case the partition is left to the
+ * whole-program solver.
+ */
+bool solvePartition(ConstraintPartition& part, const std::function<NodeID(NodeID)>& repNode,
+                    const FieldObjFn& fieldObj, const ConstObjFn& constObj)
+{
+    auto localObj = [&](NodeID o, u32_t& local) -> bool
+    {
+        Map<NodeID, u32_t>::const_iterator it = part.localIds.find(repNode(o));
+        if (it != part.localIds.end())
+        {
+            local = it->second;
+            return true;
+        }
+        // Constant objects never get copy edges, so they may be shared.
+        if (!constObj(o))
+            return false;
+        local = part.addNode(repNode(o), true);
+        return true;
+    };
+    auto addCopy = [&](u32_t src, u32_t dst) -> bool
+    {
+        if (src == dst || !part.copyEdges.insert(std::make_pair(src, dst)).second)
+            return false;
+        part.copyOuts[src].push_back(dst);
+        part.newCopyEdges.push_back(std::make_pair(part.nodes[src], part.nodes[dst]));
+        return part.pts[dst] |= part.pts[src];
+    };
+
+    FIFOWorkList<u32_t> worklist;
+    for (u32_t n = 0; n < part.nodes.size(); ++n)
+    {
+        for (u32_t dst : part.copyOuts[n])
+            part.copyEdges.insert(std::make_pair(n, dst));
+        if (!part.pts[n].empty())
+            worklist.push(n);
+    }
+
+    while (!worklist.empty())
+    {
+        u32_t n = worklist.pop();
+        PointsTo diff;
+        diff.intersectWithComplement(part.pts[n], part.propaPts[n]);
+        if (diff.empty())
+            continue;
+        part.propaPts[n] = part.pts[n];
+
+        for (NodeID o : diff)
+        {
+            u32_t obj = 0;
+            if (!localObj(o, obj))
+                return false;
+            if (part.constObjs[obj])
+                continue;
+            for (u32_t dst : part.loadOuts[n])
+            {
+                part.numOfLoad++;
+                if (addCopy(obj, dst))
+                    worklist.push(dst);
+            }
+            for (u32_t src : part.storeIns[n])
+            {
+                part.numOfStore++;
+                if (addCopy(src, obj))
+                    worklist.push(obj);
+            }
+        }
+
+        for (u32_t dst : part.copyOuts[n])
+        {
+            part.numOfCopy++;
+            if (part.pts[dst] |= diff)
+                worklist.push(dst);
+        }
+
+        for (const std::pair<u32_t, APOffset>& gep : part.gepOuts[n])
+        {
+            part.numOfGep++;
+            PointsTo fields;
+            for (NodeID o : diff)
+            {
+                NodeID field = fieldObj(o, gep.second);
+                if (field != o && part.localIds.find(field) == part.localIds.end())
+                    part.addNode(field, constObj(field));
+                fields.set(field);
+            }
+            if (part.pts[gep.first] |= fields)
+                worklist.push(gep.first);
+        }
+    }
+    return true;
+}
+
+/// Union-find over node ids
+struct NodeUnionFind
+{
+    std::vector<NodeID> parent;
+
+    explicit NodeUnionFind(NodeID size) : parent(size)
+    {
+        for (NodeID i = 0; i < size; ++i)
+            parent[i] = i;
+    }
+    NodeID find(NodeID n)
+    {
+        while (parent[n] != n)
+        {
+            parent[n] = parent[parent[n]];
+            n = parent[n];
+        }
+        return n;
+    }
+    void unite(NodeID a, NodeID b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a != b)
+            parent[std::max(a, b)] = std::min(a, b);
+    }
+};
+
+} // End anonymous namespace
+
+/*!
+ * Solve the Andersen's constraints of each Steensgaard partition on its own
+ * (in parallel with -ander-threads), then commit the points-to sets and the
+ * copy edges found to the whole-program solver, which carries on with what
+ * crosses partitions, i.e. indirect calls, and with the partitions which
+ * could not be solved locally.
+ */
+void Andersen::solvePartitions()
+{
+    if (getAnalysisTy() == PTATY::AndersenSFR_WPA)
+    {
+        writeWrnMsg("Steensgaard partitioning does not support SFR, solving the whole program instead");
+        return;
+    }
+
+    double start = stat->getClk();
+
+    // Pointers whose Steensgaard points-to sets share an object may reach
+    // each other's objects through loads/stores, so they go together.
+    Steensgaard* steens = Steensgaard::createSteensgaard(pag);
+
+    NodeID maxId = 0;
+    for (ConstraintGraph::const_iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it)
+        maxId = std::max(maxId, it->first);
+    NodeUnionFind uf(maxId + 1);
+
+    auto uniteEdges = [&](const ConstraintEdge::ConstraintEdgeSetTy& edges)
+    {
+        for (const ConstraintEdge* edge : edges)
+            uf.unite(sccRepNode(edge->getSrcID()), sccRepNode(edge->getDstID()));
+    };
+    uniteEdges(consCG->getAddrCGEdges());
+    uniteEdges(consCG->getDirectCGEdges());
+    uniteEdges(consCG->getLoadCGEdges());
+    uniteEdges(consCG->getStoreCGEdges());
+
+    Map<NodeID, NodeID> ecToObj;
+    auto uniteDerefObjs = [&](NodeID ptr)
+    {
+        NodeID ec = steens->getEC(ptr);
+        Map<NodeID, NodeID>::const_iterator it = ecToObj.find(ec);
+        if (it == ecToObj.end())
+        {
+            NodeID anchor = ptr;
+            for (NodeID o : steens->getPts(ptr))
+            {
+                NodeID obj = sccRepNode(o);
+                if (obj > maxId || pag->isConstantObj(obj))
+                    continue;
+                uf.unite(anchor, obj);
+                anchor = obj;
+            }
+            it = ecToObj.emplace(ec, anchor).first;
+        }
+        uf.unite(sccRepNode(ptr), it->second);
+    };
+    for (const ConstraintEdge* load : consCG->getLoadCGEdges())
+        uniteDerefObjs(load->getSrcID());
+    for (const ConstraintEdge* store : consCG->getStoreCGEdges())
+        uniteDerefObjs(store->getDstID());
+    // Not needed anymore; do not keep its points-to data for the whole run.
+    Steensgaard::releaseSteensgaard();
+    for (ConstraintGraph::const_iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it)
+    {
+        if (const GepObjVar* gepObj = SVFUtil::dyn_cast<GepObjVar>(pag->getGNode(it->first)))
+            uf.unite(it->first, sccRepNode(gepObj->getBaseNode()));
+    }
+
+    // Build the partitions, skipping pointers with nothing to propagate.
+    std::vector<ConstraintPartition> parts;
+    Map<NodeID, u32_t> rootToPart;
+    for (ConstraintGraph::const_iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it)
+    {
+        NodeID id = it->first;
+        const ConstraintNode* node = it->second;
+        if (sccRepNode(id) != id || (!SVFUtil::isa<ObjVar>(pag->getGNode(id)) && node->getOutEdges().empty()
+                                     && node->getInEdges().empty()))
+            continue;
+        NodeID root = uf.find(id);
+        Map<NodeID, u32_t>::const_iterator pit = rootToPart.find(root);
+        if (pit == rootToPart.end())
+        {
+            pit = rootToPart.emplace(root, parts.size()).first;
+            parts.emplace_back();
+        }
+        parts[pit->second].addNode(id, pag->isConstantObj(id));
+    }
+    numOfSteensPartitions += parts.size();
+
+    for (ConstraintPartition& part : parts)
+    {
+        for (u32_t n = 0; n < part.nodes.size(); ++n)
+        {
+            const ConstraintNode* node = consCG->getConstraintNode(part.nodes[n]);
+            for (const ConstraintEdge* edge : node->getCopyOutEdges())
+                part.copyOuts[n].push_back(part.localIds[sccRepNode(edge->getDstID())]);
+            for (const ConstraintEdge* edge : node->getGepOutEdges())
+            {
+                if (const NormalGepCGEdge* gep = SVFUtil::dyn_cast<NormalGepCGEdge>(edge))
+                    part.gepOuts[n].push_back(std::make_pair(part.localIds[sccRepNode(gep->getDstID())],
+                                              gep->getConstantFieldIdx()));
+                else
+                    part.hasVariantGep = true;
+            }
+            for (const ConstraintEdge* edge : node->getLoadOutEdges())
+            {
+                if (pag->getSVFVar(edge->getDstID())->isPointer())
+                    part.loadOuts[n].push_back(part.localIds[sccRepNode(edge->getDstID())]);
+            }
+            for (const ConstraintEdge* edge : node->getStoreInEdges())
+            {
+                if (pag->getSVFVar(edge->getSrcID())->isPointer())
+                    part.storeIns[n].push_back(part.localIds[sccRepNode(edge->getSrcID())]);
+            }
+            part.pts[n] = getPts(part.nodes[n]);
+        }
+    }
+
+    // Largest partitions first so that they do not end up last on a thread.
+    std::vector<u32_t> order;
+    for (u32_t i = 0; i < parts.size(); ++i)
+    {
+        // Variant geps make objects field-insensitive, which affects every
+        // node pointing to their fields, so leave those partitions alone.
+        if (parts[i].nodes.size() > 1 && !parts[i].hasVariantGep)
+            order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](u32_t a, u32_t b)
+    {
+        return parts[a].nodes.size() > parts[b].nodes.size();
+    });
+
+    // Workers must not read the constraint graph while others extend it with
+    // field objects, so the reps of the existing nodes are looked up now. The
+    // field objects created during the solve are their own reps.
+    std::vector<NodeID> reps(maxId + 1);
+    for (NodeID id = 0; id <= maxId; ++id)
+        reps[id] = sccRepNode(id);
+    std::mutex pagMutex;
+    std::function<NodeID(NodeID)> repNode = [&](NodeID id) -> NodeID
+    {
+        if (id <= maxId)
+            return reps[id];
+        std::lock_guard<std::mutex> lock(pagMutex);
+        return sccRepNode(id);
+    };
+    FieldObjFn fieldObj = [&](NodeID o, const APOffset& offset) -> NodeID
+    {
+        std::lock_guard<std::mutex> lock(pagMutex);
+        if (consCG->isBlkObjOrConstantObj(o) || isFieldInsensitive(o))
+            return o;
+        return consCG->getGepObjVar(o, offset);
+    };
+    ConstObjFn constObj = [&](NodeID o) -> bool
+    {
+        std::lock_guard<std::mutex> lock(pagMutex);
+        return pag->isConstantObj(o);
+    };
+
+    std::atomic<u32_t> next(0);
+    auto worker = [&]()
+    {
+        for (u32_t i = next++; i < order.size(); i = next++)
+        {
+            ConstraintPartition& part = parts[order[i]];
+            part.solved = solvePartition(part, repNode, fieldObj, constObj);
+        }
+    };
+    const u32_t numOfThreads = std::min<u32_t>(std::max<u32_t>(Options::AnderThreads(), 1), order.size());
+    if (numOfThreads <= 1)
+        worker();
+    else
+    {
+        std::vector<std::thread> threads;
+        for (u32_t t = 0; t < numOfThreads; ++t)
+            threads.emplace_back(worker);
+        for (std::thread& t : threads)
+            t.join();
+    }
+
+    // Commit in partition order: copy edges first, then the points-to sets,
+    // which are marked as propagated along all edges of their partition.
+    NodeBS solvedNodes;
+    for (ConstraintPartition& part : parts)
+    {
+        if (!part.solved)
+            continue;
+        numOfSolvedPartitions++;
+        numOfProcessedCopy += part.numOfCopy;
+        numOfProcessedGep += part.numOfGep;
+        numOfProcessedLoad += part.numOfLoad;
+        numOfProcessedStore += part.numOfStore;
+        for (const NodePair& edge : part.newCopyEdges)
+            consCG->addCopyCGEdge(edge.first, edge.second);
+        for (u32_t n = 0; n < part.nodes.size(); ++n)
+        {
+            unionPts(part.nodes[n], part.pts[n]);
+            solvedNodes.set(part.nodes[n]);
+        }
+    }
+    for (NodeID id : solvedNodes)
+        computeDiffPts(id);
+
+    // Nodes of solved partitions only need more work if the whole-program
+    // solver changes them, e.g. through indirect calls.
+    std::vector<NodeID> pending = getWorklistSnapshot();
+    clearWorklist();
+    for (NodeID id : pending)
+    {
+        if (!solvedNodes.test(sccRepNode(id)))
+            pushIntoWorklist(id);
+    }
+
+    double end = stat->getClk();
+    timeOfPartitionSolve += (end - start) / TIMEINTERVAL;
+}
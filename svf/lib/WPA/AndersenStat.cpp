@@ -312,6 +312,36 @@ void AndersenStat::performStat()
     timeStatMap["LoadStoreTime"] =  Andersen::timeOfProcessLoadStore;
     timeStatMap["CopyGepTime"] =  Andersen::timeOfProcessCopyGep;
     timeStatMap["UpdateCGTime"] =  Andersen::timeOfUpdateCallGraph;
+    if (Options::AnderThreads() > 1)
+    {
+        timeStatMap["LoadStoreCollectTime"] = Andersen::timeOfCollectLoadStore;
+        timeStatMap["LoadStoreAddEdgeTime"] = Andersen::timeOfAddLoadStoreEdges;
+        PTNumStatMap["AnderThreads"] = Options::AnderThreads();
+    }
+    if (Options::AnderHU())
+    {
+        timeStatMap["OfflineReduceTime"] = Andersen::timeOfOfflineReduction;
+        PTNumStatMap["OfflineMergedNodes"] = Andersen::numOfOfflineMerged;
+    }
+    if (Options::AnderSteensPartition())
+    {
+        timeStatMap["PartitionSolveTime"] = Andersen::timeOfPartitionSolve;
+        PTNumStatMap["SteensPartitions"] = Andersen::numOfSteensPartitions;
+        PTNumStatMap["SolvedPartitions"] = Andersen::numOfSolvedPartitions;
+    }
+    if (!Options::AnderCheckpoint().empty())
+    {
+        timeStatMap["CheckpointTime"] = Andersen::timeOfCheckpoint;
+        PTNumStatMap["Checkpoints"] = Andersen::numOfCheckpoints;
+    }
+    if (!Options::IncrementalAnder().empty())
+    {
+        timeStatMap["IncResumeTime"] = Andersen::timeOfIncResume;
+        PTNumStatMap["IncChangedFuns"] = Andersen::numOfIncChangedFuns;
+        PTNumStatMap["IncAddedCons"] = Andersen::numOfIncAddedCons;
+        PTNumStatMap["IncRemovedCons"] = Andersen::numOfIncRemovedCons;
+        PTNumStatMap["IncAffectedNodes"] = Andersen::numOfIncAffectedNodes;
+    }
 
     PTNumStatMap["TotalPointers"] = pag->getValueNodeNum();
     PTNumStatMap["TotalObjects"] = pag->getObjectNodeNum();
@@ -342,6 +372,7 @@ void AndersenStat::performStat()
     PTNumStatMap["IndEdgeSolved"] = pta->getNumOfResolvedIndCallEdge();
 
     PTNumStatMap["NumOfSCCDetect"] = Andersen::numOfSCCDetection;
+    PTNumStatMap["NumOfSCCMerged"] = Andersen::numOfSCCMerged;
     PTNumStatMap["TotalCycleNum"] = _NumOfCycles;
     PTNumStatMap["TotalPWCCycleNum"] = _NumOfPWCCycles;
     PTNumStatMap["NodesInCycles"] = _NumOfNodesInCycles;
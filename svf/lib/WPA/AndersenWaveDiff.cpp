@@ -32,6 +32,7 @@
 #include "Util/PTAStat.h"
 #include "Util/GeneralType.h"
 #include "Util/SVFUtil.h"
+#include "Util/Options.h"
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -66,15 +67,126 @@ void AndersenWaveDiff::solveWorklist()
         // process nodes in nodeStack
         processNode(nodeId);
         collapseFields();
+        collectPtsGarbage();
+        profilePtsIfRequested();
     }
 
     // New nodes will be inserted into workList during processing.
+    if (Options::AnderThreads() > 1 && getAnalysisTy() == PTATY::AndersenWaveDiff_WPA)
+    {
+        parallelPostProcessNodes();
+        // Once the workers, which read the points-to sets, are done.
+        collectPtsGarbage();
+        profilePtsIfRequested();
+        return;
+    }
+
     while (!isWorklistEmpty())
     {
         NodeID nodeId = popFromWorklist();
         // process nodes in worklist
         postProcessNode(nodeId);
+        collectPtsGarbage();
+        profilePtsIfRequested();
+    }
+}
+
+/*!
+ * Post process all nodes in the worklist with multiple threads.
+ * Phase 1 (parallel): each worker scans the load/store edges of a slice of the
+ * nodes and records the copy edges they imply. Nothing is written to the
+ * constraint graph or the points-to data in this phase.
+ * Phase 2 (sequential): the recorded edges are added in the same order as
+ * postProcessNode would have added them.
+ * The copy/gep wave stays sequential: it follows the topological order, each
+ * node's diff points-to set depending on its predecessors, and collapses PWC
+ * nodes and fields of the constraint graph as it goes.
+ */
+void AndersenWaveDiff::parallelPostProcessNodes()
+{
+    double insertStart = stat->getClk();
+
+    // getPts() may insert into the points-to map, so look up every set and
+    // node before the workers start.
+    std::vector<NodeID> nodeIds;
+    std::vector<const ConstraintNode*> nodes;
+    std::vector<const PointsTo*> nodePts;
+    while (!isWorklistEmpty())
+    {
+        NodeID nodeId = popFromWorklist();
+        nodeIds.push_back(nodeId);
+        nodes.push_back(consCG->getConstraintNode(nodeId));
+        nodePts.push_back(&getPts(nodeId));
+    }
+
+    if (loadStoreRunner == nullptr)
+        loadStoreRunner.reset(new PhaseRunner(Options::AnderThreads()));
+
+    const u32_t numOfNodes = nodeIds.size();
+    const u32_t numOfThreads = loadStoreRunner->getNumOfThreads();
+    std::vector<std::vector<NodePair>> newCopyEdges(numOfNodes);
+    std::vector<u32_t> numOfLoads(numOfThreads, 0);
+    std::vector<u32_t> numOfStores(numOfThreads, 0);
+
+    const std::function<void(u32_t)> collectWorker = [&](const u32_t thread)
+    {
+        for (u32_t i = thread; i < numOfNodes; i += numOfThreads)
+        {
+            const ConstraintNode* node = nodes[i];
+            std::vector<NodePair>& edges = newCopyEdges[i];
+            // Same edge/object order as handleLoad and handleStore.
+            for (ConstraintNode::const_iterator it = node->outgoingLoadsBegin(), eit = node->outgoingLoadsEnd();
+                    it != eit; ++it)
+            {
+                for (NodeID ptd : *nodePts[i])
+                {
+                    if (!isLoadCopyCandidate(ptd, *it))
+                        continue;
+                    ++numOfLoads[thread];
+                    edges.push_back(std::make_pair(ptd, (*it)->getDstID()));
+                }
+            }
+            for (ConstraintNode::const_iterator it = node->incomingStoresBegin(), eit = node->incomingStoresEnd();
+                    it != eit; ++it)
+            {
+                for (NodeID ptd : *nodePts[i])
+                {
+                    if (!isStoreCopyCandidate(ptd, *it))
+                        continue;
+                    ++numOfStores[thread];
+                    edges.push_back(std::make_pair((*it)->getSrcID(), ptd));
+                }
+            }
+        }
+    };
+
+    // A single node is all thread 0's.
+    if (numOfNodes > 1)
+        loadStoreRunner->run(collectWorker);
+    else
+        collectWorker(0);
+
+    for (u32_t t = 0; t < numOfThreads; ++t)
+    {
+        numOfProcessedLoad += numOfLoads[t];
+        numOfProcessedStore += numOfStores[t];
     }
+
+    double addStart = stat->getClk();
+    timeOfCollectLoadStore += (addStart - insertStart) / TIMEINTERVAL;
+
+    for (const std::vector<NodePair>& edges : newCopyEdges)
+    {
+        for (const NodePair& edge : edges)
+        {
+            if (addCopyEdge(edge.first, edge.second))
+                reanalyze = true;
+        }
+    }
+
+    double insertEnd = stat->getClk();
+    timeOfAddLoadStoreEdges += (insertEnd - addStart) / TIMEINTERVAL;
+    timeOfProcessLoadStore += (insertEnd - insertStart) / TIMEINTERVAL;
 }
 
 /*!
@@ -71,11 +71,63 @@ void FlowSensitive::initialize()
     svfg = memSSA.buildPTROnlySVFG(ander);
 
     setGraph(svfg);
+    setWorklistOrder(Options::WPAWorklistOrder());
+
+    numOfSolveThreads = getNumOfSolveThreads();
+    if (numOfSolveThreads > 1)
+        propaMutexes.reset(new std::mutex[NumPropaMutexes]);
+    forwardDFInSets();
     //AndersenWaveDiff::releaseAndersenWaveDiff();
 }
+
+/*!
+ * The IN set of an MR node (other than a function entry chi or call site
+ * chi, which get new incoming edges as the call graph is resolved) with a
+ * single incoming edge, carrying all the objects of its memory region, only
+ * ever holds the sets of its predecessor. With SVFGOPT, new edges may reach
+ * any node, so nothing is forwarded.
+ */
+void FlowSensitive::forwardDFInSets()
+{
+    if (Options::OPTSVFG()) return;
+
+    DFPTDataTy *dfPTData = getDFPTDataTy();
+    // forwardedTo[n] is the node n forwards to, if any, to avoid cycles.
+    Map<NodeID, NodeID> forwardedTo;
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it)
+    {
+        const NodeID n = it->first;
+        const MRSVFGNode *mr = SVFUtil::dyn_cast<MRSVFGNode>(it->second);
+        if (mr == nullptr || SVFUtil::isa<FormalINSVFGNode, ActualOUTSVFGNode, InterMSSAPHISVFGNode>(mr)) continue;
+        if (mr->getInEdges().size() != 1) continue;
+
+        const IndirectSVFGEdge *inEdge = SVFUtil::dyn_cast<IndirectSVFGEdge>(*mr->getInEdges().begin());
+        if (inEdge == nullptr || !inEdge->getPointsTo().contains(mr->getPointsTo())) continue;
+
+        bool coversOutEdges = true;
+        for (const SVFGEdge *edge : mr->getOutEdges())
+        {
+            const IndirectSVFGEdge *outEdge = SVFUtil::dyn_cast<IndirectSVFGEdge>(edge);
+            if (outEdge != nullptr && !inEdge->getPointsTo().contains(outEdge->getPointsTo())) coversOutEdges = false;
+        }
+
+        if (!coversOutEdges) continue;
+
+        NodeID src = inEdge->getSrcID();
+        Map<NodeID, NodeID>::const_iterator fwdIt;
+        while (src != n && (fwdIt = forwardedTo.find(src)) != forwardedTo.end()) src = fwdIt->second;
+        if (src == n) continue;
+
+        if (!dfPTData->forwardDFIn(n, inEdge->getSrcID(), SVFUtil::isa<StoreSVFGNode>(inEdge->getSrcNode()))) return;
+        forwardedTo[n] = inEdge->getSrcID();
+        ++numOfForwardedDFIns;
+    }
+}
 void FlowSensitive::solveConstraints()
 {
-    bool limitTimerSet = SVFUtil::startAnalysisLimitTimer(Options::FsTimeLimit());
+    hasBudget = Options::FsTimeLimit() != 0;
+    if (hasBudget)
+        budgetDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(Options::FsTimeLimit());
 
     double start = stat->getClk(true);
     /// Start solving constraints
@@ -88,23 +140,141 @@ void FlowSensitive::solveConstraints()
         if(0 == numOfIteration % OnTheFlyIterBudgetForStat)
             dumpStat();
 
+        // What updateCallGraph pushed is all that is not at a fixed point.
+        if (budgetExpired())
+            break;
+
         callGraphSCC->find();
 
-        initWorklist();
-        solveWorklist();
+        if (numOfSolveThreads > 1)
+        {
+            solveInParallel();
+        }
+        else
+        {
+            initWorklist();
+            solveWorklist();
+        }
+        collectPtsGarbage();
+        profilePtsIfRequested();
     }
-    while (updateCallGraph(getIndirectCallsites()));
+    while (!budgetExpired() && updateCallGraph(getIndirectCallsites()));
 
-    DBOUT(DGENERAL, outs() << SVFUtil::pasMsg("Finish Solving Constraints\n"));
+    if (budgetExpired())
+        fallBackToAnder();
 
-    // Reset the time-up alarm; analysis is done.
-    SVFUtil::stopAnalysisLimitTimer(limitTimerSet);
+    DBOUT(DGENERAL, outs() << SVFUtil::pasMsg("Finish Solving Constraints\n"));
 
     double end = stat->getClk(true);
     solveTime += (end - start) / TIMEINTERVAL;
 
 }
 
+/*!
+ * Solve until the worklist is empty or the time budget expires, leaving the
+ * nodes not at a fixed point in the worklist.
+ */
+void FlowSensitive::solveWorklist()
+{
+    while (!isWorklistEmpty())
+    {
+        if (budgetExpired())
+            return;
+
+        NodeID nodeId = popFromWorklist();
+        processNode(nodeId);
+        collapseFields();
+    }
+}
+
+/*!
+ * Return true once -fs-time-limit seconds have passed since solving started.
+ */
+bool FlowSensitive::budgetExpired()
+{
+    if (!hasBudget) return false;
+    if (budgetHasExpired) return true;
+    if (std::chrono::steady_clock::now() < budgetDeadline) return false;
+
+    budgetHasExpired = true;
+    return true;
+}
+
+/*!
+ * The points-to sets of nodes in the worklist, and of nodes reachable from
+ * them, may still grow; those of every other node are final. The pointers the
+ * former define get their Andersen's points-to sets, which over-approximate
+ * any they could reach. Calls resolved through those sets connect more nodes,
+ * so this repeats until the call graph no longer changes.
+ */
+void FlowSensitive::fallBackToAnder()
+{
+    double start = stat->getClk();
+    writeWrnMsg("-fs-time-limit: time limit reached, falling back to Andersen's for nodes not at a fixed point");
+
+    do
+    {
+        FIFOWorkList<NodeID> worklist;
+        while (!isWorklistEmpty())
+            worklist.push(popFromWorklist());
+
+        while (!worklist.empty())
+        {
+            const NodeID n = worklist.pop();
+            if (!fallbackNodes.test_and_set(n)) continue;
+
+            const SVFGNode *node = svfg->getSVFGNode(n);
+            if (fallBackNodeToAnder(node))
+                ++numOfFallbackPtrs;
+            pushDependentNodes(node, worklist);
+        }
+    }
+    while (updateCallGraph(getIndirectCallsites()));
+
+    double end = stat->getClk();
+    fallbackTime += (end - start) / TIMEINTERVAL;
+}
+
+/*!
+ * Push the successors of node.
+ */
+void FlowSensitive::pushDependentNodes(const SVFGNode* node, FIFOWorkList<NodeID>& worklist)
+{
+    for (const SVFGEdge *edge : node->getOutEdges())
+        worklist.push(edge->getDstID());
+}
+
+/*!
+ * Union the Andersen's points-to set into the top-level pointer node defines,
+ * if any. Sets are copied element by element as the two analyses may map
+ * nodes differently (-cluster-fs).
+ */
+bool FlowSensitive::fallBackNodeToAnder(const SVFGNode* node)
+{
+    NodeID ptr;
+    if (const AddrSVFGNode *addr = SVFUtil::dyn_cast<AddrSVFGNode>(node))
+        ptr = addr->getDstNodeID();
+    else if (SVFUtil::isa<CopySVFGNode, GepSVFGNode, LoadSVFGNode>(node))
+        ptr = SVFUtil::cast<StmtSVFGNode>(node)->getDstNodeID();
+    else if (const PHISVFGNode *phi = SVFUtil::dyn_cast<PHISVFGNode>(node))
+        ptr = phi->getRes()->getId();
+    else if (const FormalParmSVFGNode *fp = SVFUtil::dyn_cast<FormalParmSVFGNode>(node))
+        ptr = fp->getParam()->getId();
+    else if (const ActualRetSVFGNode *ar = SVFUtil::dyn_cast<ActualRetSVFGNode>(node))
+        ptr = ar->getRev()->getId();
+    else
+        return false;
+
+    bool changed = false;
+    for (const NodeID o : ander->getPts(ptr))
+    {
+        if (addPts(ptr, o))
+            changed = true;
+    }
+
+    return changed;
+}
+
 /*!
  * Start analysis
  */
@@ -287,7 +457,7 @@ bool FlowSensitive::processSVFGNode(SVFGNode* node)
     }
 
     double end = stat->getClk();
-    processTime += (end - start) / TIMEINTERVAL;
+    addTime(processTime, start, end);
 
     return changed;
 }
@@ -313,7 +483,7 @@ bool FlowSensitive::propFromSrcToDst(SVFGEdge* edge)
         assert(false && "new kind of svfg edge?");
 
     double end = stat->getClk();
-    propagationTime += (end - start) /TIMEINTERVAL;
+    addTime(propagationTime, start, end);
     return changed;
 }
 
@@ -343,7 +513,7 @@ bool FlowSensitive::propAlongDirectEdge(const DirectSVFGEdge* edge)
     }
 
     double end = stat->getClk();
-    directPropaTime += (end - start) / TIMEINTERVAL;
+    addTime(directPropaTime, start, end);
     return changed;
 }
 
@@ -415,7 +585,7 @@ bool FlowSensitive::propAlongIndirectEdge(const IndirectSVFGEdge* edge)
     }
 
     double end = stat->getClk();
-    indirectPropaTime += (end - start) / TIMEINTERVAL;
+    addTime(indirectPropaTime, start, end);
     return changed;
 }
 
@@ -451,7 +621,7 @@ bool FlowSensitive::processAddr(const AddrSVFGNode* addr)
         srcID = getFIObjVar(srcID);
     bool changed = addPts(addr->getDstNodeID(), srcID);
     double end = stat->getClk();
-    addrTime += (end - start) / TIMEINTERVAL;
+    addTime(addrTime, start, end);
     return changed;
 }
 
@@ -463,7 +633,7 @@ bool FlowSensitive::processCopy(const CopySVFGNode* copy)
     double start = stat->getClk();
     bool changed = unionPts(copy->getDstNodeID(), copy->getSrcNodeID());
     double end = stat->getClk();
-    copyTime += (end - start) / TIMEINTERVAL;
+    addTime(copyTime, start, end);
     return changed;
 }
 
@@ -484,7 +654,7 @@ bool FlowSensitive::processPhi(const PHISVFGNode* phi)
     }
 
     double end = stat->getClk();
-    phiTime += (end - start) / TIMEINTERVAL;
+    addTime(phiTime, start, end);
     return changed;
 }
 
@@ -499,6 +669,9 @@ bool FlowSensitive::processGep(const GepSVFGNode* edge)
 
     PointsTo tmpDstPts;
     const GepStmt* gepStmt = SVFUtil::cast<GepStmt>(edge->getSVFStmt());
+    // When solving in parallel, every object met here has already been
+    // collapsed and every field object created, so this only reads the SVFIR
+    // (see createGepObjVars).
     if (gepStmt->isVariantFieldGep())
     {
         for (NodeID o : srcPts)
@@ -509,7 +682,11 @@ bool FlowSensitive::processGep(const GepSVFGNode* edge)
                 continue;
             }
 
-            setObjFieldInsensitive(o);
+            if (!isFieldInsensitive(o))
+            {
+                assert(numOfSolveThreads <= 1 && "object not collapsed by Andersen's analysis!");
+                setObjFieldInsensitive(o);
+            }
             tmpDstPts.set(getFIObjVar(o));
         }
     }
@@ -532,7 +709,7 @@ bool FlowSensitive::processGep(const GepSVFGNode* edge)
         changed = true;
 
     double end = stat->getClk();
-    gepTime += (end - start) / TIMEINTERVAL;
+    addTime(gepTime, start, end);
     return changed;
 }
 
@@ -580,7 +757,7 @@ bool FlowSensitive::processLoad(const LoadSVFGNode* load)
         }
     }
     double end = stat->getClk();
-    loadTime += (end - start) / TIMEINTERVAL;
+    addTime(loadTime, start, end);
     return changed;
 }
 
@@ -623,27 +800,30 @@ bool FlowSensitive::processStore(const StoreSVFGNode* store)
     }
 
     double end = stat->getClk();
-    storeTime += (end - start) / TIMEINTERVAL;
+    addTime(storeTime, start, end);
 
     double updateStart = stat->getClk();
     // also merge the DFInSet to DFOutSet.
     /// check if this is a strong updates store
     NodeID singleton;
     bool isSU = isStrongUpdate(store, singleton);
+    {
+        std::lock_guard<std::mutex> guard(suMutex);
+        if (isSU) svfgHasSU.set(store->getId());
+        else svfgHasSU.reset(store->getId());
+    }
     if (isSU)
     {
-        svfgHasSU.set(store->getId());
         if (strongUpdateOutFromIn(store, singleton))
             changed = true;
     }
     else
     {
-        svfgHasSU.reset(store->getId());
         if (weakUpdateOutFromIn(store))
             changed = true;
     }
     double updateEnd = stat->getClk();
-    updateTime += (updateEnd - updateStart) / TIMEINTERVAL;
+    addTime(updateTime, updateStart, updateEnd);
 
     return changed;
 }
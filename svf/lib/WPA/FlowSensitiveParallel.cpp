@@ -0,0 +1,419 @@
+//===- FlowSensitiveParallel.cpp -- Parallel flow-sensitive solving ---------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * FlowSensitiveParallel.cpp
+ *
+ * Solve the SVFG on several threads. The SCCs of the SVFG are grouped into
+ * levels of the SCC DAG (longest distance from a root), and SCCs in the same
+ * level, which share no edges, are solved concurrently.
+ *
+ * A thread solving an SCC owns the IN/OUT sets of its nodes and the top-level
+ * pointers they define. Propagation into a node of a later level is the only
+ * write to state another thread may write too, and is made holding a lock
+ * picked by the destination node. So that threads never insert into maps
+ * other threads read, every set they may look up is created beforehand.
+ *
+ * When the time budget expires, SCCs not yet solved to a fixed point are left
+ * in the worklist for fallBackToAnder.
+ */
+
+#include "WPA/FlowSensitive.h"
+#include "WPA/Andersen.h"
+#include "Util/Options.h"
+#include "Util/PTAStat.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace SVF;
+using namespace SVFUtil;
+
+namespace
+{
+
+/// Levels with fewer nodes are solved by the calling thread alone.
+const u32_t MinParallelLevelNodes = 64;
+
+/// SCCs handed to one thread. The owner takes them from the front, other
+/// threads steal from the back.
+struct SCCQueue
+{
+    std::mutex mutex;
+    std::deque<NodeID> reps;
+};
+
+/// Takes the next SCC for thread t, stealing from another thread's queue if
+/// t's is empty. Returns false when all queues are empty.
+bool takeSCC(std::vector<SCCQueue> &queues, u32_t t, NodeID &rep, u32_t &steals)
+{
+    {
+        SCCQueue &own = queues[t];
+        std::lock_guard<std::mutex> guard(own.mutex);
+        if (!own.reps.empty())
+        {
+            rep = own.reps.front();
+            own.reps.pop_front();
+            return true;
+        }
+    }
+
+    for (u32_t i = 1; i < queues.size(); ++i)
+    {
+        SCCQueue &victim = queues[(t + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.mutex);
+        if (!victim.reps.empty())
+        {
+            rep = victim.reps.back();
+            victim.reps.pop_back();
+            ++steals;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}  // End anonymous namespace
+
+/*!
+ * Return the number of threads to solve with: -fs-threads when the analysis
+ * is plain sparse flow-sensitive analysis (subclasses change how nodes are
+ * processed) and its points-to data is mutable, 1 otherwise.
+ */
+u32_t FlowSensitive::getNumOfSolveThreads() const
+{
+    if (Options::FsThreads() <= 1) return 1;
+
+    const PTDataTy::PTDataTy ptdTy = getPTDataTy()->getPTDTY();
+    if (getAnalysisTy() != PTATY::FSSPARSE_WPA
+            || (ptdTy != PTDataTy::MutDataFlow && ptdTy != PTDataTy::MutIncDataFlow))
+    {
+        writeWrnMsg("-fs-threads: only supported by sparse flow-sensitive analysis with mutable points-to data, solving sequentially");
+        return 1;
+    }
+
+    return Options::FsThreads();
+}
+
+/*!
+ * Solve all SVFG nodes, the SCCs of each level of the SCC DAG in parallel.
+ */
+void FlowSensitive::solveInParallel()
+{
+    // Every node is solved below, so what updateConnectedNodes pushed is moot.
+    while (!isWorklistEmpty())
+        popFromWorklist();
+
+    double sccStart = stat->getClk();
+    SCC *sccDetector = getSCCDetector();
+    sccDetector->find();
+    double sccEnd = stat->getClk();
+    sccTime += (sccEnd - sccStart) / TIMEINTERVAL;
+
+    // The level of an SCC is the longest path to it from a root of the DAG,
+    // so that all edges between SCCs go to a later level.
+    std::vector<std::vector<NodeID>> levels;
+    Map<NodeID, u32_t> repLevels;
+    NodeStack topoOrder = sccDetector->topoNodeStack();
+    while (!topoOrder.empty())
+    {
+        const NodeID rep = topoOrder.top();
+        topoOrder.pop();
+
+        const u32_t level = repLevels[rep];
+        if (levels.size() <= level) levels.resize(level + 1);
+        levels[level].push_back(rep);
+
+        for (const NodeID n : sccDetector->subNodes(rep))
+        {
+            for (const SVFGEdge *edge : svfg->getSVFGNode(n)->getOutEdges())
+            {
+                const NodeID dstRep = sccDetector->repNode(edge->getDstID());
+                if (dstRep == rep) continue;
+                u32_t &dstLevel = repLevels[dstRep];
+                dstLevel = std::max(dstLevel, level + 1);
+            }
+        }
+    }
+
+    numOfSCCLevels = std::max<u32_t>(numOfSCCLevels, levels.size());
+    prepareParallelSolve();
+    // Threads read the SVFIR unlocked, so solving must not add to it.
+    const u32_t numOfPAGNodes = pag->getTotalNodeNum();
+
+    const u32_t numOfThreads = numOfSolveThreads;
+    std::vector<SCCQueue> queues(numOfThreads);
+    std::vector<u32_t> steals(numOfThreads, 0);
+
+    // SCCs not solved to a fixed point before the time budget expired.
+    std::mutex unsolvedMutex;
+    std::vector<NodeID> unsolved;
+    auto solveOrDefer = [&](const NodeID rep, FIFOWorkList<NodeID> &worklist)
+    {
+        if (solveSCC(rep, worklist)) return;
+        std::lock_guard<std::mutex> guard(unsolvedMutex);
+        unsolved.push_back(rep);
+    };
+
+    // Threads 1.. wait for a level, solve SCCs until all queues are empty,
+    // and report back. Thread 0 is the calling thread.
+    std::mutex levelMutex;
+    std::condition_variable levelStarted;
+    std::condition_variable levelFinished;
+    u32_t generation = 0;
+    u32_t busyThreads = 0;
+    bool done = false;
+
+    auto worker = [&](const u32_t t)
+    {
+        FIFOWorkList<NodeID> worklist;
+        u32_t solvedGeneration = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(levelMutex);
+                levelStarted.wait(lock, [&]()
+                {
+                    return done || generation != solvedGeneration;
+                });
+                if (done) return;
+                solvedGeneration = generation;
+            }
+
+            NodeID rep;
+            while (takeSCC(queues, t, rep, steals[t])) solveOrDefer(rep, worklist);
+
+            std::lock_guard<std::mutex> lock(levelMutex);
+            if (--busyThreads == 0) levelFinished.notify_one();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (u32_t t = 1; t < numOfThreads; ++t) threads.push_back(std::thread(worker, t));
+
+    FIFOWorkList<NodeID> worklist;
+    for (std::vector<NodeID> &level : levels)
+    {
+        u32_t levelNodes = 0;
+        for (const NodeID rep : level) levelNodes += sccDetector->subNodes(rep).count();
+        maxSCCLevelWidth = std::max<u32_t>(maxSCCLevelWidth, level.size());
+
+        if (level.size() < 2 || levelNodes < MinParallelLevelNodes)
+        {
+            for (const NodeID rep : level) solveOrDefer(rep, worklist);
+            continue;
+        }
+
+        ++numOfParallelSCCLevels;
+
+        // Largest first, dealt round-robin, so stealing only evens out the tail.
+        std::stable_sort(level.begin(), level.end(), [sccDetector](NodeID a, NodeID b)
+        {
+            return sccDetector->subNodes(a).count() > sccDetector->subNodes(b).count();
+        });
+        for (u32_t i = 0; i < level.size(); ++i) queues[i % numOfThreads].reps.push_back(level[i]);
+
+        {
+            std::lock_guard<std::mutex> lock(levelMutex);
+            busyThreads = numOfThreads - 1;
+            ++generation;
+        }
+        levelStarted.notify_all();
+
+        NodeID rep;
+        while (takeSCC(queues, 0, rep, steals[0])) solveOrDefer(rep, worklist);
+
+        std::unique_lock<std::mutex> lock(levelMutex);
+        levelFinished.wait(lock, [&]()
+        {
+            return busyThreads == 0;
+        });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(levelMutex);
+        done = true;
+    }
+    levelStarted.notify_all();
+    for (std::thread &thread : threads) thread.join();
+    stopParallelSolveIfPAGGrew(numOfPAGNodes);
+
+    for (const u32_t s : steals) numOfStolenSCCs += s;
+
+    for (const NodeID rep : unsolved)
+    {
+        for (const NodeID n : sccDetector->subNodes(rep)) pushIntoWorklist(n);
+    }
+}
+
+/*!
+ * Solve the SCC of rep to a fixed point. Unlike processNode, nodes outside
+ * the SCC are not pushed into the worklist: they are in later levels, all of
+ * whose nodes are solved anyway. Returns false, with worklist emptied, if the
+ * time budget expires first.
+ */
+bool FlowSensitive::solveSCC(NodeID rep, FIFOWorkList<NodeID> &worklist)
+{
+    const SCC *sccDetector = getSCCDetector();
+    for (const NodeID n : sccDetector->subNodes(rep)) worklist.push(n);
+
+    while (!worklist.empty())
+    {
+        if (budgetExpired())
+        {
+            worklist.clear();
+            return false;
+        }
+
+        SVFGNode *node = svfg->getSVFGNode(worklist.pop());
+        if (processSVFGNode(node))
+        {
+            for (SVFGEdge *edge : node->getOutEdges())
+            {
+                const NodeID dst = edge->getDstID();
+                if (sccDetector->repNode(dst) == rep)
+                {
+                    if (propFromSrcToDst(edge)) worklist.push(dst);
+                }
+                else
+                {
+                    // Other SCCs of this level may propagate into dst too.
+                    std::lock_guard<std::mutex> guard(propaMutexes[dst % NumPropaMutexes]);
+                    propFromSrcToDst(edge);
+                }
+            }
+        }
+
+        clearAllDFOutVarFlag(node);
+    }
+
+    return true;
+}
+
+/*!
+ * Threads read the SVFIR unlocked, which createGepObjVars makes safe. Should
+ * the SVFIR have grown all the same (numOfPAGNodes being its size before
+ * solving), stop solving in parallel.
+ */
+void FlowSensitive::stopParallelSolveIfPAGGrew(u32_t numOfPAGNodes)
+{
+    if (pag->getTotalNodeNum() == numOfPAGNodes) return;
+    writeWrnMsg("field objects were created while solving in parallel, solving sequentially from now on");
+    numOfSolveThreads = 1;
+}
+
+/*!
+ * Create the points-to sets solving may look up, as the sequential solver
+ * would on the way: the IN sets of nodes on indirect edges and of loads, the
+ * OUT sets of stores, and the top-level pointers nodes use or define.
+ */
+void FlowSensitive::prepareParallelSolve()
+{
+    createGepObjVars();
+
+    DFPTDataTy *dfPTData = getDFPTDataTy();
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it)
+    {
+        const SVFGNode *node = it->second;
+
+        const bool hasOut = SVFUtil::isa<StoreSVFGNode>(node);
+        bool hasIn = SVFUtil::isa<LoadSVFGNode>(node);
+        for (const SVFGEdge *edge : node->getInEdges())
+            hasIn |= SVFUtil::isa<IndirectSVFGEdge>(edge);
+        if (!hasOut)
+        {
+            // Propagation from a non-store reads its IN set.
+            for (const SVFGEdge *edge : node->getOutEdges())
+                hasIn |= SVFUtil::isa<IndirectSVFGEdge>(edge);
+        }
+
+        dfPTData->initDFSets(node->getId(), hasIn, hasOut);
+        initTopLevelPts(node);
+    }
+}
+
+/*!
+ * Create every field object and collapse every object processGep could, from
+ * Andersen's points-to sets which over-approximate ours, so that solving in
+ * parallel only reads the SVFIR. Andersen's analysis has normally done it all
+ * already, making this a lookup.
+ */
+void FlowSensitive::createGepObjVars()
+{
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it)
+    {
+        const GepSVFGNode *gep = SVFUtil::dyn_cast<GepSVFGNode>(it->second);
+        if (gep == nullptr) continue;
+
+        const GepStmt* gepStmt = SVFUtil::cast<GepStmt>(gep->getSVFStmt());
+        for (NodeID o : ander->getPts(gep->getSrcNodeID()))
+        {
+            if (isBlkObjOrConstantObj(o) || isFieldInsensitive(o)) continue;
+            if (gepStmt->isVariantFieldGep())
+                setObjFieldInsensitive(o);
+            else
+                getGepObjVar(o, gepStmt->getAccessPath().getConstantStructFldIdx());
+        }
+    }
+}
+
+/*!
+ * Create the points-to sets of the top-level pointers node uses or defines.
+ */
+void FlowSensitive::initTopLevelPts(const SVFGNode* node)
+{
+    if (const AddrSVFGNode *addr = SVFUtil::dyn_cast<AddrSVFGNode>(node))
+    {
+        getPts(addr->getDstNodeID());
+    }
+    else if (const StmtSVFGNode *stmt = SVFUtil::dyn_cast<StmtSVFGNode>(node))
+    {
+        getPts(stmt->getSrcNodeID());
+        getPts(stmt->getDstNodeID());
+    }
+    else if (const PHISVFGNode *phi = SVFUtil::dyn_cast<PHISVFGNode>(node))
+    {
+        getPts(phi->getRes()->getId());
+        for (PHISVFGNode::OPVers::const_iterator opIt = phi->opVerBegin(), opEit = phi->opVerEnd(); opIt != opEit; ++opIt)
+            getPts(opIt->second->getId());
+    }
+    else if (const ActualParmSVFGNode *ap = SVFUtil::dyn_cast<ActualParmSVFGNode>(node))
+    {
+        getPts(ap->getParam()->getId());
+    }
+    else if (const FormalParmSVFGNode *fp = SVFUtil::dyn_cast<FormalParmSVFGNode>(node))
+    {
+        getPts(fp->getParam()->getId());
+    }
+    else if (const ActualRetSVFGNode *ar = SVFUtil::dyn_cast<ActualRetSVFGNode>(node))
+    {
+        getPts(ar->getRev()->getId());
+    }
+    else if (const FormalRetSVFGNode *fr = SVFUtil::dyn_cast<FormalRetSVFGNode>(node))
+    {
+        getPts(fr->getRet()->getId());
+    }
+}
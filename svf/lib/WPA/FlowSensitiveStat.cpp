@@ -31,6 +31,8 @@
 #include "WPA/WPAStat.h"
 #include "WPA/FlowSensitive.h"
 #include "MemoryModel/PointsTo.h"
+#include "MemoryModel/PointsToProfiler.h"
+#include "Util/Options.h"
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -264,6 +266,39 @@ void FlowSensitiveStat::performStat()
     timeStatMap["AverageSCCSize"] = (fspta->numOfSCC == 0) ? 0 :
                                     ((double)fspta->numOfNodesInSCC / fspta->numOfSCC);
 
+    if (fspta->budgetHasExpired)
+    {
+        PTNumStatMap["FallbackNodes"] = fspta->fallbackNodes.count();
+        PTNumStatMap["FallbackPtrs"] = fspta->numOfFallbackPtrs;
+        timeStatMap["FallbackTime"] = fspta->fallbackTime;
+    }
+
+    if (fspta->numOfForwardedDFIns > 0)
+        PTNumStatMap["ForwardedDFIns"] = fspta->numOfForwardedDFIns;
+
+    // IN/OUT memory as stored, and as the mutable data-flow data would store it.
+    u64_t storedDFBytes = 0, mutableDFBytes = 0;
+    auto ptsBytes = [](const PointsTo &pts)
+    {
+        u64_t bytes[PointsToProfiler::NumTypes];
+        PointsToProfiler::estimateBytes(pts, bytes);
+        return bytes[Options::PtType()];
+    };
+    if (fspta->getDFPTDataTy()->estimateDFBytes(ptsBytes, storedDFBytes, mutableDFBytes))
+    {
+        PTNumStatMap["DFSetsKB"] = storedDFBytes / 1024;
+        PTNumStatMap["MutableDFSetsKB"] = mutableDFBytes / 1024;
+    }
+
+    if (fspta->numOfSolveThreads > 1)
+    {
+        PTNumStatMap["FsThreads"] = fspta->numOfSolveThreads;
+        PTNumStatMap["SCCLevels"] = fspta->numOfSCCLevels;
+        PTNumStatMap["MaxSCCLevelWidth"] = fspta->maxSCCLevelWidth;
+        PTNumStatMap["ParallelSCCLevels"] = fspta->numOfParallelSCCLevels;
+        PTNumStatMap["StolenSCCs"] = fspta->numOfStolenSCCs;
+    }
+
     PTAStat::printStat("Flow-Sensitive Pointer Analysis Statistics");
 }
 
@@ -34,7 +34,11 @@ VersionedFlowSensitive::VersionedFlowSensitive(SVFIR *_pag, PTATY type)
     : FlowSensitive(_pag, type)
 {
     numPrelabeledNodes = numPrelabelVersions = 0;
-    prelabelingTime = meldLabelingTime = versionPropTime = 0.0;
+    prelabelingTime = meldLabelingTime = versionPropTime = versioningPlanTime = 0.0;
+    versioningPlanReused = false;
+    numOfSolveRounds = 0;
+    numOfBufferedUpdates = numOfRedundantUpdates = numOfUniqueUpdateSets = 0;
+    parallelSolveTime = threadBusyTime = threadIdleTime = 0.0;
     // We'll grab vPtD in initialize.
 
     for (SVFIR::const_iterator it = pag->begin(); it != pag->end(); ++it)
@@ -59,8 +63,31 @@ void VersionedFlowSensitive::initialize()
     consume.resize(svfg->getTotalNodeNum());
     yield.resize(svfg->getTotalNodeNum());
 
-    prelabel();
-    meldLabel();
+    const std::string &planFile = Options::VersioningPlan();
+    if (planFile.empty())
+    {
+        prelabel();
+        meldLabel();
+    }
+    else
+    {
+        double start = stat->getClk(true);
+        const u64_t fingerprint = getVersioningFingerprint();
+        versioningPlanReused = readVersioningPlan(planFile, fingerprint);
+        double end = stat->getClk(true);
+        versioningPlanTime = (end - start) / TIMEINTERVAL;
+
+        if (!versioningPlanReused)
+        {
+            prelabel();
+            meldLabel();
+
+            start = stat->getClk(true);
+            writeVersioningPlan(planFile, fingerprint);
+            end = stat->getClk(true);
+            versioningPlanTime += (end - start) / TIMEINTERVAL;
+        }
+    }
 
     removeAllIndirectSVFGEdges();
 }
@@ -570,17 +597,7 @@ void VersionedFlowSensitive::propagateVersion(const NodeID o, const Version v, c
     {
         // o:vp has changed.
         // Add the dummy propagation node to tell the solver to propagate it later.
-        const DummyVersionPropSVFGNode *dvp = nullptr;
-        VarToPropNodeMap::const_iterator dvpIt = versionedVarToPropNode.find(dstVar);
-        if (dvpIt == versionedVarToPropNode.end())
-        {
-            dvp = svfg->addDummyVersionPropSVFGNode(o, vp);
-            versionedVarToPropNode[dstVar] = dvp;
-        }
-        else dvp = dvpIt->second;
-
-        assert(dvp != nullptr && "VFS::propagateVersion: propagation dummy node not found?");
-        pushIntoWorklist(dvp->getId());
+        pushVersionIntoWorklist(o, vp);
 
         // Notify nodes which rely on o:vp that it changed.
         for (NodeID s : getStmtReliance(o, vp)) pushIntoWorklist(s);
@@ -590,6 +607,57 @@ void VersionedFlowSensitive::propagateVersion(const NodeID o, const Version v, c
     if (time) versionPropTime += (end - start) / TIMEINTERVAL;
 }
 
+void VersionedFlowSensitive::pushVersionIntoWorklist(const NodeID o, const Version v)
+{
+    const VersionedVar ov = atKey(o, v);
+    const DummyVersionPropSVFGNode *dvp = nullptr;
+    VarToPropNodeMap::const_iterator dvpIt = versionedVarToPropNode.find(ov);
+    if (dvpIt == versionedVarToPropNode.end())
+    {
+        dvp = svfg->addDummyVersionPropSVFGNode(o, v);
+        versionedVarToPropNode[ov] = dvp;
+    }
+    else dvp = dvpIt->second;
+
+    assert(dvp != nullptr && "VFS::pushVersionIntoWorklist: propagation dummy node not found?");
+    pushIntoWorklist(dvp->getId());
+}
+
+void VersionedFlowSensitive::pushDependentNodes(const SVFGNode* node, FIFOWorkList<NodeID>& worklist)
+{
+    FlowSensitive::pushDependentNodes(node, worklist);
+
+    // Versions whose sets may still grow, and whose reliant versions have not
+    // been visited yet.
+    FIFOWorkList<VersionedVar> versions;
+    if (const DummyVersionPropSVFGNode *dvp = SVFUtil::dyn_cast<DummyVersionPropSVFGNode>(node))
+    {
+        versions.push(atKey(dvp->getObject(), dvp->getVersion()));
+    }
+    else if (isStore(node->getId()))
+    {
+        for (const ObjToVersionMap::value_type &oy : yield[node->getId()])
+            versions.push(atKey(oy.first, oy.second));
+    }
+
+    Set<VersionedVar> visited;
+    while (!versions.empty())
+    {
+        const VersionedVar ov = versions.pop();
+        if (!visited.insert(ov).second) continue;
+
+        if (const NodeBS *stmts = findStmtReliance(ov.first, ov.second))
+        {
+            for (const NodeID s : *stmts) worklist.push(s);
+        }
+
+        if (const std::vector<Version> *reliantVersions = findReliantVersions(ov.first, ov.second))
+        {
+            for (const Version r : *reliantVersions) versions.push(atKey(ov.first, r));
+        }
+    }
+}
+
 void VersionedFlowSensitive::processNode(NodeID n)
 {
     SVFGNode* sn = svfg->getSVFGNode(n);
@@ -667,7 +735,7 @@ bool VersionedFlowSensitive::processLoad(const LoadSVFGNode* load)
             if (pag->isConstantObj(o)) continue;
 
             const Version c = getConsume(l, o);
-            if (c != invalidVersion && vPtD->unionPts(p, atKey(o, c)))
+            if (c != invalidVersion && unionPtsFromVersion(p, atKey(o, c)))
             {
                 changed = true;
             }
@@ -680,7 +748,7 @@ bool VersionedFlowSensitive::processLoad(const LoadSVFGNode* load)
                 for (NodeID of : fields)
                 {
                     const Version c = getConsume(l, of);
-                    if (c != invalidVersion && vPtD->unionPts(p, atKey(of, c)))
+                    if (c != invalidVersion && unionPtsFromVersion(p, atKey(of, c)))
                     {
                         changed = true;
                     }
@@ -689,7 +757,7 @@ bool VersionedFlowSensitive::processLoad(const LoadSVFGNode* load)
         }
     }
     double end = stat->getClk();
-    loadTime += (end - start) / TIMEINTERVAL;
+    addTime(loadTime, start, end);
     return changed;
 }
 
@@ -721,7 +789,7 @@ bool VersionedFlowSensitive::processStore(const StoreSVFGNode* store)
                 if (pag->isConstantObj(o)) continue;
 
                 const Version y = getYield(l, o);
-                if (y != invalidVersion && vPtD->unionPts(atKey(o, y), q))
+                if (y != invalidVersion && unionVersionedPts(atKey(o, y), q))
                 {
                     changed = true;
                     changedObjects.set(o);
@@ -731,14 +799,17 @@ bool VersionedFlowSensitive::processStore(const StoreSVFGNode* store)
     }
 
     double end = stat->getClk();
-    storeTime += (end - start) / TIMEINTERVAL;
+    addTime(storeTime, start, end);
 
     double updateStart = stat->getClk();
 
     NodeID singleton = 0;
     bool isSU = isStrongUpdate(store, singleton);
-    if (isSU) svfgHasSU.set(l);
-    else svfgHasSU.reset(l);
+    {
+        std::lock_guard<std::mutex> guard(suMutex);
+        if (isSU) svfgHasSU.set(l);
+        else svfgHasSU.reset(l);
+    }
 
     // For all objects, perform pts(o:y) = pts(o:y) U pts(o:c) at loc,
     // except when a strong update is taking place.
@@ -751,7 +822,7 @@ bool VersionedFlowSensitive::processStore(const StoreSVFGNode* store)
         if (isSU && o == singleton) continue;
 
         const Version y = getYield(l, o);
-        if (y != invalidVersion && vPtD->unionPts(atKey(o, y), atKey(o, c)))
+        if (y != invalidVersion && unionVersionedPts(atKey(o, y), atKey(o, c)))
         {
             changed = true;
             changedObjects.set(o);
@@ -759,7 +830,7 @@ bool VersionedFlowSensitive::processStore(const StoreSVFGNode* store)
     }
 
     double updateEnd = stat->getClk();
-    updateTime += (updateEnd - updateStart) / TIMEINTERVAL;
+    addTime(updateTime, updateStart, updateEnd);
 
     // Changed objects need to be propagated. Time here should be inconsequential
     // *except* for time taken for propagateVersion, which will time itself.
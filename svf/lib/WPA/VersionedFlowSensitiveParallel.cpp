@@ -0,0 +1,510 @@
+//===- VersionedFlowSensitiveParallel.cpp -- Parallel VFS solving ------------//
+
+/*
+ * VersionedFlowSensitiveParallel.cpp
+ *
+ * Solve versioned flow-sensitive analysis on several threads, in rounds. A
+ * round first processes its nodes and object versions concurrently: threads
+ * read points-to sets but only buffer updates to them. Then the buffered
+ * updates are applied, the points-to sets partitioned over the threads by
+ * pointer or object, all versions of an object being updated by one thread.
+ * What the updates that change a set would push into the worklist of the
+ * sequential solver makes up the next round.
+ *
+ * Objects are not solved separately, even those whose versions share no
+ * statement: loads and stores tie them together through top-level pointers.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "WPA/Andersen.h"
+#include "WPA/VersionedFlowSensitive.h"
+#include "Util/Options.h"
+#include "Util/PTAStat.h"
+#include "Util/PhaseRunner.h"
+#include "MemoryModel/ConcurrentPointsToCache.h"
+
+using namespace SVF;
+using namespace SVFUtil;
+
+namespace
+{
+
+/// Rounds with fewer nodes and versions are solved by the calling thread alone.
+const size_t MinParallelRoundSize = 64;
+/// Number of nodes or versions a thread takes at a time.
+const size_t ChunkSize = 16;
+
+typedef std::chrono::steady_clock Clock;
+
+/// Points-to sets of the updates of a round, hash-consed by all threads: many
+/// updates carry the same set, e.g., a version propagated to all versions
+/// relying on it.
+typedef ConcurrentPointsToCache<PointsTo> UpdateCache;
+
+/// An update to the points-to set of a top-level pointer (version is
+/// invalidVersion) or of an object version, applied at the end of a round.
+struct PendingUpdate
+{
+    NodeID var;
+    Version version;
+    /// Node to push, or whose successors to push, if a top-level pointer changes.
+    NodeID notify;
+    bool notifySuccessors;
+    PointsToID pts;  ///< In the UpdateCache of the round.
+};
+
+/// Takes the next chunk [begin, end) of n items. Returns false when none are left.
+bool takeChunk(std::atomic<size_t> &next, const size_t n, size_t &begin, size_t &end)
+{
+    begin = next.fetch_add(ChunkSize);
+    if (begin >= n) return false;
+    end = std::min(n, begin + ChunkSize);
+    return true;
+}
+
+double secondsSince(const Clock::time_point &start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // End anonymous namespace
+
+/// What a thread computes in a round of parallel solving.
+struct VersionedFlowSensitive::SolveThread
+{
+    /// Buffered updates, by the thread applying them.
+    std::vector<std::vector<PendingUpdate>> updates;
+    /// Sets of the updates of this round, shared by all threads.
+    UpdateCache *updateCache = nullptr;
+    /// Nodes and object versions of the next round.
+    std::vector<NodeID> nextNodes;
+    std::vector<VersionedVar> nextVersions;
+    /// Node being processed.
+    NodeID node = 0;
+    u64_t numOfUpdates = 0;
+    u64_t numOfRedundantUpdates = 0;
+    double busyTime = 0;
+};
+
+thread_local VersionedFlowSensitive::SolveThread *VersionedFlowSensitive::solveThread = nullptr;
+
+/*!
+ * Return -fs-threads when the points-to data is mutable, 1 otherwise.
+ */
+u32_t VersionedFlowSensitive::getNumOfSolveThreads() const
+{
+    if (Options::FsThreads() <= 1) return 1;
+
+    if (getPTDataTy()->getPTDTY() != PTDataTy::MutVersioned)
+    {
+        writeWrnMsg("-fs-threads: only supported by versioned flow-sensitive analysis with mutable points-to data, solving sequentially");
+        return 1;
+    }
+
+    return Options::FsThreads();
+}
+
+/*!
+ * Solve all SVFG nodes, and what updateConnectedNodes left in the worklist,
+ * in rounds until no points-to set changes.
+ */
+void VersionedFlowSensitive::solveInParallel()
+{
+    const Clock::time_point solveStart = Clock::now();
+
+    std::vector<bool> inRound(svfg->getTotalNodeNum(), false);
+    std::vector<NodeID> roundNodes;
+    std::vector<VersionedVar> roundVersions;
+    NodeStack &nodeStack = SCCDetect();
+    while (!nodeStack.empty())
+    {
+        roundNodes.push_back(nodeStack.top());
+        inRound[nodeStack.top()] = true;
+        nodeStack.pop();
+    }
+
+    while (!isWorklistEmpty())
+    {
+        const NodeID n = popFromWorklist();
+        if (!inRound[n]) roundNodes.push_back(n);
+        inRound[n] = true;
+    }
+
+    for (const NodeID n : roundNodes) inRound[n] = false;
+
+    prepareParallelSolve();
+    // Threads read the SVFIR unlocked, so solving must not add to it.
+    const u32_t numOfPAGNodes = pag->getTotalNodeNum();
+
+    const u32_t numOfThreads = numOfSolveThreads;
+    std::vector<SolveThread> threads(numOfThreads);
+    UpdateCache updateCache;
+    for (SolveThread &st : threads)
+    {
+        st.updates.resize(numOfThreads);
+        st.updateCache = &updateCache;
+    }
+    PhaseRunner runner(numOfThreads);
+
+    u32_t roundThreads = numOfThreads;
+    std::atomic<size_t> nextNode(0);
+    std::atomic<size_t> nextVersion(0);
+    const std::function<void(u32_t)> compute = [&](const u32_t t)
+    {
+        const Clock::time_point start = Clock::now();
+        SolveThread &st = threads[t];
+        solveThread = &st;
+
+        size_t begin, end;
+        while (takeChunk(nextNode, roundNodes.size(), begin, end))
+        {
+            for (size_t i = begin; i < end; ++i) computeNode(st, roundNodes[i]);
+        }
+
+        while (takeChunk(nextVersion, roundVersions.size(), begin, end))
+        {
+            for (size_t i = begin; i < end; ++i) computeVersion(st, roundVersions[i]);
+        }
+
+        solveThread = nullptr;
+        st.busyTime += secondsSince(start);
+    };
+
+    const std::function<void(u32_t)> apply = [&](const u32_t t)
+    {
+        const Clock::time_point start = Clock::now();
+        // A thread alone applies the updates of all partitions.
+        for (u32_t owner = t; owner < numOfThreads; owner += roundThreads)
+        {
+            applyUpdates(threads, owner, threads[t]);
+        }
+
+        threads[t].busyTime += secondsSince(start);
+    };
+
+    while (!roundNodes.empty() || !roundVersions.empty())
+    {
+        if (budgetExpired())
+        {
+            // Leave the round for fallBackToAnder.
+            for (const NodeID n : roundNodes) pushIntoWorklist(n);
+            for (const VersionedVar &ov : roundVersions) pushVersionIntoWorklist(ov.first, ov.second);
+            break;
+        }
+
+        ++numOfSolveRounds;
+        roundThreads = roundNodes.size() + roundVersions.size() < MinParallelRoundSize ? 1 : numOfThreads;
+        nextNode = 0;
+        nextVersion = 0;
+
+        const Clock::time_point roundStart = Clock::now();
+        if (roundThreads == 1)
+        {
+            compute(0);
+            apply(0);
+        }
+        else
+        {
+            runner.run(compute);
+            runner.run(apply);
+        }
+
+        // All updates of the round are applied, so their sets can go.
+        numOfUniqueUpdateSets += updateCache.getNumOfPts() - 1;
+        updateCache.reset();
+
+        const double roundTime = secondsSince(roundStart);
+        double roundBusyTime = 0;
+        for (SolveThread &st : threads)
+        {
+            roundBusyTime += st.busyTime;
+            st.busyTime = 0;
+        }
+
+        threadBusyTime += roundBusyTime;
+        if (roundThreads > 1) threadIdleTime += roundThreads * roundTime - roundBusyTime;
+
+        // The next round gets each node once, and in the order nodes were pushed.
+        roundNodes.clear();
+        roundVersions.clear();
+        for (SolveThread &st : threads)
+        {
+            for (const NodeID n : st.nextNodes)
+            {
+                if (inRound[n]) continue;
+                inRound[n] = true;
+                roundNodes.push_back(n);
+            }
+
+            roundVersions.insert(roundVersions.end(), st.nextVersions.begin(), st.nextVersions.end());
+            st.nextNodes.clear();
+            st.nextVersions.clear();
+        }
+
+        for (const NodeID n : roundNodes) inRound[n] = false;
+        std::sort(roundVersions.begin(), roundVersions.end());
+        roundVersions.erase(std::unique(roundVersions.begin(), roundVersions.end()), roundVersions.end());
+    }
+    stopParallelSolveIfPAGGrew(numOfPAGNodes);
+
+    for (const SolveThread &st : threads)
+    {
+        numOfBufferedUpdates += st.numOfUpdates;
+        numOfRedundantUpdates += st.numOfRedundantUpdates;
+    }
+
+    parallelSolveTime += secondsSince(solveStart);
+}
+
+/*!
+ * Process n as processNode would, but with all updates buffered.
+ */
+void VersionedFlowSensitive::computeNode(SolveThread &st, NodeID n)
+{
+    SVFGNode *sn = svfg->getSVFGNode(n);
+    if (const DummyVersionPropSVFGNode *dvp = SVFUtil::dyn_cast<DummyVersionPropSVFGNode>(sn))
+    {
+        computeVersion(st, atKey(dvp->getObject(), dvp->getVersion()));
+        return;
+    }
+
+    // Updates to top-level pointers made by processSVFGNode notify n's successors.
+    st.node = n;
+    if (!processSVFGNode(sn)) return;
+
+    // Nodes which always change: as propagate, but pointers passed into
+    // callees and back are updated like any other.
+    for (const SVFGEdge *edge : sn->getOutEdges())
+    {
+        if (!SVFUtil::isa<DirectSVFGEdge>(edge)) continue;
+
+        const NodeID dst = edge->getDstID();
+        if (const ActualParmSVFGNode *ap = SVFUtil::dyn_cast<ActualParmSVFGNode>(sn))
+        {
+            const FormalParmSVFGNode *fp = SVFUtil::cast<FormalParmSVFGNode>(edge->getDstNode());
+            bufferUpdate(st, fp->getParam()->getId(), invalidVersion, getPts(ap->getParam()->getId()), dst, false);
+        }
+        else if (const FormalRetSVFGNode *fr = SVFUtil::dyn_cast<FormalRetSVFGNode>(sn))
+        {
+            const ActualRetSVFGNode *ar = SVFUtil::cast<ActualRetSVFGNode>(edge->getDstNode());
+            bufferUpdate(st, ar->getRev()->getId(), invalidVersion, getPts(fr->getRet()->getId()), dst, false);
+        }
+        else
+        {
+            st.nextNodes.push_back(dst);
+        }
+    }
+}
+
+/*!
+ * Propagate o:v to the versions relying on it, as propagateVersion would.
+ */
+void VersionedFlowSensitive::computeVersion(SolveThread &st, const VersionedVar &ov)
+{
+    double start = stat->getClk();
+
+    const std::vector<Version> *reliantVersions = findReliantVersions(ov.first, ov.second);
+    if (reliantVersions != nullptr)
+    {
+        const PointsTo &pts = vPtD->getPts(ov);
+        for (const Version r : *reliantVersions) bufferUpdate(st, ov.first, r, pts, 0, false);
+    }
+
+    double end = stat->getClk();
+    addTime(versionPropTime, start, end);
+}
+
+/*!
+ * Buffer the union of pts into var, or var:version, unless it would not
+ * change it. Returns false, the change not being made yet.
+ */
+bool VersionedFlowSensitive::bufferUpdate(SolveThread &st, NodeID var, Version version, const PointsTo &pts,
+        NodeID notify, bool notifySuccessors)
+{
+    const PointsTo &current = version == invalidVersion ? getPts(var) : vPtD->getPts(atKey(var, version));
+    if (current.contains(pts)) return false;
+
+    const PointsToID ptsId = st.updateCache->emplacePts(pts);
+    st.updates[var % st.updates.size()].push_back(PendingUpdate{var, version, notify, notifySuccessors, ptsId});
+    ++st.numOfUpdates;
+    return false;
+}
+
+/*!
+ * Apply the updates of every thread to the points-to sets of partition owner,
+ * collecting what they notify into st.
+ */
+void VersionedFlowSensitive::applyUpdates(std::vector<SolveThread> &threads, u32_t owner, SolveThread &st)
+{
+    for (SolveThread &from : threads)
+    {
+        for (const PendingUpdate &update : from.updates[owner])
+        {
+            const PointsTo &pts = st.updateCache->getActualPts(update.pts);
+            if (update.version == invalidVersion)
+            {
+                if (!FlowSensitive::unionPts(update.var, pts))
+                {
+                    ++st.numOfRedundantUpdates;
+                }
+                else if (!update.notifySuccessors)
+                {
+                    st.nextNodes.push_back(update.notify);
+                }
+                else
+                {
+                    for (const SVFGEdge *edge : svfg->getSVFGNode(update.notify)->getOutEdges())
+                    {
+                        if (SVFUtil::isa<DirectSVFGEdge>(edge)) st.nextNodes.push_back(edge->getDstID());
+                    }
+                }
+            }
+            else
+            {
+                const VersionedVar ov = atKey(update.var, update.version);
+                if (!vPtD->unionPts(ov, pts))
+                {
+                    ++st.numOfRedundantUpdates;
+                    continue;
+                }
+
+                st.nextVersions.push_back(ov);
+                if (const NodeBS *stmts = findStmtReliance(update.var, update.version))
+                {
+                    for (const NodeID s : *stmts) st.nextNodes.push_back(s);
+                }
+            }
+        }
+
+        from.updates[owner].clear();
+    }
+}
+
+/*!
+ * Create the points-to sets solving may look up or update, so that threads
+ * never insert into the maps holding them: the top-level pointers of every
+ * node, and the object versions loads, stores, and version reliances use.
+ * Andersen's points-to sets, over-approximating ours, give the objects.
+ */
+void VersionedFlowSensitive::prepareParallelSolve()
+{
+    createGepObjVars();
+
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it)
+    {
+        const NodeID l = it->first;
+        const SVFGNode *node = it->second;
+        initTopLevelPts(node);
+
+        if (const LoadSVFGNode *load = SVFUtil::dyn_cast<LoadSVFGNode>(node))
+        {
+            for (const NodeID o : ander->getPts(load->getSrcNodeID()))
+            {
+                const Version c = getConsume(l, o);
+                if (c != invalidVersion) vPtD->getPts(atKey(o, c));
+                if (!isFieldInsensitive(o)) continue;
+
+                for (const NodeID of : getAllFieldsObjVars(o))
+                {
+                    const Version fc = getConsume(l, of);
+                    if (fc != invalidVersion) vPtD->getPts(atKey(of, fc));
+                }
+            }
+        }
+        else if (const StoreSVFGNode *store = SVFUtil::dyn_cast<StoreSVFGNode>(node))
+        {
+            for (const NodeID o : ander->getPts(store->getDstNodeID()))
+            {
+                const Version y = getYield(l, o);
+                if (y != invalidVersion) vPtD->getPts(atKey(o, y));
+            }
+
+            for (const ObjToVersionMap::value_type &oc : consume[l])
+            {
+                vPtD->getPts(atKey(oc.first, oc.second));
+                const Version y = getYield(l, oc.first);
+                if (y != invalidVersion) vPtD->getPts(atKey(oc.first, y));
+            }
+        }
+    }
+
+    for (const VersionRelianceMap::value_type &ovr : versionReliance)
+    {
+        for (const Map<Version, std::vector<Version>>::value_type &vr : ovr.second)
+        {
+            vPtD->getPts(atKey(ovr.first, vr.first));
+            for (const Version r : vr.second) vPtD->getPts(atKey(ovr.first, r));
+        }
+    }
+}
+
+const std::vector<Version> *VersionedFlowSensitive::findReliantVersions(const NodeID o, const Version v) const
+{
+    const VersionRelianceMap::const_iterator oIt = versionReliance.find(o);
+    if (oIt == versionReliance.end()) return nullptr;
+    const Map<Version, std::vector<Version>>::const_iterator vIt = oIt->second.find(v);
+    return vIt == oIt->second.end() ? nullptr : &vIt->second;
+}
+
+const NodeBS *VersionedFlowSensitive::findStmtReliance(const NodeID o, const Version v) const
+{
+    const Map<NodeID, Map<Version, NodeBS>>::const_iterator oIt = stmtReliance.find(o);
+    if (oIt == stmtReliance.end()) return nullptr;
+    const Map<Version, NodeBS>::const_iterator vIt = oIt->second.find(v);
+    return vIt == oIt->second.end() ? nullptr : &vIt->second;
+}
+
+bool VersionedFlowSensitive::unionVersionedPts(const VersionedVar &dst, const PointsTo &src)
+{
+    if (SolveThread *st = getSolveThread()) return bufferUpdate(*st, dst.first, dst.second, src, 0, false);
+    return vPtD->unionPts(dst, src);
+}
+
+bool VersionedFlowSensitive::unionVersionedPts(const VersionedVar &dst, NodeID src)
+{
+    if (getSolveThread() != nullptr) return unionVersionedPts(dst, getPts(src));
+    return vPtD->unionPts(dst, src);
+}
+
+bool VersionedFlowSensitive::unionVersionedPts(const VersionedVar &dst, const VersionedVar &src)
+{
+    if (getSolveThread() != nullptr) return unionVersionedPts(dst, vPtD->getPts(src));
+    return vPtD->unionPts(dst, src);
+}
+
+bool VersionedFlowSensitive::unionPtsFromVersion(NodeID dst, const VersionedVar &src)
+{
+    if (getSolveThread() != nullptr) return unionPts(dst, vPtD->getPts(src));
+    return vPtD->unionPts(dst, src);
+}
+
+bool VersionedFlowSensitive::unionPts(NodeID id, const PointsTo &target)
+{
+    if (SolveThread *st = getSolveThread()) return bufferUpdate(*st, id, invalidVersion, target, st->node, true);
+    return FlowSensitive::unionPts(id, target);
+}
+
+bool VersionedFlowSensitive::unionPts(NodeID id, NodeID ptd)
+{
+    if (getSolveThread() != nullptr) return unionPts(id, getPts(ptd));
+    return FlowSensitive::unionPts(id, ptd);
+}
+
+bool VersionedFlowSensitive::addPts(NodeID id, NodeID ptd)
+{
+    if (getSolveThread() != nullptr)
+    {
+        PointsTo pts;
+        pts.set(ptd);
+        return unionPts(id, pts);
+    }
+
+    return FlowSensitive::addPts(id, ptd);
+}
@@ -0,0 +1,248 @@
+//===- VersionedFlowSensitivePlan.cpp -- Reusing VFS versioning --------------//
+
+/*
+ * VersionedFlowSensitivePlan.cpp
+ *
+ * Stores the versioning of versioned flow-sensitive analysis, what prelabel
+ * and meldLabel compute, so that later runs on the same SVFG skip them.
+ *
+ * With -versioning-plan=<file>, <file> is read if its fingerprint matches
+ * that of the SVFG being analysed, and (re)written after versioning from
+ * scratch otherwise. After a header, it stores, one record per line,
+ *   C l o v              o consumes version v at l
+ *   Y l o v              store l yields version v of o
+ *   R o v versions...    versions relying on o:v
+ *   S o v nodes...       statements relying on o:v
+ *   E o o'               o is versioned as o'
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "WPA/Andersen.h"
+#include "WPA/VersionedFlowSensitive.h"
+#include "Util/Options.h"
+
+using namespace SVF;
+using namespace SVFUtil;
+
+namespace
+{
+
+const std::string PlanMagic = "VFS-VERSIONING-PLAN";
+const u32_t PlanVersion = 1;
+
+}  // End anonymous namespace
+
+/*!
+ * Fingerprint of what versioning depends on: the SVFIR, the nodes and edges
+ * of the SVFG with the objects on indirect edges and MR nodes, delta nodes,
+ * and the objects stores may write according to Andersen's analysis.
+ */
+u64_t VersionedFlowSensitive::getVersioningFingerprint(void) const
+{
+    u64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](u64_t v)
+    {
+        for (u32_t i = 0; i < sizeof(v); ++i)
+        {
+            hash ^= (v >> (i * 8)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    mix(getSVFIRFingerprint());
+    mix(svfg->getTotalNodeNum());
+    for (SVFG::const_iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it)
+    {
+        const NodeID l = it->first;
+        const SVFGNode *sn = it->second;
+        mix(l);
+        mix(sn->getNodeKind());
+        mix(delta(l));
+        mix(deltaSource(l));
+
+        if (const StoreSVFGNode *store = SVFUtil::dyn_cast<StoreSVFGNode>(sn))
+        {
+            for (const NodeID o : ander->getPts(store->getDstNodeID())) mix(o);
+        }
+        else if (const MRSVFGNode *mr = SVFUtil::dyn_cast<MRSVFGNode>(sn))
+        {
+            for (const NodeID o : mr->getPointsTo()) mix(o);
+        }
+
+        for (const SVFGEdge *e : sn->getOutEdges())
+        {
+            mix(e->getDstID());
+            mix(e->getEdgeKind());
+            if (const IndirectSVFGEdge *ie = SVFUtil::dyn_cast<IndirectSVFGEdge>(e))
+            {
+                for (const NodeID o : ie->getPointsTo()) mix(o);
+            }
+        }
+    }
+
+    return hash;
+}
+
+/*!
+ * Read the versioning from filename. Returns false, changing nothing, if it
+ * cannot be read or was made for another SVFG.
+ */
+bool VersionedFlowSensitive::readVersioningPlan(const std::string &filename, u64_t fingerprint)
+{
+    std::ifstream F(filename.c_str());
+    if (!F.is_open()) return false;
+
+    outs() << "Loading versioning plan from '" << filename << "'...";
+
+    std::string magic;
+    u32_t version = 0;
+    u64_t planFingerprint = 0;
+    u32_t planPrelabeledNodes = 0;
+    if (!(F >> magic >> version >> planFingerprint >> planPrelabeledNodes)
+            || magic != PlanMagic || version != PlanVersion)
+    {
+        outs() << "  not a versioning plan!\n";
+        return false;
+    }
+
+    if (planFingerprint != fingerprint)
+    {
+        outs() << "  made for another SVFG, versioning from scratch!\n";
+        return false;
+    }
+
+    const u32_t numOfNodes = svfg->getTotalNodeNum();
+    LocVersionMap planConsume(numOfNodes);
+    LocVersionMap planYield(numOfNodes);
+    VersionRelianceMap planVersionReliance;
+    Map<NodeID, Map<Version, NodeBS>> planStmtReliance;
+    std::vector<std::pair<NodeID, NodeID>> planEquivalentObjects;
+
+    std::string line;
+    while (getline(F, line))
+    {
+        if (line.empty()) continue;
+        std::istringstream ss(line.substr(1));
+        NodeID a = 0, b = 0;
+        Version v = invalidVersion;
+        bool ok = true;
+        switch (line[0])
+        {
+        case 'C':
+        case 'Y':
+        {
+            ok = static_cast<bool>(ss >> a >> b >> v) && a < numOfNodes && v != invalidVersion;
+            if (ok) (line[0] == 'C' ? planConsume : planYield)[a][b] = v;
+            break;
+        }
+        case 'R':
+        {
+            ok = static_cast<bool>(ss >> a >> v) && v != invalidVersion;
+            if (!ok) break;
+            std::vector<Version> &reliantVersions = planVersionReliance[a][v];
+            Version r;
+            while (ss >> r) reliantVersions.push_back(r);
+            break;
+        }
+        case 'S':
+        {
+            ok = static_cast<bool>(ss >> a >> v) && v != invalidVersion;
+            if (!ok) break;
+            NodeBS &stmts = planStmtReliance[a][v];
+            while (ss >> b) stmts.set(b);
+            break;
+        }
+        case 'E':
+        {
+            ok = static_cast<bool>(ss >> a >> b);
+            if (ok) planEquivalentObjects.push_back(std::make_pair(a, b));
+            break;
+        }
+        default:
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            outs() << "  malformed record '" << line << "'!\n";
+            return false;
+        }
+    }
+
+    consume.swap(planConsume);
+    yield.swap(planYield);
+    versionReliance.swap(planVersionReliance);
+    stmtReliance.swap(planStmtReliance);
+    for (const std::pair<NodeID, NodeID> &oe : planEquivalentObjects) equivalentObject[oe.first] = oe.second;
+    numPrelabeledNodes = planPrelabeledNodes;
+
+    outs() << "\n";
+    return true;
+}
+
+/*!
+ * Write the versioning to filename, through a temporary file so that an
+ * interrupted run leaves no partial plan behind.
+ */
+void VersionedFlowSensitive::writeVersioningPlan(const std::string &filename, u64_t fingerprint) const
+{
+    outs() << "Storing versioning plan to '" << filename << "'...";
+
+    const std::string tmpFile = filename + ".tmp";
+    std::ofstream f(tmpFile.c_str(), std::ios::out | std::ios::trunc);
+    if (!f.good())
+    {
+        outs() << "  error opening file for writing!\n";
+        return;
+    }
+
+    f << PlanMagic << " " << PlanVersion << " " << fingerprint << " " << numPrelabeledNodes << "\n";
+
+    for (NodeID l = 0; l < consume.size(); ++l)
+    {
+        for (const ObjToVersionMap::value_type &ov : consume[l]) f << "C " << l << " " << ov.first << " " << ov.second << "\n";
+    }
+
+    for (NodeID l = 0; l < yield.size(); ++l)
+    {
+        for (const ObjToVersionMap::value_type &ov : yield[l]) f << "Y " << l << " " << ov.first << " " << ov.second << "\n";
+    }
+
+    for (const VersionRelianceMap::value_type &ovr : versionReliance)
+    {
+        for (const Map<Version, std::vector<Version>>::value_type &vr : ovr.second)
+        {
+            f << "R " << ovr.first << " " << vr.first;
+            for (const Version r : vr.second) f << " " << r;
+            f << "\n";
+        }
+    }
+
+    for (const Map<NodeID, Map<Version, NodeBS>>::value_type &ovs : stmtReliance)
+    {
+        for (const Map<Version, NodeBS>::value_type &vs : ovs.second)
+        {
+            f << "S " << ovs.first << " " << vs.first;
+            for (const NodeID s : vs.second) f << " " << s;
+            f << "\n";
+        }
+    }
+
+    // The constructor makes every object its own equivalent.
+    for (const Map<NodeID, NodeID>::value_type &oe : equivalentObject)
+    {
+        if (oe.first != oe.second) f << "E " << oe.first << " " << oe.second << "\n";
+    }
+
+    f.close();
+    if (!f.good() || std::rename(tmpFile.c_str(), filename.c_str()) != 0)
+    {
+        outs() << "  error writing file!\n";
+        return;
+    }
+
+    outs() << "\n";
+}
@@ -11,6 +11,7 @@
 #include "WPA/WPAStat.h"
 #include "WPA/VersionedFlowSensitive.h"
 #include "MemoryModel/PointsTo.h"
+#include "Util/Options.h"
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -97,6 +98,11 @@ void VersionedFlowSensitiveStat::performStat()
     timeStatMap["meldLabelingTime"]   = vfspta->meldLabelingTime;
     timeStatMap["PrelabelingTime"]    = vfspta->prelabelingTime;
     timeStatMap["VersionPropTime"]    = vfspta->versionPropTime;
+    if (!Options::VersioningPlan().empty())
+    {
+        timeStatMap["VersioningPlanTime"] = vfspta->versioningPlanTime;
+        PTNumStatMap["VersioningPlanReused"] = vfspta->versioningPlanReused;
+    }
 
     PTNumStatMap["TotalPointers"]  = pag->getValueNodeNum();
     PTNumStatMap["TotalObjects"]   = pag->getObjectNodeNum();
@@ -122,6 +128,26 @@ void VersionedFlowSensitiveStat::performStat()
 
     PTNumStatMap["StrongUpdates"] = vfspta->svfgHasSU.count();
 
+    if (vfspta->budgetHasExpired)
+    {
+        PTNumStatMap["FallbackNodes"] = vfspta->fallbackNodes.count();
+        PTNumStatMap["FallbackPtrs"] = vfspta->numOfFallbackPtrs;
+        timeStatMap["FallbackTime"] = vfspta->fallbackTime;
+    }
+
+    if (vfspta->numOfSolveThreads > 1)
+    {
+        PTNumStatMap["FsThreads"] = vfspta->numOfSolveThreads;
+        PTNumStatMap["SolveRounds"] = vfspta->numOfSolveRounds;
+        PTNumStatMap["BufferedUpdates"] = vfspta->numOfBufferedUpdates;
+        PTNumStatMap["RedundantUpdates"] = vfspta->numOfRedundantUpdates;
+        PTNumStatMap["UniqueUpdateSets"] = vfspta->numOfUniqueUpdateSets;
+        timeStatMap["ParallelSolveTime"] = vfspta->parallelSolveTime;
+        timeStatMap["ThreadBusyTime"] = vfspta->threadBusyTime;
+        timeStatMap["ThreadIdleTime"] = vfspta->threadIdleTime;
+        timeStatMap["ParallelSpeedup"] = vfspta->parallelSolveTime > 0 ? vfspta->threadBusyTime / vfspta->parallelSolveTime : 0;
+    }
+
     PTNumStatMap["MaxPtsSize"]        = _MaxPtsSize;
     PTNumStatMap["MaxTopLvlPtsSize"]  = _MaxTopLvlPtsSize;
     PTNumStatMap["MaxVersionPtsSize"] = _MaxVersionPtsSize;
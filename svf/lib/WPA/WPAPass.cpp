@@ -39,6 +39,7 @@
 #include "WPA/WPAPass.h"
 #include "WPA/Andersen.h"
 #include "WPA/AndersenPWC.h"
+#include "WPA/AndersenLCD.h"
 #include "WPA/FlowSensitive.h"
 #include "WPA/VersionedFlowSensitive.h"
 #include "WPA/TypeAnalysis.h"
@@ -68,7 +69,7 @@ WPAPass::~WPAPass()
  */
 void WPAPass::runOnModule(SVFIR* pag)
 {
-    for (u32_t i = 0; i<= PTATY::Default_PTA; i++)
+    for (u32_t i = 0; i<= PTATY::AndersenHLCD_WPA; i++)
     {
         PTATY iPtaTy = static_cast<PTATY>(i);
         if (Options::PASelected(iPtaTy))
@@ -97,6 +98,12 @@ void WPAPass::runPointerAnalysis(SVFIR* pag, u32_t kind)
     case PTATY::AndersenWaveDiff_WPA:
         _pta = new AndersenWaveDiff(pag);
         break;
+    case PTATY::AndersenLCD_WPA:
+        _pta = new AndersenLCD(pag);
+        break;
+    case PTATY::AndersenHLCD_WPA:
+        _pta = new AndersenHLCD(pag);
+        break;
     case PTATY::Steensgaard_WPA:
         _pta = new Steensgaard(pag);
         break;